@@ -27,7 +27,8 @@ class Clio(ConanFile):
         'grpc/1.50.1',
         'openssl/1.1.1u',
         'xrpl/2.0.0-rc1',
-        'libbacktrace/cci.20210118'
+        'libbacktrace/cci.20210118',
+        'zstd/1.5.5'
     ]
 
     default_options = {
@@ -50,6 +51,7 @@ class Clio(ConanFile):
         'protobuf/*:shared': False,
         'protobuf/*:with_zlib': True,
         'snappy/*:shared': False,
+        'zstd/*:shared': False,
         'gtest/*:no_main': True,
     }
 
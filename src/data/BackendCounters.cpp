@@ -28,7 +28,10 @@
 #include <chrono>
 #include <cstdint>
 #include <memory>
+#include <mutex>
+#include <shared_mutex>
 #include <string>
+#include <string_view>
 #include <utility>
 #include <vector>
 
@@ -154,6 +157,22 @@ BackendCounters::registerReadError(std::uint64_t const count)
     asyncReadCounters_.registerError(count);
 }
 
+void
+BackendCounters::registerReadStatement(
+    std::string_view const statement,
+    std::chrono::microseconds const duration,
+    std::uint64_t const count
+)
+{
+    readStatementCounters_.get(statement).registerCompleted(duration, count);
+}
+
+void
+BackendCounters::registerWriteStatement(std::string_view const statement, std::chrono::microseconds const duration)
+{
+    writeStatementCounters_.get(statement).registerCompleted(duration, 1u);
+}
+
 boost::json::object
 BackendCounters::report() const
 {
@@ -165,6 +184,8 @@ BackendCounters::report() const
         result[key] = value;
     for (auto const& [key, value] : asyncReadCounters_.report())
         result[key] = value;
+    result["read_statements"] = readStatementCounters_.report();
+    result["write_statements"] = writeStatementCounters_.report();
     return result;
 }
 
@@ -237,4 +258,77 @@ BackendCounters::AsyncOperationCounters::report() const
     };
 }
 
+BackendCounters::StatementCounters::StatementCounters(std::string_view const statement, std::string const& operation)
+    : completedCounter_(PrometheusService::counterInt(
+          "backend_statements_total_number",
+          Labels({{"operation", operation}, {"statement", std::string{statement}}}),
+          "The total number of completed " + operation + " operations per statement"
+      ))
+    , durationCounter_(PrometheusService::counterInt(
+          "backend_statements_duration_microseconds_total",
+          Labels({{"operation", operation}, {"statement", std::string{statement}}}),
+          "The accumulated duration of " + operation + " operations per statement"
+      ))
+    , durationHistogram_(PrometheusService::histogramInt(
+          "backend_statements_duration_milliseconds_histogram",
+          Labels({{"operation", operation}, {"statement", std::string{statement}}}),
+          histogramBuckets,
+          "The duration of " + operation + " operations per statement including retries"
+      ))
+{
+}
+
+void
+BackendCounters::StatementCounters::registerCompleted(
+    std::chrono::microseconds const duration,
+    std::uint64_t const count
+)
+{
+    auto const durationMs = std::chrono::duration_cast<std::chrono::milliseconds>(duration).count();
+    completedCounter_.get() += count;
+    durationCounter_.get() += duration.count() * count;
+    for (std::uint64_t i = 0; i < count; ++i)
+        durationHistogram_.get().observe(durationMs);
+}
+
+boost::json::object
+BackendCounters::StatementCounters::report() const
+{
+    auto const completed = completedCounter_.get().value();
+    auto const duration = durationCounter_.get().value();
+    return boost::json::object{
+        {"completed", completed},
+        {"duration_us", duration},
+        {"avg_duration_us", completed == 0u ? 0u : duration / completed}
+    };
+}
+
+BackendCounters::StatementCountersMap::StatementCountersMap(std::string operation) : operation_(std::move(operation))
+{
+}
+
+BackendCounters::StatementCounters&
+BackendCounters::StatementCountersMap::get(std::string_view const statement)
+{
+    {
+        std::shared_lock const lck{mtx_};
+        if (auto it = counters_.find(statement); it != counters_.end())
+            return it->second;
+    }
+
+    std::scoped_lock const lck{mtx_};
+    auto [it, _] = counters_.try_emplace(std::string{statement}, statement, operation_);
+    return it->second;
+}
+
+boost::json::object
+BackendCounters::StatementCountersMap::report() const
+{
+    boost::json::object result;
+    std::shared_lock const lck{mtx_};
+    for (auto const& [statement, counters] : counters_)
+        result[statement] = counters.report();
+    return result;
+}
+
 }  // namespace data
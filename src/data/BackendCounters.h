@@ -24,8 +24,14 @@
 #include <boost/json/object.hpp>
 
 #include <atomic>
+#include <chrono>
+#include <cstdint>
 #include <functional>
+#include <map>
 #include <memory>
+#include <shared_mutex>
+#include <string>
+#include <string_view>
 #include <utility>
 
 namespace data {
@@ -66,6 +72,12 @@ concept SomeBackendCounters = requires(T a) {
     {
         a.registerReadError(std::uint64_t{})
     } -> std::same_as<void>;
+    {
+        a.registerReadStatement(std::string_view{}, std::chrono::microseconds{}, std::uint64_t{})
+    } -> std::same_as<void>;
+    {
+        a.registerWriteStatement(std::string_view{}, std::chrono::microseconds{})
+    } -> std::same_as<void>;
     {
         a.report()
     } -> std::same_as<boost::json::object>;
@@ -113,12 +125,63 @@ public:
     void
     registerReadError(std::uint64_t count = 1u);
 
+    /**
+     * @brief Register the completion of a read of a specific (prepared) statement.
+     *
+     * @param statement The label of the statement
+     * @param duration How long the read took including retries
+     * @param count The number of statements that completed in this duration
+     */
+    void
+    registerReadStatement(std::string_view statement, std::chrono::microseconds duration, std::uint64_t count = 1u);
+
+    /**
+     * @brief Register the completion of a write of a specific (prepared) statement.
+     *
+     * @param statement The label of the statement
+     * @param duration How long the write took including retries
+     */
+    void
+    registerWriteStatement(std::string_view statement, std::chrono::microseconds duration);
+
     boost::json::object
     report() const;
 
 private:
     BackendCounters();
 
+    class StatementCounters {
+    public:
+        StatementCounters(std::string_view statement, std::string const& operation);
+
+        void
+        registerCompleted(std::chrono::microseconds duration, std::uint64_t count);
+
+        boost::json::object
+        report() const;
+
+    private:
+        std::reference_wrapper<util::prometheus::CounterInt> completedCounter_;
+        std::reference_wrapper<util::prometheus::CounterInt> durationCounter_;
+        std::reference_wrapper<util::prometheus::HistogramInt> durationHistogram_;
+    };
+
+    class StatementCountersMap {
+    public:
+        explicit StatementCountersMap(std::string operation);
+
+        StatementCounters&
+        get(std::string_view statement);
+
+        boost::json::object
+        report() const;
+
+    private:
+        std::string operation_;
+        mutable std::shared_mutex mtx_;
+        std::map<std::string, StatementCounters, std::less<>> counters_;
+    };
+
     class AsyncOperationCounters {
     public:
         AsyncOperationCounters(std::string name);
@@ -156,6 +219,9 @@ private:
 
     std::reference_wrapper<util::prometheus::HistogramInt> readDurationHistogram_;
     std::reference_wrapper<util::prometheus::HistogramInt> writeDurationHistogram_;
+
+    StatementCountersMap readStatementCounters_{"read"};
+    StatementCountersMap writeStatementCounters_{"write"};
 };
 
 }  // namespace data
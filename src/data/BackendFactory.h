@@ -20,6 +20,7 @@
 #pragma once
 
 #include "data/BackendInterface.h"
+#include "data/BlobCodec.h"
 #include "data/CassandraBackend.h"
 #include "util/config/Config.h"
 #include "util/log/Logger.h"
@@ -54,6 +55,8 @@ make_Backend(util::Config const& config)
     if (!backend)
         throw std::runtime_error("Invalid database type");
 
+    backend->setCodec(std::make_shared<BlobCodec const>(config.sectionOr("database.compression", {})));
+
     auto const rng = backend->hardFetchLedgerRangeNoThrow();
     if (rng) {
         backend->updateRange(rng->minSequence);
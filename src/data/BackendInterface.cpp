@@ -53,7 +53,7 @@ bool
 BackendInterface::finishWrites(std::uint32_t const ledgerSequence)
 {
     LOG(gLog.debug()) << "Want finish writes for " << ledgerSequence;
-    auto commitRes = doFinishWrites();
+    auto commitRes = doFinishWrites(ledgerSequence);
     if (commitRes) {
         LOG(gLog.debug()) << "Successfully commited. Updating range now to " << ledgerSequence;
         updateRange(ledgerSequence);
@@ -270,6 +270,39 @@ BackendInterface::updateRange(uint32_t newMax)
     }
 }
 
+void
+BackendInterface::updateRangeMin(uint32_t newMin)
+{
+    std::scoped_lock const lck(rngMtx_);
+
+    if (range && newMin <= range->maxSequence)
+        range->minSequence = newMin;
+}
+
+bool
+BackendInterface::advanceMinSequence(std::uint32_t const oldMin, std::uint32_t const newMin)
+{
+    ASSERT(newMin > oldMin, "New minimum must be above the old one. oldMin = {}, newMin = {}", oldMin, newMin);
+
+    if (not doUpdateMinSequence(oldMin, newMin))
+        return false;
+
+    updateRangeMin(newMin);
+    return true;
+}
+
+bool
+BackendInterface::extendMinSequence(std::uint32_t const oldMin, std::uint32_t const newMin)
+{
+    ASSERT(newMin < oldMin, "New minimum must be below the old one. oldMin = {}, newMin = {}", oldMin, newMin);
+
+    if (not doUpdateMinSequence(oldMin, newMin))
+        return false;
+
+    updateRangeMin(newMin);
+    return true;
+}
+
 LedgerPage
 BackendInterface::fetchLedgerPage(
     std::optional<ripple::uint256> const& cursor,
@@ -19,6 +19,7 @@
 
 #pragma once
 
+#include "data/BlobCodec.h"
 #include "data/DBHelpers.h"
 #include "data/LedgerCache.h"
 #include "data/Types.h"
@@ -29,7 +30,12 @@
 #include <boost/json.hpp>
 #include <ripple/protocol/Fees.h>
 #include <ripple/protocol/LedgerHeader.h>
+#include <ripple/protocol/TxFormats.h>
 
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <string>
 #include <thread>
 #include <type_traits>
 
@@ -122,6 +128,7 @@ protected:
     mutable std::shared_mutex rngMtx_;
     std::optional<LedgerRange> range;
     LedgerCache cache_;
+    std::shared_ptr<BlobCodec const> codec_ = std::make_shared<BlobCodec const>();
 
 public:
     BackendInterface() = default;
@@ -146,6 +153,26 @@ public:
         return cache_;
     }
 
+    /**
+     * @return The codec used for transaction and metadata blobs
+     */
+    BlobCodec const&
+    codec() const
+    {
+        return *codec_;
+    }
+
+    /**
+     * @brief Replace the blob codec; must be called before any reads or writes are issued.
+     *
+     * @param codec The codec to use
+     */
+    void
+    setCodec(std::shared_ptr<BlobCodec const> codec)
+    {
+        codec_ = std::move(codec);
+    }
+
     /**
      * @brief Fetches a specific ledger by sequence number.
      *
@@ -191,6 +218,16 @@ public:
     void
     updateRange(uint32_t newMax);
 
+    /**
+     * @brief Moves the minimum sequence of the in-memory range after history was pruned or backfilled.
+     *
+     * Has no effect if there is no range yet or newMin is above its maximum.
+     *
+     * @param newMin The new minimum sequence available
+     */
+    void
+    updateRangeMin(uint32_t newMin);
+
     /**
      * @brief Fetch the fees from a specific ledger sequence.
      *
@@ -240,6 +277,42 @@ public:
         boost::asio::yield_context yield
     ) const = 0;
 
+    /**
+     * @brief Fetches transactions of a specific type for a specific account.
+     *
+     * The filter is applied before transactions are fetched, so the limit counts matching transactions only.
+     *
+     * @param account The account to fetch transactions for
+     * @param transactionType The type of transactions to fetch
+     * @param limit The maximum number of transactions per result page
+     * @param forward Whether to fetch the page forwards or backwards from the given cursor
+     * @param cursor The cursor to resume fetching from
+     * @param yield The coroutine context
+     * @return Results and a cursor to resume from
+     */
+    virtual TransactionsAndCursor
+    fetchAccountTransactionsByType(
+        ripple::AccountID const& account,
+        ripple::TxType transactionType,
+        std::uint32_t limit,
+        bool forward,
+        std::optional<TransactionsCursor> const& cursor,
+        boost::asio::yield_context yield
+    ) const = 0;
+
+    /**
+     * @brief Fetch the oldest ledger from which an index table is filled for every ledger.
+     *
+     * Index tables added by a later version of Clio have no rows for ledgers written before the upgrade. Below the
+     * returned ledger the data has to be read without the index.
+     *
+     * @param table The name of the index table; one of the INDEX_ constants
+     * @param yield The coroutine context
+     * @return The oldest covered ledger; 0 if the whole history is covered; nullopt if the table was never written
+     */
+    virtual std::optional<std::uint32_t>
+    fetchIndexCoverage(std::string const& table, boost::asio::yield_context yield) const = 0;
+
     /**
      * @brief Fetches all transactions from a specific ledger.
      *
@@ -260,6 +333,21 @@ public:
     virtual std::vector<ripple::uint256>
     fetchAllTransactionHashesInLedger(std::uint32_t ledgerSequence, boost::asio::yield_context yield) const = 0;
 
+    /**
+     * @brief Fetches a transaction by its position in a ledger, e.g. as encoded in a CTID.
+     *
+     * @param ledgerSequence The ledger sequence the transaction was validated in
+     * @param transactionIndex The index of the transaction within that ledger
+     * @param yield The coroutine context
+     * @return The transaction if its position was recorded; nullopt otherwise
+     */
+    virtual std::optional<TransactionAndMetadata>
+    fetchTransactionByIndex(
+        std::uint32_t ledgerSequence,
+        std::uint32_t transactionIndex,
+        boost::asio::yield_context yield
+    ) const = 0;
+
     /**
      * @brief Fetches a specific NFT.
      *
@@ -497,6 +585,16 @@ public:
     virtual void
     writeLedgerObject(std::string&& key, std::uint32_t seq, std::string&& blob);
 
+    /**
+     * @brief Writes an object of a full ledger snapshot. Unlike writeLedgerObject, it is not added to the ledger diff.
+     *
+     * @param key The key to write the ledger object under
+     * @param seq The ledger sequence to write for
+     * @param blob The data to write; empty for a deleted object
+     */
+    virtual void
+    writeSnapshotObject(std::string&& key, std::uint32_t seq, std::string&& blob) = 0;
+
     /**
      * @brief Writes a new transaction.
      *
@@ -515,6 +613,16 @@ public:
         std::string&& metadata
     ) = 0;
 
+    /**
+     * @brief Writes the position of a transaction within its ledger.
+     *
+     * @param seq The ledger sequence the transaction was validated in
+     * @param transactionIndex The index of the transaction within that ledger
+     * @param hash The hash of the transaction
+     */
+    virtual void
+    writeTransactionIndex(std::uint32_t seq, std::uint32_t transactionIndex, ripple::uint256 const& hash) = 0;
+
     /**
      * @brief Writes NFTs to the database.
      *
@@ -549,6 +657,15 @@ public:
     virtual void
     writeSuccessor(std::string&& key, std::uint32_t seq, std::string&& successor) = 0;
 
+    /**
+     * @brief Write a set of successors in one go.
+     *
+     * @param successors Pairs of key and its successor
+     * @param seq The ledger sequence to write for
+     */
+    virtual void
+    writeSuccessors(std::vector<std::pair<ripple::uint256, ripple::uint256>> const& successors, std::uint32_t seq) = 0;
+
     /**
      * @brief Starts a write transaction with the DB. No-op for cassandra.
      *
@@ -560,7 +677,9 @@ public:
     /**
      * @brief Tells database we finished writing all data for a specific ledger.
      *
-     * Uses doFinishWrites to synchronize with the pending writes.
+     * Uses doFinishWrites to synchronize with the pending writes. Only the writes issued up to this ledger are waited
+     * for, so the writes of the next ledger may already be in flight while this one is being committed. Ledgers must
+     * be finished in order.
      *
      * @param ledgerSequence The ledger sequence to finish writing for
      * @return true on success; false otherwise
@@ -568,12 +687,140 @@ public:
     bool
     finishWrites(std::uint32_t ledgerSequence);
 
+    /**
+     * @brief Atomically advance the minimum ledger stored in the DB, making everything below it unavailable.
+     *
+     * Uses doUpdateMinSequence to update the DB and updates the in-memory range on success.
+     *
+     * @param oldMin The current minimum sequence
+     * @param newMin The new minimum sequence
+     * @return true on success; false if the stored minimum is no longer oldMin
+     */
+    bool
+    advanceMinSequence(std::uint32_t oldMin, std::uint32_t newMin);
+
+    /**
+     * @brief Atomically extend the minimum ledger stored in the DB down to ledgers that were backfilled.
+     *
+     * Uses doUpdateMinSequence to update the DB and updates the in-memory range on success. All ledgers from newMin
+     * up to oldMin must be fully written before this is called.
+     *
+     * @param oldMin The current minimum sequence
+     * @param newMin The new minimum sequence
+     * @return true on success; false if the stored minimum is no longer oldMin
+     */
+    bool
+    extendMinSequence(std::uint32_t oldMin, std::uint32_t newMin);
+
+    /**
+     * @brief Give the writes the calling thread issues from now on a write group of their own.
+     *
+     * For writers next to the live ETL, such as the backfill: syncThreadWrites() then only waits for their writes and
+     * finishWrites of live ledgers does not wait for them. Ledgers written by the thread don't start write groups.
+     */
+    virtual void
+    isolateThreadWrites() = 0;
+
+    /**
+     * @brief Wait for the writes of the calling thread; for all writes if it was not isolated by isolateThreadWrites().
+     */
+    virtual void
+    syncThreadWrites() = 0;
+
+    /**
+     * @brief Durably record that a chunk of ledgers below the minimum ledger was backfilled.
+     *
+     * Waits for the outstanding writes of the calling thread first (see syncThreadWrites), so a recorded chunk is
+     * always complete if the chunk was written by the same thread.
+     *
+     * @param chunk The first and last ledger of the chunk
+     */
+    virtual void
+    writeBackfilledChunk(LedgerRange const& chunk) = 0;
+
+    /**
+     * @brief Fetch all chunks of ledgers recorded by writeBackfilledChunk.
+     *
+     * @param yield The coroutine context
+     * @return The backfilled chunks in no particular order
+     */
+    virtual std::vector<LedgerRange>
+    fetchBackfilledChunks(boost::asio::yield_context yield) const = 0;
+
+    /**
+     * @brief Durably record how far the initial ledger load got, so it can be resumed after a restart.
+     *
+     * Waits for all outstanding writes first, so everything up to the last key of each cursor is written.
+     *
+     * @param progress The sequence being loaded and the cursors of all of its marker ranges
+     */
+    virtual void
+    writeInitialLoadProgress(InitialLoadProgress const& progress) = 0;
+
+    /**
+     * @brief Fetch the progress recorded by writeInitialLoadProgress.
+     *
+     * @param yield The coroutine context
+     * @return The progress with the cursors ordered by marker; nullopt if no initial load is in progress
+     */
+    virtual std::optional<InitialLoadProgress>
+    fetchInitialLoadProgress(boost::asio::yield_context yield) const = 0;
+
+    /**
+     * @brief Forget the progress of the initial ledger load once the load is finished.
+     */
+    virtual void
+    clearInitialLoadProgress() = 0;
+
+    /**
+     * @brief Fetch the lease of the ETL writer.
+     *
+     * @param yield The coroutine context
+     * @return The lease; nullopt if no process ever was the writer
+     */
+    virtual std::optional<WriterLease>
+    fetchWriterLease(boost::asio::yield_context yield) const = 0;
+
+    /**
+     * @brief Atomically replace the lease of the ETL writer if it did not change since it was fetched.
+     *
+     * @param expected The lease as fetched; nullopt if there was none
+     * @param lease The new lease
+     * @return true on success; false if the lease is no longer the expected one
+     */
+    virtual bool
+    updateWriterLease(std::optional<WriterLease> const& expected, WriterLease const& lease) = 0;
+
+    /**
+     * @brief Delete history below the minimum ledger and wait for the deletes of the calling thread to finish.
+     *
+     * Deletes are issued in chunks; each chunk is waited for before waitForCapacity is called and the next one issued.
+     * Rows that others are found through (transactions, ledger transactions, diffs and headers) are only deleted once
+     * those are gone, so collecting the history again after an interrupted deletion still finds everything left.
+     *
+     * @param history The rows to delete
+     * @param chunkSize The maximum number of deletes issued at once
+     * @param waitForCapacity Called between chunks; returns once the next chunk may be issued
+     */
+    virtual void
+    deleteHistory(
+        PrunedHistory const& history,
+        std::size_t chunkSize,
+        std::function<void()> const& waitForCapacity
+    ) = 0;
+
     /**
      * @return true if database is overwhelmed; false otherwise
      */
     virtual bool
     isTooBusy() const = 0;
 
+    /**
+     * @return The share of the outstanding write requests allowance currently in use, from 0 to 1
+     */
+    virtual double
+    writeLoad() const = 0;
+
     /**
      * @return json object containing backend usage statistics
      */
@@ -585,7 +832,10 @@ private:
     doWriteLedgerObject(std::string&& key, std::uint32_t seq, std::string&& blob) = 0;
 
     virtual bool
-    doFinishWrites() = 0;
+    doFinishWrites(std::uint32_t ledgerSequence) = 0;
+
+    virtual bool
+    doUpdateMinSequence(std::uint32_t oldMin, std::uint32_t newMin) = 0;
 };
 
 }  // namespace data
@@ -0,0 +1,271 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of clio: https://github.com/XRPLF/clio
+    Copyright (c) 2023, the clio developers.
+
+    Permission to use, copy, modify, and distribute this software for any
+    purpose with or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL,  DIRECT,  INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include "data/BlobCodec.h"
+
+#include "data/Types.h"
+#include "util/Expected.h"
+#include "util/config/Config.h"
+#include "util/prometheus/Label.h"
+#include "util/prometheus/Prometheus.h"
+
+#include <boost/json/object.hpp>
+#include <fmt/core.h>
+#include <zstd.h>
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <iterator>
+#include <memory>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace data {
+
+namespace {
+
+// Two zero bytes would encode a field header with type code 0, which is never emitted by the XRPL serializer
+constexpr std::uint8_t MARKER = 0x00;
+
+// Guards against allocating based on a corrupted frame header; real transactions and metadata are far smaller
+constexpr unsigned long long MAX_DECODED_SIZE = 64ull * 1024 * 1024;
+
+struct CCtxDeleter {
+    void
+    operator()(ZSTD_CCtx* ctx) const
+    {
+        ZSTD_freeCCtx(ctx);
+    }
+};
+
+struct DCtxDeleter {
+    void
+    operator()(ZSTD_DCtx* ctx) const
+    {
+        ZSTD_freeDCtx(ctx);
+    }
+};
+
+// zstd contexts are not thread-safe but are expensive to create, so every thread keeps its own
+ZSTD_CCtx*
+compressionContext()
+{
+    thread_local std::unique_ptr<ZSTD_CCtx, CCtxDeleter> const ctx{ZSTD_createCCtx()};
+    return ctx.get();
+}
+
+ZSTD_DCtx*
+decompressionContext()
+{
+    thread_local std::unique_ptr<ZSTD_DCtx, DCtxDeleter> const ctx{ZSTD_createDCtx()};
+    return ctx.get();
+}
+
+std::uint64_t
+microsecondsSince(std::chrono::steady_clock::time_point const startTime)
+{
+    return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - startTime).count();
+}
+
+std::vector<char>
+readDictionary(std::string const& path)
+{
+    std::ifstream in{path, std::ios::binary};
+    if (not in)
+        throw std::runtime_error(fmt::format("Can't open compression dictionary '{}'", path));
+
+    return {std::istreambuf_iterator<char>{in}, std::istreambuf_iterator<char>{}};
+}
+
+}  // namespace
+
+using namespace util::prometheus;
+
+void
+BlobCodec::CDictDeleter::operator()(ZSTD_CDict_s* dict) const
+{
+    ZSTD_freeCDict(dict);
+}
+
+void
+BlobCodec::DDictDeleter::operator()(ZSTD_DDict_s* dict) const
+{
+    ZSTD_freeDDict(dict);
+}
+
+BlobCodec::Counters::Counters(std::string const& operation)
+    : blobs(PrometheusService::counterInt(
+          "backend_blob_codec_total_number",
+          Labels({Label{"operation", operation}}),
+          "The total number of transaction and metadata blobs passed through the compression codec"
+      ))
+    , rawBytes(PrometheusService::counterInt(
+          "backend_blob_codec_bytes_total",
+          Labels({Label{"operation", operation}, Label{"format", "raw"}}),
+          "The total size of blobs handled by the compression codec"
+      ))
+    , storedBytes(PrometheusService::counterInt(
+          "backend_blob_codec_bytes_total",
+          Labels({Label{"operation", operation}, Label{"format", "stored"}}),
+          "The total size of blobs handled by the compression codec"
+      ))
+    , durationUs(PrometheusService::counterInt(
+          "backend_blob_codec_duration_microseconds_total",
+          Labels({Label{"operation", operation}}),
+          "The total CPU time spent in the compression codec"
+      ))
+{
+}
+
+boost::json::object
+BlobCodec::Counters::report() const
+{
+    auto const raw = rawBytes.get().value();
+    auto const stored = storedBytes.get().value();
+
+    boost::json::object result;
+    result["blobs"] = blobs.get().value();
+    result["raw_bytes"] = raw;
+    result["stored_bytes"] = stored;
+    result["saved_bytes"] = raw > stored ? raw - stored : 0u;
+    result["duration_us"] = durationUs.get().value();
+    return result;
+}
+
+BlobCodec::BlobCodec() = default;
+
+BlobCodec::BlobCodec(util::Config const& config)
+    : enabled_{config.valueOr("enabled", false)}, level_{config.valueOr("level", DEFAULT_LEVEL)}
+{
+    if (level_ < ZSTD_minCLevel() or level_ > ZSTD_maxCLevel()) {
+        throw std::runtime_error(fmt::format(
+            "Compression level must be between {} and {}, got {}", ZSTD_minCLevel(), ZSTD_maxCLevel(), level_
+        ));
+    }
+
+    if (auto const path = config.maybeValue<std::string>("dictionary"); path) {
+        auto const dictionary = readDictionary(*path);
+
+        cdict_.reset(ZSTD_createCDict(dictionary.data(), dictionary.size(), level_));
+        ddict_.reset(ZSTD_createDDict(dictionary.data(), dictionary.size()));
+        if (not cdict_ or not ddict_)
+            throw std::runtime_error(fmt::format("Can't load compression dictionary '{}'", *path));
+
+        dictionaryId_ = ZSTD_getDictID_fromDict(dictionary.data(), dictionary.size());
+    }
+}
+
+BlobCodec::~BlobCodec() = default;
+
+std::string
+BlobCodec::encode(std::string&& blob) const
+{
+    if (not enabled_ or blob.empty())
+        return std::move(blob);
+
+    auto const startTime = std::chrono::steady_clock::now();
+
+    std::string encoded(HEADER_SIZE + ZSTD_compressBound(blob.size()), '\0');
+    encoded[0] = static_cast<char>(MARKER);
+    encoded[1] = static_cast<char>(MARKER);
+    encoded[2] = static_cast<char>(FORMAT_ZSTD);
+
+    auto* dst = encoded.data() + HEADER_SIZE;
+    auto const capacity = encoded.size() - HEADER_SIZE;
+    auto const size = cdict_
+        ? ZSTD_compress_usingCDict(compressionContext(), dst, capacity, blob.data(), blob.size(), cdict_.get())
+        : ZSTD_compressCCtx(compressionContext(), dst, capacity, blob.data(), blob.size(), level_);
+
+    // Incompressible blobs are stored as is, which decode passes through
+    auto const keepRaw = ZSTD_isError(size) or HEADER_SIZE + size >= blob.size();
+    if (not keepRaw)
+        encoded.resize(HEADER_SIZE + size);
+
+    ++encodeCounters_.blobs.get();
+    encodeCounters_.rawBytes.get() += blob.size();
+    encodeCounters_.storedBytes.get() += keepRaw ? blob.size() : encoded.size();
+    encodeCounters_.durationUs.get() += microsecondsSince(startTime);
+
+    return keepRaw ? std::move(blob) : std::move(encoded);
+}
+
+util::Expected<Blob, std::string>
+BlobCodec::decode(Blob&& blob) const
+{
+    if (not isEncoded(blob))
+        return std::move(blob);
+
+    if (blob[2] != FORMAT_ZSTD)
+        return util::Unexpected{fmt::format("Unknown blob format version {}", blob[2])};
+
+    auto const startTime = std::chrono::steady_clock::now();
+    auto const* src = blob.data() + HEADER_SIZE;
+    auto const srcSize = blob.size() - HEADER_SIZE;
+
+    auto const contentSize = ZSTD_getFrameContentSize(src, srcSize);
+    if (contentSize == ZSTD_CONTENTSIZE_ERROR or contentSize == ZSTD_CONTENTSIZE_UNKNOWN or
+        contentSize > MAX_DECODED_SIZE)
+        return util::Unexpected{std::string{"Corrupted compressed blob header"}};
+
+    auto const frameDictionaryId = ZSTD_getDictID_fromFrame(src, srcSize);
+    if (frameDictionaryId != 0 and (not ddict_ or frameDictionaryId != dictionaryId_)) {
+        return util::Unexpected{
+            fmt::format("Blob was compressed with dictionary {} which is not configured", frameDictionaryId)
+        };
+    }
+
+    Blob decoded(contentSize);
+    auto const size = ddict_
+        ? ZSTD_decompress_usingDDict(decompressionContext(), decoded.data(), decoded.size(), src, srcSize, ddict_.get())
+        : ZSTD_decompressDCtx(decompressionContext(), decoded.data(), decoded.size(), src, srcSize);
+
+    if (ZSTD_isError(size) or size != contentSize)
+        return util::Unexpected{fmt::format("Can't decompress blob: {}", ZSTD_getErrorName(size))};
+
+    ++decodeCounters_.blobs.get();
+    decodeCounters_.rawBytes.get() += decoded.size();
+    decodeCounters_.storedBytes.get() += blob.size();
+    decodeCounters_.durationUs.get() += microsecondsSince(startTime);
+
+    return decoded;
+}
+
+bool
+BlobCodec::isEncoded(Blob const& blob)
+{
+    return blob.size() > HEADER_SIZE and blob[0] == MARKER and blob[1] == MARKER;
+}
+
+boost::json::object
+BlobCodec::report() const
+{
+    boost::json::object result;
+    result["enabled"] = enabled_;
+    result["dictionary_id"] = dictionaryId_;
+    result["encode"] = encodeCounters_.report();
+    result["decode"] = decodeCounters_.report();
+    return result;
+}
+
+}  // namespace data
@@ -0,0 +1,153 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of clio: https://github.com/XRPLF/clio
+    Copyright (c) 2023, the clio developers.
+
+    Permission to use, copy, modify, and distribute this software for any
+    purpose with or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL,  DIRECT,  INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#pragma once
+
+#include "data/Types.h"
+#include "util/Expected.h"
+#include "util/config/Config.h"
+#include "util/prometheus/Prometheus.h"
+
+#include <boost/json/object.hpp>
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <string>
+
+struct ZSTD_CDict_s;
+struct ZSTD_DDict_s;
+
+namespace data {
+
+/**
+ * @brief Optional client-side compression of transaction and metadata blobs.
+ *
+ * Encoded blobs start with a two byte marker followed by a format version byte. The marker (two zero bytes) can never
+ * start a serialized XRPL object, so rows written before compression was enabled (or with compression disabled) are
+ * passed through decode unchanged.
+ *
+ * Version 1 is a single zstd frame, optionally compressed against a dictionary trained offline on XRPL binary (e.g.
+ * with `zstd --train`). The dictionary must stay available for as long as rows compressed with it are readable.
+ */
+class BlobCodec {
+public:
+    static constexpr std::uint8_t FORMAT_ZSTD = 1;
+    static constexpr std::size_t HEADER_SIZE = 3;
+    static constexpr int DEFAULT_LEVEL = 3;
+
+private:
+    struct CDictDeleter {
+        void
+        operator()(ZSTD_CDict_s* dict) const;
+    };
+
+    struct DDictDeleter {
+        void
+        operator()(ZSTD_DDict_s* dict) const;
+    };
+
+    struct Counters {
+        std::reference_wrapper<util::prometheus::CounterInt> blobs;
+        std::reference_wrapper<util::prometheus::CounterInt> rawBytes;
+        std::reference_wrapper<util::prometheus::CounterInt> storedBytes;
+        std::reference_wrapper<util::prometheus::CounterInt> durationUs;
+
+        explicit Counters(std::string const& operation);
+
+        boost::json::object
+        report() const;
+    };
+
+    bool enabled_ = false;
+    int level_ = DEFAULT_LEVEL;
+    std::unique_ptr<ZSTD_CDict_s, CDictDeleter> cdict_;
+    std::unique_ptr<ZSTD_DDict_s, DDictDeleter> ddict_;
+    std::uint32_t dictionaryId_ = 0;
+
+    Counters encodeCounters_{"encode"};
+    Counters decodeCounters_{"decode"};
+
+public:
+    /**
+     * @brief Create a codec with compression disabled; it still decodes compressed rows without a dictionary.
+     */
+    BlobCodec();
+
+    /**
+     * @brief Create a codec from the `database.compression` section of the config.
+     *
+     * @param config The compression config section
+     * @throws std::runtime_error if the dictionary can't be loaded or the compression level is invalid
+     */
+    explicit BlobCodec(util::Config const& config);
+
+    ~BlobCodec();
+
+    BlobCodec(BlobCodec const&) = delete;
+    BlobCodec&
+    operator=(BlobCodec const&) = delete;
+
+    /**
+     * @return true if new blobs are compressed; false otherwise
+     */
+    [[nodiscard]] bool
+    isEnabled() const
+    {
+        return enabled_;
+    }
+
+    /**
+     * @brief Encode a blob for storage.
+     *
+     * The blob is returned unchanged if compression is disabled or would not make it smaller.
+     *
+     * @param blob The raw blob
+     * @return The blob in storage format
+     */
+    [[nodiscard]] std::string
+    encode(std::string&& blob) const;
+
+    /**
+     * @brief Decode a blob read from storage.
+     *
+     * @param blob The blob in storage format
+     * @return The raw blob on success; error message otherwise
+     */
+    [[nodiscard]] util::Expected<Blob, std::string>
+    decode(Blob&& blob) const;
+
+    /**
+     * @brief Check whether a stored blob carries the codec header.
+     *
+     * @param blob The blob in storage format
+     * @return true if the blob was encoded by this codec; false if it is a raw blob
+     */
+    [[nodiscard]] static bool
+    isEncoded(Blob const& blob);
+
+    /**
+     * @return JSON report of bytes in and out of the codec and the CPU time spent, per direction
+     */
+    [[nodiscard]] boost::json::object
+    report() const;
+};
+
+}  // namespace data
@@ -34,6 +34,16 @@
 #include <ripple/protocol/LedgerHeader.h>
 #include <ripple/protocol/nft.h>
 
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <optional>
+#include <stdexcept>
+#include <string>
+
 namespace data::cassandra {
 
 /**
@@ -52,10 +62,20 @@ class BasicCassandraBackend : public BackendInterface {
     Schema<SettingsProviderType> schema_;
     Handle handle_;
 
+    // only set if reads are configured to use a separate session
+    std::optional<Handle> readHandle_;
+
     // have to be mutable because BackendInterface constness :(
     mutable ExecutionStrategyType executor_;
 
-    std::atomic_uint32_t ledgerSequence_ = 0u;
+    // write group of each ledger that was written but not yet committed
+    std::mutex writeGroupsMtx_;
+    std::map<std::uint32_t, std::uint64_t> writeGroups_;
+
+    // the coverage of the index tables is recorded once, when this process commits its first ledger
+    std::once_flag indexCoverageRecorded_;
+    mutable std::mutex indexCoverageMtx_;
+    mutable std::map<std::string, std::uint32_t> indexCoverage_;
 
 public:
     /**
@@ -68,11 +88,17 @@ public:
         : settingsProvider_{std::move(settingsProvider)}
         , schema_{settingsProvider_}
         , handle_{settingsProvider_.getSettings()}
-        , executor_{settingsProvider_.getSettings(), handle_}
+        , readHandle_{settingsProvider_.getReadSettings()}
+        , executor_{settingsProvider_.getSettings(), handle_, readHandle_ ? *readHandle_ : handle_}
     {
         if (auto const res = handle_.connect(); not res)
             throw std::runtime_error("Could not connect to Cassandra: " + res.error());
 
+        if (readHandle_) {
+            if (auto const res = readHandle_->connect(); not res)
+                throw std::runtime_error("Could not connect to Cassandra for reads: " + res.error());
+        }
+
         if (not readOnly) {
             if (auto const res = handle_.execute(schema_.createKeyspace); not res) {
                 // on datastax, creation of keyspaces can be configured to only be done thru the admin
@@ -133,68 +159,132 @@ public:
         // being. Should be removed later and schema updated to use proper
         // types.
         statement.bindAt(2, Limit{limit});
-        auto const res = executor_.read(yield, statement);
-        auto const& results = res.value();
-        if (not results.hasRows()) {
-            LOG(log_.debug()) << "No rows returned";
-            return {};
+        return fetchIndexedTransactions(statement, limit, forward, yield);
+    }
+
+    TransactionsAndCursor
+    fetchAccountTransactionsByType(
+        ripple::AccountID const& account,
+        ripple::TxType const transactionType,
+        std::uint32_t const limit,
+        bool const forward,
+        std::optional<TransactionsCursor> const& cursor,
+        boost::asio::yield_context yield
+    ) const override
+    {
+        auto const rng = fetchLedgerRange();
+        if (!rng)
+            return {{}, {}};
+
+        Statement const statement = [this, forward, &account, transactionType]() {
+            if (forward)
+                return schema_->selectAccountTxByTypeForward.bind(account, transactionType);
+
+            return schema_->selectAccountTxByType.bind(account, transactionType);
+        }();
+
+        if (cursor) {
+            statement.bindAt(2, cursor->asTuple());
+        } else {
+            auto const placeHolder = forward ? 0u : std::numeric_limits<std::uint32_t>::max();
+            statement.bindAt(2, std::make_tuple(placeHolder, placeHolder));
         }
 
-        std::vector<ripple::uint256> hashes = {};
-        auto numRows = results.numRows();
-        LOG(log_.info()) << "num_rows = " << numRows;
+        statement.bindAt(3, Limit{limit});
+        return fetchIndexedTransactions(statement, limit, forward, yield);
+    }
 
-        for (auto [hash, data] : extract<ripple::uint256, std::tuple<uint32_t, uint32_t>>(results)) {
-            hashes.push_back(hash);
-            if (--numRows == 0) {
-                LOG(log_.debug()) << "Setting cursor";
-                cursor = data;
+    bool
+    doFinishWrites(std::uint32_t const ledgerSequence) override
+    {
+        // wait for the writes of this ledger and everything written before it. writes of later ledgers that are
+        // already being issued are not waited for
+        if (auto const group = takeWriteGroup(ledgerSequence); group.has_value()) {
+            executor_.sync(*group);
+        } else {
+            executor_.sync();
+        }
 
-                // forward queries by ledger/tx sequence `>=`
-                // so we have to advance the index by one
-                if (forward)
-                    ++cursor->transactionIndex;
-            }
+        std::call_once(indexCoverageRecorded_, [this, ledgerSequence]() {
+            // a database created by this version has the index tables filled from its first ledger on
+            auto const minSequence = range ? ledgerSequence : 0u;
+            for (auto const* table : {INDEX_ACCOUNT_TX_BY_TYPE, INDEX_NFT_STATE, INDEX_LEDGER_TRANSACTION_INDEXES})
+                executor_.writeSync(schema_->insertIndexCoverage, std::string{table}, minSequence);
+        });
+
+        if (!range) {
+            executor_.writeSync(schema_->updateLedgerRange, ledgerSequence, false, ledgerSequence);
         }
 
-        auto const txns = fetchTransactions(hashes, yield);
-        LOG(log_.debug()) << "Txns = " << txns.size();
+        if (not executeSyncUpdate(
+                schema_->updateLedgerRange.bind(ledgerSequence, true, ledgerSequence - 1), ledgerSequence
+            )) {
+            LOG(log_.warn()) << "Update failed for ledger " << ledgerSequence;
+            return false;
+        }
 
-        if (txns.size() == limit) {
-            LOG(log_.debug()) << "Returning cursor";
-            return {txns, cursor};
+        LOG(log_.info()) << "Committed ledger " << ledgerSequence;
+        return true;
+    }
+
+    std::optional<std::uint32_t>
+    fetchIndexCoverage(std::string const& table, boost::asio::yield_context yield) const override
+    {
+        {
+            std::scoped_lock const lck{indexCoverageMtx_};
+            if (auto const it = indexCoverage_.find(table); it != indexCoverage_.end())
+                return it->second;
         }
 
-        return {txns, {}};
+        auto const res = executor_.read(yield, schema_->selectIndexCoverage, table);
+        if (not res) {
+            LOG(log_.error()) << "Could not fetch coverage of " << table << ": " << res.error();
+            return std::nullopt;
+        }
+
+        if (auto const minSequence = res->template get<std::uint32_t>(); minSequence) {
+            // the coverage never changes once recorded
+            std::scoped_lock const lck{indexCoverageMtx_};
+            indexCoverage_[table] = *minSequence;
+            return minSequence;
+        }
+
+        return std::nullopt;
     }
 
     bool
-    doFinishWrites() override
+    doUpdateMinSequence(std::uint32_t const oldMin, std::uint32_t const newMin) override
     {
-        // wait for other threads to finish their writes
-        executor_.sync();
-
-        if (!range) {
-            executor_.writeSync(schema_->updateLedgerRange, ledgerSequence_, false, ledgerSequence_);
+        auto const res = executor_.writeSync(schema_->updateLedgerRange, newMin, false, oldMin);
+        auto const applied = res->template get<bool>();
+        if (not applied) {
+            LOG(log_.error()) << "doUpdateMinSequence - error getting result - no row";
+            return false;
         }
 
-        if (not executeSyncUpdate(schema_->updateLedgerRange.bind(ledgerSequence_, true, ledgerSequence_ - 1))) {
-            LOG(log_.warn()) << "Update failed for ledger " << ledgerSequence_;
+        if (not *applied) {
+            LOG(log_.warn()) << "Minimum ledger changed concurrently; could not move it from " << oldMin << " to "
+                             << newMin;
             return false;
         }
 
-        LOG(log_.info()) << "Committed ledger " << ledgerSequence_;
+        LOG(log_.info()) << "Moved minimum ledger from " << oldMin << " to " << newMin;
         return true;
     }
 
     void
     writeLedger(ripple::LedgerHeader const& ledgerInfo, std::string&& blob) override
     {
+        // ledgers of isolated writers or below the range are not committed one by one, so they don't start write groups
+        auto const rng = fetchLedgerRange();
+        if (not executor_.isThreadIsolated() and (not rng or ledgerInfo.seq > rng->maxSequence)) {
+            std::lock_guard const lck(writeGroupsMtx_);
+            writeGroups_[ledgerInfo.seq] = executor_.newWriteGroup();
+        }
+
         executor_.write(schema_->insertLedgerHeader, ledgerInfo.seq, std::move(blob));
 
         executor_.write(schema_->insertLedgerHash, ledgerInfo.hash, ledgerInfo.seq);
-
-        ledgerSequence_ = ledgerInfo.seq;
     }
 
     std::optional<std::uint32_t>
@@ -406,40 +496,7 @@ public:
         }
 
         statement.bindAt(2, Limit{limit});
-
-        auto const res = executor_.read(yield, statement);
-        auto const& results = res.value();
-        if (not results.hasRows()) {
-            LOG(log_.debug()) << "No rows returned";
-            return {};
-        }
-
-        std::vector<ripple::uint256> hashes = {};
-        auto numRows = results.numRows();
-        LOG(log_.info()) << "num_rows = " << numRows;
-
-        for (auto [hash, data] : extract<ripple::uint256, std::tuple<uint32_t, uint32_t>>(results)) {
-            hashes.push_back(hash);
-            if (--numRows == 0) {
-                LOG(log_.debug()) << "Setting cursor";
-                cursor = data;
-
-                // forward queries by ledger/tx sequence `>=`
-                // so we have to advance the index by one
-                if (forward)
-                    ++cursor->transactionIndex;
-            }
-        }
-
-        auto const txns = fetchTransactions(hashes, yield);
-        LOG(log_.debug()) << "NFT Txns = " << txns.size();
-
-        if (txns.size() == limit) {
-            LOG(log_.debug()) << "Returning cursor";
-            return {txns, cursor};
-        }
-
-        return {txns, {}};
+        return fetchIndexedTransactions(statement, limit, forward, yield);
     }
 
     NFTsAndCursor
@@ -452,18 +509,22 @@ public:
         boost::asio::yield_context yield
     ) const override
     {
+        // Until the state table covers all of the history it misses the NFTs that did not change since the upgrade
+        if (fetchIndexCoverage(INDEX_NFT_STATE, yield) != 0u)
+            return fetchNFTsByIssuerWithoutState(issuer, taxon, ledgerSequence, limit, cursorIn, yield);
+
         NFTsAndCursor ret;
 
-        Statement const idQueryStatement = [&taxon, &issuer, &cursorIn, &limit, this]() {
+        Statement const stateQueryStatement = [&taxon, &issuer, &cursorIn, &limit, this]() {
             if (taxon.has_value()) {
-                auto r = schema_->selectNFTIDsByIssuerTaxon.bind(issuer);
+                auto r = schema_->selectNFTStatesByIssuerTaxon.bind(issuer);
                 r.bindAt(1, *taxon);
                 r.bindAt(2, cursorIn.value_or(ripple::uint256(0)));
                 r.bindAt(3, Limit{limit});
                 return r;
             }
 
-            auto r = schema_->selectNFTIDsByIssuer.bind(issuer);
+            auto r = schema_->selectNFTStatesByIssuer.bind(issuer);
             r.bindAt(
                 1,
                 std::make_tuple(
@@ -475,58 +536,67 @@ public:
             return r;
         }();
 
-        // Query for all the NFTs issued by the account, potentially filtered by the taxon
-        auto const res = executor_.read(yield, idQueryStatement);
+        // Query the latest state of all the NFTs issued by the account, potentially filtered by the taxon
+        auto const res = executor_.read(yield, stateQueryStatement);
 
-        auto const& idQueryResults = res.value();
-        if (not idQueryResults.hasRows()) {
+        auto const& stateQueryResults = res.value();
+        if (not stateQueryResults.hasRows()) {
             LOG(log_.debug()) << "No rows returned";
             return {};
         }
 
-        std::vector<ripple::uint256> nftIDs;
-        for (auto const [nftID] : extract<ripple::uint256>(idQueryResults))
-            nftIDs.push_back(nftID);
-
-        if (nftIDs.empty())
-            return ret;
-
-        if (nftIDs.size() == limit)
-            ret.cursor = nftIDs.back();
-
+        // NFTs changed after the requested ledger need their state at that ledger looked up separately. Only the row of
+        // the mint has the URI, so NFTs changed since look it up too
+        std::vector<std::size_t> staleIndexes;
         std::vector<Statement> selectNFTStatements;
-        selectNFTStatements.reserve(nftIDs.size());
+        std::vector<Statement> selectNFTURIStatements;
+        std::vector<std::size_t> uriIndexes;
+        std::vector<Statement> selectURIStatements;
+
+        for (auto [nftID, seq, owner, isBurned, uri] :
+             extract<ripple::uint256, uint32_t, ripple::AccountID, bool, std::optional<Blob>>(stateQueryResults)) {
+            if (seq > ledgerSequence) {
+                staleIndexes.push_back(ret.nfts.size());
+                selectNFTStatements.push_back(schema_->selectNFT.bind(nftID, ledgerSequence));
+                selectNFTURIStatements.push_back(schema_->selectNFTURI.bind(nftID, ledgerSequence));
+            } else if (not uri) {
+                uriIndexes.push_back(ret.nfts.size());
+                selectURIStatements.push_back(schema_->selectNFTURI.bind(nftID, ledgerSequence));
+            }
 
-        std::transform(
-            std::cbegin(nftIDs),
-            std::cend(nftIDs),
-            std::back_inserter(selectNFTStatements),
-            [&](auto const& nftID) { return schema_->selectNFT.bind(nftID, ledgerSequence); }
-        );
+            ret.nfts.emplace_back(nftID, seq, owner, std::move(uri).value_or(Blob{}), isBurned);
+        }
 
-        auto const nftInfos = executor_.readEach(yield, selectNFTStatements);
+        if (ret.nfts.size() == limit)
+            ret.cursor = ret.nfts.back().tokenID;
 
-        std::vector<Statement> selectNFTURIStatements;
-        selectNFTURIStatements.reserve(nftIDs.size());
+        if (not uriIndexes.empty()) {
+            auto const uris = executor_.readEach(yield, selectURIStatements);
+            for (std::size_t i = 0; i < uriIndexes.size(); ++i) {
+                if (auto const maybeUri = uris[i].template get<ripple::Blob>(); maybeUri)
+                    ret.nfts[uriIndexes[i]].uri = *maybeUri;
+            }
+        }
 
-        std::transform(
-            std::cbegin(nftIDs),
-            std::cend(nftIDs),
-            std::back_inserter(selectNFTURIStatements),
-            [&](auto const& nftID) { return schema_->selectNFTURI.bind(nftID, ledgerSequence); }
-        );
+        if (staleIndexes.empty())
+            return ret;
 
+        auto const nftInfos = executor_.readEach(yield, selectNFTStatements);
         auto const nftUris = executor_.readEach(yield, selectNFTURIStatements);
 
-        for (auto i = 0u; i < nftIDs.size(); i++) {
+        // walk backwards so that erasing NFTs which did not exist yet keeps the remaining indexes valid
+        for (auto i = staleIndexes.size(); i-- > 0;) {
+            auto& nft = ret.nfts[staleIndexes[i]];
             if (auto const maybeRow = nftInfos[i].template get<uint32_t, ripple::AccountID, bool>(); maybeRow) {
-                auto [seq, owner, isBurned] = *maybeRow;
-                NFT nft(nftIDs[i], seq, owner, isBurned);
+                auto const& [seq, owner, isBurned] = *maybeRow;
+                nft = NFT(nft.tokenID, seq, owner, isBurned);
                 if (auto const maybeUri = nftUris[i].template get<ripple::Blob>(); maybeUri)
                     nft.uri = *maybeUri;
-                ret.nfts.push_back(nft);
+            } else {
+                ret.nfts.erase(ret.nfts.begin() + static_cast<std::ptrdiff_t>(staleIndexes[i]));
             }
         }
+
         return ret;
     }
 
@@ -553,9 +623,9 @@ public:
     fetchTransaction(ripple::uint256 const& hash, boost::asio::yield_context yield) const override
     {
         if (auto const res = executor_.read(yield, schema_->selectTransaction, hash); res) {
-            if (auto const maybeValue = res->template get<Blob, Blob, uint32_t, uint32_t>(); maybeValue) {
-                auto [transaction, meta, seq, date] = *maybeValue;
-                return std::make_optional<TransactionAndMetadata>(transaction, meta, seq, date);
+            if (auto maybeValue = res->template get<Blob, Blob, uint32_t, uint32_t>(); maybeValue) {
+                auto& [transaction, meta, seq, date] = *maybeValue;
+                return decodeTransaction(std::move(transaction), std::move(meta), seq, date);
             }
 
             LOG(log_.debug()) << "Could not fetch transaction - no rows";
@@ -566,6 +636,26 @@ public:
         return std::nullopt;
     }
 
+    std::optional<TransactionAndMetadata>
+    fetchTransactionByIndex(
+        std::uint32_t const ledgerSequence,
+        std::uint32_t const transactionIndex,
+        boost::asio::yield_context yield
+    ) const override
+    {
+        auto const res = executor_.read(yield, schema_->selectTransactionHashByIndex, ledgerSequence, transactionIndex);
+        if (not res) {
+            LOG(log_.error()) << "Could not fetch transaction hash by index: " << res.error();
+            return std::nullopt;
+        }
+
+        if (auto const maybeHash = res->template get<ripple::uint256>(); maybeHash)
+            return fetchTransaction(*maybeHash, yield);
+
+        LOG(log_.debug()) << "Could not fetch transaction hash by index - no rows";
+        return std::nullopt;
+    }
+
     std::optional<ripple::uint256>
     doFetchSuccessorKey(ripple::uint256 key, std::uint32_t const ledgerSequence, boost::asio::yield_context yield)
         const override
@@ -612,9 +702,11 @@ public:
                 std::cbegin(entries),
                 std::cend(entries),
                 std::back_inserter(results),
-                [](auto const& res) -> TransactionAndMetadata {
-                    if (auto const maybeRow = res.template get<Blob, Blob, uint32_t, uint32_t>(); maybeRow)
-                        return *maybeRow;
+                [this](auto const& res) -> TransactionAndMetadata {
+                    if (auto maybeRow = res.template get<Blob, Blob, uint32_t, uint32_t>(); maybeRow) {
+                        auto& [transaction, meta, seq, date] = *maybeRow;
+                        return decodeTransaction(std::move(transaction), std::move(meta), seq, date);
+                    }
 
                     return {};
                 }
@@ -674,47 +766,35 @@ public:
     std::vector<LedgerObject>
     fetchLedgerDiff(std::uint32_t const ledgerSequence, boost::asio::yield_context yield) const override
     {
-        auto const [keys, timeDiff] = util::timed([this, &ledgerSequence, yield]() -> std::vector<ripple::uint256> {
-            auto const res = executor_.read(yield, schema_->selectDiff, ledgerSequence);
-            if (not res) {
-                LOG(log_.error()) << "Could not fetch ledger diff: " << res.error() << "; ledger = " << ledgerSequence;
-                return {};
-            }
-
-            auto const& results = res.value();
-            if (not results) {
-                LOG(log_.error()) << "Could not fetch ledger diff - no rows; ledger = " << ledgerSequence;
-                return {};
-            }
-
-            std::vector<ripple::uint256> resultKeys;
-            for (auto [key] : extract<ripple::uint256>(results))
-                resultKeys.push_back(key);
-
-            return resultKeys;
+        std::vector<LedgerObject> results;
+        auto const statement = schema_->selectDiff.bind(ledgerSequence);
+
+        // objects of each page of diff keys are fetched while the next page of keys is being read
+        auto const timeDiff = util::timed([this, &results, &statement, ledgerSequence, yield]() {
+            executor_.readPaged(yield, statement, [this, &results, ledgerSequence, yield](auto const& page) {
+                std::vector<ripple::uint256> keys;
+                keys.reserve(page.numRows());
+                for (auto [key] : extract<ripple::uint256>(page))
+                    keys.push_back(key);
+
+                auto const objs = fetchLedgerObjects(keys, ledgerSequence, yield);
+                std::transform(
+                    std::cbegin(keys),
+                    std::cend(keys),
+                    std::cbegin(objs),
+                    std::back_inserter(results),
+                    [](auto const& key, auto const& obj) {
+                        return LedgerObject{key, obj};
+                    }
+                );
+            });
         });
 
-        // one of the above errors must have happened
-        if (keys.empty())
-            return {};
+        if (results.empty())
+            LOG(log_.error()) << "Could not fetch ledger diff - no rows; ledger = " << ledgerSequence;
 
-        LOG(log_.debug()) << "Fetched " << keys.size() << " diff hashes from Cassandra in " << timeDiff
+        LOG(log_.debug()) << "Fetched " << results.size() << " diff objects from Cassandra in " << timeDiff
                           << " milliseconds";
-
-        auto const objs = fetchLedgerObjects(keys, ledgerSequence, yield);
-        std::vector<LedgerObject> results;
-        results.reserve(keys.size());
-
-        std::transform(
-            std::cbegin(keys),
-            std::cend(keys),
-            std::cbegin(objs),
-            std::back_inserter(results),
-            [](auto const& key, auto const& obj) {
-                return LedgerObject{key, obj};
-            }
-        );
-
         return results;
     }
 
@@ -729,6 +809,16 @@ public:
         executor_.write(schema_->insertObject, std::move(key), seq, std::move(blob));
     }
 
+    void
+    writeSnapshotObject(std::string&& key, std::uint32_t const seq, std::string&& blob) override
+    {
+        LOG(log_.trace()) << " Writing snapshot object " << key.size() << ":" << seq << " [" << blob.size()
+                          << " bytes]";
+        ASSERT(key.size() == sizeof(ripple::uint256), "Key must be 256 bits");
+
+        executor_.write(schema_->insertObject, std::move(key), seq, std::move(blob));
+    }
+
     void
     writeSuccessor(std::string&& key, std::uint32_t const seq, std::string&& successor) override
     {
@@ -740,6 +830,25 @@ public:
         executor_.write(schema_->insertSuccessor, std::move(key), seq, std::move(successor));
     }
 
+    void
+    writeSuccessors(std::vector<std::pair<ripple::uint256, ripple::uint256>> const& successors, std::uint32_t const seq)
+        override
+    {
+        std::vector<Statement> statements;
+        statements.reserve(successors.size());
+
+        std::transform(
+            std::cbegin(successors),
+            std::cend(successors),
+            std::back_inserter(statements),
+            [this, seq](auto const& successor) {
+                return schema_->insertSuccessor.bind(successor.first, seq, successor.second);
+            }
+        );
+
+        executor_.write(std::move(statements));
+    }
+
     void
     writeAccountTransactions(std::vector<AccountTransactionsData> data) override
     {
@@ -759,6 +868,23 @@ public:
                     );
                 }
             );
+
+            if (record.transactionType == ripple::ttINVALID)
+                continue;
+
+            std::transform(
+                std::begin(record.accounts),
+                std::end(record.accounts),
+                std::back_inserter(statements),
+                [this, &record](auto const& account) {
+                    return schema_->insertAccountTxByType.bind(
+                        account,
+                        record.transactionType,
+                        std::make_tuple(record.ledgerSequence, record.transactionIndex),
+                        record.txHash
+                    );
+                }
+            );
         }
 
         executor_.write(std::move(statements));
@@ -796,12 +922,20 @@ public:
         );
     }
 
+    void
+    writeTransactionIndex(std::uint32_t const seq, std::uint32_t const transactionIndex, ripple::uint256 const& hash)
+        override
+    {
+        executor_.write(schema_->insertLedgerTransactionIndex, seq, transactionIndex, hash);
+    }
+
     void
     writeNFTs(std::vector<NFTsData> const& data) override
     {
         std::vector<Statement> statements;
-        statements.reserve(data.size() * 3);
+        statements.reserve(data.size() * 4);
 
+        auto const writesNFTState = not data.empty() and isNFTStateWritten();
         for (NFTsData const& record : data) {
             statements.push_back(
                 schema_->insertNFT.bind(record.tokenID, record.ledgerSequence, record.owner, record.isBurned)
@@ -822,9 +956,244 @@ public:
                     schema_->insertNFTURI.bind(record.tokenID, record.ledgerSequence, record.uri.value())
                 );
             }
+
+            if (not writesNFTState)
+                continue;
+
+            auto const issuer = ripple::nft::getIssuer(record.tokenID);
+            auto const taxon = static_cast<uint32_t>(ripple::nft::getTaxon(record.tokenID));
+
+            if (record.uri) {
+                statements.push_back(schema_->insertNFTState.bind(
+                    issuer, taxon, record.tokenID, record.ledgerSequence, record.owner, record.isBurned, *record.uri
+                ));
+            } else {
+                statements.push_back(schema_->updateNFTState.bind(
+                    issuer, taxon, record.tokenID, record.ledgerSequence, record.owner, record.isBurned
+                ));
+            }
+        }
+
+        executor_.write(std::move(statements));
+    }
+
+    void
+    isolateThreadWrites() override
+    {
+        executor_.isolateThread();
+    }
+
+    void
+    syncThreadWrites() override
+    {
+        executor_.syncThread();
+    }
+
+    void
+    writeBackfilledChunk(LedgerRange const& chunk) override
+    {
+        // the chunk is only recorded once all of its writes made it; writes of other threads are not waited for
+        executor_.syncThread();
+        executor_.writeSync(schema_->insertBackfilledChunk, chunk.minSequence, chunk.maxSequence);
+    }
+
+    std::vector<LedgerRange>
+    fetchBackfilledChunks(boost::asio::yield_context yield) const override
+    {
+        std::vector<LedgerRange> chunks;
+        auto const statement = schema_->selectBackfilledChunks.bind();
+
+        executor_.readPaged(yield, statement, [&chunks](auto const& page) {
+            for (auto [first, last] : extract<std::uint32_t, std::uint32_t>(page))
+                chunks.push_back({first, last});
+        });
+
+        return chunks;
+    }
+
+    void
+    writeInitialLoadProgress(InitialLoadProgress const& progress) override
+    {
+        // a cursor is only recorded once all of the objects up to its last key made it
+        executor_.sync();
+
+        std::vector<Statement> statements;
+        statements.reserve(progress.cursors.size());
+
+        for (auto const& cursor : progress.cursors) {
+            if (cursor.firstKey and cursor.lastKey) {
+                statements.push_back(schema_->insertInitialLoadCursor.bind(
+                    cursor.marker, progress.sequence, *cursor.firstKey, *cursor.lastKey, cursor.isDone
+                ));
+            } else {
+                statements.push_back(
+                    schema_->insertInitialLoadMarker.bind(cursor.marker, progress.sequence, cursor.isDone)
+                );
+            }
         }
 
         executor_.write(std::move(statements));
+        executor_.sync();
+    }
+
+    std::optional<InitialLoadProgress>
+    fetchInitialLoadProgress(boost::asio::yield_context yield) const override
+    {
+        std::optional<InitialLoadProgress> progress;
+        auto const statement = schema_->selectInitialLoadProgress.bind();
+
+        executor_.readPaged(yield, statement, [&progress](auto const& page) {
+            for (auto [marker, sequence, firstKey, lastKey, isDone] : extract<
+                     ripple::uint256,
+                     std::uint32_t,
+                     std::optional<ripple::uint256>,
+                     std::optional<ripple::uint256>,
+                     bool>(page)) {
+                if (not progress)
+                    progress.emplace().sequence = sequence;
+
+                progress->cursors.push_back({marker, firstKey, lastKey, isDone});
+            }
+        });
+
+        if (progress) {
+            std::ranges::sort(progress->cursors, {}, &InitialLoadCursor::marker);
+            LOG(log_.debug()) << "Fetched initial load progress of " << progress->cursors.size()
+                              << " markers for ledger " << progress->sequence;
+        }
+
+        return progress;
+    }
+
+    void
+    clearInitialLoadProgress() override
+    {
+        executor_.writeSync(schema_->deleteInitialLoadProgress);
+    }
+
+    std::optional<WriterLease>
+    fetchWriterLease(boost::asio::yield_context yield) const override
+    {
+        auto const res = executor_.read(yield, schema_->selectWriterLease);
+        if (not res) {
+            LOG(log_.error()) << "Could not fetch writer lease: " << res.error();
+            return std::nullopt;
+        }
+
+        if (auto const maybeRow = res->template get<Blob, std::uint64_t, std::uint64_t>(); maybeRow) {
+            auto const& [writer, term, heartbeat] = *maybeRow;
+            return WriterLease{.writer = {writer.begin(), writer.end()}, .term = term, .heartbeat = heartbeat};
+        }
+
+        return std::nullopt;
+    }
+
+    bool
+    updateWriterLease(std::optional<WriterLease> const& expected, WriterLease const& lease) override
+    {
+        // a lightweight transaction, so only one of the processes racing for the lease gets it
+        auto const res = expected.has_value()
+            ? executor_.writeSync(
+                  schema_->updateWriterLease,
+                  lease.writer,
+                  lease.term,
+                  lease.heartbeat,
+                  expected->writer,
+                  expected->term,
+                  expected->heartbeat
+              )
+            : executor_.writeSync(schema_->insertWriterLease, lease.writer, lease.term, lease.heartbeat);
+
+        auto const applied = res->template get<bool>();
+        if (not applied) {
+            LOG(log_.error()) << "updateWriterLease - error getting result - no row";
+            return false;
+        }
+
+        if (not *applied) {
+            // writeSync retries timeouts, so a rejection may be of a retry of an update that was applied already
+            auto const current = synchronousAndRetryOnTimeout([this](auto yield) { return fetchWriterLease(yield); });
+            return current == lease;
+        }
+
+        return true;
+    }
+
+    void
+    deleteHistory(
+        PrunedHistory const& history,
+        std::size_t const chunkSize,
+        std::function<void()> const& waitForCapacity
+    ) override
+    {
+        auto const minSeqIdx = std::make_tuple(history.minSequence, 0u);
+
+        std::size_t numInChunk = 0;
+        auto const remove = [&](auto const& statement, auto const&... args) {
+            if (numInChunk == chunkSize) {
+                executor_.syncThread();
+                waitForCapacity();
+                numInChunk = 0;
+            }
+
+            executor_.write(statement, args...);
+            ++numInChunk;
+        };
+
+        // rows that others were found through are only deleted once those are gone
+        auto const finishStep = [&]() {
+            executor_.syncThread();
+            numInChunk = 0;
+        };
+
+        for (auto const& [key, bound] : history.objects)
+            remove(schema_->deleteObjectsBefore, key, bound);
+
+        for (auto const& [key, bound] : history.successors)
+            remove(schema_->deleteSuccessorsBefore, key, bound);
+
+        for (auto const& [tokenID, bound] : history.nfts)
+            remove(schema_->deleteNFTsBefore, tokenID, bound);
+
+        if (not history.nfts.empty() and isNFTStateWritten()) {
+            for (auto const& [tokenID, bound] : history.nfts) {
+                auto const taxon = static_cast<std::uint32_t>(ripple::nft::getTaxon(tokenID));
+                remove(schema_->deleteNFTStatesBefore, ripple::nft::getIssuer(tokenID), taxon, tokenID, bound);
+            }
+        }
+
+        for (auto const& account : history.accounts)
+            remove(schema_->deleteAccountTxBefore, account, minSeqIdx);
+
+        for (auto const& [account, transactionType] : history.accountTxTypes)
+            remove(schema_->deleteAccountTxByTypeBefore, account, transactionType, minSeqIdx);
+
+        for (auto const& tokenID : history.nftTokenIDs)
+            remove(schema_->deleteNFTTxBefore, tokenID, minSeqIdx);
+
+        finishStep();
+
+        for (auto const& [seq, hashes] : history.transactions) {
+            for (auto const& hash : hashes)
+                remove(schema_->deleteTransaction, hash);
+        }
+
+        for (auto const& hash : history.ledgerHashes)
+            remove(schema_->deleteLedgerHash, hash);
+
+        finishStep();
+
+        for (auto const& [seq, hashes] : history.transactions) {
+            remove(schema_->deleteLedgerTransactions, seq);
+            remove(schema_->deleteLedgerTransactionIndexes, seq);
+        }
+
+        for (auto const seq : history.ledgerSequences) {
+            remove(schema_->deleteDiff, seq);
+            remove(schema_->deleteLedgerHeader, seq);
+        }
+
+        finishStep();
     }
 
     void
@@ -840,15 +1209,221 @@ public:
         return executor_.isTooBusy();
     }
 
+    double
+    writeLoad() const override
+    {
+        return executor_.writeLoad();
+    }
+
     boost::json::object
     stats() const override
     {
-        return executor_.stats();
+        auto result = executor_.stats();
+        result["blob_codec"] = codec().report();
+        return result;
     }
 
 private:
+    /**
+     * @brief Fetch the transactions listed by a bound account_tx or nf_token_transactions query.
+     *
+     * Transactions of each page of hashes are fetched while the next page of hashes is being read.
+     *
+     * @param statement The bound query returning hash and (ledger sequence, transaction index) pairs
+     * @param limit The limit bound to the query
+     * @param forward Whether the query is in ascending order
+     * @param yield The coroutine context
+     * @return The transactions and the cursor to continue from if the limit was reached
+     */
+    TransactionsAndCursor
+    fetchIndexedTransactions(
+        Statement const& statement,
+        std::uint32_t const limit,
+        bool const forward,
+        boost::asio::yield_context yield
+    ) const
+    {
+        std::vector<TransactionAndMetadata> txns;
+        std::optional<TransactionsCursor> cursor;
+
+        executor_.readPaged(yield, statement, [this, &txns, &cursor, yield](auto const& page) {
+            std::vector<ripple::uint256> hashes;
+            hashes.reserve(page.numRows());
+            for (auto [hash, data] : extract<ripple::uint256, std::tuple<uint32_t, uint32_t>>(page)) {
+                hashes.push_back(hash);
+                cursor = data;
+            }
+
+            auto pageTxns = fetchTransactions(hashes, yield);
+            txns.insert(txns.end(), std::make_move_iterator(pageTxns.begin()), std::make_move_iterator(pageTxns.end()));
+        });
+
+        if (txns.empty()) {
+            LOG(log_.debug()) << "No rows returned";
+            return {};
+        }
+
+        LOG(log_.debug()) << "Txns = " << txns.size();
+
+        // forward queries by ledger/tx sequence `>=`
+        // so we have to advance the index by one
+        if (forward)
+            ++cursor->transactionIndex;
+
+        if (txns.size() == limit) {
+            LOG(log_.debug()) << "Returning cursor";
+            return {std::move(txns), cursor};
+        }
+
+        return {std::move(txns), {}};
+    }
+
+    /**
+     * @brief Whether issuer_nf_token_state is written.
+     *
+     * The table is only read once it covers the whole history, and nothing fills in the ledgers written before it
+     * existed. So it is not written to a database upgraded from a version without it, whose coverage starts at the
+     * first ledger written after the upgrade. Enabling it there takes a migration that fills the table in.
+     */
+    bool
+    isNFTStateWritten() const
+    {
+        auto const coverage = synchronousAndRetryOnTimeout([this](auto yield) {
+            return fetchIndexCoverage(INDEX_NFT_STATE, yield);
+        });
+        return coverage.value_or(0u) == 0u;
+    }
+
+    /**
+     * @brief Fetch a page of the NFTs of an issuer by looking up each token listed in issuer_nf_tokens_v2.
+     *
+     * Used while issuer_nf_token_state does not cover the whole history.
+     */
+    NFTsAndCursor
+    fetchNFTsByIssuerWithoutState(
+        ripple::AccountID const& issuer,
+        std::optional<std::uint32_t> const& taxon,
+        std::uint32_t const ledgerSequence,
+        std::uint32_t const limit,
+        std::optional<ripple::uint256> const& cursorIn,
+        boost::asio::yield_context yield
+    ) const
+    {
+        NFTsAndCursor ret;
+
+        Statement const idQueryStatement = [&taxon, &issuer, &cursorIn, &limit, this]() {
+            if (taxon.has_value()) {
+                auto r = schema_->selectNFTIDsByIssuerTaxon.bind(issuer);
+                r.bindAt(1, *taxon);
+                r.bindAt(2, cursorIn.value_or(ripple::uint256(0)));
+                r.bindAt(3, Limit{limit});
+                return r;
+            }
+
+            auto r = schema_->selectNFTIDsByIssuer.bind(issuer);
+            r.bindAt(
+                1,
+                std::make_tuple(
+                    cursorIn.has_value() ? ripple::nft::toUInt32(ripple::nft::getTaxon(*cursorIn)) : 0,
+                    cursorIn.value_or(ripple::uint256(0))
+                )
+            );
+            r.bindAt(2, Limit{limit});
+            return r;
+        }();
+
+        // Query for all the NFTs issued by the account, potentially filtered by the taxon
+        auto const res = executor_.read(yield, idQueryStatement);
+
+        auto const& idQueryResults = res.value();
+        if (not idQueryResults.hasRows()) {
+            LOG(log_.debug()) << "No rows returned";
+            return {};
+        }
+
+        std::vector<ripple::uint256> nftIDs;
+        for (auto const [nftID] : extract<ripple::uint256>(idQueryResults))
+            nftIDs.push_back(nftID);
+
+        if (nftIDs.empty())
+            return ret;
+
+        if (nftIDs.size() == limit)
+            ret.cursor = nftIDs.back();
+
+        std::vector<Statement> selectNFTStatements;
+        selectNFTStatements.reserve(nftIDs.size());
+
+        std::transform(
+            std::cbegin(nftIDs),
+            std::cend(nftIDs),
+            std::back_inserter(selectNFTStatements),
+            [&](auto const& nftID) { return schema_->selectNFT.bind(nftID, ledgerSequence); }
+        );
+
+        auto const nftInfos = executor_.readEach(yield, selectNFTStatements);
+
+        std::vector<Statement> selectNFTURIStatements;
+        selectNFTURIStatements.reserve(nftIDs.size());
+
+        std::transform(
+            std::cbegin(nftIDs),
+            std::cend(nftIDs),
+            std::back_inserter(selectNFTURIStatements),
+            [&](auto const& nftID) { return schema_->selectNFTURI.bind(nftID, ledgerSequence); }
+        );
+
+        auto const nftUris = executor_.readEach(yield, selectNFTURIStatements);
+
+        for (auto i = 0u; i < nftIDs.size(); i++) {
+            if (auto const maybeRow = nftInfos[i].template get<uint32_t, ripple::AccountID, bool>(); maybeRow) {
+                auto [seq, owner, isBurned] = *maybeRow;
+                NFT nft(nftIDs[i], seq, owner, isBurned);
+                if (auto const maybeUri = nftUris[i].template get<ripple::Blob>(); maybeUri)
+                    nft.uri = *maybeUri;
+                ret.nfts.push_back(nft);
+            }
+        }
+        return ret;
+    }
+
+    /**
+     * @brief Decode a transaction as stored.
+     *
+     * A blob that can not be decoded is corrupt or was written with a dictionary that is not configured. That is never
+     * served as if the transaction was missing or empty.
+     *
+     * @throws std::runtime_error if the transaction or its metadata can not be decoded
+     */
+    TransactionAndMetadata
+    decodeTransaction(Blob&& transaction, Blob&& metadata, std::uint32_t const seq, std::uint32_t const date) const
+    {
+        auto decodedTransaction = codec().decode(std::move(transaction));
+        auto decodedMetadata = codec().decode(std::move(metadata));
+        if (not decodedTransaction or not decodedMetadata) {
+            auto const& error = decodedTransaction ? decodedMetadata.error() : decodedTransaction.error();
+            LOG(log_.error()) << "Could not decode transaction of ledger " << seq << ": " << error;
+            throw std::runtime_error("Could not decode transaction of ledger " + std::to_string(seq) + ": " + error);
+        }
+
+        return {std::move(*decodedTransaction), std::move(*decodedMetadata), seq, date};
+    }
+
+    std::optional<std::uint64_t>
+    takeWriteGroup(std::uint32_t const ledgerSequence)
+    {
+        std::lock_guard const lck(writeGroupsMtx_);
+        auto const it = writeGroups_.find(ledgerSequence);
+        if (it == writeGroups_.end())
+            return std::nullopt;
+
+        auto const group = it->second;
+        writeGroups_.erase(writeGroups_.begin(), std::next(it));
+        return group;
+    }
+
     bool
-    executeSyncUpdate(Statement statement)
+    executeSyncUpdate(Statement statement, std::uint32_t const ledgerSequence)
     {
         auto const res = executor_.writeSync(statement);
         auto maybeSuccess = res->template get<bool>();
@@ -865,7 +1440,7 @@ private:
             // against what we were trying to write in the first place and
             // use that as the source of truth for the result.
             auto rng = hardFetchLedgerRangeNoThrow();
-            return rng && rng->maxSequence == ledgerSequence_;
+            return rng && rng->maxSequence == ledgerSequence;
         }
 
         return true;
@@ -28,8 +28,13 @@
 #include <ripple/basics/StringUtilities.h>
 #include <ripple/protocol/SField.h>
 #include <ripple/protocol/STAccount.h>
+#include <ripple/protocol/TxFormats.h>
 #include <ripple/protocol/TxMeta.h>
 
+#include <cstdint>
+#include <utility>
+#include <vector>
+
 /**
  * @brief Struct used to keep track of what to write to account_transactions/account_tx tables.
  */
@@ -38,12 +43,14 @@ struct AccountTransactionsData {
     std::uint32_t ledgerSequence{};
     std::uint32_t transactionIndex{};
     ripple::uint256 txHash;
+    ripple::TxType transactionType = ripple::ttINVALID;  // not indexed by type if invalid
 
-    AccountTransactionsData(ripple::TxMeta& meta, ripple::uint256 const& txHash)
+    AccountTransactionsData(ripple::TxMeta& meta, ripple::uint256 const& txHash, ripple::TxType transactionType)
         : accounts(meta.getAffectedAccounts())
         , ledgerSequence(meta.getLgrSeq())
         , transactionIndex(meta.getIndex())
         , txHash(txHash)
+        , transactionType(transactionType)
     {
     }
 
@@ -138,6 +145,25 @@ struct NFTsData {
     }
 };
 
+/**
+ * @brief Rows to delete when the minimum retained ledger is advanced.
+ *
+ * Versioned rows are described by a key and an exclusive upper bound; every version of the key below the bound is
+ * deleted. Bounds never exceed minSequence, so state at minSequence and above stays readable.
+ */
+struct PrunedHistory {
+    std::uint32_t minSequence = 0;
+    std::vector<std::uint32_t> ledgerSequences;
+    std::vector<ripple::uint256> ledgerHashes;
+    std::vector<std::pair<std::uint32_t, std::vector<ripple::uint256>>> transactions;  // hashes per ledger
+    std::vector<std::pair<ripple::uint256, std::uint32_t>> objects;
+    std::vector<std::pair<ripple::uint256, std::uint32_t>> successors;
+    std::vector<std::pair<ripple::uint256, std::uint32_t>> nfts;
+    std::vector<ripple::AccountID> accounts;   // account_tx rows below minSequence
+    std::vector<std::pair<ripple::AccountID, ripple::TxType>> accountTxTypes;  // account_tx_by_type rows, likewise
+    std::vector<ripple::uint256> nftTokenIDs;  // nf_token_transactions rows below minSequence
+};
+
 /**
  * @brief Check whether the supplied object is an offer.
  *
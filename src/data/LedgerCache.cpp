@@ -24,11 +24,14 @@
 
 #include <ripple/basics/base_uint.h>
 
+#include <algorithm>
 #include <cstddef>
 #include <cstdint>
+#include <iterator>
 #include <mutex>
 #include <optional>
 #include <shared_mutex>
+#include <utility>
 #include <vector>
 
 namespace data {
@@ -106,6 +109,46 @@ LedgerCache::getPredecessor(ripple::uint256 const& key, uint32_t seq) const
     return {{e->first, e->second.blob}};
 }
 
+std::vector<std::pair<ripple::uint256, ripple::uint256>>
+LedgerCache::getSuccessorUpdates(std::vector<ripple::uint256> const& keys, uint32_t seq) const
+{
+    ASSERT(std::is_sorted(keys.cbegin(), keys.cend()), "Keys must be sorted");
+
+    std::vector<std::pair<ripple::uint256, ripple::uint256>> edges;
+    if (!full_)
+        return edges;
+
+    std::shared_lock const lck{mtx_};
+    if (seq != latestSeq_)
+        return edges;
+
+    // keys are sorted, so edge sources never decrease and duplicates are always adjacent
+    auto const addEdge = [&edges](ripple::uint256 const& key, ripple::uint256 const& successor) {
+        if (edges.empty() || edges.back().first != key)
+            edges.emplace_back(key, successor);
+    };
+
+    edges.reserve(keys.size() * 2);
+    for (auto const& key : keys) {
+        auto it = map_.lower_bound(key);
+        auto const predecessor = it == map_.begin() ? firstKey : std::prev(it)->first;
+        auto const isCreated = it != map_.end() && it->first == key;
+
+        if (isCreated)
+            ++it;
+
+        auto const successor = it == map_.end() ? lastKey : it->first;
+        if (isCreated) {
+            addEdge(predecessor, key);
+            addEdge(key, successor);
+        } else {
+            addEdge(predecessor, successor);
+        }
+    }
+
+    return edges;
+}
+
 std::optional<Blob>
 LedgerCache::get(ripple::uint256 const& key, uint32_t seq) const
 {
@@ -119,6 +119,22 @@ public:
     std::optional<LedgerObject>
     getPredecessor(ripple::uint256 const& key, uint32_t seq) const;
 
+    /**
+     * @brief Computes all successor edges affected by objects created or deleted in the latest ledger.
+     *
+     * The cache must already be updated with the ledger. Every created key gets an edge from its predecessor and one to
+     * its successor; every deleted key gets an edge from its predecessor to its successor. Keys without a predecessor or
+     * successor are linked to firstKey or lastKey respectively. All edges are computed under a single lock.
+     *
+     * Note: This function always returns an empty vector when @ref isFull() returns false.
+     *
+     * @param keys The keys created or deleted in the ledger, sorted in ascending order
+     * @param seq The sequence to compute for
+     * @return Pairs of key and its new successor, sorted by key and free of duplicates
+     */
+    std::vector<std::pair<ripple::uint256, ripple::uint256>>
+    getSuccessorUpdates(std::vector<ripple::uint256> const& keys, uint32_t seq) const;
+
     /**
      * @brief Disables the cache.
      */
@@ -22,7 +22,9 @@
 #include <ripple/basics/base_uint.h>
 #include <ripple/protocol/AccountID.h>
 
+#include <cstdint>
 #include <optional>
+#include <string>
 #include <utility>
 #include <vector>
 
@@ -174,6 +176,51 @@ struct LedgerRange {
     std::uint32_t maxSequence = 0;
 };
 
+/**
+ * @brief How far the download of one marker range of the initial ledger got.
+ *
+ * The range starts at the marker and ends at the marker of the next cursor. The first and last keys are only set once
+ * something was written.
+ */
+struct InitialLoadCursor {
+    ripple::uint256 marker;
+    std::optional<ripple::uint256> firstKey;
+    std::optional<ripple::uint256> lastKey;
+    bool isDone = false;
+};
+
+/**
+ * @brief A checkpoint of the initial ledger load, used to resume it after a restart or on another source.
+ */
+struct InitialLoadProgress {
+    std::uint32_t sequence = 0;
+    std::vector<InitialLoadCursor> cursors;
+};
+
+/**
+ * @brief The lease of the ETL writer.
+ *
+ * The writer renews the lease by bumping the heartbeat; another process takes it over by starting a new term. A lease
+ * without a writer was released and is free to take.
+ */
+struct WriterLease {
+    std::string writer;
+    std::uint64_t term = 0;
+    std::uint64_t heartbeat = 0;
+
+    bool
+    operator==(WriterLease const&) const = default;
+};
+
+/** @brief Index table serving account_tx requests filtered by transaction type. */
+constexpr auto INDEX_ACCOUNT_TX_BY_TYPE = "account_tx_by_type";
+
+/** @brief Index table serving nfts_by_issuer requests. */
+constexpr auto INDEX_NFT_STATE = "issuer_nf_token_state";
+
+/** @brief Index table serving tx requests by CTID. */
+constexpr auto INDEX_LEDGER_TRANSACTION_INDEXES = "ledger_transaction_indexes";
+
 constexpr ripple::uint256 firstKey{"0000000000000000000000000000000000000000000000000000000000000000"};
 constexpr ripple::uint256 lastKey{"FFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFF"};
 constexpr ripple::uint256 hi192{"0000000000000000000000000000000000000000000000001111111111111111"};
@@ -26,6 +26,7 @@
 
 #include <chrono>
 #include <concepts>
+#include <cstdint>
 #include <optional>
 #include <string>
 
@@ -39,6 +40,9 @@ concept SomeSettingsProvider = requires(T a) {
     {
         a.getSettings()
     } -> std::same_as<Settings>;
+    {
+        a.getReadSettings()
+    } -> std::same_as<std::optional<Settings>>;
     {
         a.getKeyspace()
     } -> std::same_as<std::string>;
@@ -69,12 +73,33 @@ concept SomeExecutionStrategy = requires(
     {
         T(settings, handle)
     };
+    {
+        T(settings, handle, handle)
+    };
     {
         a.sync()
     } -> std::same_as<void>;
+    {
+        a.sync(std::uint64_t{})
+    } -> std::same_as<void>;
+    {
+        a.newWriteGroup()
+    } -> std::same_as<std::uint64_t>;
+    {
+        a.isolateThread()
+    } -> std::same_as<void>;
+    {
+        a.isThreadIsolated()
+    } -> std::same_as<bool>;
+    {
+        a.syncThread()
+    } -> std::same_as<void>;
     {
         a.isTooBusy()
     } -> std::same_as<bool>;
+    {
+        a.writeLoad()
+    } -> std::same_as<double>;
     {
         a.writeSync(statement)
     } -> std::same_as<ResultOrError>;
@@ -99,6 +124,9 @@ concept SomeExecutionStrategy = requires(
     {
         a.readEach(token, statements)
     } -> std::same_as<std::vector<Result>>;
+    {
+        a.readPaged(token, statement, [](Result const&) {})
+    } -> std::same_as<void>;
     {
         a.stats()
     } -> std::same_as<boost::json::object>;
@@ -118,6 +118,21 @@ public:
             settingsProvider_.get().getTtl()
         ));
 
+        statements.emplace_back(fmt::format(
+            R"(
+           CREATE TABLE IF NOT EXISTS {}
+                  (     
+             ledger_sequence bigint, 
+           transaction_index bigint, 
+                        hash blob, 
+                     PRIMARY KEY (ledger_sequence, transaction_index) 
+                  ) 
+             WITH default_time_to_live = {}
+            )",
+            qualifiedTableName(settingsProvider_.get(), "ledger_transaction_indexes"),
+            settingsProvider_.get().getTtl()
+        ));
+
         statements.emplace_back(fmt::format(
             R"(
            CREATE TABLE IF NOT EXISTS {}
@@ -163,6 +178,23 @@ public:
             settingsProvider_.get().getTtl()
         ));
 
+        statements.emplace_back(fmt::format(
+            R"(
+           CREATE TABLE IF NOT EXISTS {}
+                  ( 
+                    account blob,    
+                    tx_type bigint,
+                    seq_idx tuple<bigint, bigint>, 
+                       hash blob,
+                    PRIMARY KEY ((account, tx_type), seq_idx) 
+                  ) 
+             WITH CLUSTERING ORDER BY (seq_idx DESC)
+              AND default_time_to_live = {}
+            )",
+            qualifiedTableName(settingsProvider_.get(), "account_tx_by_type"),
+            settingsProvider_.get().getTtl()
+        ));
+
         statements.emplace_back(fmt::format(
             R"(
            CREATE TABLE IF NOT EXISTS {}
@@ -200,6 +232,55 @@ public:
             qualifiedTableName(settingsProvider_.get(), "ledger_range")
         ));
 
+        statements.emplace_back(fmt::format(
+            R"(
+           CREATE TABLE IF NOT EXISTS {}
+                  ( 
+                    first_sequence bigint PRIMARY KEY,
+                     last_sequence bigint
+                  )
+            )",
+            qualifiedTableName(settingsProvider_.get(), "backfilled_chunks")
+        ));
+
+        statements.emplace_back(fmt::format(
+            R"(
+           CREATE TABLE IF NOT EXISTS {}
+                  ( 
+                      marker blob PRIMARY KEY,
+                    sequence bigint,
+                   first_key blob,
+                    last_key blob,
+                     is_done boolean
+                  )
+            )",
+            qualifiedTableName(settingsProvider_.get(), "initial_load_progress")
+        ));
+
+        statements.emplace_back(fmt::format(
+            R"(
+           CREATE TABLE IF NOT EXISTS {}
+                  ( 
+                  is_current boolean PRIMARY KEY,
+                      writer blob,
+                        term bigint,
+                   heartbeat bigint
+                  )
+            )",
+            qualifiedTableName(settingsProvider_.get(), "writer_lease")
+        ));
+
+        statements.emplace_back(fmt::format(
+            R"(
+           CREATE TABLE IF NOT EXISTS {}
+                  ( 
+                  table_name blob PRIMARY KEY,
+                min_sequence bigint
+                  )
+            )",
+            qualifiedTableName(settingsProvider_.get(), "index_coverage")
+        ));
+
         statements.emplace_back(fmt::format(
             R"(
            CREATE TABLE IF NOT EXISTS {}
@@ -249,6 +330,26 @@ public:
             settingsProvider_.get().getTtl()
         ));
 
+        statements.emplace_back(fmt::format(
+            R"(
+           CREATE TABLE IF NOT EXISTS {}
+                  ( 
+                      issuer blob,
+                       taxon bigint,
+                    token_id blob,
+                    sequence bigint,
+                       owner blob,
+                   is_burned boolean,
+                         uri blob,
+                     PRIMARY KEY (issuer, taxon, token_id, sequence)
+                  ) 
+             WITH CLUSTERING ORDER BY (taxon ASC, token_id ASC, sequence DESC)
+              AND default_time_to_live = {}
+            )",
+            qualifiedTableName(settingsProvider_.get(), "issuer_nf_token_state"),
+            settingsProvider_.get().getTtl()
+        ));
+
         statements.emplace_back(fmt::format(
             R"(
            CREATE TABLE IF NOT EXISTS {}
@@ -281,12 +382,22 @@ public:
         {
         }
 
+    private:
+        PreparedStatement
+        prepare(std::string_view label, std::string const& query) const
+        {
+            auto statement = handle_.get().prepare(query);
+            statement.setLabel(label);  // label is used to attribute latency stats to the statement
+            return statement;
+        }
+
+    public:
         //
         // Insert queries
         //
 
         PreparedStatement insertObject = [this]() {
-            return handle_.get().prepare(fmt::format(
+            return prepare("insertObject", fmt::format(
                 R"(
                 INSERT INTO {} 
                        (key, sequence, object)
@@ -297,7 +408,7 @@ public:
         }();
 
         PreparedStatement insertTransaction = [this]() {
-            return handle_.get().prepare(fmt::format(
+            return prepare("insertTransaction", fmt::format(
                 R"(
                 INSERT INTO {} 
                        (hash, ledger_sequence, date, transaction, metadata)
@@ -308,7 +419,7 @@ public:
         }();
 
         PreparedStatement insertLedgerTransaction = [this]() {
-            return handle_.get().prepare(fmt::format(
+            return prepare("insertLedgerTransaction", fmt::format(
                 R"(
                 INSERT INTO {} 
                        (ledger_sequence, hash)
@@ -318,8 +429,76 @@ public:
             ));
         }();
 
+        PreparedStatement insertLedgerTransactionIndex = [this]() {
+            return prepare("insertLedgerTransactionIndex", fmt::format(
+                R"(
+                INSERT INTO {} 
+                       (ledger_sequence, transaction_index, hash)
+                VALUES (?, ?, ?)
+                )",
+                qualifiedTableName(settingsProvider_.get(), "ledger_transaction_indexes")
+            ));
+        }();
+
+        PreparedStatement insertBackfilledChunk = [this]() {
+            return prepare("insertBackfilledChunk", fmt::format(
+                R"(
+                INSERT INTO {} 
+                       (first_sequence, last_sequence)
+                VALUES (?, ?)
+                )",
+                qualifiedTableName(settingsProvider_.get(), "backfilled_chunks")
+            ));
+        }();
+
+        PreparedStatement insertWriterLease = [this]() {
+            return prepare("insertWriterLease", fmt::format(
+                R"(
+                INSERT INTO {} 
+                       (is_current, writer, term, heartbeat)
+                VALUES (true, ?, ?, ?)
+                    IF NOT EXISTS
+                )",
+                qualifiedTableName(settingsProvider_.get(), "writer_lease")
+            ));
+        }();
+
+        PreparedStatement insertIndexCoverage = [this]() {
+            return prepare("insertIndexCoverage", fmt::format(
+                R"(
+                INSERT INTO {} 
+                       (table_name, min_sequence)
+                VALUES (?, ?)
+                    IF NOT EXISTS
+                )",
+                qualifiedTableName(settingsProvider_.get(), "index_coverage")
+            ));
+        }();
+
+        PreparedStatement insertInitialLoadCursor = [this]() {
+            return prepare("insertInitialLoadCursor", fmt::format(
+                R"(
+                INSERT INTO {} 
+                       (marker, sequence, first_key, last_key, is_done)
+                VALUES (?, ?, ?, ?, ?)
+                )",
+                qualifiedTableName(settingsProvider_.get(), "initial_load_progress")
+            ));
+        }();
+
+        PreparedStatement insertInitialLoadMarker = [this]() {
+            return prepare("insertInitialLoadMarker", fmt::format(
+                R"(
+                INSERT INTO {} 
+                       (marker, sequence, is_done)
+                VALUES (?, ?, ?)
+                )",
+                qualifiedTableName(settingsProvider_.get(), "initial_load_progress")
+            ));
+        }();
+
         PreparedStatement insertSuccessor = [this]() {
-            return handle_.get().prepare(fmt::format(
+            return prepare("insertSuccessor", fmt::format(
                 R"(
                 INSERT INTO {} 
                        (key, seq, next)
@@ -330,7 +509,7 @@ public:
         }();
 
         PreparedStatement insertDiff = [this]() {
-            return handle_.get().prepare(fmt::format(
+            return prepare("insertDiff", fmt::format(
                 R"(
                 INSERT INTO {} 
                        (seq, key)
@@ -341,7 +520,7 @@ public:
         }();
 
         PreparedStatement insertAccountTx = [this]() {
-            return handle_.get().prepare(fmt::format(
+            return prepare("insertAccountTx", fmt::format(
                 R"(
                 INSERT INTO {} 
                        (account, seq_idx, hash)
@@ -351,8 +530,19 @@ public:
             ));
         }();
 
+        PreparedStatement insertAccountTxByType = [this]() {
+            return prepare("insertAccountTxByType", fmt::format(
+                R"(
+                INSERT INTO {} 
+                       (account, tx_type, seq_idx, hash)
+                VALUES (?, ?, ?, ?)
+                )",
+                qualifiedTableName(settingsProvider_.get(), "account_tx_by_type")
+            ));
+        }();
+
         PreparedStatement insertNFT = [this]() {
-            return handle_.get().prepare(fmt::format(
+            return prepare("insertNFT", fmt::format(
                 R"(
                 INSERT INTO {} 
                        (token_id, sequence, owner, is_burned)
@@ -363,7 +553,7 @@ public:
         }();
 
         PreparedStatement insertIssuerNFT = [this]() {
-            return handle_.get().prepare(fmt::format(
+            return prepare("insertIssuerNFT", fmt::format(
                 R"(
                 INSERT INTO {} 
                        (issuer, taxon, token_id)
@@ -374,7 +564,7 @@ public:
         }();
 
         PreparedStatement insertNFTURI = [this]() {
-            return handle_.get().prepare(fmt::format(
+            return prepare("insertNFTURI", fmt::format(
                 R"(
                 INSERT INTO {} 
                        (token_id, sequence, uri)
@@ -384,8 +574,32 @@ public:
             ));
         }();
 
+        // Every change of an NFT is a row of its own, so the latest ledger wins regardless of write order
+        PreparedStatement insertNFTState = [this]() {
+            return prepare("insertNFTState", fmt::format(
+                R"(
+                INSERT INTO {} 
+                       (issuer, taxon, token_id, sequence, owner, is_burned, uri)
+                VALUES (?, ?, ?, ?, ?, ?, ?)
+                )",
+                qualifiedTableName(settingsProvider_.get(), "issuer_nf_token_state")
+            ));
+        }();
+
+        // Same as above for changes after the mint; only the row of the mint has the URI
+        PreparedStatement updateNFTState = [this]() {
+            return prepare("updateNFTState", fmt::format(
+                R"(
+                INSERT INTO {} 
+                       (issuer, taxon, token_id, sequence, owner, is_burned)
+                VALUES (?, ?, ?, ?, ?, ?)
+                )",
+                qualifiedTableName(settingsProvider_.get(), "issuer_nf_token_state")
+            ));
+        }();
+
         PreparedStatement insertNFTTx = [this]() {
-            return handle_.get().prepare(fmt::format(
+            return prepare("insertNFTTx", fmt::format(
                 R"(
                 INSERT INTO {} 
                        (token_id, seq_idx, hash)
@@ -396,7 +610,7 @@ public:
         }();
 
         PreparedStatement insertLedgerHeader = [this]() {
-            return handle_.get().prepare(fmt::format(
+            return prepare("insertLedgerHeader", fmt::format(
                 R"(
                 INSERT INTO {} 
                        (sequence, header)
@@ -407,7 +621,7 @@ public:
         }();
 
         PreparedStatement insertLedgerHash = [this]() {
-            return handle_.get().prepare(fmt::format(
+            return prepare("insertLedgerHash", fmt::format(
                 R"(
                 INSERT INTO {} 
                        (hash, sequence)
@@ -422,7 +636,7 @@ public:
         //
 
         PreparedStatement updateLedgerRange = [this]() {
-            return handle_.get().prepare(fmt::format(
+            return prepare("updateLedgerRange", fmt::format(
                 R"(
                 UPDATE {} 
                    SET sequence = ?
@@ -433,8 +647,29 @@ public:
             ));
         }();
 
+        PreparedStatement updateWriterLease = [this]() {
+            return prepare("updateWriterLease", fmt::format(
+                R"(
+                UPDATE {} 
+                   SET writer = ?, term = ?, heartbeat = ?
+                 WHERE is_current = true
+                    IF writer = ? AND term = ? AND heartbeat = ?
+                )",
+                qualifiedTableName(settingsProvider_.get(), "writer_lease")
+            ));
+        }();
+
+        PreparedStatement deleteInitialLoadProgress = [this]() {
+            return prepare("deleteInitialLoadProgress", fmt::format(
+                R"(
+                TRUNCATE {}
+                )",
+                qualifiedTableName(settingsProvider_.get(), "initial_load_progress")
+            ));
+        }();
+
         PreparedStatement deleteLedgerRange = [this]() {
-            return handle_.get().prepare(fmt::format(
+            return prepare("deleteLedgerRange", fmt::format(
                 R"(
                 UPDATE {} 
                    SET sequence = ?
@@ -444,12 +679,156 @@ public:
             ));
         }();
 
+        //
+        // History pruning queries
+        //
+
+        PreparedStatement deleteObjectsBefore = [this]() {
+            return prepare("deleteObjectsBefore", fmt::format(
+                R"(
+                DELETE FROM {}
+                 WHERE key = ?
+                   AND sequence < ?
+                )",
+                qualifiedTableName(settingsProvider_.get(), "objects")
+            ));
+        }();
+
+        PreparedStatement deleteSuccessorsBefore = [this]() {
+            return prepare("deleteSuccessorsBefore", fmt::format(
+                R"(
+                DELETE FROM {}
+                 WHERE key = ?
+                   AND seq < ?
+                )",
+                qualifiedTableName(settingsProvider_.get(), "successor")
+            ));
+        }();
+
+        PreparedStatement deleteDiff = [this]() {
+            return prepare("deleteDiff", fmt::format(
+                R"(
+                DELETE FROM {}
+                 WHERE seq = ?
+                )",
+                qualifiedTableName(settingsProvider_.get(), "diff")
+            ));
+        }();
+
+        PreparedStatement deleteTransaction = [this]() {
+            return prepare("deleteTransaction", fmt::format(
+                R"(
+                DELETE FROM {}
+                 WHERE hash = ?
+                )",
+                qualifiedTableName(settingsProvider_.get(), "transactions")
+            ));
+        }();
+
+        PreparedStatement deleteLedgerTransactions = [this]() {
+            return prepare("deleteLedgerTransactions", fmt::format(
+                R"(
+                DELETE FROM {}
+                 WHERE ledger_sequence = ?
+                )",
+                qualifiedTableName(settingsProvider_.get(), "ledger_transactions")
+            ));
+        }();
+
+        PreparedStatement deleteLedgerTransactionIndexes = [this]() {
+            return prepare("deleteLedgerTransactionIndexes", fmt::format(
+                R"(
+                DELETE FROM {}
+                 WHERE ledger_sequence = ?
+                )",
+                qualifiedTableName(settingsProvider_.get(), "ledger_transaction_indexes")
+            ));
+        }();
+
+        PreparedStatement deleteAccountTxBefore = [this]() {
+            return prepare("deleteAccountTxBefore", fmt::format(
+                R"(
+                DELETE FROM {}
+                 WHERE account = ?
+                   AND seq_idx < ?
+                )",
+                qualifiedTableName(settingsProvider_.get(), "account_tx")
+            ));
+        }();
+
+        PreparedStatement deleteAccountTxByTypeBefore = [this]() {
+            return prepare("deleteAccountTxByTypeBefore", fmt::format(
+                R"(
+                DELETE FROM {}
+                 WHERE account = ?
+                   AND tx_type = ?
+                   AND seq_idx < ?
+                )",
+                qualifiedTableName(settingsProvider_.get(), "account_tx_by_type")
+            ));
+        }();
+
+        PreparedStatement deleteNFTsBefore = [this]() {
+            return prepare("deleteNFTsBefore", fmt::format(
+                R"(
+                DELETE FROM {}
+                 WHERE token_id = ?
+                   AND sequence < ?
+                )",
+                qualifiedTableName(settingsProvider_.get(), "nf_tokens")
+            ));
+        }();
+
+        PreparedStatement deleteNFTStatesBefore = [this]() {
+            return prepare("deleteNFTStatesBefore", fmt::format(
+                R"(
+                DELETE FROM {}
+                 WHERE issuer = ?
+                   AND taxon = ?
+                   AND token_id = ?
+                   AND sequence < ?
+                )",
+                qualifiedTableName(settingsProvider_.get(), "issuer_nf_token_state")
+            ));
+        }();
+
+        PreparedStatement deleteNFTTxBefore = [this]() {
+            return prepare("deleteNFTTxBefore", fmt::format(
+                R"(
+                DELETE FROM {}
+                 WHERE token_id = ?
+                   AND seq_idx < ?
+                )",
+                qualifiedTableName(settingsProvider_.get(), "nf_token_transactions")
+            ));
+        }();
+
+        PreparedStatement deleteLedgerHeader = [this]() {
+            return prepare("deleteLedgerHeader", fmt::format(
+                R"(
+                DELETE FROM {}
+                 WHERE sequence = ?
+                )",
+                qualifiedTableName(settingsProvider_.get(), "ledgers")
+            ));
+        }();
+
+        PreparedStatement deleteLedgerHash = [this]() {
+            return prepare("deleteLedgerHash", fmt::format(
+                R"(
+                DELETE FROM {}
+                 WHERE hash = ?
+                )",
+                qualifiedTableName(settingsProvider_.get(), "ledger_hashes")
+            ));
+        }();
+
         //
         // Select queries
         //
 
         PreparedStatement selectSuccessor = [this]() {
-            return handle_.get().prepare(fmt::format(
+            return prepare("selectSuccessor", fmt::format(
                 R"(
                 SELECT next 
                   FROM {}               
@@ -463,7 +842,7 @@ public:
         }();
 
         PreparedStatement selectDiff = [this]() {
-            return handle_.get().prepare(fmt::format(
+            return prepare("selectDiff", fmt::format(
                 R"(
                 SELECT key 
                   FROM {}
@@ -474,7 +853,7 @@ public:
         }();
 
         PreparedStatement selectObject = [this]() {
-            return handle_.get().prepare(fmt::format(
+            return prepare("selectObject", fmt::format(
                 R"(
                 SELECT object, sequence 
                   FROM {}               
@@ -488,7 +867,7 @@ public:
         }();
 
         PreparedStatement selectTransaction = [this]() {
-            return handle_.get().prepare(fmt::format(
+            return prepare("selectTransaction", fmt::format(
                 R"(
                 SELECT transaction, metadata, ledger_sequence, date 
                   FROM {}
@@ -499,7 +878,7 @@ public:
         }();
 
         PreparedStatement selectAllTransactionHashesInLedger = [this]() {
-            return handle_.get().prepare(fmt::format(
+            return prepare("selectAllTransactionHashesInLedger", fmt::format(
                 R"(
                 SELECT hash 
                   FROM {}               
@@ -509,8 +888,20 @@ public:
             ));
         }();
 
+        PreparedStatement selectTransactionHashByIndex = [this]() {
+            return prepare("selectTransactionHashByIndex", fmt::format(
+                R"(
+                SELECT hash 
+                  FROM {}
+                 WHERE ledger_sequence = ?
+                   AND transaction_index = ?
+                )",
+                qualifiedTableName(settingsProvider_.get(), "ledger_transaction_indexes")
+            ));
+        }();
+
         PreparedStatement selectLedgerPageKeys = [this]() {
-            return handle_.get().prepare(fmt::format(
+            return prepare("selectLedgerPageKeys", fmt::format(
                 R"(
                 SELECT key 
                   FROM {}               
@@ -525,7 +916,7 @@ public:
         }();
 
         PreparedStatement selectLedgerPage = [this]() {
-            return handle_.get().prepare(fmt::format(
+            return prepare("selectLedgerPage", fmt::format(
                 R"(
                 SELECT object, key
                   FROM {}
@@ -540,7 +931,7 @@ public:
         }();
 
         PreparedStatement getToken = [this]() {
-            return handle_.get().prepare(fmt::format(
+            return prepare("getToken", fmt::format(
                 R"(
                 SELECT TOKEN(key) 
                   FROM {}               
@@ -552,7 +943,7 @@ public:
         }();
 
         PreparedStatement selectAccountTx = [this]() {
-            return handle_.get().prepare(fmt::format(
+            return prepare("selectAccountTx", fmt::format(
                 R"(
                 SELECT hash, seq_idx 
                   FROM {}               
@@ -565,7 +956,7 @@ public:
         }();
 
         PreparedStatement selectAccountTxForward = [this]() {
-            return handle_.get().prepare(fmt::format(
+            return prepare("selectAccountTxForward", fmt::format(
                 R"(
                 SELECT hash, seq_idx 
                   FROM {}               
@@ -578,8 +969,37 @@ public:
             ));
         }();
 
+        PreparedStatement selectAccountTxByType = [this]() {
+            return prepare("selectAccountTxByType", fmt::format(
+                R"(
+                SELECT hash, seq_idx 
+                  FROM {}               
+                 WHERE account = ?
+                   AND tx_type = ?
+                   AND seq_idx < ?
+                 LIMIT ?
+                )",
+                qualifiedTableName(settingsProvider_.get(), "account_tx_by_type")
+            ));
+        }();
+
+        PreparedStatement selectAccountTxByTypeForward = [this]() {
+            return prepare("selectAccountTxByTypeForward", fmt::format(
+                R"(
+                SELECT hash, seq_idx 
+                  FROM {}               
+                 WHERE account = ?
+                   AND tx_type = ?
+                   AND seq_idx > ?
+              ORDER BY seq_idx ASC 
+                 LIMIT ?
+                )",
+                qualifiedTableName(settingsProvider_.get(), "account_tx_by_type")
+            ));
+        }();
+
         PreparedStatement selectNFT = [this]() {
-            return handle_.get().prepare(fmt::format(
+            return prepare("selectNFT", fmt::format(
                 R"(
                 SELECT sequence, owner, is_burned
                   FROM {}    
@@ -593,7 +1013,7 @@ public:
         }();
 
         PreparedStatement selectNFTURI = [this]() {
-            return handle_.get().prepare(fmt::format(
+            return prepare("selectNFTURI", fmt::format(
                 R"(
                 SELECT uri
                   FROM {}    
@@ -607,7 +1027,7 @@ public:
         }();
 
         PreparedStatement selectNFTTx = [this]() {
-            return handle_.get().prepare(fmt::format(
+            return prepare("selectNFTTx", fmt::format(
                 R"(
                 SELECT hash, seq_idx
                   FROM {}    
@@ -621,7 +1041,7 @@ public:
         }();
 
         PreparedStatement selectNFTTxForward = [this]() {
-            return handle_.get().prepare(fmt::format(
+            return prepare("selectNFTTxForward", fmt::format(
                 R"(
                 SELECT hash, seq_idx
                   FROM {}    
@@ -635,7 +1055,7 @@ public:
         }();
 
         PreparedStatement selectNFTIDsByIssuer = [this]() {
-            return handle_.get().prepare(fmt::format(
+            return prepare("selectNFTIDsByIssuer", fmt::format(
                 R"(
                 SELECT token_id
                   FROM {}    
@@ -649,7 +1069,7 @@ public:
         }();
 
         PreparedStatement selectNFTIDsByIssuerTaxon = [this]() {
-            return handle_.get().prepare(fmt::format(
+            return prepare("selectNFTIDsByIssuerTaxon", fmt::format(
                 R"(
                 SELECT token_id
                   FROM {}    
@@ -663,8 +1083,38 @@ public:
             ));
         }();
 
+        // The rows of an NFT are in descending ledger order, so each group takes the columns of the latest one
+        PreparedStatement selectNFTStatesByIssuer = [this]() {
+            return prepare("selectNFTStatesByIssuer", fmt::format(
+                R"(
+                SELECT token_id, sequence, owner, is_burned, uri
+                  FROM {}    
+                 WHERE issuer = ?
+                   AND (taxon, token_id) > ?
+              GROUP BY issuer, taxon, token_id
+                 LIMIT ?
+                )",
+                qualifiedTableName(settingsProvider_.get(), "issuer_nf_token_state")
+            ));
+        }();
+
+        PreparedStatement selectNFTStatesByIssuerTaxon = [this]() {
+            return prepare("selectNFTStatesByIssuerTaxon", fmt::format(
+                R"(
+                SELECT token_id, sequence, owner, is_burned, uri
+                  FROM {}    
+                 WHERE issuer = ?
+                   AND taxon = ?
+                   AND token_id > ?
+              GROUP BY issuer, taxon, token_id
+                 LIMIT ?
+                )",
+                qualifiedTableName(settingsProvider_.get(), "issuer_nf_token_state")
+            ));
+        }();
+
         PreparedStatement selectLedgerByHash = [this]() {
-            return handle_.get().prepare(fmt::format(
+            return prepare("selectLedgerByHash", fmt::format(
                 R"(
                 SELECT sequence
                   FROM {}
@@ -676,7 +1126,7 @@ public:
         }();
 
         PreparedStatement selectLedgerBySeq = [this]() {
-            return handle_.get().prepare(fmt::format(
+            return prepare("selectLedgerBySeq", fmt::format(
                 R"(
                 SELECT header
                   FROM {}
@@ -687,7 +1137,7 @@ public:
         }();
 
         PreparedStatement selectLatestLedger = [this]() {
-            return handle_.get().prepare(fmt::format(
+            return prepare("selectLatestLedger", fmt::format(
                 R"(
                 SELECT sequence
                   FROM {}    
@@ -697,8 +1147,50 @@ public:
             ));
         }();
 
+        PreparedStatement selectBackfilledChunks = [this]() {
+            return prepare("selectBackfilledChunks", fmt::format(
+                R"(
+                SELECT first_sequence, last_sequence
+                  FROM {}
+                )",
+                qualifiedTableName(settingsProvider_.get(), "backfilled_chunks")
+            ));
+        }();
+
+        PreparedStatement selectWriterLease = [this]() {
+            return prepare("selectWriterLease", fmt::format(
+                R"(
+                SELECT writer, term, heartbeat
+                  FROM {}
+                 WHERE is_current = true
+                )",
+                qualifiedTableName(settingsProvider_.get(), "writer_lease")
+            ));
+        }();
+
+        PreparedStatement selectIndexCoverage = [this]() {
+            return prepare("selectIndexCoverage", fmt::format(
+                R"(
+                SELECT min_sequence
+                  FROM {}
+                 WHERE table_name = ?
+                )",
+                qualifiedTableName(settingsProvider_.get(), "index_coverage")
+            ));
+        }();
+
+        PreparedStatement selectInitialLoadProgress = [this]() {
+            return prepare("selectInitialLoadProgress", fmt::format(
+                R"(
+                SELECT marker, sequence, first_key, last_key, is_done
+                  FROM {}
+                )",
+                qualifiedTableName(settingsProvider_.get(), "initial_load_progress")
+            ));
+        }();
+
         PreparedStatement selectLedgerRange = [this]() {
-            return handle_.get().prepare(fmt::format(
+            return prepare("selectLedgerRange", fmt::format(
                 R"(
                 SELECT sequence
                   FROM {}
@@ -26,6 +26,7 @@
 
 #include <boost/json/conversion.hpp>
 #include <boost/json/value.hpp>
+#include <cassandra.h>
 
 #include <cerrno>
 #include <chrono>
@@ -38,6 +39,7 @@
 #include <stdexcept>
 #include <string>
 #include <system_error>
+#include <unordered_map>
 
 namespace data::cassandra {
 
@@ -67,6 +69,31 @@ tag_invoke(boost::json::value_to_tag<Settings::SecureConnectionBundle>, boost::j
 }
 }  // namespace detail
 
+namespace {
+
+CassConsistency
+parseConsistency(std::string const& name)
+{
+    static std::unordered_map<std::string, CassConsistency> const levels = {
+        {"any", CASS_CONSISTENCY_ANY},
+        {"one", CASS_CONSISTENCY_ONE},
+        {"two", CASS_CONSISTENCY_TWO},
+        {"three", CASS_CONSISTENCY_THREE},
+        {"quorum", CASS_CONSISTENCY_QUORUM},
+        {"all", CASS_CONSISTENCY_ALL},
+        {"local_quorum", CASS_CONSISTENCY_LOCAL_QUORUM},
+        {"each_quorum", CASS_CONSISTENCY_EACH_QUORUM},
+        {"local_one", CASS_CONSISTENCY_LOCAL_ONE},
+    };
+
+    if (auto const it = levels.find(name); it != levels.end())
+        return it->second;
+
+    throw std::runtime_error("Unknown Cassandra consistency level: " + name);
+}
+
+}  // namespace
+
 SettingsProvider::SettingsProvider(util::Config const& cfg, uint16_t ttl)
     : config_{cfg}
     , keyspace_{cfg.valueOr<std::string>("keyspace", "clio")}
@@ -74,6 +101,7 @@ SettingsProvider::SettingsProvider(util::Config const& cfg, uint16_t ttl)
     , replicationFactor_{cfg.valueOr<uint16_t>("replication_factor", 3)}
     , ttl_{ttl}
     , settings_{parseSettings()}
+    , readSettings_{parseReadSettings()}
 {
 }
 
@@ -83,6 +111,12 @@ SettingsProvider::getSettings() const
     return settings_;
 }
 
+std::optional<Settings>
+SettingsProvider::getReadSettings() const
+{
+    return readSettings_;
+}
+
 std::optional<std::string>
 SettingsProvider::parseOptionalCertificate() const
 {
@@ -106,6 +140,30 @@ SettingsProvider::parseOptionalCertificate() const
 
 Settings
 SettingsProvider::parseSettings() const
+{
+    auto settings = parseCommonSettings();
+    if (config_.contains("write"))
+        parseSessionSettings(settings, config_.section("write"));
+
+    return settings;
+}
+
+std::optional<Settings>
+SettingsProvider::parseReadSettings() const
+{
+    // reads share the session with writes unless either role is configured separately
+    if (not config_.contains("read") and not config_.contains("write"))
+        return std::nullopt;
+
+    auto settings = parseCommonSettings();
+    if (config_.contains("read"))
+        parseSessionSettings(settings, config_.section("read"));
+
+    return settings;
+}
+
+Settings
+SettingsProvider::parseCommonSettings() const
 {
     auto settings = Settings::defaultSettings();
     if (auto const bundle = config_.maybeValue<Settings::SecureConnectionBundle>("secure_connect_bundle"); bundle) {
@@ -115,13 +173,10 @@ SettingsProvider::parseSettings() const
             config_.valueOrThrow<Settings::ContactPoints>("Missing contact_points in Cassandra config");
     }
 
-    settings.threads = config_.valueOr<uint32_t>("threads", settings.threads);
     settings.maxWriteRequestsOutstanding =
         config_.valueOr<uint32_t>("max_write_requests_outstanding", settings.maxWriteRequestsOutstanding);
     settings.maxReadRequestsOutstanding =
         config_.valueOr<uint32_t>("max_read_requests_outstanding", settings.maxReadRequestsOutstanding);
-    settings.coreConnectionsPerHost =
-        config_.valueOr<uint32_t>("core_connections_per_host", settings.coreConnectionsPerHost);
 
     settings.queueSizeIO = config_.maybeValue<uint32_t>("queue_size_io");
 
@@ -133,11 +188,40 @@ SettingsProvider::parseSettings() const
     if (requestTimeoutSecond)
         settings.requestTimeout = std::chrono::milliseconds{*requestTimeoutSecond * util::MILLISECONDS_PER_SECOND};
 
+    if (auto const threshold = config_.maybeValue<uint32_t>("slow_statement_threshold"); threshold)
+        settings.slowStatementThreshold = std::chrono::milliseconds{*threshold};
+
+    settings.pageSize = config_.valueOr<uint32_t>("page_size", settings.pageSize);
+    if (settings.pageSize == 0)
+        throw std::runtime_error("page_size must be positive");
+
     settings.certificate = parseOptionalCertificate();
     settings.username = config_.maybeValue<std::string>("username");
     settings.password = config_.maybeValue<std::string>("password");
 
+    parseSessionSettings(settings, config_);
     return settings;
 }
 
+void
+SettingsProvider::parseSessionSettings(Settings& settings, util::Config const& section)
+{
+    if (auto const bundle = section.maybeValue<Settings::SecureConnectionBundle>("secure_connect_bundle"); bundle) {
+        settings.connectionInfo = *bundle;
+    } else if (section.contains("contact_points")) {
+        settings.connectionInfo =
+            section.valueOrThrow<Settings::ContactPoints>("Invalid contact_points in Cassandra config");
+    }
+
+    settings.threads = section.valueOr<uint32_t>("threads", settings.threads);
+    settings.coreConnectionsPerHost =
+        section.valueOr<uint32_t>("core_connections_per_host", settings.coreConnectionsPerHost);
+
+    if (auto const dataCenter = section.maybeValue<std::string>("local_data_center"); dataCenter)
+        settings.localDataCenter = dataCenter;
+
+    if (auto const consistency = section.maybeValue<std::string>("consistency"); consistency)
+        settings.consistency = parseConsistency(*consistency);
+}
+
 }  // namespace data::cassandra
@@ -25,6 +25,9 @@
 #include "util/config/Config.h"
 #include "util/log/Logger.h"
 
+#include <optional>
+#include <string>
+
 namespace data::cassandra {
 
 /**
@@ -38,6 +41,7 @@ class SettingsProvider {
     uint16_t replicationFactor_;
     uint16_t ttl_;
     Settings settings_;
+    std::optional<Settings> readSettings_;
 
 public:
     /**
@@ -49,11 +53,18 @@ public:
     explicit SettingsProvider(util::Config const& cfg, uint16_t ttl = 0);
 
     /**
-     * @return The cluster settings
+     * @return The cluster settings; used for writes and, unless a separate read session is configured, for reads
      */
     [[nodiscard]] Settings
     getSettings() const;
 
+    /**
+     * @return The settings of the dedicated read session if a `read` or `write` section is configured; nullopt
+     * otherwise
+     */
+    [[nodiscard]] std::optional<Settings>
+    getReadSettings() const;
+
     /**
      * @return The specified keyspace
      */
@@ -96,6 +107,15 @@ private:
 
     [[nodiscard]] Settings
     parseSettings() const;
+
+    [[nodiscard]] std::optional<Settings>
+    parseReadSettings() const;
+
+    [[nodiscard]] Settings
+    parseCommonSettings() const;
+
+    static void
+    parseSessionSettings(Settings& settings, util::Config const& section);
 };
 
 }  // namespace data::cassandra
@@ -70,6 +70,19 @@ Cluster::Cluster(Settings const& settings) : ManagedObject{cass_cluster_new(), c
         throw std::runtime_error(fmt::format("Could not set core connections per host: {}", cass_error_desc(rc)));
     }
 
+    if (auto const rc = cass_cluster_set_consistency(*this, settings.consistency); rc != CASS_OK) {
+        throw std::runtime_error(fmt::format("Could not set consistency: {}", cass_error_desc(rc)));
+    }
+
+    if (settings.localDataCenter) {
+        auto const rc = cass_cluster_set_load_balance_dc_aware(*this, settings.localDataCenter->c_str(), 0, cass_false);
+        if (rc != CASS_OK) {
+            throw std::runtime_error(fmt::format(
+                "Could not set local data center to {}: {}", *settings.localDataCenter, cass_error_desc(rc)
+            ));
+        }
+    }
+
     auto const queueSize =
         settings.queueSizeIO.value_or(settings.maxWriteRequestsOutstanding + settings.maxReadRequestsOutstanding);
     if (auto const rc = cass_cluster_set_queue_size_io(*this, queueSize); rc != CASS_OK) {
@@ -83,6 +96,9 @@ Cluster::Cluster(Settings const& settings) : ManagedObject{cass_cluster_new(), c
     LOG(log_.info()) << "Threads: " << settings.threads;
     LOG(log_.info()) << "Core connections per host: " << settings.coreConnectionsPerHost;
     LOG(log_.info()) << "IO queue size: " << queueSize;
+    LOG(log_.info()) << "Consistency: " << cass_consistency_string(settings.consistency);
+    if (settings.localDataCenter)
+        LOG(log_.info()) << "Local data center: " << *settings.localDataCenter;
 }
 
 void
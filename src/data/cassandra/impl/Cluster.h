@@ -42,6 +42,8 @@ struct Settings {
     static constexpr std::size_t DEFAULT_CONNECTION_TIMEOUT = 10000;
     static constexpr uint32_t DEFAULT_MAX_WRITE_REQUESTS_OUTSTANDING = 10'000;
     static constexpr uint32_t DEFAULT_MAX_READ_REQUESTS_OUTSTANDING = 100'000;
+    static constexpr std::size_t DEFAULT_SLOW_STATEMENT_THRESHOLD = 500;
+    static constexpr uint32_t DEFAULT_PAGE_SIZE = 256;
     /**
      * @brief Represents the configuration of contact points for cassandra.
      */
@@ -81,6 +83,18 @@ struct Settings {
     /** @brief The number of connection per host to always have active */
     uint32_t coreConnectionsPerHost = 1u;
 
+    /** @brief The consistency level of all statements executed on the session */
+    CassConsistency consistency = CASS_CONSISTENCY_QUORUM;
+
+    /** @brief The data center to prefer for requests; the driver picks one from the contact points if not set */
+    std::optional<std::string> localDataCenter{};
+
+    /** @brief Statements taking at least this long (in milliseconds) are sampled to the log with their bound key */
+    std::chrono::milliseconds slowStatementThreshold = std::chrono::milliseconds{DEFAULT_SLOW_STATEMENT_THRESHOLD};
+
+    /** @brief The number of rows fetched per round trip by paged reads */
+    uint32_t pageSize = DEFAULT_PAGE_SIZE;
+
     /** @brief Size of the IO queue */
     std::optional<uint32_t> queueSizeIO{};
 
@@ -32,11 +32,16 @@
 #include <boost/asio/spawn.hpp>
 
 #include <atomic>
+#include <chrono>
 #include <condition_variable>
+#include <cstdint>
+#include <exception>
 #include <functional>
+#include <map>
 #include <memory>
 #include <mutex>
 #include <optional>
+#include <string_view>
 #include <thread>
 
 namespace data::cassandra::detail {
@@ -51,6 +56,9 @@ namespace data::cassandra::detail {
  */
 template <typename HandleType = Handle, SomeBackendCounters BackendCountersType = BackendCounters>
 class DefaultExecutionStrategy {
+    // at most one slow statement is logged per this interval so an overloaded DB does not also flood the log
+    static constexpr auto SLOW_STATEMENT_LOG_INTERVAL = std::chrono::seconds{1};
+
     util::Logger log_{"Backend"};
 
     std::uint32_t maxWriteRequestsOutstanding_;
@@ -65,10 +73,29 @@ class DefaultExecutionStrategy {
     std::mutex syncMutex_;
     std::condition_variable syncCv_;
 
+    // async writes are tagged with the write group that was current when they were issued
+    std::atomic_uint64_t currentWriteGroup_ = 0;
+    std::map<std::uint64_t, std::uint32_t> numWriteRequestsOutstandingPerGroup_;  // guarded by syncMutex_
+
+    // isolated write groups sort after all others, so sync(group) never waits for them
+    static constexpr std::uint64_t FIRST_ISOLATED_WRITE_GROUP = std::uint64_t{1} << 63;
+    std::atomic_uint64_t nextIsolatedWriteGroup_ = FIRST_ISOLATED_WRITE_GROUP;
+
+    struct ThreadWriteGroup {
+        DefaultExecutionStrategy const* strategy = nullptr;
+        std::uint64_t group = 0;
+    };
+    static inline thread_local ThreadWriteGroup threadWriteGroup_;
+
+    std::chrono::milliseconds slowStatementThreshold_;
+    std::uint32_t pageSize_;
+    std::atomic<std::chrono::steady_clock::time_point> lastSlowStatementLogTime_{};
+
     boost::asio::io_context ioc_;
     std::optional<boost::asio::io_service::work> work_;
 
-    std::reference_wrapper<HandleType const> handle_;
+    std::reference_wrapper<HandleType const> writeHandle_;
+    std::reference_wrapper<HandleType const> readHandle_;
     std::thread thread_;
 
     typename BackendCountersType::PtrType counters_;
@@ -84,22 +111,44 @@ public:
 
     /**
      * @param settings The settings to use
-     * @param handle A handle to the cassandra database
+     * @param handle A handle to the cassandra database used for both reads and writes
+     * @param counters The counters to use
      */
     DefaultExecutionStrategy(
         Settings const& settings,
         HandleType const& handle,
         typename BackendCountersType::PtrType counters = BackendCountersType::make()
+    )
+        : DefaultExecutionStrategy(settings, handle, handle, std::move(counters))
+    {
+    }
+
+    /**
+     * @param settings The settings to use
+     * @param writeHandle A handle to the cassandra database used for writes
+     * @param readHandle A handle to the cassandra database used for reads
+     * @param counters The counters to use
+     */
+    DefaultExecutionStrategy(
+        Settings const& settings,
+        HandleType const& writeHandle,
+        HandleType const& readHandle,
+        typename BackendCountersType::PtrType counters = BackendCountersType::make()
     )
         : maxWriteRequestsOutstanding_{settings.maxWriteRequestsOutstanding}
         , maxReadRequestsOutstanding_{settings.maxReadRequestsOutstanding}
+        , slowStatementThreshold_{settings.slowStatementThreshold}
+        , pageSize_{settings.pageSize}
         , work_{ioc_}
-        , handle_{std::cref(handle)}
+        , writeHandle_{std::cref(writeHandle)}
+        , readHandle_{std::cref(readHandle)}
         , thread_{[this]() { ioc_.run(); }}
         , counters_{std::move(counters)}
     {
         LOG(log_.info()) << "Max write requests outstanding is " << maxWriteRequestsOutstanding_
                          << "; Max read requests outstanding is " << maxReadRequestsOutstanding_;
+        if (&writeHandle != &readHandle)
+            LOG(log_.info()) << "Reads and writes use separate sessions";
     }
 
     ~DefaultExecutionStrategy()
@@ -121,6 +170,69 @@ public:
         LOG(log_.debug()) << "Sync done.";
     }
 
+    /**
+     * @brief Wait for the async writes of the given write group and all groups started before it to finish.
+     *
+     * Writes issued in later groups are not waited for.
+     *
+     * @param group The write group to wait for
+     */
+    void
+    sync(std::uint64_t const group)
+    {
+        LOG(log_.debug()) << "Waiting to sync writes up to group " << group << "...";
+        std::unique_lock<std::mutex> lck(syncMutex_);
+        syncCv_.wait(lck, [this, group]() { return finishedWriteRequestsUpTo(group); });
+        LOG(log_.debug()) << "Sync of group " << group << " done.";
+    }
+
+    /**
+     * @brief Start a new write group; async writes issued from now on belong to it.
+     *
+     * @return The id of the new write group
+     */
+    std::uint64_t
+    newWriteGroup()
+    {
+        return ++currentWriteGroup_;
+    }
+
+    /**
+     * @brief Move the async writes the calling thread issues from now on into an isolated write group of its own.
+     *
+     * An isolated group is only waited for by syncThread() on the same thread and by sync(); never by sync(group).
+     */
+    void
+    isolateThread()
+    {
+        threadWriteGroup_ = {.strategy = this, .group = nextIsolatedWriteGroup_++};
+    }
+
+    /** @return true if the calling thread issues its async writes into an isolated write group; false otherwise */
+    bool
+    isThreadIsolated() const
+    {
+        return threadWriteGroup_.strategy == this;
+    }
+
+    /**
+     * @brief Wait for the async writes of the calling thread to finish.
+     *
+     * Waits for all async writes like sync() if the calling thread is not isolated.
+     */
+    void
+    syncThread()
+    {
+        if (not isThreadIsolated()) {
+            sync();
+            return;
+        }
+
+        auto const group = threadWriteGroup_.group;
+        std::unique_lock<std::mutex> lck(syncMutex_);
+        syncCv_.wait(lck, [this, group]() { return not numWriteRequestsOutstandingPerGroup_.contains(group); });
+    }
+
     /**
      * @return true if outstanding read requests allowance is exhausted; false otherwise
      */
@@ -133,6 +245,15 @@ public:
         return result;
     }
 
+    /**
+     * @return The share of the outstanding write requests allowance in use, from 0 to 1
+     */
+    double
+    writeLoad() const
+    {
+        return static_cast<double>(numWriteRequestsOutstanding_) / maxWriteRequestsOutstanding_;
+    }
+
     /**
      * @brief Blocking query execution used for writing data.
      *
@@ -143,9 +264,10 @@ public:
     {
         auto const startTime = std::chrono::steady_clock::now();
         while (true) {
-            auto res = handle_.get().execute(statement);
+            auto res = writeHandle_.get().execute(statement);
             if (res) {
                 counters_->registerWriteSync(startTime);
+                onStatementWritten(statement.label(), statement.boundKey(), startTime);
                 return res;
             }
 
@@ -183,18 +305,21 @@ public:
         auto const startTime = std::chrono::steady_clock::now();
 
         auto statement = preparedStatement.bind(std::forward<Args>(args)...);
-        incrementOutstandingRequestCount();
+        auto const label = statement.label();
+        auto key = statement.boundKey();
+        auto const group = incrementOutstandingRequestCount();
 
         counters_->registerWriteStarted();
         // Note: lifetime is controlled by std::shared_from_this internally
         AsyncExecutor<std::decay_t<decltype(statement)>, HandleType>::run(
             ioc_,
-            handle_,
+            writeHandle_,
             std::move(statement),
-            [this, startTime](auto const&) {
-                decrementOutstandingRequestCount();
+            [this, startTime, group, label, key = std::move(key)](auto const&) {
+                decrementOutstandingRequestCount(group);
 
                 counters_->registerWriteFinished(startTime);
+                onStatementWritten(label, key, startTime);
             },
             [this]() { counters_->registerWriteRetry(); }
         );
@@ -216,17 +341,21 @@ public:
 
         auto const startTime = std::chrono::steady_clock::now();
 
-        incrementOutstandingRequestCount();
+        // batches are built from a single prepared statement so the first one is representative
+        auto const label = statements.front().label();
+        auto key = statements.front().boundKey();
+        auto const group = incrementOutstandingRequestCount();
 
         counters_->registerWriteStarted();
         // Note: lifetime is controlled by std::shared_from_this internally
         AsyncExecutor<std::decay_t<decltype(statements)>, HandleType>::run(
             ioc_,
-            handle_,
+            writeHandle_,
             std::move(statements),
-            [this, startTime](auto const&) {
-                decrementOutstandingRequestCount();
+            [this, startTime, group, label, key = std::move(key)](auto const&) {
+                decrementOutstandingRequestCount(group);
                 counters_->registerWriteFinished(startTime);
+                onStatementWritten(label, key, startTime);
             },
             [this]() { counters_->registerWriteRetry(); }
         );
@@ -276,7 +405,7 @@ public:
             auto init = [this, &statements, &future]<typename Self>(Self& self) {
                 auto sself = std::make_shared<Self>(std::move(self));
 
-                future.emplace(handle_.get().asyncExecute(statements, [sself](auto&& res) mutable {
+                future.emplace(readHandle_.get().asyncExecute(statements, [sself](auto&& res) mutable {
                     boost::asio::post(
                         boost::asio::get_associated_executor(*sself),
                         [sself, res = std::forward<decltype(res)>(res)]() mutable { sself->complete(std::move(res)); }
@@ -291,6 +420,11 @@ public:
 
             if (res) {
                 counters_->registerReadFinished(startTime, numStatements);
+                if (not statements.empty()) {
+                    onStatementRead(
+                        statements.front().label(), statements.front().boundKey(), startTime, numStatements
+                    );
+                }
                 return res;
             }
 
@@ -329,7 +463,7 @@ public:
             auto init = [this, &statement, &future]<typename Self>(Self& self) {
                 auto sself = std::make_shared<Self>(std::move(self));
 
-                future.emplace(handle_.get().asyncExecute(statement, [sself](auto&& res) mutable {
+                future.emplace(readHandle_.get().asyncExecute(statement, [sself](auto&& res) mutable {
                     boost::asio::post(
                         boost::asio::get_associated_executor(*sself),
                         [sself, res = std::forward<decltype(res)>(res)]() mutable { sself->complete(std::move(res)); }
@@ -344,6 +478,7 @@ public:
 
             if (res) {
                 counters_->registerReadFinished(startTime);
+                onStatementRead(statement.label(), statement.boundKey(), startTime);
                 return res;
             }
 
@@ -401,7 +536,7 @@ public:
                 std::cend(statements),
                 std::back_inserter(futures),
                 [this, &executionHandler](auto const& statement) {
-                    return handle_.get().asyncExecute(statement, executionHandler);
+                    return readHandle_.get().asyncExecute(statement, executionHandler);
                 }
             );
         };
@@ -415,9 +550,19 @@ public:
             ASSERT(errorsCount <= statements.size(), "Errors number cannot exceed statements number");
             counters_->registerReadError(errorsCount);
             counters_->registerReadFinished(startTime, statements.size() - errorsCount);
+            if (errorsCount < statements.size()) {
+                onStatementRead(
+                    statements.front().label(),
+                    statements.front().boundKey(),
+                    startTime,
+                    statements.size() - errorsCount
+                );
+            }
             throw DatabaseTimeout{};
         }
         counters_->registerReadFinished(startTime, statements.size());
+        if (not statements.empty())
+            onStatementRead(statements.front().label(), statements.front().boundKey(), startTime, statements.size());
 
         std::vector<ResultType> results;
         results.reserve(futures.size());
@@ -449,6 +594,53 @@ public:
         return results;
     }
 
+    /**
+     * @brief Coroutine-based paged read used for potentially large result sets.
+     *
+     * Pages are fetched using the driver's native paging state. The request for the next page is sent before the
+     * current page is handed to the callback, so fetching page N+1 overlaps with processing page N.
+     *
+     * @param token Completion token (yield_context)
+     * @param statement Statement to execute; its page size and paging state are updated on every round trip
+     * @param onPage Callback invoked with each page (ResultType) in order; it may yield on the same token
+     * @throw DatabaseTimeout on timeout
+     */
+    template <typename FnType>
+    void
+    readPaged(CompletionTokenType token, StatementType const& statement, FnType&& onPage)
+    {
+        statement.setPageSize(pageSize_);
+
+        auto page = read(token, statement);
+        while (true) {
+            auto const& result = page.value();
+
+            std::optional<PendingRead> next;
+            if (result.hasMorePages()) {
+                statement.setPagingState(result);
+                next.emplace(*this, statement);
+            }
+
+            // the in-flight request must complete before we unwind, so the exception is rethrown only after that
+            std::exception_ptr error;
+            try {
+                onPage(result);
+            } catch (...) {
+                error = std::current_exception();
+            }
+
+            if (not next) {
+                if (error)
+                    std::rethrow_exception(error);
+                return;
+            }
+
+            page = next->get(token);
+            if (error)
+                std::rethrow_exception(error);
+        }
+    }
+
     /**
      * @brief Get statistics about the backend.
      */
@@ -459,7 +651,142 @@ public:
     }
 
 private:
+    /**
+     * @brief A read that is sent right away while its result is picked up by the coroutine later on.
+     *
+     * Must be waited on with @ref get before it goes out of scope as the driver calls back into it.
+     */
+    class PendingRead {
+        struct State {
+            std::mutex mtx;
+            std::optional<ResultOrErrorType> result;
+            std::function<void()> onReady;
+        };
+
+        std::reference_wrapper<DefaultExecutionStrategy> strategy_;
+        std::reference_wrapper<StatementType const> statement_;
+        std::chrono::steady_clock::time_point startTime_ = std::chrono::steady_clock::now();
+        std::shared_ptr<State> state_ = std::make_shared<State>();
+        std::optional<FutureWithCallbackType> future_;
+
+    public:
+        PendingRead(DefaultExecutionStrategy& strategy, StatementType const& statement)
+            : strategy_{std::ref(strategy)}, statement_{std::cref(statement)}
+        {
+            strategy.counters_->registerReadStarted();
+            ++strategy.numReadRequestsOutstanding_;
+
+            future_.emplace(strategy.readHandle_.get().asyncExecute(statement, [state = state_](auto&& res) {
+                std::function<void()> onReady;
+                {
+                    std::scoped_lock const lck{state->mtx};
+                    state->result.emplace(std::forward<decltype(res)>(res));
+                    onReady = std::move(state->onReady);
+                }
+
+                if (onReady)
+                    onReady();
+            }));
+        }
+
+        /**
+         * @brief Wait for the result; falls back to a regular (retrying) read if the request failed.
+         *
+         * @param token Completion token (yield_context)
+         * @return The result
+         */
+        ResultOrErrorType
+        get(CompletionTokenType token)
+        {
+            auto init = [this]<typename Self>(Self& self) {
+                auto sself = std::make_shared<Self>(std::move(self));
+                auto complete = [sself]() {
+                    boost::asio::post(boost::asio::get_associated_executor(*sself), [sself]() mutable {
+                        sself->complete();
+                    });
+                };
+
+                std::unique_lock lck{state_->mtx};
+                if (not state_->result) {
+                    state_->onReady = std::move(complete);
+                    return;
+                }
+
+                lck.unlock();
+                complete();
+            };
+
+            boost::asio::async_compose<CompletionTokenType, void()>(
+                init, token, boost::asio::get_associated_executor(token)
+            );
+
+            auto& strategy = strategy_.get();
+            --strategy.numReadRequestsOutstanding_;
+
+            auto res = std::move(*state_->result);
+            if (res) {
+                strategy.counters_->registerReadFinished(startTime_);
+                strategy.onStatementRead(statement_.get().label(), statement_.get().boundKey(), startTime_);
+                return res;
+            }
+
+            LOG(strategy.log_.error()) << "Failed paged read in coroutine: " << res.error();
+            strategy.counters_->registerReadError();
+            strategy.throwErrorIfNeeded(res.error());
+
+            // the paging state is still set on the statement so the same page is requested again
+            return strategy.read(token, statement_.get());
+        }
+    };
+
+    template <typename KeyType>
+    void
+    onStatementRead(
+        std::string_view label,
+        KeyType const& key,
+        std::chrono::steady_clock::time_point startTime,
+        std::uint64_t count = 1u
+    )
+    {
+        auto const duration =
+            std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - startTime);
+        counters_->registerReadStatement(label, duration, count);
+        sampleIfSlow("read", label, key, duration);
+    }
+
+    template <typename KeyType>
     void
+    onStatementWritten(std::string_view label, KeyType const& key, std::chrono::steady_clock::time_point startTime)
+    {
+        auto const duration =
+            std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - startTime);
+        counters_->registerWriteStatement(label, duration);
+        sampleIfSlow("write", label, key, duration);
+    }
+
+    template <typename KeyType>
+    void
+    sampleIfSlow(
+        std::string_view operation,
+        std::string_view label,
+        KeyType const& key,
+        std::chrono::microseconds duration
+    )
+    {
+        if (duration < slowStatementThreshold_)
+            return;
+
+        auto const now = std::chrono::steady_clock::now();
+        auto last = lastSlowStatementLogTime_.load();
+        if (now - last < SLOW_STATEMENT_LOG_INTERVAL or
+            not lastSlowStatementLogTime_.compare_exchange_strong(last, now))
+            return;
+
+        LOG(log_.warn()) << "Slow " << operation << " statement " << label << " took " << duration.count()
+                         << " microseconds; key = " << key;
+    }
+
+    std::uint64_t
     incrementOutstandingRequestCount()
     {
         {
@@ -471,10 +798,15 @@ private:
             }
         }
         ++numWriteRequestsOutstanding_;
+
+        std::lock_guard const lck(syncMutex_);
+        auto const group = isThreadIsolated() ? threadWriteGroup_.group : currentWriteGroup_.load();
+        ++numWriteRequestsOutstandingPerGroup_[group];
+        return group;
     }
 
     void
-    decrementOutstandingRequestCount()
+    decrementOutstandingRequestCount(std::uint64_t const group)
     {
         // sanity check
         ASSERT(numWriteRequestsOutstanding_ > 0, "Decrementing num outstanding below 0");
@@ -485,12 +817,20 @@ private:
             std::lock_guard const lck(throttleMutex_);
             throttleCv_.notify_one();
         }
-        if (cur == 0) {
-            // mutex lock required to prevent race condition around spurious
-            // wakeup
-            std::lock_guard const lck(syncMutex_);
-            syncCv_.notify_one();
-        }
+
+        // mutex lock required to prevent race condition around spurious
+        // wakeup
+        std::lock_guard const lck(syncMutex_);
+        auto const it = numWriteRequestsOutstandingPerGroup_.find(group);
+        ASSERT(it != numWriteRequestsOutstandingPerGroup_.end(), "Write group {} has no outstanding requests", group);
+
+        auto const groupFinished = (--it->second == 0);
+        if (groupFinished)
+            numWriteRequestsOutstandingPerGroup_.erase(it);
+
+        // both sync() and sync(group) may be waiting
+        if (cur == 0 or groupFinished)
+            syncCv_.notify_all();
     }
 
     bool
@@ -505,6 +845,13 @@ private:
         return numWriteRequestsOutstanding_ == 0;
     }
 
+    bool
+    finishedWriteRequestsUpTo(std::uint64_t const group) const
+    {
+        return numWriteRequestsOutstandingPerGroup_.empty() or
+            numWriteRequestsOutstandingPerGroup_.begin()->first > group;
+    }
+
     void
     throwErrorIfNeeded(CassandraError err) const
     {
@@ -48,6 +48,12 @@ Result::hasRows() const
     return numRows() > 0;
 }
 
+[[nodiscard]] bool
+Result::hasMorePages() const
+{
+    return cass_result_has_more_pages(*this) == cass_true;
+}
+
 /* implicit */ ResultIterator::ResultIterator(CassIterator* ptr)
     : ManagedObject{ptr, resultIteratorDeleter}, hasMore_{cass_iterator_next(ptr) != 0u}
 {
@@ -29,6 +29,7 @@
 
 #include <compare>
 #include <iterator>
+#include <optional>
 #include <tuple>
 
 namespace data::cassandra::detail {
@@ -36,6 +37,12 @@ namespace data::cassandra::detail {
 template <typename>
 static constexpr bool unsupported_v = false;
 
+template <typename>
+static constexpr bool is_optional_v = false;
+
+template <typename Type>
+static constexpr bool is_optional_v<std::optional<Type>> = true;
+
 template <typename Type>
 inline Type
 extractColumn(CassRow const* row, std::size_t idx)
@@ -54,7 +61,11 @@ extractColumn(CassRow const* row, std::size_t idx)
     using UintTupleType = std::tuple<uint32_t, uint32_t>;
     using UCharVectorType = std::vector<unsigned char>;
 
-    if constexpr (std::is_same_v<DecayedType, ripple::uint256>) {
+    // optional columns map a null cell (e.g. a column that was never written) to nullopt
+    if constexpr (is_optional_v<DecayedType>) {
+        if (cass_value_is_null(cass_row_get_column(row, idx)) == cass_false)
+            output = extractColumn<typename DecayedType::value_type>(row, idx);
+    } else if constexpr (std::is_same_v<DecayedType, ripple::uint256>) {
         cass_byte_t const* buf = nullptr;
         std::size_t bufSize = 0;
         auto const rc = cass_value_get_bytes(cass_row_get_column(row, idx), &buf, &bufSize);
@@ -110,6 +121,12 @@ struct Result : public ManagedObject<CassResult const> {
     [[nodiscard]] bool
     hasRows() const;
 
+    /**
+     * @return true if the query has more rows to fetch using the paging state of this result; false otherwise
+     */
+    [[nodiscard]] bool
+    hasMorePages() const;
+
     template <typename... RowTypes>
     std::optional<std::tuple<RowTypes...>>
     get() const
@@ -22,26 +22,104 @@
 #include "data/cassandra/Types.h"
 #include "data/cassandra/impl/Collection.h"
 #include "data/cassandra/impl/ManagedObject.h"
+#include "data/cassandra/impl/Result.h"
 #include "data/cassandra/impl/Tuple.h"
 #include "util/Expected.h"
 
 #include <cassandra.h>
 #include <fmt/core.h>
 #include <ripple/basics/base_uint.h>
+#include <ripple/basics/strHex.h>
 #include <ripple/protocol/STAccount.h>
 
+#include <algorithm>
+#include <array>
 #include <chrono>
 #include <compare>
+#include <cstdint>
 #include <iterator>
+#include <optional>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
 
 namespace data::cassandra::detail {
 
+/** @brief The label used for statements that were not created from a labelled prepared statement */
+static constexpr std::string_view UNLABELED_STATEMENT = "unlabeled";
+
+/**
+ * @brief The first value bound to a statement (usually the partition key), kept for diagnostics.
+ *
+ * Binary values are truncated to 32 bytes; formatting to a readable string only happens when printed.
+ */
+class BoundKey {
+    static constexpr std::size_t MAX_SIZE = ripple::uint256::size();
+
+    std::array<unsigned char, MAX_SIZE> bytes_{};
+    std::size_t size_ = 0u;
+    std::optional<int64_t> number_;
+
+public:
+    /**
+     * @brief Remember the given value if it's of a supported type; ignored otherwise.
+     *
+     * @param value The value that was bound
+     */
+    template <typename Type>
+    void
+    remember(Type const& value)
+    {
+        using DecayedType = std::decay_t<Type>;
+
+        auto copyBytes = [this](auto const* data, std::size_t size) {
+            size_ = std::min(size, MAX_SIZE);
+            std::copy_n(reinterpret_cast<unsigned char const*>(data), size_, bytes_.begin());
+        };
+
+        if constexpr (std::is_same_v<DecayedType, ripple::uint256> || std::is_same_v<DecayedType, ripple::AccountID> ||
+                      std::is_same_v<DecayedType, std::vector<unsigned char>>) {
+            copyBytes(value.data(), value.size());
+        } else if constexpr (std::is_convertible_v<DecayedType, std::string_view>) {
+            auto const view = std::string_view{value};
+            copyBytes(view.data(), view.size());
+        } else if constexpr (std::is_same_v<DecayedType, bool>) {
+            number_ = value ? 1 : 0;
+        } else if constexpr (std::is_integral_v<DecayedType>) {
+            number_ = static_cast<int64_t>(value);
+        }
+    }
+
+    /**
+     * @return The key in printable form (hex for binary values); empty if nothing was remembered
+     */
+    [[nodiscard]] std::string
+    toString() const
+    {
+        if (number_)
+            return std::to_string(*number_);
+        return ripple::strHex(bytes_.begin(), bytes_.begin() + size_);
+    }
+
+    friend std::ostream&
+    operator<<(std::ostream& os, BoundKey const& key)
+    {
+        return os << key.toString();
+    }
+};
+
 class Statement : public ManagedObject<CassStatement> {
     static constexpr auto deleter = [](CassStatement* ptr) { cass_statement_free(ptr); };
 
     template <typename>
     static constexpr bool unsupported_v = false;
 
+    std::string_view label_ = UNLABELED_STATEMENT;
+
+    // mutable because binding is a const operation on the statement
+    mutable BoundKey key_;
+
 public:
     /**
      * @brief Construct a new statement with optionally provided arguments.
@@ -53,17 +131,58 @@ public:
     explicit Statement(std::string_view query, Args&&... args)
         : ManagedObject{cass_statement_new(query.data(), sizeof...(args)), deleter}
     {
-        cass_statement_set_consistency(*this, CASS_CONSISTENCY_QUORUM);
         cass_statement_set_is_idempotent(*this, cass_true);
         bind<Args...>(std::forward<Args>(args)...);
     }
 
-    /* implicit */ Statement(CassStatement* ptr) : ManagedObject{ptr, deleter}
+    /* implicit */ Statement(CassStatement* ptr, std::string_view label = UNLABELED_STATEMENT)
+        : ManagedObject{ptr, deleter}, label_{label}
     {
-        cass_statement_set_consistency(*this, CASS_CONSISTENCY_QUORUM);
         cass_statement_set_is_idempotent(*this, cass_true);
     }
 
+    /**
+     * @return The label of the prepared statement this statement was bound from
+     */
+    [[nodiscard]] std::string_view
+    label() const
+    {
+        return label_;
+    }
+
+    /**
+     * @return The first value bound to this statement
+     */
+    [[nodiscard]] BoundKey const&
+    boundKey() const
+    {
+        return key_;
+    }
+
+    /**
+     * @brief Set the maximum number of rows returned by a single execution of this statement.
+     *
+     * @param pageSize The number of rows per page
+     */
+    void
+    setPageSize(std::uint32_t const pageSize) const
+    {
+        if (auto const rc = cass_statement_set_paging_size(*this, static_cast<int>(pageSize)); rc != CASS_OK)
+            throw std::logic_error(fmt::format("Set paging size: {}", cass_error_desc(rc)));
+    }
+
+    /**
+     * @brief Continue from where the given result (a page of this statement) left off on the next execution.
+     *
+     * @param result The last page fetched using this statement
+     */
+    void
+    setPagingState(Result const& result) const
+    {
+        if (auto const rc = cass_statement_set_paging_state(*this, result); rc != CASS_OK)
+            throw std::logic_error(fmt::format("Set paging state: {}", cass_error_desc(rc)));
+    }
+
     /**
      * @brief Binds the given arguments to the statement.
      *
@@ -103,6 +222,9 @@ public:
         using UintByteTupleType = std::tuple<uint32_t, ripple::uint256>;
         using ByteVectorType = std::vector<ripple::uint256>;
 
+        if (idx == 0)
+            key_.remember(value);
+
         if constexpr (std::is_same_v<DecayedType, ripple::uint256>) {
             auto const rc = bindBytes(value.data(), value.size());
             throwErrorIfNeeded(rc, "Bind ripple::uint256");
@@ -148,11 +270,33 @@ public:
 class PreparedStatement : public ManagedObject<CassPrepared const> {
     static constexpr auto deleter = [](CassPrepared const* ptr) { cass_prepared_free(ptr); };
 
+    std::string_view label_ = UNLABELED_STATEMENT;
+
 public:
     /* implicit */ PreparedStatement(CassPrepared const* ptr) : ManagedObject{ptr, deleter}
     {
     }
 
+    /**
+     * @brief Set the label used to attribute statistics of the bound statements.
+     *
+     * @param label The label to use; must be a string with static storage duration (e.g. a literal)
+     */
+    void
+    setLabel(std::string_view label)
+    {
+        label_ = label;
+    }
+
+    /**
+     * @return The label of this prepared statement
+     */
+    [[nodiscard]] std::string_view
+    label() const
+    {
+        return label_;
+    }
+
     /**
      * @brief Bind the given arguments and produce a ready to execute Statement.
      *
@@ -163,7 +307,7 @@ public:
     Statement
     bind(Args&&... args) const
     {
-        Statement statement = cass_prepared_bind(*this);
+        Statement statement{cass_prepared_bind(*this), label_};
         statement.bind<Args...>(std::forward<Args>(args)...);
         return statement;
     }
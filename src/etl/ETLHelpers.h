@@ -24,11 +24,14 @@
 
 #include <ripple/basics/base_uint.h>
 
+#include <atomic>
 #include <condition_variable>
+#include <cstddef>
 #include <mutex>
 #include <optional>
 #include <queue>
 #include <sstream>
+#include <vector>
 
 namespace etl {
 /**
@@ -85,6 +88,18 @@ public:
         return max_;
     }
 
+    /**
+     * @brief Get most recently validated sequence without waiting for one.
+     *
+     * @return Sequence of most recently validated ledger; nullopt if no ledgers are known to have been validated yet
+     */
+    std::optional<uint32_t>
+    tryGetMostRecent() const
+    {
+        std::lock_guard const lck(m_);
+        return max_;
+    }
+
     /**
      * @brief Waits for the sequence to be validated by the network.
      *
@@ -204,6 +219,118 @@ public:
     }
 };
 
+/**
+ * @brief Bounded single-producer/single-consumer queue backed by a ring buffer.
+ *
+ * Exactly one thread may push and exactly one thread may pop at any given time. Blocked calls sleep on the opposite
+ * index using atomic wait instead of a mutex and condition variable.
+ */
+template <class T>
+class SpscRingBuffer {
+    std::vector<std::optional<T>> slots_;
+
+    // head_ is only written by the consumer and tail_ only by the producer; keep them on separate cache lines
+    alignas(64) std::atomic_size_t head_ = 0;
+    alignas(64) std::atomic_size_t tail_ = 0;
+
+public:
+    /**
+     * @brief Create an instance of the ring buffer.
+     *
+     * @param capacity Maximum number of elements held at once. Pushing onto a full buffer blocks until an element is
+     * popped.
+     */
+    explicit SpscRingBuffer(std::size_t capacity) : slots_(capacity)
+    {
+        ASSERT(capacity > 0, "Ring buffer capacity must be positive");
+    }
+
+    /**
+     * @brief Push element onto the ring buffer.
+     *
+     * Note: This method will block until free space is available.
+     *
+     * @param elt Element to push. Ownership is transferred
+     */
+    void
+    push(T&& elt)
+    {
+        auto const tail = tail_.load(std::memory_order_relaxed);
+        for (auto head = head_.load(std::memory_order_acquire); tail - head == slots_.size();
+             head = head_.load(std::memory_order_acquire))
+            head_.wait(head, std::memory_order_acquire);
+
+        slots_[tail % slots_.size()].emplace(std::move(elt));
+        tail_.store(tail + 1, std::memory_order_release);
+        tail_.notify_one();
+    }
+
+    /**
+     * @brief Pop element from the ring buffer.
+     *
+     * Note: Will block until the ring buffer is non-empty.
+     *
+     * @return Element popped from the ring buffer
+     */
+    T
+    pop()
+    {
+        auto const head = head_.load(std::memory_order_relaxed);
+        for (auto tail = tail_.load(std::memory_order_acquire); tail == head;
+             tail = tail_.load(std::memory_order_acquire))
+            tail_.wait(tail, std::memory_order_acquire);
+
+        return take(head);
+    }
+
+    /**
+     * @brief Attempt to pop an element.
+     *
+     * @return Element popped from the ring buffer or empty optional if it was empty
+     */
+    std::optional<T>
+    tryPop()
+    {
+        auto const head = head_.load(std::memory_order_relaxed);
+        if (tail_.load(std::memory_order_acquire) == head)
+            return std::nullopt;
+
+        return take(head);
+    }
+
+    /**
+     * @return The number of elements currently held; exact only when called by the producer or the consumer
+     */
+    std::size_t
+    size() const
+    {
+        auto const head = head_.load(std::memory_order_acquire);
+        return tail_.load(std::memory_order_acquire) - head;
+    }
+
+    /**
+     * @return The maximum number of elements held at once
+     */
+    std::size_t
+    capacity() const
+    {
+        return slots_.size();
+    }
+
+private:
+    T
+    take(std::size_t head)
+    {
+        auto& slot = slots_[head % slots_.size()];
+        T ret = std::move(*slot);
+        slot.reset();
+
+        head_.store(head + 1, std::memory_order_release);
+        head_.notify_one();
+        return ret;
+    }
+};
+
 /**
  * @brief Parititions the uint256 keyspace into numMarkers partitions, each of equal size.
  *
@@ -20,6 +20,8 @@
 #include "etl/ETLService.h"
 
 #include "data/BackendInterface.h"
+#include "etl/HistoryPruner.h"
+#include "etl/WriterElection.h"
 #include "util/Assert.h"
 #include "util/Constants.h"
 #include "util/config/Config.h"
@@ -32,6 +34,7 @@
 #include <chrono>
 #include <cstddef>
 #include <cstdint>
+#include <functional>
 #include <memory>
 #include <optional>
 #include <stdexcept>
@@ -48,6 +51,7 @@ ETLService::runETLPipeline(uint32_t startSequence, uint32_t numExtractors)
         return {};
 
     LOG(log_.debug()) << "Starting etl pipeline";
+    state_.writeConflict = false;  // left over from the last time this process was the writer
     state_.isWriting = true;
 
     auto const rng = backend_->hardFetchLedgerRangeNoThrow();
@@ -61,16 +65,35 @@ ETLService::runETLPipeline(uint32_t startSequence, uint32_t numExtractors)
 
     auto const begin = std::chrono::system_clock::now();
     auto extractors = std::vector<std::unique_ptr<ExtractorType>>{};
-    auto pipe = DataPipeType{numExtractors, startSequence};
+    auto pipe = DataPipeType{numExtractors, startSequence, extractionQueueDepth_};
 
     for (auto i = 0u; i < numExtractors; ++i) {
         extractors.push_back(std::make_unique<ExtractorType>(
-            pipe, networkValidatedLedgers_, ledgerFetcher_, startSequence + i, finishSequence_, state_
+            pipe,
+            networkValidatedLedgers_,
+            ledgerFetcher_,
+            startSequence + i,
+            finishSequence_,
+            state_,
+            extractorFetchesInFlight_
         ));
     }
 
-    auto transformer =
-        TransformerType{pipe, backend_, ledgerLoader_, ledgerPublisher_, amendmentBlockHandler_, startSequence, state_};
+    auto renewLease = std::function<bool()>{};
+    if (writerElection_->isEnabled())
+        renewLease = [this]() { return writerElection_->renew(); };
+
+    auto transformer = TransformerType{
+        pipe,
+        backend_,
+        ledgerLoader_,
+        ledgerPublisher_,
+        amendmentBlockHandler_,
+        startSequence,
+        state_,
+        pipelinedWrites_,
+        std::move(renewLease)
+    };
     transformer.waitTillFinished();  // suspend current thread until exit condition is met
     pipe.cleanup();                  // TODO: this should probably happen automatically using destructor
 
@@ -85,6 +108,7 @@ ETLService::runETLPipeline(uint32_t startSequence, uint32_t numExtractors)
                       << ((end - begin).count()) / NANOSECONDS_PER_SECOND;
 
     state_.isWriting = false;
+    writerElection_->release();
 
     LOG(log_.debug()) << "Stopping etl pipeline";
     return lastPublishedSeq;
@@ -131,6 +155,10 @@ ETLService::monitor()
 
         if (ledger) {
             rng = backend_->hardFetchLedgerRangeNoThrow();
+
+            // a download resumed after a restart only put the objects written since then into the cache
+            if (rng and not backend_->cache().isFull())
+                cacheLoader_.load(rng->maxSequence);
         } else {
             LOG(log_.error()) << "Failed to load initial ledger. Exiting monitor loop";
             return;
@@ -160,6 +188,20 @@ ETLService::publishNextSequence(uint32_t nextSequence)
     if (auto rng = backend_->hardFetchLedgerRangeNoThrow(); rng && rng->maxSequence >= nextSequence) {
         ledgerPublisher_.publish(nextSequence, {});
         ++nextSequence;
+    } else if (writerElection_->isEnabled()) {
+        // The writer is elected by lease: take over as soon as the lease expires instead of waiting for publishing
+        // the next ledger to fail
+        if (writerElection_->tryAcquire()) {
+            LOG(log_.info()) << "Holding the writer lease. Beginning ETL at ledger " << nextSequence;
+            if (auto const lastPublished = runETLPipeline(nextSequence, extractorThreads_); lastPublished)
+                nextSequence = *lastPublished + 1;
+            LOG(log_.info()) << "Aborting ETL. Falling back to publishing";
+        } else if (networkValidatedLedgers_->waitUntilValidatedByNetwork(
+                       nextSequence, static_cast<uint32_t>(writerElection_->heartbeatInterval().count())
+                   )) {
+            // validated but not written yet; give the writer a moment before checking the database again
+            std::this_thread::sleep_for(WRITER_LEASE_POLL_INTERVAL);
+        }
     } else if (networkValidatedLedgers_->waitUntilValidatedByNetwork(nextSequence, util::MILLISECONDS_PER_SECOND)) {
         LOG(log_.info()) << "Ledger with sequence = " << nextSequence << " has been validated by the network. "
                          << "Attempting to find in database and publish";
@@ -266,7 +308,13 @@ ETLService::ETLService(
     , networkValidatedLedgers_(std::move(ledgers))
     , cacheLoader_(config, ioc, backend, backend->cache())
     , ledgerFetcher_(backend, balancer)
-    , ledgerLoader_(backend, balancer, ledgerFetcher_, state_)
+    , ledgerLoader_(
+          backend,
+          balancer,
+          ledgerFetcher_,
+          state_,
+          config.valueOr<std::uint32_t>("transaction_decode_threads", DEFAULT_TRANSACTION_DECODE_THREADS)
+      )
     , ledgerPublisher_(ioc, backend, backend->cache(), subscriptions, state_)
     , amendmentBlockHandler_(ioc, state_)
 {
@@ -274,6 +322,23 @@ ETLService::ETLService(
     finishSequence_ = config.maybeValue<uint32_t>("finish_sequence");
     state_.isReadOnly = config.valueOr("read_only", state_.isReadOnly);
     extractorThreads_ = config.valueOr<uint32_t>("extractor_threads", extractorThreads_);
+    extractorFetchesInFlight_ = config.valueOr<uint32_t>("extractor_fetches_in_flight", extractorFetchesInFlight_);
+    if (extractorFetchesInFlight_ == 0u)
+        throw std::runtime_error("extractor_fetches_in_flight must be greater than 0");
+    extractionQueueDepth_ = config.maybeValue<uint32_t>("extraction_queue_depth");
+    if (extractionQueueDepth_ == 0u)
+        throw std::runtime_error("extraction_queue_depth must be greater than 0");
+    pipelinedWrites_ = config.valueOr("pipelined_writes", pipelinedWrites_);
     txnThreshold_ = config.valueOr<size_t>("txn_threshold", txnThreshold_);
+
+    // the pruner would raise the minimum ledger while the backfill lowers it
+    if (config.contains("history_pruning.retain_ledgers") and config.contains("backfill.start_sequence"))
+        throw std::runtime_error("history_pruning.retain_ledgers and backfill.start_sequence can't be set together");
+
+    historyPruner_ = std::make_unique<HistoryPruner>(config.sectionOr("history_pruning", {}), backend_, state_);
+    writerElection_ = std::make_unique<WriterElection>(config.sectionOr("writer_lease", {}), backend_, state_);
+    backfill_ = std::make_unique<BackfillType>(
+        config.sectionOr("backfill", {}), backend_, ledgerFetcher_, ledgerLoader_, state_
+    );
 }
 }  // namespace etl
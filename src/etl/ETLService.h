@@ -21,10 +21,13 @@
 
 #include "data/BackendInterface.h"
 #include "data/LedgerCache.h"
+#include "etl/HistoryPruner.h"
 #include "etl/LoadBalancer.h"
 #include "etl/Source.h"
 #include "etl/SystemState.h"
+#include "etl/WriterElection.h"
 #include "etl/impl/AmendmentBlock.h"
+#include "etl/impl/Backfill.h"
 #include "etl/impl/CacheLoader.h"
 #include "etl/impl/ExtractionDataPipe.h"
 #include "etl/impl/Extractor.h"
@@ -39,6 +42,7 @@
 #include <grpcpp/grpcpp.h>
 #include <ripple/proto/org/xrpl/rpc/v1/xrp_ledger.grpc.pb.h>
 
+#include <chrono>
 #include <memory>
 
 struct AccountTransactionsData;
@@ -61,6 +65,8 @@ namespace etl {
  * such process is performing ETL and writing to the database. The other processes simply monitor the database for new
  * ledgers, and publish those ledgers to the various subscription streams. If a monitoring process determines that the
  * ETL writer has failed (no new ledgers written for some time), the process will attempt to become the ETL writer.
+ * Unless disabled in the `writer_lease` section of the config, the writer holds a lease in the database (see
+ * WriterElection) and a monitoring process takes over as soon as that lease expires.
  *
  * If there are multiple monitoring processes that try to become the ETL writer at the same time, one will win out, and
  * the others will fall back to monitoring/publishing. In this sense, this class dynamically transitions from monitoring
@@ -81,6 +87,10 @@ class ETLService {
     using AmendmentBlockHandlerType = etl::detail::AmendmentBlockHandler<>;
     using TransformerType =
         etl::detail::Transformer<DataPipeType, LedgerLoaderType, LedgerPublisherType, AmendmentBlockHandlerType>;
+    using BackfillType = etl::detail::Backfill<LedgerFetcherType, LedgerLoaderType>;
+
+    static constexpr std::uint32_t DEFAULT_TRANSACTION_DECODE_THREADS = 4;
+    static constexpr auto WRITER_LEASE_POLL_INTERVAL = std::chrono::milliseconds{100};
 
     util::Logger log_{"ETL"};
 
@@ -89,6 +99,9 @@ class ETLService {
     std::shared_ptr<NetworkValidatedLedgersType> networkValidatedLedgers_;
 
     std::uint32_t extractorThreads_ = 1;
+    std::uint32_t extractorFetchesInFlight_ = 1;
+    std::optional<std::uint32_t> extractionQueueDepth_;
+    bool pipelinedWrites_ = false;
     std::thread worker_;
 
     CacheLoaderType cacheLoader_;
@@ -98,6 +111,9 @@ class ETLService {
     AmendmentBlockHandlerType amendmentBlockHandler_;
 
     SystemState state_;
+    std::unique_ptr<HistoryPruner> historyPruner_;
+    std::unique_ptr<WriterElection> writerElection_;
+    std::unique_ptr<BackfillType> backfill_;
 
     size_t numMarkers_ = 2;
     std::optional<uint32_t> startSequence_;
@@ -203,9 +219,32 @@ public:
         auto last = ledgerPublisher_.getLastPublish();
         if (last.time_since_epoch().count() != 0)
             result["last_publish_age_seconds"] = std::to_string(ledgerPublisher_.lastPublishAgeSeconds());
+        result["history_pruning"] = historyPruner_->getInfo();
+        result["writer_lease"] = writerElection_->getInfo();
         return result;
     }
 
+    /**
+     * @brief Request ledger history below the given ledger to be deleted.
+     *
+     * @param minSequence The new minimum ledger to retain
+     * @return true if the request was accepted; false if this process is read-only
+     */
+    bool
+    requestHistoryPruning(std::uint32_t minSequence) const
+    {
+        return historyPruner_->request(minSequence);
+    }
+
+    /**
+     * @brief Get state of the history pruner as a JSON object
+     */
+    boost::json::object
+    getHistoryPruningInfo() const
+    {
+        return historyPruner_->getInfo();
+    }
+
     /**
      * @brief Get the etl nodes' state
      * @return the etl nodes' state, nullopt if etl nodes are not connected
@@ -0,0 +1,292 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of clio: https://github.com/XRPLF/clio
+    Copyright (c) 2023, the clio developers.
+
+    Permission to use, copy, modify, and distribute this software for any
+    purpose with or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL,  DIRECT,  INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include "etl/HistoryPruner.h"
+
+#include "data/BackendInterface.h"
+#include "data/DBHelpers.h"
+#include "etl/NFTHelpers.h"
+#include "etl/SystemState.h"
+#include "util/Assert.h"
+#include "util/config/Config.h"
+#include "util/log/Logger.h"
+#include "util/prometheus/Label.h"
+#include "util/prometheus/Prometheus.h"
+
+#include <boost/asio/spawn.hpp>
+#include <boost/json/object.hpp>
+#include <ripple/basics/base_uint.h>
+#include <ripple/beast/core/CurrentThreadName.h>
+#include <ripple/protocol/AccountID.h>
+#include <ripple/protocol/STTx.h>
+#include <ripple/protocol/Serializer.h>
+#include <ripple/protocol/TxFormats.h>
+#include <ripple/protocol/TxMeta.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <set>
+#include <stdexcept>
+#include <thread>
+#include <utility>
+
+namespace etl {
+
+HistoryPruner::HistoryPruner(
+    util::Config const& config,
+    std::shared_ptr<BackendInterface> backend,
+    SystemState const& state
+)
+    : backend_{std::move(backend)}
+    , state_{std::cref(state)}
+    , ledgersPerBatch_{config.valueOr<std::uint32_t>("ledgers_per_batch", DEFAULT_LEDGERS_PER_BATCH)}
+    , maxWriteLoad_{config.valueOr("max_write_load", DEFAULT_MAX_WRITE_LOAD)}
+    , retainLedgers_{config.maybeValue<std::uint32_t>("retain_ledgers")}
+    , prunedLedgersCounter_{PrometheusService::counterInt(
+          "etl_pruned_ledgers_total_number",
+          util::prometheus::Labels(),
+          "The total number of ledgers deleted by the history pruner"
+      )}
+{
+    if (ledgersPerBatch_ == 0)
+        throw std::runtime_error("history_pruning.ledgers_per_batch must be positive");
+
+    if (maxWriteLoad_ <= 0 or maxWriteLoad_ > 1)
+        throw std::runtime_error("history_pruning.max_write_load must be in (0, 1]");
+
+    if (retainLedgers_ and *retainLedgers_ == 0)
+        throw std::runtime_error("history_pruning.retain_ledgers must be positive");
+
+    worker_ = std::thread{[this]() { run(); }};
+}
+
+HistoryPruner::~HistoryPruner()
+{
+    {
+        std::scoped_lock const lck{mtx_};
+        isStopping_ = true;
+    }
+    cv_.notify_one();
+
+    if (worker_.joinable())
+        worker_.join();
+}
+
+bool
+HistoryPruner::request(std::uint32_t const minSequence)
+{
+    if (state_.get().isReadOnly)
+        return false;
+
+    {
+        std::scoped_lock const lck{mtx_};
+        requestedMinSequence_ = std::max(minSequence, requestedMinSequence_.value_or(0));
+        hasNewRequest_ = true;
+    }
+    cv_.notify_one();
+
+    LOG(log_.info()) << "History pruning requested below ledger " << minSequence;
+    return true;
+}
+
+bool
+HistoryPruner::pruneBatch(std::uint32_t const oldMin, std::uint32_t const newMin)
+{
+    ASSERT(newMin > oldMin, "Nothing to prune. oldMin = {}, newMin = {}", oldMin, newMin);
+
+    auto const history = data::synchronousAndRetryOnTimeout([&](auto yield) -> std::optional<PrunedHistory> {
+        // nothing is deleted if the minimum was moved concurrently
+        if (auto const range = backend_->hardFetchLedgerRange(yield); not range or range->minSequence != oldMin)
+            return std::nullopt;
+
+        return collectHistory(oldMin, newMin, yield);
+    });
+    if (not history)
+        return false;
+
+    // The rows are deleted before the range is advanced, so an interrupted batch is redone from oldMin rather than
+    // leaving rows below the minimum behind for good
+    backend_->deleteHistory(*history, DELETES_PER_CHUNK, [this]() { waitForWriteCapacity(); });
+    if (not backend_->advanceMinSequence(oldMin, newMin)) {
+        LOG(log_.error()) << "Deleted ledgers " << oldMin << " to " << newMin - 1
+                          << " but the minimum ledger was moved concurrently";
+        return false;
+    }
+
+    prunedLedgersCounter_.get() += newMin - oldMin;
+
+    LOG(log_.info()) << "Pruned ledgers " << oldMin << " to " << newMin - 1 << ": " << history->objects.size()
+                     << " objects, " << history->accounts.size() << " accounts, " << history->nfts.size() << " NFTs";
+    return true;
+}
+
+boost::json::object
+HistoryPruner::getInfo() const
+{
+    boost::json::object result;
+    result["is_pruning"] = isPruning_.load();
+    result["pruned_ledgers"] = prunedLedgersCounter_.get().value();
+
+    std::scoped_lock const lck{mtx_};
+    if (requestedMinSequence_)
+        result["requested_min_ledger"] = *requestedMinSequence_;
+    if (retainLedgers_)
+        result["retain_ledgers"] = *retainLedgers_;
+
+    return result;
+}
+
+void
+HistoryPruner::run()
+{
+    beast::setCurrentThreadName("HistoryPruner");
+    // batches only wait for their own deletes, not for the live ETL
+    backend_->isolateThreadWrites();
+
+    std::unique_lock lck{mtx_};
+    while (not isStopping_) {
+        cv_.wait_for(lck, RECHECK_INTERVAL, [this]() { return isStopping_ or hasNewRequest_; });
+        if (isStopping_)
+            break;
+
+        hasNewRequest_ = false;
+        auto const requested = requestedMinSequence_;
+
+        lck.unlock();
+        if (state_.get().isWriting)
+            pruneTo(requested);
+        lck.lock();
+    }
+}
+
+void
+HistoryPruner::pruneTo(std::optional<std::uint32_t> requestedMinSequence)
+{
+    auto const range = backend_->hardFetchLedgerRangeNoThrow();
+    if (not range)
+        return;
+
+    auto target = requestedMinSequence;
+    if (retainLedgers_ and range->maxSequence > *retainLedgers_)
+        target = std::max(target.value_or(0), range->maxSequence - *retainLedgers_ + 1);
+
+    if (not target or *target <= range->minSequence)
+        return;
+
+    // the latest ledger is never pruned
+    auto const newMin = std::min(*target, range->maxSequence);
+    auto min = range->minSequence;
+
+    isPruning_ = true;
+    while (min < newMin and not isStopping_ and not state_.get().isStopping and state_.get().isWriting) {
+        waitForWriteCapacity();
+
+        auto const batchEnd = std::min(newMin, min + ledgersPerBatch_);
+        if (not pruneBatch(min, batchEnd))
+            break;
+
+        min = batchEnd;
+    }
+    isPruning_ = false;
+
+    std::scoped_lock const lck{mtx_};
+    if (requestedMinSequence_ and *requestedMinSequence_ <= min)
+        requestedMinSequence_.reset();
+}
+
+void
+HistoryPruner::waitForWriteCapacity() const
+{
+    while (backend_->writeLoad() >= maxWriteLoad_ and not isStopping_)
+        std::this_thread::sleep_for(THROTTLE_INTERVAL);
+}
+
+PrunedHistory
+HistoryPruner::collectHistory(std::uint32_t const oldMin, std::uint32_t const newMin, boost::asio::yield_context yield)
+    const
+{
+    // Latest version of each versioned row within the batch; only older versions are deleted
+    std::map<ripple::uint256, std::uint32_t> objects;
+    std::map<ripple::uint256, std::uint32_t> successors;
+    std::map<ripple::uint256, std::uint32_t> nfts;
+    std::set<ripple::AccountID> accounts;
+    std::set<std::pair<ripple::AccountID, ripple::TxType>> accountTxTypes;
+    std::set<ripple::uint256> nftTokenIDs;
+
+    PrunedHistory history;
+    history.minSequence = newMin;
+
+    for (auto seq = oldMin; seq < newMin; ++seq) {
+        history.ledgerSequences.push_back(seq);
+        if (auto const header = backend_->fetchLedgerBySequence(seq, yield); header)
+            history.ledgerHashes.push_back(header->hash);
+
+        auto hashes = backend_->fetchAllTransactionHashesInLedger(seq, yield);
+        auto const transactions = backend_->fetchTransactions(hashes, yield);
+        for (std::size_t i = 0; i < transactions.size(); ++i) {
+            auto const& txn = transactions[i];
+            if (txn.transaction.empty())
+                continue;
+
+            ripple::SerialIter it{txn.transaction.data(), txn.transaction.size()};
+            ripple::STTx const sttx{it};
+            ripple::TxMeta txMeta{hashes[i], seq, txn.metadata};
+
+            for (auto const& account : txMeta.getAffectedAccounts()) {
+                accounts.insert(account);
+                accountTxTypes.emplace(account, sttx.getTxnType());
+            }
+
+            auto const [nftTxs, maybeNFT] = getNFTDataFromTx(txMeta, sttx);
+            for (auto const& nftTx : nftTxs)
+                nftTokenIDs.insert(nftTx.tokenID);
+
+            if (maybeNFT)
+                nfts[maybeNFT->tokenID] = seq;
+        }
+        history.transactions.emplace_back(seq, std::move(hashes));
+
+        for (auto const& object : backend_->fetchLedgerDiff(seq, yield)) {
+            if (object.blob.empty()) {
+                // A deleted object is not readable at newMin, so the deletion marker can go too. Nothing links to a
+                // deleted key anymore, so its successor rows are dead; successors of other keys are left to the TTL
+                objects[object.key] = seq + 1;
+                successors[object.key] = seq + 1;
+            } else {
+                objects[object.key] = seq;
+            }
+        }
+    }
+
+    history.objects.assign(objects.begin(), objects.end());
+    history.successors.assign(successors.begin(), successors.end());
+    history.nfts.assign(nfts.begin(), nfts.end());
+    history.accounts.assign(accounts.begin(), accounts.end());
+    history.accountTxTypes.assign(accountTxTypes.begin(), accountTxTypes.end());
+    history.nftTokenIDs.assign(nftTokenIDs.begin(), nftTokenIDs.end());
+
+    return history;
+}
+
+}  // namespace etl
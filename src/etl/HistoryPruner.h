@@ -0,0 +1,144 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of clio: https://github.com/XRPLF/clio
+    Copyright (c) 2023, the clio developers.
+
+    Permission to use, copy, modify, and distribute this software for any
+    purpose with or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL,  DIRECT,  INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#pragma once
+
+#include "data/BackendInterface.h"
+#include "data/DBHelpers.h"
+#include "etl/SystemState.h"
+#include "util/config/Config.h"
+#include "util/log/Logger.h"
+#include "util/prometheus/Prometheus.h"
+
+#include <boost/asio/spawn.hpp>
+#include <boost/json/object.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <thread>
+
+namespace etl {
+
+/**
+ * @brief Deletes ledger history below a requested minimum ledger while the server keeps serving.
+ *
+ * Pruning is requested by an admin via the prune_history command or, if `retain_ledgers` is configured, follows the
+ * latest ledger automatically. Only the ETL writer prunes. History is removed in batches of `ledgers_per_batch`
+ * ledgers: the rows are deleted first and the minimum of the stored ledger range is advanced after, so a batch that
+ * is interrupted is redone from its first ledger. Readers may see the ledgers of a batch partially deleted meanwhile.
+ * Deletes are issued in chunks of DELETES_PER_CHUNK, and a batch or chunk is only started while less than
+ * `max_write_load` of the backend's outstanding write allowance is in use, which leaves the ETL and read traffic room
+ * to breathe.
+ */
+class HistoryPruner {
+public:
+    static constexpr std::uint32_t DEFAULT_LEDGERS_PER_BATCH = 16;
+    static constexpr double DEFAULT_MAX_WRITE_LOAD = 0.25;
+    static constexpr std::size_t DELETES_PER_CHUNK = 512;
+
+private:
+    static constexpr auto RECHECK_INTERVAL = std::chrono::seconds{10};
+    static constexpr auto THROTTLE_INTERVAL = std::chrono::milliseconds{100};
+
+    util::Logger log_{"ETL"};
+
+    std::shared_ptr<BackendInterface> backend_;
+    std::reference_wrapper<SystemState const> state_;
+
+    std::uint32_t ledgersPerBatch_ = DEFAULT_LEDGERS_PER_BATCH;
+    double maxWriteLoad_ = DEFAULT_MAX_WRITE_LOAD;
+    std::optional<std::uint32_t> retainLedgers_;
+
+    std::reference_wrapper<util::prometheus::CounterInt> prunedLedgersCounter_;
+
+    mutable std::mutex mtx_;
+    std::condition_variable cv_;
+    std::optional<std::uint32_t> requestedMinSequence_;
+    bool hasNewRequest_ = false;
+    std::atomic_bool isStopping_ = false;
+    std::atomic_bool isPruning_ = false;
+
+    std::thread worker_;
+
+public:
+    /**
+     * @brief Create the pruner and start its worker thread.
+     *
+     * @param config The `history_pruning` section of the config
+     * @param backend The backend to prune
+     * @param state The ETL state; pruning only happens while this process is the ETL writer
+     */
+    HistoryPruner(util::Config const& config, std::shared_ptr<BackendInterface> backend, SystemState const& state);
+
+    /**
+     * @brief Stop pruning and join the worker thread. A batch that is in progress is finished first.
+     */
+    ~HistoryPruner();
+
+    HistoryPruner(HistoryPruner const&) = delete;
+    HistoryPruner&
+    operator=(HistoryPruner const&) = delete;
+
+    /**
+     * @brief Request history below the given ledger to be deleted.
+     *
+     * @param minSequence The new minimum ledger to retain
+     * @return true if the request was accepted; false if this process never writes to the database
+     */
+    bool
+    request(std::uint32_t minSequence);
+
+    /**
+     * @brief Prune a single batch of ledgers.
+     *
+     * @param oldMin The current minimum ledger of the database
+     * @param newMin The new minimum ledger; must be above oldMin
+     * @return true on success; false if the minimum was moved concurrently
+     */
+    bool
+    pruneBatch(std::uint32_t oldMin, std::uint32_t newMin);
+
+    /**
+     * @return The state of the pruner as a JSON object
+     */
+    boost::json::object
+    getInfo() const;
+
+private:
+    void
+    run();
+
+    void
+    pruneTo(std::optional<std::uint32_t> requestedMinSequence);
+
+    void
+    waitForWriteCapacity() const;
+
+    PrunedHistory
+    collectHistory(std::uint32_t oldMin, std::uint32_t newMin, boost::asio::yield_context yield) const;
+};
+
+}  // namespace etl
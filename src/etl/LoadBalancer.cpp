@@ -25,7 +25,10 @@
 #include "etl/ETLState.h"
 #include "etl/ProbingSource.h"
 #include "etl/Source.h"
+#include "etl/impl/AsyncData.h"
+#include "etl/impl/LedgerFetchPool.h"
 #include "util/Assert.h"
+#include "util/LedgerUtils.h"
 #include "util/Random.h"
 #include "util/log/Logger.h"
 
@@ -35,12 +38,21 @@
 #include <boost/json/object.hpp>
 #include <boost/json/value.hpp>
 #include <fmt/core.h>
+#include <grpcpp/grpcpp.h>
+#include <ripple/basics/Slice.h>
+#include <ripple/basics/strHex.h>
+#include <ripple/protocol/LedgerHeader.h>
 
 #include <algorithm>
 #include <chrono>
 #include <cstddef>
 #include <cstdint>
+#include <exception>
+#include <future>
+#include <iterator>
 #include <memory>
+#include <mutex>
+#include <numeric>
 #include <optional>
 #include <stdexcept>
 #include <string>
@@ -87,6 +99,7 @@ LoadBalancer::LoadBalancer(
     std::shared_ptr<feed::SubscriptionManager> subscriptions,
     std::shared_ptr<NetworkValidatedLedgers> validatedLedgers
 )
+    : validatedLedgers_{validatedLedgers}
 {
     static constexpr std::uint32_t MAX_DOWNLOAD = 256;
     if (auto value = config.maybeValue<uint32_t>("num_markers"); value) {
@@ -133,38 +146,93 @@ LoadBalancer::LoadBalancer(
 
     if (sources_.empty())
         checkOnETLFailure("No ETL sources configured. Please check the configuration");
+
+    setupFetching(config);
+}
+
+LoadBalancer::LoadBalancer(
+    Config const& config,
+    std::vector<std::unique_ptr<Source>> sources,
+    std::shared_ptr<NetworkValidatedLedgers> validatedLedgers
+)
+    : sources_{std::move(sources)}, validatedLedgers_{std::move(validatedLedgers)}
+{
+    setupFetching(config);
+}
+
+void
+LoadBalancer::setupFetching(Config const& config)
+{
+    if (auto value = config.maybeValue<std::size_t>("hedged_fetch_sources"); value)
+        hedgedFetchSources_ = std::clamp(*value, std::size_t{1}, std::max(sources_.size(), std::size_t{1}));
+
+    fetchPool_ = std::make_unique<detail::LedgerFetchPool>(
+        [this]() {
+            std::vector<Source*> ranked;
+            for (auto const sourceIdx : rankSources())
+                ranked.push_back(sources_[sourceIdx].get());
+            return ranked;
+        },
+        config.valueOr<std::size_t>("grpc_pollers", detail::LedgerFetchPool::DEFAULT_POLLERS),
+        config.valueOr<std::size_t>("grpc_fetches_per_source", detail::LedgerFetchPool::DEFAULT_FETCHES_PER_SOURCE)
+    );
 }
 
 LoadBalancer::~LoadBalancer()
 {
+    // the calls in flight refer to the sources
+    if (fetchPool_)
+        fetchPool_->stop();
+
     sources_.clear();
 }
 
-std::pair<std::vector<std::string>, bool>
+bool
 LoadBalancer::loadInitialLedger(uint32_t sequence, bool cacheOnly)
 {
-    std::vector<std::string> response;
-    auto const success = execute(
-        [this, &response, &sequence, cacheOnly](auto& source) {
-            auto [data, res] = source->loadInitialLedger(sequence, downloadRanges_, cacheOnly);
-
+    return execute(
+        [this, sequence, cacheOnly](auto& source) {
+            auto const res = source->loadInitialLedger(sequence, downloadRanges_, cacheOnly);
             if (!res) {
                 LOG(log_.error()) << "Failed to download initial ledger."
                                   << " Sequence = " << sequence << " source = " << source->toString();
-            } else {
-                response = std::move(data);
             }
 
             return res;
         },
         sequence
     );
-    return {std::move(response), success};
+}
+
+bool
+LoadBalancer::loadLedgerSnapshot(uint32_t sequence)
+{
+    return execute(
+        [this, sequence](auto& source) {
+            auto const res = source->loadLedgerSnapshot(sequence, downloadRanges_);
+            if (!res) {
+                LOG(log_.error()) << "Failed to download ledger snapshot."
+                                  << " Sequence = " << sequence << " source = " << source->toString();
+            }
+
+            return res;
+        },
+        sequence
+    );
 }
 
 LoadBalancer::OptionalGetLedgerResponseType
 LoadBalancer::fetchLedger(uint32_t ledgerSequence, bool getObjects, bool getObjectNeighbors)
 {
+    // only the newest ledger is worth the extra load; older ones are fetched while catching up or backfilling
+    if (auto const mostRecent = validatedLedgers_->tryGetMostRecent();
+        hedgedFetchSources_ > 1 and (not mostRecent or ledgerSequence >= *mostRecent)) {
+        if (auto response = fetchLedgerHedged(ledgerSequence, getObjects, getObjectNeighbors); response)
+            return response;
+
+        LOG(log_.warn()) << "Hedged fetch of ledger " << ledgerSequence << " failed. Trying sources one by one";
+    }
+
     GetLedgerResponseType response;
     bool const success = execute(
         [&response, ledgerSequence, getObjects, getObjectNeighbors, log = log_](auto& source) {
@@ -189,6 +257,104 @@ LoadBalancer::fetchLedger(uint32_t ledgerSequence, bool getObjects, bool getObje
     return {};
 }
 
+std::future<LoadBalancer::OptionalGetLedgerResponseType>
+LoadBalancer::fetchLedgerAsync(uint32_t ledgerSequence, bool getObjects, bool getObjectNeighbors)
+{
+    // deferred, so the newest ledger is fetched by the thread waiting for it, the same way it would be synchronously
+    if (auto const mostRecent = validatedLedgers_->tryGetMostRecent();
+        hedgedFetchSources_ > 1 and (not mostRecent or ledgerSequence >= *mostRecent)) {
+        return std::async(std::launch::deferred, [this, ledgerSequence, getObjects, getObjectNeighbors]() {
+            return fetchLedger(ledgerSequence, getObjects, getObjectNeighbors);
+        });
+    }
+
+    return fetchPool_->fetch(ledgerSequence, getObjects, getObjectNeighbors);
+}
+
+LoadBalancer::OptionalGetLedgerResponseType
+LoadBalancer::fetchLedgerHedged(uint32_t ledgerSequence, bool getObjects, bool getObjectNeighbors)
+{
+    grpc::CompletionQueue cq;
+    std::vector<std::unique_ptr<detail::AsyncLedgerFetch>> fetches;
+
+    for (auto const sourceIdx : rankSources()) {
+        if (fetches.size() == hedgedFetchSources_)
+            break;
+
+        auto& source = sources_[sourceIdx];
+        if (!source->hasLedger(ledgerSequence))
+            continue;
+
+        if (auto fetch = source->fetchLedgerAsync(ledgerSequence, getObjects, getObjectNeighbors, cq); fetch)
+            fetches.push_back(std::move(fetch));
+    }
+
+    OptionalGetLedgerResponseType result;
+    void* tag = nullptr;
+    bool ok = false;
+
+    for (auto numPending = fetches.size(); numPending > 0 && cq.Next(&tag, &ok); --numPending) {
+        ASSERT(tag != nullptr, "Tag can't be null.");
+        auto* fetch = static_cast<detail::AsyncLedgerFetch*>(tag);
+        fetch->complete();
+
+        if (result or not ok)
+            continue;
+
+        if (!fetch->status().ok()) {
+            LOG(log_.debug()) << "Hedged fetch of ledger " << ledgerSequence
+                              << " failed at a source. error_code: " << fetch->status().error_code()
+                              << ", error_msg: " << fetch->status().error_message();
+            continue;
+        }
+
+        if (acceptHedgedResponse(ledgerSequence, fetch->response())) {
+            result = std::move(fetch->response());
+            for (auto& other : fetches)
+                other->cancel();
+        }
+    }
+
+    cq.Shutdown();
+    while (cq.Next(&tag, &ok)) {
+    }
+
+    if (result) {
+        LOG(log_.info()) << "Successfully fetched ledger = " << ledgerSequence << " from the first of "
+                         << fetches.size() << " sources";
+    }
+
+    return result;
+}
+
+bool
+LoadBalancer::acceptHedgedResponse(uint32_t ledgerSequence, GetLedgerResponseType const& response)
+{
+    if (!response.validated())
+        return false;
+
+    ripple::LedgerHeader header;
+    try {
+        header = util::deserializeHeader(ripple::makeSlice(response.ledger_header()));
+    } catch (std::exception const& e) {
+        LOG(log_.warn()) << "Hedged fetch of ledger " << ledgerSequence << " returned a malformed header: " << e.what();
+        return false;
+    }
+
+    if (header.seq != ledgerSequence)
+        return false;
+
+    std::scoped_lock const lck{lastHedgedMtx_};
+    if (lastHedged_ and lastHedged_->first + 1 == ledgerSequence and lastHedged_->second != header.parentHash) {
+        LOG(log_.warn()) << "Hedged fetch of ledger " << ledgerSequence << " returned parent hash "
+                         << ripple::strHex(header.parentHash) << " instead of " << ripple::strHex(lastHedged_->second);
+        return false;
+    }
+
+    lastHedged_ = std::make_pair(header.seq, header.hash);
+    return true;
+}
+
 std::optional<boost::json::object>
 LoadBalancer::forwardToRippled(
     boost::json::object const& request,
@@ -196,18 +362,9 @@ LoadBalancer::forwardToRippled(
     boost::asio::yield_context yield
 ) const
 {
-    std::size_t sourceIdx = 0;
-    if (!sources_.empty())
-        sourceIdx = util::Random::uniform(0ul, sources_.size() - 1);
-
-    auto numAttempts = 0u;
-
-    while (numAttempts < sources_.size()) {
+    for (auto const sourceIdx : rankSources()) {
         if (auto res = sources_[sourceIdx]->forwardToRippled(request, clientIp, yield))
             return res;
-
-        sourceIdx = (sourceIdx + 1) % sources_.size();
-        ++numAttempts;
     }
 
     return {};
@@ -238,49 +395,66 @@ LoadBalancer::toJson() const
     return ret;
 }
 
+std::vector<std::size_t>
+LoadBalancer::rankSources() const
+{
+    std::vector<double> scores;
+    scores.reserve(sources_.size());
+    for (auto const& source : sources_)
+        scores.push_back(source->score());
+
+    std::vector<std::size_t> order(sources_.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(), [&scores](auto lhs, auto rhs) { return scores[lhs] < scores[rhs]; });
+
+    if (sources_.size() > 1) {
+        auto const first = util::Random::uniform(0ul, sources_.size() - 1);
+        auto second = util::Random::uniform(0ul, sources_.size() - 2);
+        if (second >= first)
+            ++second;
+
+        auto const picked = std::ranges::find(order, scores[second] < scores[first] ? second : first);
+        std::rotate(order.begin(), picked, std::next(picked));
+    }
+
+    return order;
+}
+
 template <class Func>
 bool
 LoadBalancer::execute(Func f, uint32_t ledgerSequence)
 {
-    std::size_t sourceIdx = 0;
-    if (!sources_.empty())
-        sourceIdx = util::Random::uniform(0ul, sources_.size() - 1);
-
-    auto numAttempts = 0;
-
     while (true) {
-        auto& source = sources_[sourceIdx];
-
-        LOG(log_.debug()) << "Attempting to execute func. ledger sequence = " << ledgerSequence
-                          << " - source = " << source->toString();
-        // Originally, it was (source->hasLedger(ledgerSequence) || true)
-        /* Sometimes rippled has ledger but doesn't actually know. However,
-        but this does NOT happen in the normal case and is safe to remove
-        This || true is only needed when loading full history standalone */
-        if (source->hasLedger(ledgerSequence)) {
-            bool const res = f(source);
-            if (res) {
-                LOG(log_.debug()) << "Successfully executed func at source = " << source->toString()
-                                  << " - ledger sequence = " << ledgerSequence;
-                break;
+        for (auto const sourceIdx : rankSources()) {
+            auto& source = sources_[sourceIdx];
+
+            LOG(log_.debug()) << "Attempting to execute func. ledger sequence = " << ledgerSequence
+                              << " - source = " << source->toString();
+            // Originally, it was (source->hasLedger(ledgerSequence) || true)
+            /* Sometimes rippled has ledger but doesn't actually know. However,
+            but this does NOT happen in the normal case and is safe to remove
+            This || true is only needed when loading full history standalone */
+            if (source->hasLedger(ledgerSequence)) {
+                bool const res = f(source);
+                if (res) {
+                    LOG(log_.debug()) << "Successfully executed func at source = " << source->toString()
+                                      << " - ledger sequence = " << ledgerSequence;
+                    return true;
+                }
+
+                LOG(log_.warn()) << "Failed to execute func at source = " << source->toString()
+                                 << " - ledger sequence = " << ledgerSequence;
+            } else {
+                LOG(log_.warn()) << "Ledger not present at source = " << source->toString()
+                                 << " - ledger sequence = " << ledgerSequence;
             }
-
-            LOG(log_.warn()) << "Failed to execute func at source = " << source->toString()
-                             << " - ledger sequence = " << ledgerSequence;
-        } else {
-            LOG(log_.warn()) << "Ledger not present at source = " << source->toString()
-                             << " - ledger sequence = " << ledgerSequence;
-        }
-        sourceIdx = (sourceIdx + 1) % sources_.size();
-        numAttempts++;
-        if (numAttempts % sources_.size() == 0) {
-            LOG(log_.info()) << "Ledger sequence " << ledgerSequence
-                             << " is not yet available from any configured sources. "
-                             << "Sleeping and trying again";
-            std::this_thread::sleep_for(std::chrono::seconds(2));
         }
+
+        LOG(log_.info()) << "Ledger sequence " << ledgerSequence
+                         << " is not yet available from any configured sources. "
+                         << "Sleeping and trying again";
+        std::this_thread::sleep_for(std::chrono::seconds(2));
     }
-    return true;
 }
 
 std::optional<ETLState>
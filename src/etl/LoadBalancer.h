@@ -28,13 +28,27 @@
 
 #include <boost/asio.hpp>
 #include <grpcpp/grpcpp.h>
+#include <ripple/basics/base_uint.h>
 #include <ripple/proto/org/xrpl/rpc/v1/xrp_ledger.grpc.pb.h>
 
+#include <cstddef>
+#include <cstdint>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <utility>
+#include <vector>
+
 namespace etl {
 class Source;
 class ProbingSource;
 }  // namespace etl
 
+namespace etl::detail {
+class LedgerFetchPool;
+}  // namespace etl::detail
+
 namespace feed {
 class SubscriptionManager;
 }  // namespace feed
@@ -63,6 +77,15 @@ private:
     std::uint32_t downloadRanges_ =
         DEFAULT_DOWNLOAD_RANGES; /*< The number of markers to use when downloading intial ledger */
 
+    std::shared_ptr<NetworkValidatedLedgers> validatedLedgers_;
+    std::size_t hedgedFetchSources_ = 1; /*< The number of sources the newest ledger is fetched from at once */
+
+    // the last ledger accepted from a hedged fetch; the next one must build on it
+    std::mutex lastHedgedMtx_;
+    std::optional<std::pair<std::uint32_t, ripple::uint256>> lastHedged_;
+
+    std::unique_ptr<detail::LedgerFetchPool> fetchPool_;
+
 public:
     /**
      * @brief Create an instance of the load balancer.
@@ -81,6 +104,19 @@ public:
         std::shared_ptr<NetworkValidatedLedgers> validatedLedgers
     );
 
+    /**
+     * @brief Create a load balancer over sources that were created already, e.g. for testing.
+     *
+     * @param config The configuration to use; the ETL sources configured in it are ignored
+     * @param sources The sources to balance requests over
+     * @param validatedLedgers The network validated ledgers datastructure
+     */
+    LoadBalancer(
+        util::Config const& config,
+        std::vector<std::unique_ptr<Source>> sources,
+        std::shared_ptr<NetworkValidatedLedgers> validatedLedgers
+    );
+
     /**
      * @brief A factory function for the load balancer.
      *
@@ -124,18 +160,35 @@ public:
     /**
      * @brief Load the initial ledger, writing data to the queue.
      *
+     * If a source fails halfway through, the next one resumes from the progress checkpointed by the failed one.
+     *
      * @param sequence Sequence of ledger to download
      * @param cacheOnly Whether to only write to cache and not to the DB; defaults to false
+     * @return true if the download was successful; false if the server is shutting down
      */
-    std::pair<std::vector<std::string>, bool>
+    bool
     loadInitialLedger(uint32_t sequence, bool cacheOnly = false);
 
+    /**
+     * @brief Download the full state of a ledger into the DB without touching the cache.
+     *
+     * Used to seed the state of a ledger below the current range of the DB, e.g. by the backfill.
+     *
+     * @param sequence Sequence of ledger to download
+     * @return true if the download was successful; false if the server is shutting down
+     */
+    bool
+    loadLedgerSnapshot(uint32_t sequence);
+
     /**
      * @brief Fetch data for a specific ledger.
      *
      * This function will continuously try to fetch data for the specified ledger until the fetch succeeds, the ledger
      * is found in the database, or the server is shutting down.
      *
+     * If `hedged_fetch_sources` is configured, the newest validated ledger is requested from that many sources at once
+     * and the first consistent response wins; see fetchLedgerHedged().
+     *
      * @param ledgerSequence Sequence of the ledger to fetch
      * @param getObjects Whether to get the account state diff between this ledger and the prior one
      * @param getObjectNeighbors Whether to request object neighbors
@@ -145,6 +198,22 @@ public:
     OptionalGetLedgerResponseType
     fetchLedger(uint32_t ledgerSequence, bool getObjects, bool getObjectNeighbors);
 
+    /**
+     * @brief Start fetching data for a specific ledger without waiting for it.
+     *
+     * The call is made over the asynchronous gRPC API; see detail::LedgerFetchPool. At most `grpc_fetches_per_source`
+     * calls are in flight to a single source and their completions are handled by `grpc_pollers` threads. Like
+     * fetchLedger(), the fetch is retried until it succeeds. The newest validated ledger is fetched by fetchLedger()
+     * when the future is waited on, so it is still hedged if that is configured.
+     *
+     * @param ledgerSequence Sequence of the ledger to fetch
+     * @param getObjects Whether to get the account state diff between this ledger and the prior one
+     * @param getObjectNeighbors Whether to request object neighbors
+     * @return The extracted data once it arrives; the optional will be empty if the server is shutting down
+     */
+    std::future<OptionalGetLedgerResponseType>
+    fetchLedgerAsync(uint32_t ledgerSequence, bool getObjects, bool getObjectNeighbors);
+
     /**
      * @brief Determine whether messages received on the transactions_proposed stream should be forwarded to subscribing
      * clients.
@@ -165,7 +234,7 @@ public:
     toJson() const;
 
     /**
-     * @brief Forward a JSON RPC request to a randomly selected rippled node.
+     * @brief Forward a JSON RPC request to a rippled node picked by score; see rankSources().
      *
      * @param request JSON-RPC request to forward
      * @param clientIp The IP address of the peer, if known
@@ -188,11 +257,54 @@ public:
 
 private:
     /**
-     * @brief Execute a function on a randomly selected source.
+     * @brief Set up how ledgers are fetched from the sources, which must all be added already.
+     *
+     * @param config The configuration to use
+     */
+    void
+    setupFetching(util::Config const& config);
+
+    /**
+     * @brief Request a ledger from several sources at once and take the first complete and consistent response.
+     *
+     * A response is consistent if it is validated, is for the requested ledger and, if the previous ledger was fetched
+     * this way too, its parent hash is the hash of that ledger. The calls still running are cancelled.
+     *
+     * @param ledgerSequence Sequence of the ledger to fetch
+     * @param getObjects Whether to get the account state diff between this ledger and the prior one
+     * @param getObjectNeighbors Whether to request object neighbors
+     * @return The first consistent response; nullopt if no source returned one
+     */
+    OptionalGetLedgerResponseType
+    fetchLedgerHedged(uint32_t ledgerSequence, bool getObjects, bool getObjectNeighbors);
+
+    /**
+     * @brief Check a response of a hedged fetch and remember its hash if it is accepted.
+     *
+     * @param ledgerSequence Sequence of the requested ledger
+     * @param response The response
+     * @return true if the response is consistent; false otherwise
+     */
+    bool
+    acceptHedgedResponse(uint32_t ledgerSequence, GetLedgerResponseType const& response);
+
+    /**
+     * @brief Order the sources to try a request on by their scores.
+     *
+     * The first source is the better scored of two randomly picked ones ("power of two choices"). That spreads the load
+     * over the healthy sources while a slow or lagging one is rarely tried first. The others follow from best to worst.
+     *
+     * @return Indices into the sources, in the order to try them
+     */
+    std::vector<std::size_t>
+    rankSources() const;
+
+    /**
+     * @brief Execute a function on the best source; see rankSources().
      *
      * @note f is a function that takes an Source as an argument and returns a bool.
-     * Attempt to execute f for one randomly chosen Source that has the specified ledger. If f returns false, another
-     * randomly chosen Source is used. The process repeats until f returns true.
+     * Attempt to execute f for the first ranked Source that has the specified ledger. If f returns false, the next
+     * ranked Source is used. The process repeats until f returns true, ranking the sources again after every pass.
      *
      * @param f Function to execute. This function takes the ETL source as an argument, and returns a bool
      * @param ledgerSequence f is executed for each Source that has this ledger
@@ -23,6 +23,7 @@
 #include "etl/ETLHelpers.h"
 #include "etl/LoadBalancer.h"
 #include "etl/Source.h"
+#include "etl/impl/AsyncData.h"
 #include "feed/SubscriptionManager.h"
 #include "util/config/Config.h"
 #include "util/log/Logger.h"
@@ -37,6 +38,7 @@
 
 #include <cstdint>
 #include <functional>
+#include <limits>
 #include <memory>
 #include <mutex>
 #include <optional>
@@ -97,6 +99,15 @@ ProbingSource::hasLedger(uint32_t sequence) const
     return currentSrc_->hasLedger(sequence);
 }
 
+double
+ProbingSource::score() const
+{
+    // a source that is still probing can't serve requests yet
+    if (!currentSrc_)
+        return std::numeric_limits<double>::max();
+    return currentSrc_->score();
+}
+
 boost::json::object
 ProbingSource::toJson() const
 {
@@ -129,14 +140,22 @@ ProbingSource::token() const
     return currentSrc_->token();
 }
 
-std::pair<std::vector<std::string>, bool>
+bool
 ProbingSource::loadInitialLedger(std::uint32_t sequence, std::uint32_t numMarkers, bool cacheOnly)
 {
     if (!currentSrc_)
-        return {{}, false};
+        return false;
     return currentSrc_->loadInitialLedger(sequence, numMarkers, cacheOnly);
 }
 
+bool
+ProbingSource::loadLedgerSnapshot(std::uint32_t sequence, std::uint32_t numMarkers)
+{
+    if (!currentSrc_)
+        return false;
+    return currentSrc_->loadLedgerSnapshot(sequence, numMarkers);
+}
+
 std::pair<grpc::Status, ProbingSource::GetLedgerResponseType>
 ProbingSource::fetchLedger(uint32_t sequence, bool getObjects, bool getObjectNeighbors)
 {
@@ -145,6 +164,14 @@ ProbingSource::fetchLedger(uint32_t sequence, bool getObjects, bool getObjectNei
     return currentSrc_->fetchLedger(sequence, getObjects, getObjectNeighbors);
 }
 
+std::unique_ptr<etl::detail::AsyncLedgerFetch>
+ProbingSource::fetchLedgerAsync(uint32_t sequence, bool getObjects, bool getObjectNeighbors, grpc::CompletionQueue& cq)
+{
+    if (!currentSrc_)
+        return nullptr;
+    return currentSrc_->fetchLedgerAsync(sequence, getObjects, getObjectNeighbors, cq);
+}
+
 std::optional<boost::json::object>
 ProbingSource::forwardToRippled(
     boost::json::object const& request,
@@ -92,18 +92,27 @@ public:
     bool
     hasLedger(uint32_t sequence) const override;
 
+    double
+    score() const override;
+
     boost::json::object
     toJson() const override;
 
     std::string
     toString() const override;
 
-    std::pair<std::vector<std::string>, bool>
+    bool
     loadInitialLedger(std::uint32_t sequence, std::uint32_t numMarkers, bool cacheOnly = false) override;
 
+    bool
+    loadLedgerSnapshot(std::uint32_t sequence, std::uint32_t numMarkers) override;
+
     std::pair<grpc::Status, GetLedgerResponseType>
     fetchLedger(uint32_t sequence, bool getObjects = true, bool getObjectNeighbors = false) override;
 
+    std::unique_ptr<etl::detail::AsyncLedgerFetch>
+    fetchLedgerAsync(uint32_t sequence, bool getObjects, bool getObjectNeighbors, grpc::CompletionQueue& cq) override;
+
     std::optional<boost::json::object>
     forwardToRippled(
         boost::json::object const& request,
@@ -20,10 +20,15 @@
 #pragma once
 
 #include "data/BackendInterface.h"
+#include "data/DBHelpers.h"
+#include "data/Types.h"
 #include "etl/ETLHelpers.h"
 #include "etl/LoadBalancer.h"
 #include "etl/impl/AsyncData.h"
 #include "etl/impl/ForwardCache.h"
+#include "etl/impl/ForwardingConnectionPool.h"
+#include "etl/impl/SourceScore.h"
+#include "etl/impl/StreamMessage.h"
 #include "feed/SubscriptionManager.h"
 #include "util/Assert.h"
 #include "util/config/Config.h"
@@ -40,7 +45,15 @@
 #include <grpcpp/grpcpp.h>
 #include <ripple/proto/org/xrpl/rpc/v1/xrp_ledger.grpc.pb.h>
 
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string>
 #include <utility>
+#include <vector>
 
 namespace feed {
 class SubscriptionManager;
@@ -97,6 +110,14 @@ public:
     virtual bool
     hasLedger(uint32_t sequence) const = 0;
 
+    /**
+     * @brief Rate how well this source serves requests; see etl::detail::SourceScore.
+     *
+     * @return The score; lower is better
+     */
+    virtual double
+    score() const = 0;
+
     /**
      * @brief Fetch data for a specific ledger.
      *
@@ -112,16 +133,41 @@ public:
     fetchLedger(uint32_t sequence, bool getObjects = true, bool getObjectNeighbors = false) = 0;
 
     /**
-     * @brief Download a ledger in full.
+     * @brief Start fetching data for a specific ledger without waiting for the response.
+     *
+     * @param sequence Sequence of the ledger to fetch
+     * @param getObjects Whether to get the account state diff between this ledger and the prior one
+     * @param getObjectNeighbors Whether to request object neighbors
+     * @param cq The completion queue the call completes on; the tag is the returned call
+     * @return The started call; nullptr if the source has no gRPC connection
+     */
+    virtual std::unique_ptr<etl::detail::AsyncLedgerFetch>
+    fetchLedgerAsync(uint32_t sequence, bool getObjects, bool getObjectNeighbors, grpc::CompletionQueue& cq) = 0;
+
+    /**
+     * @brief Download a ledger in full, including all successors.
+     *
+     * Unless only the cache is loaded, the progress is checkpointed to the DB. A download of the same ledger resumes
+     * from the last checkpoint, whether it runs on another source or after a restart.
      *
      * @param sequence Sequence of the ledger to download
-     * @param numMarkers Number of markers to generate for async calls
+     * @param numMarkers Number of markers to generate for async calls if there is no checkpoint to resume from
      * @param cacheOnly Only insert into cache, not the DB; defaults to false
-     * @return A std::pair of the data and a bool indicating whether the download was successfull
+     * @return true if the download was successful; false otherwise
      */
-    virtual std::pair<std::vector<std::string>, bool>
+    virtual bool
     loadInitialLedger(uint32_t sequence, std::uint32_t numMarkers, bool cacheOnly = false) = 0;
 
+    /**
+     * @brief Download the full state of a ledger into the DB, including all successors, without touching the cache.
+     *
+     * @param sequence Sequence of the ledger to download
+     * @param numMarkers Number of markers to generate for async calls
+     * @return true if the download was successful; false otherwise
+     */
+    virtual bool
+    loadLedgerSnapshot(uint32_t sequence, std::uint32_t numMarkers) = 0;
+
     /**
      * @brief Forward a request to rippled.
      *
@@ -213,6 +259,10 @@ class SourceImpl : public Source {
     etl::detail::ForwardCache forwardCache_;
     boost::uuids::uuid uuid_{};
 
+    // mutable because forwarding is a const operation on the source
+    mutable etl::detail::SourceScore score_;
+    mutable etl::detail::ForwardingConnectionPool forwardingPool_;
+
 protected:
     std::string ip_;
     size_t numFailures_ = 0;
@@ -256,6 +306,8 @@ public:
         , subscriptions_(std::move(subscriptions))
         , balancer_(balancer)
         , forwardCache_(config, ioc, *this)
+        , score_(config.valueOr<std::string>("ip", {}) + ":" + config.valueOr<std::string>("ws_port", {}))
+        , forwardingPool_(ioc, config.valueOr<std::string>("ip", {}), config.valueOr<std::string>("ws_port", {}))
         , strand_(boost::asio::make_strand(ioc))
         , timer_(strand_)
         , resolver_(strand_)
@@ -283,10 +335,13 @@ public:
                 LOG(log_.debug()) << "Exception while creating stub = " << e.what() << " . Remote = " << toString();
             }
         }
+
+        forwardCache_.start();
     }
 
     ~SourceImpl() override
     {
+        forwardCache_.stop();
         derived().close(false);
     }
 
@@ -311,71 +366,11 @@ public:
     {
         LOG(log_.trace()) << "Attempting to forward request to tx. Request = " << boost::json::serialize(request);
 
-        boost::json::object response;
-
-        namespace beast = boost::beast;
-        namespace http = boost::beast::http;
-        namespace websocket = beast::websocket;
-        namespace net = boost::asio;
-        using tcp = boost::asio::ip::tcp;
+        auto response = forwardingPool_.request(request, clientIp, yield);
+        if (response)
+            (*response)["forwarded"] = true;
 
-        try {
-            auto executor = boost::asio::get_associated_executor(yield);
-            beast::error_code ec;
-            tcp::resolver resolver{executor};
-
-            auto ws = std::make_unique<websocket::stream<beast::tcp_stream>>(executor);
-
-            auto const results = resolver.async_resolve(ip_, wsPort_, yield[ec]);
-            if (ec)
-                return {};
-
-            ws->next_layer().expires_after(std::chrono::seconds(3));
-            ws->next_layer().async_connect(results, yield[ec]);
-            if (ec)
-                return {};
-
-            // if client ip is know, change the User-Agent of the handshake and to tell rippled to charge the client
-            // IP for RPC resources. See "secure_gateway" in
-            // https://github.com/ripple/rippled/blob/develop/cfg/rippled-example.cfg
-
-            // TODO: user-agent can be clio-[version]
-            ws->set_option(websocket::stream_base::decorator([&clientIp](websocket::request_type& req) {
-                req.set(http::field::user_agent, std::string(BOOST_BEAST_VERSION_STRING) + " websocket-client-coro");
-                if (clientIp)
-                    req.set(http::field::forwarded, "for=" + *clientIp);
-            }));
-
-            ws->async_handshake(ip_, "/", yield[ec]);
-            if (ec)
-                return {};
-
-            ws->async_write(net::buffer(boost::json::serialize(request)), yield[ec]);
-            if (ec)
-                return {};
-
-            beast::flat_buffer buffer;
-            ws->async_read(buffer, yield[ec]);
-            if (ec)
-                return {};
-
-            auto begin = static_cast<char const*>(buffer.data().data());
-            auto end = begin + buffer.data().size();
-            auto parsed = boost::json::parse(std::string(begin, end));
-
-            if (!parsed.is_object()) {
-                LOG(log_.error()) << "Error parsing response: " << std::string{begin, end};
-                return {};
-            }
-
-            response = parsed.as_object();
-            response["forwarded"] = true;
-
-            return response;
-        } catch (std::exception const& e) {
-            LOG(log_.error()) << "Encountered exception : " << e.what();
-            return {};
-        }
+        return response;
     }
 
     bool
@@ -403,18 +398,17 @@ public:
         if (!stub_)
             return {{grpc::StatusCode::INTERNAL, "No Stub"}, response};
 
-        // Ledger header with txns and metadata
-        org::xrpl::rpc::v1::GetLedgerRequest request;
+        auto const request = makeGetLedgerRequest(sequence, getObjects, getObjectNeighbors);
         grpc::ClientContext context;
+        context.set_deadline(std::chrono::system_clock::now() + etl::detail::AsyncLedgerFetch::TIMEOUT);
 
-        request.mutable_ledger()->set_sequence(sequence);
-        request.set_transactions(true);
-        request.set_expand(true);
-        request.set_get_objects(getObjects);
-        request.set_get_object_neighbors(getObjectNeighbors);
-        request.set_user("ETL");
-
+        auto const start = std::chrono::steady_clock::now();
         grpc::Status const status = stub_->GetLedger(&context, request, &response);
+        if (status.ok()) {
+            score_.recordSuccess(std::chrono::steady_clock::now() - start);
+        } else {
+            score_.recordFailure();
+        }
 
         if (status.ok() && !response.is_unlimited()) {
             log_.warn(
@@ -425,6 +419,23 @@ public:
         return {status, std::move(response)};
     }
 
+    std::unique_ptr<etl::detail::AsyncLedgerFetch>
+    fetchLedgerAsync(uint32_t sequence, bool getObjects, bool getObjectNeighbors, grpc::CompletionQueue& cq) override
+    {
+        if (!stub_)
+            return nullptr;
+
+        return std::make_unique<etl::detail::AsyncLedgerFetch>(
+            *stub_, makeGetLedgerRequest(sequence, getObjects, getObjectNeighbors), cq, score_
+        );
+    }
+
+    double
+    score() const override
+    {
+        return score_.score(getLag(), std::chrono::system_clock::now() - getLastMsgTime());
+    }
+
     std::string
     toString() const override
     {
@@ -451,75 +462,44 @@ public:
             );
         }
 
+        res["health"] = score_.toJson(getLag(), std::chrono::system_clock::now() - getLastMsgTime());
+
         return res;
     }
 
-    std::pair<std::vector<std::string>, bool>
+    bool
     loadInitialLedger(std::uint32_t sequence, std::uint32_t numMarkers, bool cacheOnly = false) override
     {
-        if (!stub_)
-            return {{}, false};
-
-        grpc::CompletionQueue cq;
-        void* tag = nullptr;
-        bool ok = false;
-        std::vector<etl::detail::AsyncCallData> calls;
-        auto markers = getMarkers(numMarkers);
-
-        for (size_t i = 0; i < markers.size(); ++i) {
-            std::optional<ripple::uint256> nextMarker;
-
-            if (i + 1 < markers.size())
-                nextMarker = markers[i + 1];
+        if (cacheOnly) {
+            auto cursors = makeCursors(numMarkers);
+            if (!downloadLedgerData(sequence, cursors, etl::detail::AsyncCallData::Target::CacheOnly, false))
+                return false;
 
-            calls.emplace_back(sequence, markers[i], nextMarker);
+            LOG(log_.info()) << "Finished loadInitialLedger. cache size = " << backend_->cache().size();
+            return true;
         }
 
-        LOG(log_.debug()) << "Starting data download for ledger " << sequence << ". Using source = " << toString();
-
-        for (auto& c : calls)
-            c.call(stub_, cq);
-
-        size_t numFinished = 0;
-        bool abort = false;
-        size_t const incr = 500000;
-        size_t progress = incr;
-        std::vector<std::string> edgeKeys;
-
-        while (numFinished < calls.size() && cq.Next(&tag, &ok)) {
-            ASSERT(tag != nullptr, "Tag can't be null.");
-            auto ptr = static_cast<etl::detail::AsyncCallData*>(tag);
-
-            if (!ok) {
-                LOG(log_.error()) << "loadInitialLedger - ok is false";
-                return {{}, false};  // handle cancelled
-            }
-
-            LOG(log_.trace()) << "Marker prefix = " << ptr->getMarkerPrefix();
-
-            auto result = ptr->process(stub_, cq, *backend_, abort, cacheOnly);
-            if (result != etl::detail::AsyncCallData::CallStatus::MORE) {
-                ++numFinished;
-                LOG(log_.debug()) << "Finished a marker. "
-                                  << "Current number of finished = " << numFinished;
+        auto cursors = resumeCursors(sequence, numMarkers);
+        if (!downloadLedgerData(sequence, cursors, etl::detail::AsyncCallData::Target::CacheAndDatabase, true))
+            return false;
 
-                std::string const lastKey = ptr->getLastKey();
+        writeEdgeSuccessors(sequence, cursors);
 
-                if (!lastKey.empty())
-                    edgeKeys.push_back(ptr->getLastKey());
-            }
+        LOG(log_.info()) << "Finished loadInitialLedger. cache size = " << backend_->cache().size();
+        return true;
+    }
 
-            if (result == etl::detail::AsyncCallData::CallStatus::ERRORED)
-                abort = true;
+    bool
+    loadLedgerSnapshot(std::uint32_t sequence, std::uint32_t numMarkers) override
+    {
+        auto cursors = makeCursors(numMarkers);
+        if (!downloadLedgerData(sequence, cursors, etl::detail::AsyncCallData::Target::DatabaseOnly, false))
+            return false;
 
-            if (backend_->cache().size() > progress) {
-                LOG(log_.info()) << "Downloaded " << backend_->cache().size() << " records from rippled";
-                progress += incr;
-            }
-        }
+        writeEdgeSuccessors(sequence, cursors);
 
-        LOG(log_.info()) << "Finished loadInitialLedger. cache size = " << backend_->cache().size();
-        return {std::move(edgeKeys), !abort};
+        LOG(log_.info()) << "Finished loadLedgerSnapshot for ledger " << sequence;
+        return true;
     }
 
     std::optional<boost::json::object>
@@ -534,7 +514,15 @@ public:
             return resp;
         }
 
-        return requestFromRippled(request, clientIp, yield);
+        auto const start = std::chrono::steady_clock::now();
+        auto response = requestFromRippled(request, clientIp, yield);
+        if (response) {
+            score_.recordSuccess(std::chrono::steady_clock::now() - start);
+        } else {
+            score_.recordFailure();
+        }
+
+        return response;
     }
 
     void
@@ -654,9 +642,31 @@ public:
         setLastMsgTime();
 
         try {
-            auto const msg = boost::beast::buffers_to_string(readBuffer_.data());
+            auto msg = boost::beast::buffers_to_string(readBuffer_.data());
             readBuffer_.consume(size);
 
+            // proposed transactions, validations and manifests are published as they were received, so only what
+            // routing needs is read from them
+            auto const message = etl::detail::inspectStreamMessage(msg);
+            if (!message) {
+                LOG(log_.error()) << "Error parsing stream message: " << msg;
+                return false;
+            }
+
+            if (!message->hasResult && message->type != "ledgerClosed") {
+                if (balancer_.shouldPropagateTxnStream(this)) {
+                    auto const pubMsg = std::make_shared<std::string>(std::move(msg));
+                    if (message->hasTransaction) {
+                        subscriptions_->forwardProposedTransaction(pubMsg, message->accounts);
+                    } else if (message->type == "validationReceived") {
+                        subscriptions_->forwardValidation(pubMsg);
+                    } else if (message->type == "manifestReceived") {
+                        subscriptions_->forwardManifest(pubMsg);
+                    }
+                }
+                return true;
+            }
+
             auto const raw = boost::json::parse(msg);
             auto const response = raw.as_object();
             uint32_t ledgerIndex = 0;
@@ -673,7 +683,7 @@ public:
 
                 LOG(log_.info()) << "Received a message on ledger "
                                  << " subscription stream. Message : " << response << " - " << toString();
-            } else if (response.contains("type") && response.at("type") == "ledgerClosed") {
+            } else {
                 LOG(log_.info()) << "Received a message on ledger "
                                  << " subscription stream. Message : " << response << " - " << toString();
                 if (response.contains("ledger_index")) {
@@ -683,17 +693,7 @@ public:
                     auto const& validatedLedgers = response.at("validated_ledgers").as_string();
                     setValidatedRange({validatedLedgers.data(), validatedLedgers.size()});
                 }
-            } else {
-                if (balancer_.shouldPropagateTxnStream(this)) {
-                    if (response.contains("transaction")) {
-                        forwardCache_.freshen();
-                        subscriptions_->forwardProposedTransaction(response);
-                    } else if (response.contains("type") && response.at("type") == "validationReceived") {
-                        subscriptions_->forwardValidation(response);
-                    } else if (response.contains("type") && response.at("type") == "manifestReceived") {
-                        subscriptions_->forwardManifest(response);
-                    }
-                }
+                forwardCache_.onLedgerClosed();
             }
 
             if (ledgerIndex != 0) {
@@ -767,6 +767,22 @@ protected:
     }
 
 private:
+    static org::xrpl::rpc::v1::GetLedgerRequest
+    makeGetLedgerRequest(uint32_t sequence, bool getObjects, bool getObjectNeighbors)
+    {
+        // Ledger header with txns and metadata
+        org::xrpl::rpc::v1::GetLedgerRequest request;
+
+        request.mutable_ledger()->set_sequence(sequence);
+        request.set_transactions(true);
+        request.set_expand(true);
+        request.set_get_objects(getObjects);
+        request.set_get_object_neighbors(getObjectNeighbors);
+        request.set_user("ETL");
+
+        return request;
+    }
+
     void
     setLastMsgTime()
     {
@@ -781,6 +797,22 @@ private:
         return lastMsgTime_;
     }
 
+    std::uint32_t
+    getLag() const
+    {
+        auto const mostRecent = networkValidatedLedgers_->tryGetMostRecent();
+        if (!mostRecent)
+            return 0;
+
+        std::lock_guard const lck(mtx_);
+        if (validatedLedgers_.empty())
+            return etl::detail::SourceScore::MAX_LAG;
+
+        // the ranges are sorted and disjoint, so the last one ends at the latest ledger of the source
+        auto const latest = validatedLedgers_.back().second;
+        return latest < *mostRecent ? *mostRecent - latest : 0;
+    }
+
     void
     setValidatedRange(std::string const& range)
     {
@@ -816,6 +848,88 @@ private:
         std::lock_guard const lck(mtx_);
         return validatedLedgersRaw_;
     }
+
+    /**
+     * @brief Create cursors that cover the whole key space with nothing downloaded yet.
+     *
+     * @param numMarkers Number of markers to generate
+     * @return The cursors ordered by marker
+     */
+    static std::vector<data::InitialLoadCursor>
+    makeCursors(std::uint32_t numMarkers)
+    {
+        std::vector<data::InitialLoadCursor> cursors;
+        for (auto const& marker : getMarkers(numMarkers))
+            cursors.push_back({.marker = marker});
+
+        return cursors;
+    }
+
+    /**
+     * @brief Pick up the cursors checkpointed by a previous download of the ledger, if any.
+     *
+     * @param sequence Sequence of the ledger to download
+     * @param numMarkers Number of markers to generate if there is nothing to resume
+     * @return The cursors ordered by marker
+     */
+    std::vector<data::InitialLoadCursor>
+    resumeCursors(std::uint32_t sequence, std::uint32_t numMarkers)
+    {
+        auto progress = data::synchronousAndRetryOnTimeout([this](auto yield) {
+            return backend_->fetchInitialLoadProgress(yield);
+        });
+
+        if (!progress || progress->sequence != sequence)
+            return makeCursors(numMarkers);
+
+        auto const numDone = std::ranges::count_if(progress->cursors, [](auto const& c) { return c.isDone; });
+        LOG(log_.info()) << "Resuming download of ledger " << sequence << ". " << numDone << " of "
+                         << progress->cursors.size() << " markers are done already";
+
+        return std::move(progress->cursors);
+    }
+
+    /**
+     * @brief Link the marker ranges to each other and to the ends of the key space.
+     *
+     * Each range links its own keys while it is downloaded.
+     *
+     * @param sequence Sequence of the downloaded ledger
+     * @param cursors The cursors of the finished download
+     */
+    void
+    writeEdgeSuccessors(std::uint32_t sequence, std::vector<data::InitialLoadCursor> const& cursors)
+    {
+        auto prev = uint256ToString(data::firstKey);
+        for (auto const& cursor : cursors) {
+            if (!cursor.firstKey)
+                continue;
+
+            backend_->writeSuccessor(std::move(prev), sequence, uint256ToString(*cursor.firstKey));
+            prev = uint256ToString(*cursor.lastKey);
+        }
+        backend_->writeSuccessor(std::move(prev), sequence, uint256ToString(data::lastKey));
+    }
+
+    /**
+     * @brief Download the full state map of a ledger; see etl::detail::downloadLedgerData.
+     *
+     * @param sequence Sequence of the ledger to download
+     * @param cursors The marker ranges to download, ordered by marker
+     * @param target Where the downloaded objects go
+     * @param checkpoint Whether to write the progress to the DB
+     * @return true if all marker ranges were downloaded; false otherwise
+     */
+    bool
+    downloadLedgerData(
+        std::uint32_t sequence,
+        std::vector<data::InitialLoadCursor>& cursors,
+        etl::detail::AsyncCallData::Target target,
+        bool checkpoint
+    )
+    {
+        return etl::detail::downloadLedgerData(stub_, *backend_, sequence, cursors, target, checkpoint, toString());
+    }
 };
 
 /**
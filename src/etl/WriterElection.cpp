@@ -0,0 +1,307 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of clio: https://github.com/XRPLF/clio
+    Copyright (c) 2023, the clio developers.
+
+    Permission to use, copy, modify, and distribute this software for any
+    purpose with or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL,  DIRECT,  INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include "etl/WriterElection.h"
+
+#include "data/BackendInterface.h"
+#include "data/Types.h"
+#include "etl/SystemState.h"
+#include "util/config/Config.h"
+#include "util/log/Logger.h"
+#include "util/prometheus/Label.h"
+#include "util/prometheus/Prometheus.h"
+
+#include <boost/asio/ip/host_name.hpp>
+#include <boost/json/object.hpp>
+#include <boost/uuid/random_generator.hpp>
+#include <boost/uuid/uuid_io.hpp>
+#include <ripple/beast/core/CurrentThreadName.h>
+
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <utility>
+
+namespace etl {
+
+namespace {
+
+std::string
+makeWriterId()
+{
+    return boost::asio::ip::host_name() + "-" + boost::uuids::to_string(boost::uuids::random_generator{}());
+}
+
+}  // namespace
+
+WriterElection::WriterElection(
+    util::Config const& config,
+    std::shared_ptr<BackendInterface> backend,
+    SystemState& state
+)
+    : backend_{std::move(backend)}
+    , state_{std::ref(state)}
+    , isEnabled_{config.valueOr("enabled", true) and not state.isReadOnly}
+    , id_{config.valueOr<std::string>("id", makeWriterId())}
+    , leaseDuration_{config.valueOr<std::int64_t>("duration_ms", DEFAULT_LEASE_DURATION.count())}
+    , heartbeatInterval_{config.valueOr<std::int64_t>("heartbeat_ms", leaseDuration_.count() / 4)}
+    , progressTimeout_{config.valueOr<std::int64_t>("progress_timeout_ms", DEFAULT_PROGRESS_TIMEOUT.count())}
+    , isWriterGauge_{PrometheusService::gaugeInt(
+          "etl_writer_lease_is_writer",
+          util::prometheus::Labels({{"writer_id", id_}}),
+          "Whether this process holds the ETL writer lease"
+      )}
+    , termGauge_{PrometheusService::gaugeInt(
+          "etl_writer_lease_term",
+          util::prometheus::Labels(),
+          "The term of the ETL writer lease; increases each time another process takes over"
+      )}
+    , leaseAgeGauge_{PrometheusService::gaugeInt(
+          "etl_writer_lease_age_milliseconds",
+          util::prometheus::Labels(),
+          "Time since the ETL writer lease was last renewed, as seen by this process"
+      )}
+{
+    if (leaseDuration_.count() <= 0)
+        throw std::runtime_error("writer_lease.duration_ms must be positive");
+
+    if (heartbeatInterval_.count() <= 0 or heartbeatInterval_ >= leaseDuration_)
+        throw std::runtime_error("writer_lease.heartbeat_ms must be positive and less than writer_lease.duration_ms");
+
+    if (progressTimeout_.count() <= 0)
+        throw std::runtime_error("writer_lease.progress_timeout_ms must be positive");
+
+    if (id_.empty())
+        throw std::runtime_error("writer_lease.id must not be empty");
+
+    if (isEnabled_) {
+        LOG(log_.info()) << "Electing the ETL writer by lease as " << id_ << "; lease expires after "
+                         << leaseDuration_.count() << "ms";
+        heartbeat_ = std::thread{[this]() { run(); }};
+    }
+}
+
+WriterElection::~WriterElection()
+{
+    release();
+
+    {
+        std::scoped_lock const lck{mtx_};
+        isStopping_ = true;
+    }
+    cv_.notify_one();
+
+    if (heartbeat_.joinable())
+        heartbeat_.join();
+}
+
+bool
+WriterElection::isEnabled() const
+{
+    return isEnabled_;
+}
+
+std::chrono::milliseconds
+WriterElection::heartbeatInterval() const
+{
+    return heartbeatInterval_;
+}
+
+bool
+WriterElection::tryAcquire()
+{
+    if (not isEnabled_)
+        return false;
+
+    {
+        std::scoped_lock const lck{mtx_};
+        if (isHolder_)
+            return true;
+    }
+
+    auto const current = data::synchronousAndRetryOnTimeout([&](auto yield) {
+        return backend_->fetchWriterLease(yield);
+    });
+
+    std::scoped_lock const lck{mtx_};
+    observe(current);
+
+    auto const isFree = not current or current->writer.empty() or
+        std::chrono::steady_clock::now() - leaseSeenAt_ >= leaseDuration_;
+    if (not isFree)
+        return false;
+
+    auto const next = data::WriterLease{.writer = id_, .term = current ? current->term + 1 : 1, .heartbeat = 0};
+    if (not write(next))
+        return false;
+
+    isHolder_ = true;
+    progressAt_ = std::chrono::steady_clock::now();
+    updateMetrics();
+
+    if (current and not current->writer.empty()) {
+        LOG(log_.warn()) << "Took over the expired writer lease of " << current->writer << "; term " << next.term;
+    } else {
+        LOG(log_.info()) << "Acquired the writer lease; term " << next.term;
+    }
+    return true;
+}
+
+bool
+WriterElection::renew()
+{
+    std::scoped_lock const lck{mtx_};
+    if (not isHolder_)
+        return false;
+
+    progressAt_ = std::chrono::steady_clock::now();
+    return extend();
+}
+
+void
+WriterElection::release()
+{
+    std::scoped_lock const lck{mtx_};
+    giveUp();
+}
+
+boost::json::object
+WriterElection::getInfo() const
+{
+    boost::json::object result;
+    result["enabled"] = isEnabled_;
+    result["id"] = id_;
+
+    std::scoped_lock const lck{mtx_};
+    result["is_writer"] = isHolder_;
+    if (lease_) {
+        result["writer"] = lease_->writer;
+        result["term"] = lease_->term;
+        result["age_ms"] =
+            std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - leaseSeenAt_)
+                .count();
+    }
+
+    return result;
+}
+
+void
+WriterElection::run()
+{
+    beast::setCurrentThreadName("WriterElection");
+
+    std::unique_lock lck{mtx_};
+    while (not isStopping_) {
+        cv_.wait_for(lck, heartbeatInterval_, [this]() { return isStopping_; });
+        if (isStopping_)
+            break;
+
+        if (isHolder_) {
+            if (std::chrono::steady_clock::now() - progressAt_ < progressTimeout_) {
+                extend();
+                continue;
+            }
+
+            // The ETL of this process is stuck; let a standby take over instead of holding the lease forever
+            LOG(log_.warn()) << "No ledger committed for " << progressTimeout_.count() << "ms. Giving up the lease";
+            state_.get().writeConflict = true;
+            giveUp();
+            continue;
+        }
+
+        // Standbys keep watching so that the age of the lease is known when they try to take over
+        lck.unlock();
+        auto const current = data::synchronousAndRetryOnTimeout([&](auto yield) {
+            return backend_->fetchWriterLease(yield);
+        });
+        lck.lock();
+
+        if (not isHolder_)
+            observe(current);
+        updateMetrics();
+    }
+}
+
+bool
+WriterElection::extend()
+{
+    auto next = *lease_;
+    ++next.heartbeat;
+    if (write(next))
+        return true;
+
+    // The lease only changes under our feet if another process decided it expired and took over
+    isHolder_ = false;
+    state_.get().writeConflict = true;
+    updateMetrics();
+
+    LOG(log_.warn()) << "Lost the writer lease of term " << lease_->term << " to another process";
+    return false;
+}
+
+void
+WriterElection::giveUp()
+{
+    if (not isHolder_)
+        return;
+
+    isHolder_ = false;
+    if (write(data::WriterLease{.writer = "", .term = lease_->term, .heartbeat = lease_->heartbeat + 1})) {
+        LOG(log_.info()) << "Released the writer lease of term " << lease_->term;
+    }
+
+    updateMetrics();
+}
+
+void
+WriterElection::observe(std::optional<data::WriterLease> const& lease)
+{
+    if (lease == lease_)
+        return;
+
+    lease_ = lease;
+    leaseSeenAt_ = std::chrono::steady_clock::now();
+}
+
+bool
+WriterElection::write(data::WriterLease const& lease)
+{
+    if (not backend_->updateWriterLease(lease_, lease))
+        return false;
+
+    observe(lease);
+    return true;
+}
+
+void
+WriterElection::updateMetrics()
+{
+    isWriterGauge_.get().set(isHolder_ ? 1 : 0);
+    termGauge_.get().set(lease_ ? static_cast<std::int64_t>(lease_->term) : 0);
+    leaseAgeGauge_.get().set(
+        std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - leaseSeenAt_).count()
+    );
+}
+
+}  // namespace etl
@@ -0,0 +1,173 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of clio: https://github.com/XRPLF/clio
+    Copyright (c) 2023, the clio developers.
+
+    Permission to use, copy, modify, and distribute this software for any
+    purpose with or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL,  DIRECT,  INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#pragma once
+
+#include "data/BackendInterface.h"
+#include "data/Types.h"
+#include "etl/SystemState.h"
+#include "util/config/Config.h"
+#include "util/log/Logger.h"
+#include "util/prometheus/Prometheus.h"
+
+#include <boost/json/object.hpp>
+
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+
+namespace etl {
+
+/**
+ * @brief Elects the ETL writer among the processes sharing a database, using a lease stored in the database.
+ *
+ * The writer renews the lease with a lightweight transaction every `heartbeat_ms` and before it commits a ledger. If
+ * a renewal fails, another process took the lease over and the writer stops at once. The other processes watch the
+ * lease and take it over as soon as it was not renewed for `duration_ms`. Expiry is measured on the local steady clock
+ * from when a process last saw the lease change, so the clocks of the processes do not have to agree. A writer that
+ * stops writing releases the lease, so it can be taken over right away.
+ *
+ * The heartbeat only keeps the lease while the writer makes progress: if no ledger was committed for
+ * `progress_timeout_ms`, the writer releases the lease and stops, so a wedged writer can't hold up the cluster.
+ *
+ * Read-only processes never take part.
+ */
+class WriterElection {
+public:
+    static constexpr auto DEFAULT_LEASE_DURATION = std::chrono::milliseconds{2000};
+    static constexpr auto DEFAULT_PROGRESS_TIMEOUT = std::chrono::milliseconds{10000};
+
+private:
+    util::Logger log_{"ETL"};
+
+    std::shared_ptr<BackendInterface> backend_;
+    std::reference_wrapper<SystemState> state_;
+
+    bool isEnabled_ = true;
+    std::string id_;
+    std::chrono::milliseconds leaseDuration_ = DEFAULT_LEASE_DURATION;
+    std::chrono::milliseconds heartbeatInterval_ = DEFAULT_LEASE_DURATION / 4;
+    std::chrono::milliseconds progressTimeout_ = DEFAULT_PROGRESS_TIMEOUT;
+
+    std::reference_wrapper<util::prometheus::GaugeInt> isWriterGauge_;
+    std::reference_wrapper<util::prometheus::GaugeInt> termGauge_;
+    std::reference_wrapper<util::prometheus::GaugeInt> leaseAgeGauge_;
+
+    mutable std::mutex mtx_;
+    std::condition_variable cv_;
+    std::optional<data::WriterLease> lease_;                 // as last seen in or written to the database
+    std::chrono::steady_clock::time_point leaseSeenAt_ = std::chrono::steady_clock::now();  // when lease_ changed
+    bool isHolder_ = false;
+    std::chrono::steady_clock::time_point progressAt_;  // when the lease was acquired or last renewed for a ledger
+    bool isStopping_ = false;
+
+    std::thread heartbeat_;
+
+public:
+    /**
+     * @brief Create the election and start watching or renewing the lease.
+     *
+     * @param config The `writer_lease` section of the config
+     * @param backend The backend storing the lease
+     * @param state The ETL state; the write conflict flag is raised when the lease is lost
+     * @throws std::runtime_error if the config is invalid
+     */
+    WriterElection(util::Config const& config, std::shared_ptr<BackendInterface> backend, SystemState& state);
+
+    /**
+     * @brief Release the lease if held and stop.
+     */
+    ~WriterElection();
+
+    WriterElection(WriterElection const&) = delete;
+    WriterElection&
+    operator=(WriterElection const&) = delete;
+
+    /**
+     * @return true if the writer is elected by lease; false if processes take over after failing to publish instead
+     */
+    bool
+    isEnabled() const;
+
+    /**
+     * @return How often the lease is renewed by the writer and checked by the other processes
+     */
+    std::chrono::milliseconds
+    heartbeatInterval() const;
+
+    /**
+     * @brief Take the lease over if it is free or expired.
+     *
+     * @return true if this process holds the lease; false otherwise
+     */
+    bool
+    tryAcquire();
+
+    /**
+     * @brief Renew the lease held by this process before committing a ledger. Raises the write conflict flag if the
+     * lease was taken over.
+     *
+     * @return true if the lease is still held; false otherwise
+     */
+    bool
+    renew();
+
+    /**
+     * @brief Give up the lease, if held, so another process can take over without waiting for it to expire.
+     */
+    void
+    release();
+
+    /**
+     * @return The state of the lease as a JSON object
+     */
+    boost::json::object
+    getInfo() const;
+
+private:
+    void
+    run();
+
+    /** @brief Must be called under mtx_. */
+    bool
+    extend();
+
+    /** @brief Must be called under mtx_. */
+    void
+    giveUp();
+
+    /** @brief Must be called under mtx_. */
+    void
+    observe(std::optional<data::WriterLease> const& lease);
+
+    /** @brief Must be called under mtx_. */
+    bool
+    write(data::WriterLease const& lease);
+
+    /** @brief Must be called under mtx_. */
+    void
+    updateMetrics();
+};
+
+}  // namespace etl
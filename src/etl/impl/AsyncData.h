@@ -20,13 +20,25 @@
 #pragma once
 
 #include "data/BackendInterface.h"
+#include "data/DBHelpers.h"
+#include "data/Types.h"
 #include "etl/NFTHelpers.h"
+#include "etl/impl/SourceScore.h"
 #include "util/Assert.h"
 #include "util/log/Logger.h"
 
 #include <grpcpp/grpcpp.h>
 #include <ripple/proto/org/xrpl/rpc/v1/xrp_ledger.grpc.pb.h>
 
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
 namespace etl::detail {
 
 class AsyncCallData {
@@ -41,9 +53,17 @@ class AsyncCallData {
     grpc::Status status_;
     unsigned char nextPrefix_;
 
+    std::string firstKey_;
     std::string lastKey_;
 
 public:
+    /**
+     * @brief Where the downloaded objects go.
+     *
+     * DatabaseOnly writes a snapshot below the range of the DB.
+     */
+    enum class Target { CacheAndDatabase, CacheOnly, DatabaseOnly };
+
     AsyncCallData(uint32_t seq, ripple::uint256 const& marker, std::optional<ripple::uint256> const& nextMarker)
     {
         request_.mutable_ledger()->set_sequence(seq);
@@ -73,6 +93,22 @@ public:
         context_ = std::make_unique<grpc::ClientContext>();
     }
 
+    /**
+     * @brief Create a call that resumes the download of a marker range where a previous call left off.
+     *
+     * @param seq The sequence of the ledger to download
+     * @param cursor How far the previous call got
+     * @param nextMarker The marker of the next range; nullopt for the last range
+     */
+    AsyncCallData(uint32_t seq, data::InitialLoadCursor const& cursor, std::optional<ripple::uint256> const& nextMarker)
+        : AsyncCallData(seq, cursor.lastKey.value_or(cursor.marker), nextMarker)
+    {
+        if (cursor.firstKey)
+            firstKey_ = uint256ToString(*cursor.firstKey);
+        if (cursor.lastKey)
+            lastKey_ = uint256ToString(*cursor.lastKey);
+    }
+
     enum class CallStatus { MORE, DONE, ERRORED };
 
     CallStatus
@@ -81,7 +117,7 @@ public:
         grpc::CompletionQueue& cq,
         BackendInterface& backend,
         bool abort,
-        bool cacheOnly = false
+        Target target = Target::CacheAndDatabase
     )
     {
         LOG(log_.trace()) << "Processing response. "
@@ -101,17 +137,7 @@ public:
         }
 
         std::swap(cur_, next_);
-
-        bool more = true;
-
-        // if no marker returned, we are done
-        if (cur_->marker().empty())
-            more = false;
-
-        // if returned marker is greater than our end, we are done
-        unsigned char const prefix = cur_->marker()[0];
-        if (nextPrefix_ != 0x00 && prefix >= nextPrefix_)
-            more = false;
+        bool const more = hasMore();
 
         // if we are not done, make the next async call
         if (more) {
@@ -119,34 +145,29 @@ public:
             call(stub, cq);
         }
 
-        auto const numObjects = cur_->ledger_objects().objects_size();
-        LOG(log_.debug()) << "Writing " << numObjects << " objects";
-
-        std::vector<data::LedgerObject> cacheUpdates;
-        cacheUpdates.reserve(numObjects);
+        write(backend, more, target);
+        return more ? CallStatus::MORE : CallStatus::DONE;
+    }
 
-        for (int i = 0; i < numObjects; ++i) {
-            auto& obj = *(cur_->mutable_ledger_objects()->mutable_objects(i));
-            if (!more && nextPrefix_ != 0x00) {
-                if (static_cast<unsigned char>(obj.key()[0]) >= nextPrefix_)
-                    continue;
-            }
-            cacheUpdates.push_back(
-                {*ripple::uint256::fromVoidChecked(obj.key()), {obj.mutable_data()->begin(), obj.mutable_data()->end()}}
-            );
-            if (!cacheOnly) {
-                if (!lastKey_.empty())
-                    backend.writeSuccessor(std::move(lastKey_), request_.ledger().sequence(), std::string{obj.key()});
-                lastKey_ = obj.key();
-                backend.writeNFTs(getNFTDataFromObj(request_.ledger().sequence(), obj.key(), obj.data()));
-                backend.writeLedgerObject(
-                    std::move(*obj.mutable_key()), request_.ledger().sequence(), std::move(*obj.mutable_data())
-                );
-            }
-        }
-        backend.cache().update(cacheUpdates, request_.ledger().sequence(), cacheOnly);
-        LOG(log_.debug()) << "Wrote " << numObjects << " objects. Got more: " << (more ? "YES" : "NO");
+    /**
+     * @brief Process a page that was received earlier, e.g. read from a recording, instead of calling the source.
+     *
+     * @param page The response to a call for this range, or for where the previous page left off
+     * @param backend The backend to write to
+     * @param target Where the objects go
+     * @return MORE if the range continues after the page; DONE otherwise
+     */
+    CallStatus
+    processRecorded(
+        org::xrpl::rpc::v1::GetLedgerDataResponse page,
+        BackendInterface& backend,
+        Target target = Target::CacheAndDatabase
+    )
+    {
+        *cur_ = std::move(page);
+        bool const more = hasMore();
 
+        write(backend, more, target);
         return more ? CallStatus::MORE : CallStatus::DONE;
     }
 
@@ -173,11 +194,314 @@ public:
         return ripple::strHex(std::string{next_->marker().data()[0]});
     }
 
+    std::string
+    getFirstKey()
+    {
+        return firstKey_;
+    }
+
     std::string
     getLastKey()
     {
         return lastKey_;
     }
+
+private:
+    bool
+    hasMore() const
+    {
+        // if no marker returned, we are done
+        if (cur_->marker().empty())
+            return false;
+
+        // if returned marker is greater than our end, we are done
+        unsigned char const prefix = cur_->marker()[0];
+        return nextPrefix_ == 0x00 || prefix < nextPrefix_;
+    }
+
+    void
+    write(BackendInterface& backend, bool more, Target target)
+    {
+        auto const numObjects = cur_->ledger_objects().objects_size();
+        LOG(log_.debug()) << "Writing " << numObjects << " objects";
+
+        auto const sequence = request_.ledger().sequence();
+        std::vector<data::LedgerObject> cacheUpdates;
+        if (target != Target::DatabaseOnly)
+            cacheUpdates.reserve(numObjects);
+
+        for (int i = 0; i < numObjects; ++i) {
+            auto& obj = *(cur_->mutable_ledger_objects()->mutable_objects(i));
+            if (!more && nextPrefix_ != 0x00) {
+                if (static_cast<unsigned char>(obj.key()[0]) >= nextPrefix_)
+                    continue;
+            }
+            // a resumed call starts at the last key that was written already
+            if (!lastKey_.empty() && obj.key() <= lastKey_)
+                continue;
+            if (target != Target::DatabaseOnly) {
+                cacheUpdates.push_back(
+                    {*ripple::uint256::fromVoidChecked(obj.key()),
+                     {obj.mutable_data()->begin(), obj.mutable_data()->end()}}
+                );
+            }
+            if (target != Target::CacheOnly) {
+                writeBookBaseSuccessor(backend, sequence, obj.key(), obj.data());
+                if (firstKey_.empty())
+                    firstKey_ = obj.key();
+                if (!lastKey_.empty())
+                    backend.writeSuccessor(std::move(lastKey_), sequence, std::string{obj.key()});
+                lastKey_ = obj.key();
+                backend.writeNFTs(getNFTDataFromObj(sequence, obj.key(), obj.data()));
+                if (target == Target::DatabaseOnly) {
+                    backend.writeSnapshotObject(
+                        std::move(*obj.mutable_key()), sequence, std::move(*obj.mutable_data())
+                    );
+                } else {
+                    backend.writeLedgerObject(std::move(*obj.mutable_key()), sequence, std::move(*obj.mutable_data()));
+                }
+            }
+        }
+        if (target != Target::DatabaseOnly)
+            backend.cache().update(cacheUpdates, sequence, target == Target::CacheOnly);
+        LOG(log_.debug()) << "Wrote " << numObjects << " objects. Got more: " << (more ? "YES" : "NO");
+    }
+
+    /**
+     * @brief Point the book base of a book directory at the directory if it is the first one of its book.
+     *
+     * Keys arrive in order and markers only split at the first byte of a key, which a book directory shares with its
+     * book base. So the directory is the first of its book if it is the first key of this call or the key before it
+     * is below the book base.
+     */
+    void
+    writeBookBaseSuccessor(
+        BackendInterface& backend,
+        uint32_t sequence,
+        std::string const& key,
+        std::string const& blob
+    ) const
+    {
+        auto const uintKey = ripple::uint256::fromVoid(key.data());
+        if (!isBookDir(uintKey, blob))
+            return;
+
+        auto const base = getBookBase(uintKey);
+        if (lastKey_.empty() || ripple::uint256::fromVoid(lastKey_.data()) < base)
+            backend.writeSuccessor(uint256ToString(base), sequence, std::string{key});
+    }
+};
+
+/** @brief How often the progress of a checkpointed ledger download is written to the DB */
+static constexpr auto INITIAL_LOAD_CHECKPOINT_INTERVAL = std::chrono::seconds{30};
+
+/**
+ * @brief Download the full state map of a ledger, streaming each unfinished marker range in its own async call.
+ *
+ * The cursors are updated with the progress of the calls whether or not the download succeeds. If checkpointing, they
+ * are also written to the DB periodically and when the download fails, so another source or a restart can resume
+ * where this one stopped.
+ *
+ * @param stub The stub of the source to download from; nothing is downloaded without one
+ * @param backend The backend to write to
+ * @param sequence Sequence of the ledger to download
+ * @param cursors The marker ranges to download, ordered by marker
+ * @param target Where the downloaded objects go
+ * @param checkpoint Whether to write the progress to the DB
+ * @param sourceName Name of the source, for logging
+ * @return true if all marker ranges were downloaded; false otherwise
+ */
+inline bool
+downloadLedgerData(
+    std::unique_ptr<org::xrpl::rpc::v1::XRPLedgerAPIService::Stub>& stub,
+    BackendInterface& backend,
+    std::uint32_t sequence,
+    std::vector<data::InitialLoadCursor>& cursors,
+    AsyncCallData::Target target,
+    bool checkpoint,
+    std::string const& sourceName
+)
+{
+    static util::Logger const log{"ETL"};
+
+    if (!stub)
+        return false;
+
+    grpc::CompletionQueue cq;
+    void* tag = nullptr;
+    bool ok = false;
+    std::vector<AsyncCallData> calls;
+    std::vector<std::size_t> cursorIndices;
+
+    for (size_t i = 0; i < cursors.size(); ++i) {
+        if (cursors[i].isDone)
+            continue;
+
+        std::optional<ripple::uint256> nextMarker;
+        if (i + 1 < cursors.size())
+            nextMarker = cursors[i + 1].marker;
+
+        calls.emplace_back(sequence, cursors[i], nextMarker);
+        cursorIndices.push_back(i);
+    }
+
+    auto const updateCursors = [&]() {
+        for (size_t i = 0; i < calls.size(); ++i) {
+            auto& cursor = cursors[cursorIndices[i]];
+            if (auto const firstKey = calls[i].getFirstKey(); !firstKey.empty())
+                cursor.firstKey = ripple::uint256::fromVoid(firstKey.data());
+            if (auto const lastKey = calls[i].getLastKey(); !lastKey.empty())
+                cursor.lastKey = ripple::uint256::fromVoid(lastKey.data());
+        }
+
+        if (checkpoint)
+            backend.writeInitialLoadProgress({.sequence = sequence, .cursors = cursors});
+    };
+
+    // record the sequence before anything is written, so a restart never mixes the state of two ledgers
+    if (checkpoint)
+        updateCursors();
+
+    LOG(log.debug()) << "Starting data download for ledger " << sequence << ". Using source = " << sourceName
+                     << ". Markers left = " << calls.size();
+
+    for (auto& c : calls)
+        c.call(stub, cq);
+
+    size_t numFinished = 0;
+    bool abort = false;
+    size_t const incr = 500000;
+    size_t progress = incr;
+    auto lastCheckpoint = std::chrono::steady_clock::now();
+
+    while (numFinished < calls.size() && cq.Next(&tag, &ok)) {
+        ASSERT(tag != nullptr, "Tag can't be null.");
+        auto ptr = static_cast<AsyncCallData*>(tag);
+
+        if (!ok) {
+            LOG(log.error()) << "downloadLedgerData - ok is false";
+            updateCursors();
+            return false;  // handle cancelled
+        }
+
+        LOG(log.trace()) << "Marker prefix = " << ptr->getMarkerPrefix();
+
+        auto result = ptr->process(stub, cq, backend, abort, target);
+        if (result != AsyncCallData::CallStatus::MORE) {
+            ++numFinished;
+            LOG(log.debug()) << "Finished a marker. "
+                             << "Current number of finished = " << numFinished;
+        }
+
+        if (result == AsyncCallData::CallStatus::DONE)
+            cursors[cursorIndices[static_cast<std::size_t>(ptr - calls.data())]].isDone = true;
+
+        if (result == AsyncCallData::CallStatus::ERRORED)
+            abort = true;
+
+        if (backend.cache().size() > progress) {
+            LOG(log.info()) << "Downloaded " << backend.cache().size() << " records from rippled";
+            progress += incr;
+        }
+
+        if (checkpoint && std::chrono::steady_clock::now() - lastCheckpoint > INITIAL_LOAD_CHECKPOINT_INTERVAL) {
+            updateCursors();
+            lastCheckpoint = std::chrono::steady_clock::now();
+        }
+    }
+
+    updateCursors();
+    return !abort;
+}
+
+/**
+ * @brief A GetLedger call to a single source that completes on a completion queue.
+ *
+ * Used to fetch a ledger from several sources at once. The call itself is the tag it completes with.
+ */
+class AsyncLedgerFetch {
+public:
+    /** @brief How long a call may take before it fails with DEADLINE_EXCEEDED */
+    static constexpr auto TIMEOUT = std::chrono::seconds{30};
+
+private:
+    std::reference_wrapper<SourceScore> score_;
+    std::chrono::steady_clock::time_point start_ = std::chrono::steady_clock::now();
+
+    grpc::ClientContext context_;
+    grpc::Status status_;
+    org::xrpl::rpc::v1::GetLedgerResponse response_;
+    std::unique_ptr<grpc::ClientAsyncResponseReader<org::xrpl::rpc::v1::GetLedgerResponse>> reader_;
+    bool isCancelled_ = false;
+
+public:
+    /**
+     * @brief Start the call.
+     *
+     * @param stub The stub of the source to call
+     * @param request The request to send
+     * @param cq The completion queue the call completes on
+     * @param score The score of the source, which the outcome of the call is recorded in
+     */
+    AsyncLedgerFetch(
+        org::xrpl::rpc::v1::XRPLedgerAPIService::Stub& stub,
+        org::xrpl::rpc::v1::GetLedgerRequest const& request,
+        grpc::CompletionQueue& cq,
+        SourceScore& score
+    )
+        : score_{score}
+    {
+        context_.set_deadline(std::chrono::system_clock::now() + TIMEOUT);
+        reader_ = stub.PrepareAsyncGetLedger(&context_, request, &cq);
+        reader_->StartCall();
+        reader_->Finish(&response_, &status_, this);
+    }
+
+    AsyncLedgerFetch(AsyncLedgerFetch const&) = delete;
+    AsyncLedgerFetch&
+    operator=(AsyncLedgerFetch const&) = delete;
+
+    /**
+     * @brief Cancel the call if it did not complete yet. It still completes on the completion queue.
+     */
+    void
+    cancel()
+    {
+        isCancelled_ = true;
+        context_.TryCancel();
+    }
+
+    /**
+     * @brief Record the outcome of the call in the score of the source, unless it was cancelled.
+     *
+     * Must only be called once the completion queue returned the call.
+     */
+    void
+    complete()
+    {
+        if (isCancelled_)
+            return;
+
+        if (status_.ok()) {
+            score_.get().recordSuccess(std::chrono::steady_clock::now() - start_);
+        } else {
+            score_.get().recordFailure();
+        }
+    }
+
+    /** @return The status of the completed call */
+    grpc::Status const&
+    status() const
+    {
+        return status_;
+    }
+
+    /** @return The response of the completed call */
+    org::xrpl::rpc::v1::GetLedgerResponse&
+    response()
+    {
+        return response_;
+    }
 };
 
 }  // namespace etl::detail
@@ -0,0 +1,400 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of clio: https://github.com/XRPLF/clio
+    Copyright (c) 2023, the clio developers.
+
+    Permission to use, copy, modify, and distribute this software for any
+    purpose with or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL,  DIRECT,  INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#pragma once
+
+#include "data/BackendInterface.h"
+#include "data/Types.h"
+#include "etl/SystemState.h"
+#include "util/config/Config.h"
+#include "util/log/Logger.h"
+#include "util/prometheus/Label.h"
+#include "util/prometheus/Prometheus.h"
+
+#include <ripple/beast/core/CurrentThreadName.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <stdexcept>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace etl::detail {
+
+/**
+ * @brief Fills in the ledger history below the range of the DB, running several ETL pipelines in parallel.
+ *
+ * The history from `start_sequence` up to the minimum ledger of the DB is split into chunks of `chunk_size` ledgers,
+ * aligned to multiples of the chunk size so that they are the same after a restart. Each of the `pipelines` threads
+ * takes the next chunk from the top down, writes a full snapshot of its first ledger and the diffs of all others.
+ * Finished chunks are recorded in the DB, so a restart only redoes the chunks that were in progress. The minimum of the
+ * ledger range is extended over the finished chunks once they are contiguous with it, so readers never see a gap.
+ *
+ * Backfilling writes a lot; a ledger is only started while less than `max_write_load` of the backend's outstanding
+ * write allowance is in use, which leaves room to the live ETL.
+ *
+ * Only the ETL writer backfills, so the processes sharing a DB do not all download the same chunks. A process that
+ * stops being the writer drops the chunks in progress and plans again from the DB once it writes again.
+ */
+template <typename LedgerFetcherType, typename LedgerLoaderType>
+class Backfill {
+public:
+    static constexpr std::uint32_t DEFAULT_CHUNK_SIZE = 10000;
+    static constexpr std::uint32_t DEFAULT_PIPELINES = 4;
+    static constexpr double DEFAULT_MAX_WRITE_LOAD = 0.5;
+
+private:
+    static constexpr auto RECHECK_INTERVAL = std::chrono::seconds{10};
+    static constexpr auto THROTTLE_INTERVAL = std::chrono::milliseconds{100};
+
+    struct Chunk {
+        data::LedgerRange ledgers;
+        bool isDone = false;
+    };
+
+    util::Logger log_{"ETL"};
+
+    std::shared_ptr<BackendInterface> backend_;
+    std::reference_wrapper<LedgerFetcherType> fetcher_;
+    std::reference_wrapper<LedgerLoaderType> loader_;
+    std::reference_wrapper<SystemState const> state_;
+
+    std::optional<std::uint32_t> startSequence_;
+    std::uint32_t chunkSize_ = DEFAULT_CHUNK_SIZE;
+    std::uint32_t numPipelines_ = DEFAULT_PIPELINES;
+    double maxWriteLoad_ = DEFAULT_MAX_WRITE_LOAD;
+
+    std::reference_wrapper<util::prometheus::CounterInt> backfilledLedgersCounter_;
+
+    std::mutex mtx_;
+    std::condition_variable cv_;
+    std::vector<Chunk> chunks_;  // from the top down
+    std::size_t nextChunk_ = 0;
+    std::uint32_t topSequence_ = 0;  // the minimum ledger of the DB before backfilling
+    std::uint32_t minSequence_ = 0;  // the minimum ledger of the DB as extended so far
+    std::atomic_bool isStopping_ = false;
+
+    std::thread worker_;
+
+public:
+    /**
+     * @brief Create the backfill and start it unless there is nothing to do.
+     *
+     * @param config The `backfill` section of the config
+     * @param backend The backend to write to
+     * @param fetcher The ledger fetcher
+     * @param loader The ledger loader
+     * @param state The ETL state; backfilling only happens while this process is the ETL writer
+     */
+    Backfill(
+        util::Config const& config,
+        std::shared_ptr<BackendInterface> backend,
+        LedgerFetcherType& fetcher,
+        LedgerLoaderType& loader,
+        SystemState const& state
+    )
+        : backend_{std::move(backend)}
+        , fetcher_{std::ref(fetcher)}
+        , loader_{std::ref(loader)}
+        , state_{std::cref(state)}
+        , startSequence_{config.maybeValue<std::uint32_t>("start_sequence")}
+        , chunkSize_{config.valueOr<std::uint32_t>("chunk_size", DEFAULT_CHUNK_SIZE)}
+        , numPipelines_{config.valueOr<std::uint32_t>("pipelines", DEFAULT_PIPELINES)}
+        , maxWriteLoad_{config.valueOr("max_write_load", DEFAULT_MAX_WRITE_LOAD)}
+        , backfilledLedgersCounter_{PrometheusService::counterInt(
+              "etl_backfilled_ledgers_total_number",
+              util::prometheus::Labels(),
+              "The total number of ledgers written by the backfill"
+          )}
+    {
+        if (chunkSize_ == 0)
+            throw std::runtime_error("backfill.chunk_size must be positive");
+
+        if (numPipelines_ == 0)
+            throw std::runtime_error("backfill.pipelines must be positive");
+
+        if (maxWriteLoad_ <= 0 or maxWriteLoad_ > 1)
+            throw std::runtime_error("backfill.max_write_load must be in (0, 1]");
+
+        if (startSequence_ and not state_.get().isReadOnly)
+            worker_ = std::thread{[this]() { run(); }};
+    }
+
+    /**
+     * @brief Stop backfilling and join all threads. Chunks that are in progress are redone after a restart.
+     */
+    ~Backfill()
+    {
+        {
+            std::scoped_lock const lck{mtx_};
+            isStopping_ = true;
+        }
+        cv_.notify_all();
+
+        waitTillFinished();
+    }
+
+    Backfill(Backfill const&) = delete;
+    Backfill&
+    operator=(Backfill const&) = delete;
+
+    /**
+     * @brief Wait until all chunks are backfilled or the backfill was stopped.
+     */
+    void
+    waitTillFinished()
+    {
+        if (worker_.joinable())
+            worker_.join();
+    }
+
+private:
+    void
+    run()
+    {
+        beast::setCurrentThreadName("ETL backfill");
+
+        while (auto const range = waitForWriter()) {
+            if (not planChunks(*range))
+                return;
+
+            {
+                // chunks recorded before a restart may already be contiguous with the range
+                std::scoped_lock const lck{mtx_};
+                extendRange();
+            }
+
+            std::vector<std::thread> pipelines;
+            pipelines.reserve(numPipelines_);
+            for (auto i = 0u; i < numPipelines_; ++i) {
+                pipelines.emplace_back([this]() {
+                    beast::setCurrentThreadName("ETL backfill pipeline");
+                    // a pipeline only waits for the writes of its own chunks, not for the live ETL or other pipelines
+                    backend_->isolateThreadWrites();
+                    runPipeline();
+                });
+            }
+
+            for (auto& pipeline : pipelines)
+                pipeline.join();
+
+            std::scoped_lock const lck{mtx_};
+            if (minSequence_ == *startSequence_ or isStopped()) {
+                LOG(log_.info()) << "Backfill " << (minSequence_ == *startSequence_ ? "finished" : "stopped")
+                                 << ". Minimum ledger = " << minSequence_;
+                return;
+            }
+
+            LOG(log_.info()) << "No longer the ETL writer. Pausing the backfill at minimum ledger " << minSequence_;
+        }
+    }
+
+    /** @brief The DB is only backfilled by the ETL writer, once the initial ledger was loaded. */
+    std::optional<data::LedgerRange>
+    waitForWriter()
+    {
+        while (not isStopped()) {
+            if (state_.get().isWriting) {
+                if (auto const range = backend_->hardFetchLedgerRangeNoThrow(); range)
+                    return range;
+            }
+
+            std::unique_lock lck{mtx_};
+            cv_.wait_for(lck, RECHECK_INTERVAL, [this]() { return isStopping_.load(); });
+        }
+
+        return std::nullopt;
+    }
+
+    bool
+    planChunks(data::LedgerRange const& range)
+    {
+        if (*startSequence_ >= range.minSequence) {
+            LOG(log_.info()) << "Nothing to backfill. start_sequence = " << *startSequence_
+                             << ", minimum ledger = " << range.minSequence;
+            return false;
+        }
+
+        auto const recorded = data::synchronousAndRetryOnTimeout([this](auto yield) {
+            return backend_->fetchBackfilledChunks(yield);
+        });
+
+        std::scoped_lock const lck{mtx_};
+        topSequence_ = minSequence_ = range.minSequence;
+        chunks_.clear();
+        nextChunk_ = 0;
+
+        auto last = range.minSequence - 1;
+        while (true) {
+            auto const first = std::max(last - last % chunkSize_, *startSequence_);
+            auto const isDone = std::any_of(recorded.begin(), recorded.end(), [first, last](auto const& chunk) {
+                return chunk.minSequence <= first and chunk.maxSequence >= last;
+            });
+
+            chunks_.push_back({.ledgers = {.minSequence = first, .maxSequence = last}, .isDone = isDone});
+            if (first == *startSequence_)
+                break;
+
+            last = first - 1;
+        }
+
+        auto const numDone = std::count_if(chunks_.begin(), chunks_.end(), [](auto const& c) { return c.isDone; });
+        LOG(log_.info()) << "Backfilling ledgers " << *startSequence_ << " to " << range.minSequence - 1 << " in "
+                         << chunks_.size() << " chunks using " << numPipelines_ << " pipelines. " << numDone
+                         << " chunks were backfilled before";
+        return true;
+    }
+
+    void
+    runPipeline()
+    {
+        while (auto const chunk = takeNextChunk()) {
+            if (not loadChunk(*chunk))
+                return;
+
+            backend_->writeBackfilledChunk(*chunk);
+            finishChunk(*chunk);
+        }
+    }
+
+    std::optional<data::LedgerRange>
+    takeNextChunk()
+    {
+        std::scoped_lock const lck{mtx_};
+        while (nextChunk_ < chunks_.size() and not isInterrupted()) {
+            auto const& chunk = chunks_[nextChunk_++];
+            if (not chunk.isDone)
+                return chunk.ledgers;
+        }
+
+        return std::nullopt;
+    }
+
+    /** @return true if all ledgers of the chunk were written; false if the backfill is stopping or pausing */
+    bool
+    loadChunk(data::LedgerRange const& chunk)
+    {
+        LOG(log_.info()) << "Backfilling ledgers " << chunk.minSequence << " to " << chunk.maxSequence;
+
+        try {
+            waitForWriteCapacity();
+            if (isInterrupted() or not loader_.get().loadLedgerSnapshot(chunk.minSequence))
+                return false;
+            ++backfilledLedgersCounter_.get();
+
+            for (auto seq = chunk.minSequence + 1; seq <= chunk.maxSequence; ++seq) {
+                waitForWriteCapacity();
+                if (isInterrupted())
+                    return false;
+
+                auto data = fetcher_.get().fetchDataAndDiff(seq);
+                if (not data)
+                    return false;
+
+                loader_.get().loadLedgerDiff(*data);
+                ++backfilledLedgersCounter_.get();
+            }
+
+            // unlike the first ledger of every other chunk, the minimum ledger is not a snapshot written by a backfill
+            if (chunk.maxSequence + 1 == topSequence_) {
+                auto data = fetcher_.get().fetchDataAndDiff(topSequence_);
+                if (not data)
+                    return false;
+
+                loader_.get().loadDeletions(*data);
+            }
+        } catch (std::runtime_error const& e) {
+            LOG(log_.error()) << "Failed to backfill ledgers " << chunk.minSequence << " to " << chunk.maxSequence
+                              << ": " << e.what() << ". Stopping the backfill";
+            isStopping_ = true;
+            return false;
+        }
+
+        return true;
+    }
+
+    void
+    finishChunk(data::LedgerRange const& chunk)
+    {
+        std::scoped_lock const lck{mtx_};
+
+        auto const it = std::find_if(chunks_.begin(), chunks_.end(), [&chunk](auto const& c) {
+            return c.ledgers.minSequence == chunk.minSequence;
+        });
+        it->isDone = true;
+
+        LOG(log_.info()) << "Backfilled ledgers " << chunk.minSequence << " to " << chunk.maxSequence;
+        extendRange();
+    }
+
+    /** @brief Extend the range over the finished chunks that are contiguous with it. Must be called under mtx_. */
+    void
+    extendRange()
+    {
+        auto newMin = minSequence_;
+        for (auto const& chunk : chunks_) {
+            if (not chunk.isDone)
+                break;
+
+            newMin = chunk.ledgers.minSequence;
+        }
+
+        if (newMin == minSequence_)
+            return;
+
+        if (not backend_->extendMinSequence(minSequence_, newMin)) {
+            LOG(log_.error()) << "Minimum ledger changed while backfilling. Stopping the backfill";
+            isStopping_ = true;
+            return;
+        }
+
+        minSequence_ = newMin;
+    }
+
+    void
+    waitForWriteCapacity() const
+    {
+        while (backend_->writeLoad() >= maxWriteLoad_ and not isInterrupted())
+            std::this_thread::sleep_for(THROTTLE_INTERVAL);
+    }
+
+    bool
+    isStopped() const
+    {
+        return isStopping_ or state_.get().isStopping;
+    }
+
+    /** @return true if the pipelines have to drop their chunks, because of stopping or no longer being the writer */
+    bool
+    isInterrupted() const
+    {
+        return isStopped() or not state_.get().isWriting;
+    }
+};
+
+}  // namespace etl::detail
@@ -20,44 +20,72 @@
 #pragma once
 
 #include "etl/ETLHelpers.h"
-#include "util/log/Logger.h"
+#include "util/Assert.h"
+#include "util/prometheus/Label.h"
+#include "util/prometheus/Prometheus.h"
 
+#include <cstddef>
+#include <cstdint>
+#include <functional>
 #include <memory>
+#include <optional>
+#include <string>
 #include <vector>
 
 namespace etl::detail {
 
 /**
- * @brief A collection of thread safe async queues used by Extractor and Transformer to communicate
+ * @brief A collection of single-producer/single-consumer queues used by Extractor and Transformer to communicate.
+ *
+ * Each extractor owns one queue and the transformer is its only consumer.
  */
 template <typename RawDataType>
 class ExtractionDataPipe {
 public:
     using DataType = std::optional<RawDataType>;
-    using QueueType = ThreadSafeQueue<DataType>;  // TODO: probably should use boost::lockfree::queue instead?
+    using QueueType = SpscRingBuffer<DataType>;
 
     constexpr static auto TOTAL_MAX_IN_QUEUE = 1000u;
 
 private:
-    util::Logger log_{"ETL"};
+    struct Queue {
+        QueueType buffer;
+        std::reference_wrapper<util::prometheus::GaugeInt> sizeGauge;
+
+        Queue(std::size_t depth, util::prometheus::GaugeInt& gauge) : buffer{depth}, sizeGauge{gauge}
+        {
+        }
+    };
 
     uint32_t stride_;
     uint32_t startSequence_;
 
-    std::vector<std::shared_ptr<QueueType>> queues_;
+    std::vector<std::unique_ptr<Queue>> queues_;
 
 public:
     /**
      * @brief Create a new instance of the extraction data pipe
      *
-     * @param stride
-     * @param startSequence
+     * @param stride The number of extractors, each getting its own queue
+     * @param startSequence The first sequence to be extracted
+     * @param queueDepth Maximum number of ledgers waiting in each queue; splits TOTAL_MAX_IN_QUEUE across all queues
+     * if not set
      */
-    ExtractionDataPipe(uint32_t stride, uint32_t startSequence) : stride_{stride}, startSequence_{startSequence}
+    ExtractionDataPipe(uint32_t stride, uint32_t startSequence, std::optional<uint32_t> queueDepth = std::nullopt)
+        : stride_{stride}, startSequence_{startSequence}
     {
-        auto const maxQueueSize = TOTAL_MAX_IN_QUEUE / stride;
-        for (size_t i = 0; i < stride_; ++i)
-            queues_.push_back(std::make_unique<QueueType>(maxQueueSize));
+        auto const depth = queueDepth.value_or(TOTAL_MAX_IN_QUEUE / stride);
+        ASSERT(depth > 0, "Extraction queue depth must be positive");
+
+        for (size_t i = 0; i < stride_; ++i) {
+            auto& gauge = PrometheusService::gaugeInt(
+                "etl_extraction_queue_size",
+                util::prometheus::Labels({{"queue", std::to_string(i)}}),
+                "Number of extracted ledgers waiting for the transformer, including a blocked extractor"
+            );
+            gauge.set(0);
+            queues_.push_back(std::make_unique<Queue>(depth, gauge));
+        }
     }
 
     /**
@@ -71,7 +99,9 @@ public:
     void
     push(uint32_t sequence, DataType&& data)
     {
-        getQueue(sequence)->push(std::move(data));
+        auto& queue = getQueue(sequence);
+        ++queue.sizeGauge.get();
+        queue.buffer.push(std::move(data));
     }
 
     /**
@@ -85,7 +115,10 @@ public:
     DataType
     popNext(uint32_t sequence)
     {
-        return getQueue(sequence)->pop();
+        auto& queue = getQueue(sequence);
+        auto data = queue.buffer.pop();
+        --queue.sizeGauge.get();
+        return data;
     }
 
     /**
@@ -111,22 +144,24 @@ public:
     /**
      * @brief Unblocks internal queues
      *
-     * Note: For now this must be called by the ETL when Transformer exits.
+     * Note: For now this must be called by the ETL when Transformer exits, as it pops from the queues in its stead.
      */
     void
     cleanup()
     {
         // TODO: this should not have to be called by hand. it should be done via RAII
-        for (auto i = 0u; i < stride_; ++i)
-            getQueue(i)->tryPop();  // pop from each queue that might be blocked on a push
+        for (auto& queue : queues_) {
+            // pop from each queue that might be blocked on a push
+            if (queue->buffer.tryPop().has_value())
+                --queue->sizeGauge.get();
+        }
     }
 
 private:
-    std::shared_ptr<QueueType>
+    Queue&
     getQueue(uint32_t sequence)
     {
-        LOG(log_.debug()) << "Grabbing extraction queue for " << sequence << "; start was " << startSequence_;
-        return queues_[(sequence - startSequence_) % stride_];
+        return *queues_[(sequence - startSequence_) % stride_];
     }
 };
 
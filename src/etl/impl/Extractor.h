@@ -27,7 +27,11 @@
 #include <ripple/beast/core/CurrentThreadName.h>
 
 #include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
 #include <mutex>
+#include <optional>
 #include <thread>
 #include <utility>
 
@@ -46,6 +50,7 @@ class Extractor {
     uint32_t startSequence_;
     std::optional<uint32_t> finishSequence_;
     std::reference_wrapper<SystemState const> state_;  // shared state for ETL
+    std::size_t fetchesInFlight_;
 
     std::thread thread_;
 
@@ -56,7 +61,8 @@ public:
         LedgerFetcherType& ledgerFetcher,
         uint32_t startSequence,
         std::optional<uint32_t> finishSequence,
-        SystemState const& state
+        SystemState const& state,
+        std::size_t fetchesInFlight = 1
     )
         : pipe_(std::ref(pipe))
         , networkValidatedLedgers_{std::move(networkValidatedLedgers)}
@@ -64,6 +70,7 @@ public:
         , startSequence_{startSequence}
         , finishSequence_{finishSequence}
         , state_{std::cref(state)}
+        , fetchesInFlight_{fetchesInFlight}
     {
         thread_ = std::thread([this]() { process(); });
     }
@@ -87,6 +94,18 @@ private:
     {
         beast::setCurrentThreadName("ETLService extract");
 
+        if (fetchesInFlight_ > 1) {
+            extractPipelined();
+        } else {
+            extractSequential();
+        }
+
+        pipe_.get().finish(startSequence_);
+    }
+
+    void
+    extractSequential()
+    {
         double totalTime = 0.0;
         auto currentSequence = startSequence_;
 
@@ -104,17 +123,69 @@ private:
             if (!fetchResponse)
                 break;
 
-            // TODO: extract this part into a strategy perhaps
-            auto const tps = fetchResponse->transactions_list().transactions_size() / time;
-            LOG(log_.info()) << "Extract phase time = " << time << "; Extract phase tps = " << tps
-                             << "; Avg extract time = " << totalTime / (currentSequence - startSequence_ + 1)
-                             << "; seq = " << currentSequence;
-
-            pipe_.get().push(currentSequence, std::move(fetchResponse));
+            push(currentSequence, std::move(fetchResponse), time, totalTime);
             currentSequence += pipe_.get().getStride();
         }
+    }
 
-        pipe_.get().finish(startSequence_);
+    /**
+     * @brief Keep up to fetchesInFlight_ ledgers in flight and push them to the pipe in order.
+     *
+     * Only ledgers the network validated already are fetched ahead; the wait for a new one starts once nothing else is
+     * in flight. That way catching up overlaps the fetches while following the network behaves as before.
+     */
+    void
+    extractPipelined()
+    {
+        using FutureType = decltype(std::declval<LedgerFetcherType&>().fetchDataAndDiffAsync(uint32_t{}));
+
+        double totalTime = 0.0;
+        auto nextSequence = startSequence_;
+        std::deque<std::pair<uint32_t, FutureType>> inFlight;
+
+        auto const isValidated = [this, &inFlight](uint32_t sequence) {
+            if (inFlight.empty())
+                return networkValidatedLedgers_->waitUntilValidatedByNetwork(sequence);
+
+            auto const mostRecent = networkValidatedLedgers_->tryGetMostRecent();
+            return mostRecent && sequence <= *mostRecent;
+        };
+
+        while (true) {
+            while (inFlight.size() < fetchesInFlight_ && !shouldFinish(nextSequence) && isValidated(nextSequence)) {
+                inFlight.emplace_back(nextSequence, ledgerFetcher_.get().fetchDataAndDiffAsync(nextSequence));
+                nextSequence += pipe_.get().getStride();
+            }
+
+            if (inFlight.empty())
+                break;
+
+            auto next = std::move(inFlight.front());
+            inFlight.pop_front();
+
+            auto [fetchResponse, time] =
+                ::util::timed<std::chrono::duration<double>>([&next]() { return next.second.get(); });
+            totalTime += time;
+
+            // the fetches still in flight are abandoned; see extractSequential() for when a fetch is unsuccessful
+            if (!fetchResponse || hasWriteConflict() || isStopping())
+                break;
+
+            push(next.first, std::move(fetchResponse), time, totalTime);
+        }
+    }
+
+    template <typename FetchResponseType>
+    void
+    push(uint32_t sequence, FetchResponseType&& fetchResponse, double time, double totalTime)
+    {
+        // TODO: extract this part into a strategy perhaps
+        auto const tps = fetchResponse->transactions_list().transactions_size() / time;
+        LOG(log_.info()) << "Extract phase time = " << time << "; Extract phase tps = " << tps
+                         << "; Avg extract time = " << totalTime / (sequence - startSequence_ + 1)
+                         << "; seq = " << sequence;
+
+        pipe_.get().push(sequence, std::forward<FetchResponseType>(fetchResponse));
     }
 
     bool
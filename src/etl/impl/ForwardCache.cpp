@@ -21,52 +21,166 @@
 
 #include "etl/Source.h"
 #include "rpc/RPCHelpers.h"
+#include "util/config/Config.h"
 #include "util/log/Logger.h"
+#include "util/prometheus/Label.h"
+#include "util/prometheus/Prometheus.h"
 
+#include <boost/asio/io_context.hpp>
 #include <boost/asio/spawn.hpp>
+#include <boost/asio/steady_timer.hpp>
 #include <boost/json/object.hpp>
+#include <boost/system/error_code.hpp>
 
-#include <atomic>
+#include <chrono>
+#include <cstdint>
 #include <memory>
 #include <mutex>
 #include <optional>
 #include <shared_mutex>
+#include <stdexcept>
 #include <string>
+#include <utility>
+#include <vector>
 
 namespace etl::detail {
 
-void
-ForwardCache::freshen()
+ForwardCache::ForwardCache(util::Config const& config, boost::asio::io_context& ioc, Source const& source)
+    : strand_(boost::asio::make_strand(ioc)), source_(source)
 {
-    LOG(log_.trace()) << "Freshening ForwardCache";
+    auto const sourceName = config.valueOr<std::string>("ip", {}) + ":" + config.valueOr<std::string>("ws_port", {});
+
+    auto const addEntry = [&](std::string const& command, Refresh refresh, std::uint32_t maxAge) {
+        auto const counter = [&](char const* status, char const* description) -> util::prometheus::CounterInt& {
+            return PrometheusService::counterInt(
+                "etl_forward_cache_total_number",
+                util::prometheus::Labels({{"source", sourceName}, {"command", command}, {"status", status}}),
+                description
+            );
+        };
+
+        entries_.insert_or_assign(
+            command,
+            Entry{
+                .refresh = refresh,
+                .maxAge = std::chrono::seconds{maxAge},
+                .timer = refresh == Refresh::OnTimer ? std::make_unique<boost::asio::steady_timer>(strand_) : nullptr,
+                .hits = counter("hit", "Total number of forwarded requests served from the cache"),
+                .misses = counter("miss", "Total number of cacheable forwarded requests not served from the cache"),
+                .refreshes = counter("refresh", "Total number of requests sent to refresh the cache"),
+            }
+        );
+    };
 
-    auto numOutstanding = std::make_shared<std::atomic_uint>(latestForwarded_.size());
+    if (config.contains("cache")) {
+        auto commands = config.arrayOrThrow("cache", "Source cache must be array");
 
-    for (auto const& cacheEntry : latestForwarded_) {
-        boost::asio::spawn(
-            strand_,
-            [this, numOutstanding, command = cacheEntry.first](boost::asio::yield_context yield) {
-                boost::json::object const request = {{"command", command}};
-                auto resp = source_.requestFromRippled(request, std::nullopt, yield);
+        auto duration = DEFAULT_DURATION;
+        if (config.contains("cache_duration"))
+            duration = config.valueOrThrow<uint32_t>("cache_duration", "Source cache_duration must be a number");
 
-                if (!resp || resp->contains("error"))
-                    resp = {};
+        for (auto const& command : commands) {
+            auto key = command.valueOrThrow<std::string>("Source forward command must be array of strings");
+            addEntry(key, Refresh::OnLedgerClose, duration);
+        }
+    }
 
-                {
-                    std::scoped_lock const lk(mtx_);
-                    latestForwarded_[command] = resp;
-                }
-            }
-        );
+    if (config.contains("cache_timers")) {
+        auto timers = config.arrayOrThrow("cache_timers", "Source cache_timers must be array");
+
+        for (auto const& timer : timers) {
+            auto key = timer.valueOrThrow<std::string>("command", "Source cache timer must have a command");
+            auto const maxAge = timer.valueOrThrow<uint32_t>("max_age", "Source cache timer must have a max_age");
+            if (maxAge == 0)
+                throw std::runtime_error("Source cache timer max_age must be positive");
+
+            addEntry(key, Refresh::OnTimer, maxAge);
+        }
     }
 }
 
 void
-ForwardCache::clear()
+ForwardCache::start()
+{
+    std::vector<std::string> commands;
+    for (auto const& [command, entry] : entries_) {
+        if (entry.refresh == Refresh::OnTimer)
+            commands.push_back(command);
+    }
+
+    for (auto const& command : commands)
+        freshen(command);
+}
+
+void
+ForwardCache::stop()
 {
     std::scoped_lock const lk(mtx_);
-    for (auto& cacheEntry : latestForwarded_)
-        latestForwarded_[cacheEntry.first] = {};
+    stopped_ = true;
+    for (auto& [_, entry] : entries_) {
+        if (entry.timer)
+            entry.timer->cancel();
+    }
+}
+
+void
+ForwardCache::onLedgerClosed()
+{
+    std::vector<std::string> commands;
+    for (auto const& [command, entry] : entries_) {
+        if (entry.refresh == Refresh::OnLedgerClose)
+            commands.push_back(command);
+    }
+
+    for (auto const& command : commands)
+        freshen(command);
+}
+
+void
+ForwardCache::freshen(std::string const& command)
+{
+    {
+        std::scoped_lock const lk(mtx_);
+        auto& entry = entries_.at(command);
+        if (stopped_ || entry.isRefreshing)
+            return;
+
+        entry.isRefreshing = true;
+        ++entry.refreshes.get();
+    }
+
+    LOG(log_.trace()) << "Freshening ForwardCache for " << command;
+
+    boost::asio::spawn(strand_, [this, command](boost::asio::yield_context yield) {
+        boost::json::object const request = {{"command", command}};
+        auto resp = source_.requestFromRippled(request, std::nullopt, yield);
+
+        if (!resp || resp->contains("error"))
+            resp = {};
+
+        std::scoped_lock const lk(mtx_);
+        auto& entry = entries_.at(command);
+        entry.response = std::move(resp);
+        entry.updated = std::chrono::steady_clock::now();
+        entry.isRefreshing = false;
+
+        if (entry.refresh == Refresh::OnTimer)
+            scheduleRefresh(command, entry);
+    });
+}
+
+void
+ForwardCache::scheduleRefresh(std::string const& command, Entry& entry)
+{
+    if (stopped_)
+        return;
+
+    // refreshing at half the max age keeps the response fresh while the next refresh is in flight
+    entry.timer->expires_after(entry.maxAge / 2);
+    entry.timer->async_wait([this, command](boost::system::error_code ec) {
+        if (!ec)
+            freshen(command);
+    });
 }
 
 std::optional<boost::json::object>
@@ -85,10 +199,18 @@ ForwardCache::get(boost::json::object const& request) const
         return {};
 
     std::shared_lock const lk(mtx_);
-    if (!latestForwarded_.contains(*command))
+    auto const it = entries_.find(*command);
+    if (it == entries_.end())
+        return {};
+
+    auto const& entry = it->second;
+    if (!entry.response || std::chrono::steady_clock::now() - entry.updated > entry.maxAge) {
+        ++entry.misses.get();
         return {};
+    }
 
-    return {latestForwarded_.at(*command)};
+    ++entry.hits.get();
+    return entry.response;
 }
 
 }  // namespace etl::detail
@@ -19,16 +19,20 @@
 
 #pragma once
 
-#include "data/BackendInterface.h"
-#include "etl/ETLHelpers.h"
 #include "util/config/Config.h"
 #include "util/log/Logger.h"
+#include "util/prometheus/Prometheus.h"
 
 #include <boost/asio.hpp>
 #include <boost/json.hpp>
 
-#include <atomic>
-#include <mutex>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <shared_mutex>
+#include <string>
 #include <unordered_map>
 
 namespace etl {
@@ -39,44 +43,87 @@ namespace etl::detail {
 
 /**
  * @brief Cache for rippled responses
+ *
+ * Every cached command has a freshness policy. Commands listed in `cache` are refreshed whenever a ledger closes and
+ * are served for at most `cache_duration` seconds. Commands listed in `cache_timers` are refreshed on a timer, often
+ * enough that they are never served older than their `max_age` seconds. Only one refresh of a command is in flight at a
+ * time; refreshes triggered meanwhile are dropped.
  */
 class ForwardCache {
-    using ResponseType = std::optional<boost::json::object>;
+public:
     static constexpr std::uint32_t DEFAULT_DURATION = 10;
 
+    /**
+     * @brief What triggers a refresh of a cached command.
+     */
+    enum class Refresh { OnLedgerClose, OnTimer };
+
+private:
+    struct Entry {
+        Refresh refresh;
+        std::chrono::steady_clock::duration maxAge;
+        std::optional<boost::json::object> response;
+        std::chrono::steady_clock::time_point updated;
+        bool isRefreshing = false;
+        std::unique_ptr<boost::asio::steady_timer> timer;
+
+        std::reference_wrapper<util::prometheus::CounterInt> hits;
+        std::reference_wrapper<util::prometheus::CounterInt> misses;
+        std::reference_wrapper<util::prometheus::CounterInt> refreshes;
+    };
+
     util::Logger log_{"ETL"};
 
     mutable std::shared_mutex mtx_;
-    std::unordered_map<std::string, ResponseType> latestForwarded_;
+    std::unordered_map<std::string, Entry> entries_;
+    bool stopped_ = false;
+
     boost::asio::strand<boost::asio::io_context::executor_type> strand_;
     etl::Source const& source_;
-    std::uint32_t duration_ = DEFAULT_DURATION;
-
-    void
-    clear();
 
 public:
-    ForwardCache(util::Config const& config, boost::asio::io_context& ioc, Source const& source)
-        : strand_(boost::asio::make_strand(ioc)), source_(source)
-    {
-        if (config.contains("cache")) {
-            auto commands = config.arrayOrThrow("cache", "Source cache must be array");
-
-            if (config.contains("cache_duration"))
-                duration_ = config.valueOrThrow<uint32_t>("cache_duration", "Source cache_duration must be a number");
-
-            for (auto const& command : commands) {
-                auto key = command.valueOrThrow<std::string>("Source forward command must be array of strings");
-                latestForwarded_[key] = {};
-            }
-        }
-    }
+    /**
+     * @brief Create the cache and start the timers of the commands refreshed on a timer.
+     *
+     * @param config The configuration of the source
+     * @param ioc The io_context to run on
+     * @param source The source to refresh the responses from
+     */
+    ForwardCache(util::Config const& config, boost::asio::io_context& ioc, Source const& source);
+
+    /**
+     * @brief Fill the commands refreshed on a timer and keep refreshing them; call once the source is constructed.
+     */
+    void
+    start();
 
+    /**
+     * @brief Stop refreshing; must be called before the source goes away.
+     */
     void
-    freshen();
+    stop();
 
+    /**
+     * @brief Refresh the commands that are refreshed whenever a ledger closes.
+     */
+    void
+    onLedgerClosed();
+
+    /**
+     * @brief Get the cached response to a request.
+     *
+     * @param request The request
+     * @return The response if the command is cached and its response is fresh; nullopt otherwise
+     */
     std::optional<boost::json::object>
     get(boost::json::object const& request) const;
+
+private:
+    void
+    freshen(std::string const& command);
+
+    void
+    scheduleRefresh(std::string const& command, Entry& entry);
 };
 
 }  // namespace etl::detail
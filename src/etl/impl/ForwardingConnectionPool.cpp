@@ -0,0 +1,479 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of clio: https://github.com/XRPLF/clio
+    Copyright (c) 2023, the clio developers.
+
+    Permission to use, copy, modify, and distribute this software for any
+    purpose with or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL,  DIRECT,  INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include "etl/impl/ForwardingConnectionPool.h"
+
+#include "util/log/Logger.h"
+
+#include <boost/asio/associated_executor.hpp>
+#include <boost/asio/buffer.hpp>
+#include <boost/asio/error.hpp>
+#include <boost/asio/io_context.hpp>
+#include <boost/asio/ip/tcp.hpp>
+#include <boost/asio/post.hpp>
+#include <boost/asio/spawn.hpp>
+#include <boost/asio/steady_timer.hpp>
+#include <boost/asio/strand.hpp>
+#include <boost/beast/core/bind_handler.hpp>
+#include <boost/beast/core/buffers_to_string.hpp>
+#include <boost/beast/core/error.hpp>
+#include <boost/beast/core/flat_buffer.hpp>
+#include <boost/beast/core/stream_traits.hpp>
+#include <boost/beast/core/tcp_stream.hpp>
+#include <boost/beast/http/field.hpp>
+#include <boost/beast/version.hpp>
+#include <boost/beast/websocket/rfc6455.hpp>
+#include <boost/beast/websocket/stream.hpp>
+#include <boost/beast/websocket/stream_base.hpp>
+#include <boost/json/object.hpp>
+#include <boost/json/parse.hpp>
+#include <boost/json/serialize.hpp>
+#include <boost/system/error_code.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <utility>
+
+namespace etl::detail {
+
+namespace {
+
+// if the client ip is known, tell rippled to charge the client IP for RPC resources. See "secure_gateway" in
+// https://github.com/ripple/rippled/blob/develop/cfg/rippled-example.cfg
+// TODO: user-agent can be clio-[version]
+auto
+makeDecorator(std::optional<std::string> clientIp)
+{
+    return boost::beast::websocket::stream_base::decorator(
+        [clientIp = std::move(clientIp)](boost::beast::websocket::request_type& req) {
+            req.set(
+                boost::beast::http::field::user_agent,
+                std::string(BOOST_BEAST_VERSION_STRING) + " websocket-client-coro"
+            );
+            if (clientIp)
+                req.set(boost::beast::http::field::forwarded, "for=" + *clientIp);
+        }
+    );
+}
+
+}  // namespace
+
+ForwardingConnection::ForwardingConnection(
+    boost::asio::io_context& ioc,
+    std::string ip,
+    std::string wsPort,
+    std::optional<std::string> clientIp
+)
+    : strand_(boost::asio::make_strand(ioc))
+    , ws_(strand_)
+    , ip_(std::move(ip))
+    , wsPort_(std::move(wsPort))
+    , clientIp_(std::move(clientIp))
+{
+}
+
+void
+ForwardingConnection::start()
+{
+    boost::asio::spawn(strand_, [self = shared_from_this()](boost::asio::yield_context yield) { self->run(yield); });
+}
+
+void
+ForwardingConnection::close()
+{
+    boost::asio::post(strand_, [self = shared_from_this()] {
+        self->fail(boost::asio::error::operation_aborted, "close");
+    });
+}
+
+std::optional<boost::json::object>
+ForwardingConnection::request(
+    boost::json::object const& request,
+    std::chrono::steady_clock::duration timeout,
+    boost::asio::yield_context yield
+)
+{
+    auto channel = std::make_shared<ResponseChannel>(yield.get_executor(), 1);
+
+    std::int64_t id = 0;
+    {
+        std::scoped_lock const lck{mtx_};
+        if (closed_)
+            return std::nullopt;
+
+        id = ++nextId_;
+        pending_.emplace(id, channel);
+    }
+
+    // the id rippled echoes back is the one of the connection, not the one the client chose
+    auto message = request;
+    message["id"] = id;
+    boost::asio::post(strand_, [self = shared_from_this(), serialized = boost::json::serialize(message)]() mutable {
+        self->messages_.push(std::move(serialized));
+        self->maybeSendNext();
+    });
+
+    boost::asio::steady_timer timer{yield.get_executor(), timeout};
+    timer.async_wait([weakChannel = std::weak_ptr{channel}](boost::system::error_code ec) {
+        if (auto const timedOut = weakChannel.lock(); timedOut && !ec)
+            timedOut->try_send(boost::system::error_code{boost::asio::error::timed_out}, boost::json::object{});
+    });
+
+    boost::system::error_code ec;
+    auto response = channel->async_receive(yield[ec]);
+    timer.cancel();
+
+    {
+        std::scoped_lock const lck{mtx_};
+        pending_.erase(id);
+        lastUsed_ = std::chrono::steady_clock::now();
+    }
+
+    if (ec) {
+        LOG(log_.debug()) << "Forwarded request to " << ip_ << ":" << wsPort_ << " failed: " << ec.message();
+        return std::nullopt;
+    }
+
+    if (auto const it = request.find("id"); it != request.end()) {
+        response["id"] = it->value();
+    } else {
+        response.erase("id");
+    }
+
+    return response;
+}
+
+bool
+ForwardingConnection::isClosed() const
+{
+    std::scoped_lock const lck{mtx_};
+    return closed_;
+}
+
+bool
+ForwardingConnection::wasReady() const
+{
+    return wasReady_;
+}
+
+std::chrono::steady_clock::duration
+ForwardingConnection::idleFor() const
+{
+    std::scoped_lock const lck{mtx_};
+    if (!pending_.empty())
+        return std::chrono::steady_clock::duration::zero();
+
+    return std::chrono::steady_clock::now() - lastUsed_;
+}
+
+void
+ForwardingConnection::run(boost::asio::yield_context yield)
+{
+    namespace websocket = boost::beast::websocket;
+
+    boost::beast::error_code ec;
+    boost::asio::ip::tcp::resolver resolver{strand_};
+
+    auto const results = resolver.async_resolve(ip_, wsPort_, yield[ec]);
+    if (ec || isClosed())
+        return fail(ec, "resolve");
+
+    auto& stream = boost::beast::get_lowest_layer(ws_);
+    stream.expires_after(CONNECT_TIMEOUT);
+    stream.async_connect(results, yield[ec]);
+    if (ec || isClosed())
+        return fail(ec, "connect");
+
+    // websocket timeouts take over from here; the keep-alive pings are the health check of an idle connection
+    stream.expires_never();
+    ws_.set_option(websocket::stream_base::timeout{
+        .handshake_timeout = CONNECT_TIMEOUT,
+        .idle_timeout = HEALTH_CHECK_TIMEOUT,
+        .keep_alive_pings = true,
+    });
+    ws_.set_option(makeDecorator(clientIp_));
+
+    ws_.async_handshake(ip_, "/", yield[ec]);
+    if (ec || isClosed())
+        return fail(ec, "handshake");
+
+    LOG(log_.debug()) << "Opened forwarding connection to " << ip_ << ":" << wsPort_;
+    connected_ = true;
+    wasReady_ = true;
+    maybeSendNext();
+
+    boost::beast::flat_buffer buffer;
+    while (true) {
+        ws_.async_read(buffer, yield[ec]);
+        if (ec)
+            return fail(ec, "read");
+
+        onMessage(boost::beast::buffers_to_string(buffer.data()));
+        buffer.consume(buffer.size());
+    }
+}
+
+void
+ForwardingConnection::onMessage(std::string const& message)
+{
+    boost::system::error_code ec;
+    auto parsed = boost::json::parse(message, ec);
+    if (ec || !parsed.is_object()) {
+        LOG(log_.error()) << "Error parsing response: " << message;
+        return;
+    }
+
+    auto& response = parsed.as_object();
+    auto const* id = response.if_contains("id");
+    if (id == nullptr || !id->is_int64()) {
+        LOG(log_.debug()) << "Dropping message without a request id: " << message;
+        return;
+    }
+
+    std::shared_ptr<ResponseChannel> channel;
+    {
+        std::scoped_lock const lck{mtx_};
+        if (auto const it = pending_.find(id->as_int64()); it != pending_.end())
+            channel = it->second;
+    }
+
+    if (!channel) {
+        LOG(log_.debug()) << "Dropping response to a request that timed out: " << message;
+        return;
+    }
+
+    channel->try_send(boost::system::error_code{}, std::move(response));
+}
+
+void
+ForwardingConnection::maybeSendNext()
+{
+    if (!connected_ || sending_ || messages_.empty() || isClosed())
+        return;
+
+    sending_ = true;
+    ws_.async_write(
+        boost::asio::buffer(messages_.front()),
+        boost::beast::bind_front_handler(&ForwardingConnection::onWrite, shared_from_this())
+    );
+}
+
+void
+ForwardingConnection::onWrite(boost::beast::error_code ec, std::size_t)
+{
+    messages_.pop();
+    sending_ = false;
+    if (ec)
+        return fail(ec, "write");
+
+    maybeSendNext();
+}
+
+void
+ForwardingConnection::fail(boost::beast::error_code ec, char const* what)
+{
+    {
+        std::scoped_lock const lck{mtx_};
+        if (closed_)
+            return;
+
+        closed_ = true;
+        for (auto const& [_, channel] : pending_)
+            channel->try_send(ec, boost::json::object{});
+        pending_.clear();
+    }
+
+    LOG(log_.debug()) << "Closing forwarding connection to " << ip_ << ":" << wsPort_ << " on " << what << ": "
+                      << ec.message();
+    boost::beast::get_lowest_layer(ws_).close();
+}
+
+ForwardingConnectionPool::ForwardingConnectionPool(boost::asio::io_context& ioc, std::string ip, std::string wsPort)
+    : ioc_(ioc), ip_(std::move(ip)), wsPort_(std::move(wsPort))
+{
+}
+
+ForwardingConnectionPool::~ForwardingConnectionPool()
+{
+    std::scoped_lock const lck{mtx_};
+    for (auto const& [_, connection] : connections_)
+        connection->close();
+}
+
+std::optional<boost::json::object>
+ForwardingConnectionPool::request(
+    boost::json::object const& request,
+    std::optional<std::string> const& clientIp,
+    boost::asio::yield_context yield
+)
+{
+    std::shared_ptr<ForwardingConnection> connection;
+    {
+        std::scoped_lock const lck{mtx_};
+        sweep();
+
+        if (std::chrono::steady_clock::now() < retryAfter_) {
+            LOG(log_.debug()) << "Not forwarding to " << ip_ << ":" << wsPort_ << " while backing off";
+            return std::nullopt;
+        }
+
+        connection = acquire(clientIp);
+    }
+
+    if (!connection)
+        return requestWithNewConnection(request, clientIp, yield);
+
+    return connection->request(request, REQUEST_TIMEOUT, yield);
+}
+
+std::size_t
+ForwardingConnectionPool::size() const
+{
+    std::scoped_lock const lck{mtx_};
+    return connections_.size();
+}
+
+void
+ForwardingConnectionPool::sweep()
+{
+    for (auto it = connections_.begin(); it != connections_.end();) {
+        auto const& connection = it->second;
+
+        if (connection->isClosed()) {
+            if (!connection->wasReady()) {
+                ++numConnectFailures_;
+                auto const backoff =
+                    std::min(std::chrono::seconds{1 << std::min<std::size_t>(numConnectFailures_ - 1, 5)}, MAX_BACKOFF);
+                retryAfter_ = std::chrono::steady_clock::now() + backoff;
+
+                LOG(log_.warn()) << "Failed to connect to " << ip_ << ":" << wsPort_ << " for forwarding; retrying in "
+                                 << backoff.count() << "s";
+            }
+
+            it = connections_.erase(it);
+            continue;
+        }
+
+        if (connection->wasReady())
+            numConnectFailures_ = 0;
+
+        if (connection->idleFor() > IDLE_TIMEOUT) {
+            connection->close();
+            it = connections_.erase(it);
+            continue;
+        }
+
+        ++it;
+    }
+}
+
+std::shared_ptr<ForwardingConnection>
+ForwardingConnectionPool::acquire(std::optional<std::string> const& clientIp)
+{
+    auto const key = clientIp.value_or("");
+    if (auto const it = connections_.find(key); it != connections_.end())
+        return it->second;
+
+    if (connections_.size() >= MAX_CONNECTIONS) {
+        // make room by closing the connection that has been idle the longest, unless all of them are busy
+        auto const idlest =
+            std::max_element(connections_.begin(), connections_.end(), [](auto const& a, auto const& b) {
+                return a.second->idleFor() < b.second->idleFor();
+            });
+        if (idlest->second->idleFor() == std::chrono::steady_clock::duration::zero())
+            return nullptr;
+
+        idlest->second->close();
+        connections_.erase(idlest);
+    }
+
+    auto connection = std::make_shared<ForwardingConnection>(ioc_, ip_, wsPort_, clientIp);
+    connection->start();
+    connections_.emplace(key, connection);
+
+    return connection;
+}
+
+std::optional<boost::json::object>
+ForwardingConnectionPool::requestWithNewConnection(
+    boost::json::object const& request,
+    std::optional<std::string> const& clientIp,
+    boost::asio::yield_context yield
+) const
+{
+    namespace beast = boost::beast;
+    namespace websocket = beast::websocket;
+    namespace net = boost::asio;
+    using tcp = boost::asio::ip::tcp;
+
+    try {
+        auto executor = boost::asio::get_associated_executor(yield);
+        beast::error_code ec;
+        tcp::resolver resolver{executor};
+
+        auto ws = std::make_unique<websocket::stream<beast::tcp_stream>>(executor);
+
+        auto const results = resolver.async_resolve(ip_, wsPort_, yield[ec]);
+        if (ec)
+            return {};
+
+        ws->next_layer().expires_after(REQUEST_TIMEOUT);
+        ws->next_layer().async_connect(results, yield[ec]);
+        if (ec)
+            return {};
+
+        ws->set_option(makeDecorator(clientIp));
+
+        ws->async_handshake(ip_, "/", yield[ec]);
+        if (ec)
+            return {};
+
+        ws->async_write(net::buffer(boost::json::serialize(request)), yield[ec]);
+        if (ec)
+            return {};
+
+        beast::flat_buffer buffer;
+        ws->async_read(buffer, yield[ec]);
+        if (ec)
+            return {};
+
+        auto begin = static_cast<char const*>(buffer.data().data());
+        auto end = begin + buffer.data().size();
+        auto parsed = boost::json::parse(std::string(begin, end));
+
+        if (!parsed.is_object()) {
+            LOG(log_.error()) << "Error parsing response: " << std::string{begin, end};
+            return {};
+        }
+
+        return parsed.as_object();
+    } catch (std::exception const& e) {
+        LOG(log_.error()) << "Encountered exception : " << e.what();
+        return {};
+    }
+}
+
+}  // namespace etl::detail
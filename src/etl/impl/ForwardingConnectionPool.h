@@ -0,0 +1,244 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of clio: https://github.com/XRPLF/clio
+    Copyright (c) 2023, the clio developers.
+
+    Permission to use, copy, modify, and distribute this software for any
+    purpose with or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL,  DIRECT,  INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#pragma once
+
+#include "util/log/Logger.h"
+
+#include <boost/asio/experimental/concurrent_channel.hpp>
+#include <boost/asio/io_context.hpp>
+#include <boost/asio/spawn.hpp>
+#include <boost/asio/strand.hpp>
+#include <boost/beast/core/error.hpp>
+#include <boost/beast/core/tcp_stream.hpp>
+#include <boost/beast/websocket/stream.hpp>
+#include <boost/json/object.hpp>
+#include <boost/system/error_code.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <queue>
+#include <string>
+#include <unordered_map>
+
+namespace etl::detail {
+
+/**
+ * @brief A long-lived WebSocket connection to rippled that many requests are multiplexed over.
+ *
+ * Every request gets an id unique to the connection, so responses can arrive in any order and are matched to their
+ * requests by id. The id of the original request is put back into its response. Keep-alive pings tell a dead connection
+ * from a quiet one.
+ */
+class ForwardingConnection : public std::enable_shared_from_this<ForwardingConnection> {
+public:
+    static constexpr auto CONNECT_TIMEOUT = std::chrono::seconds{3};
+    static constexpr auto HEALTH_CHECK_TIMEOUT = std::chrono::seconds{20};
+
+private:
+    using ResponseChannel =
+        boost::asio::experimental::concurrent_channel<void(boost::system::error_code, boost::json::object)>;
+
+    util::Logger log_{"ETL"};
+
+    boost::asio::strand<boost::asio::io_context::executor_type> strand_;
+    boost::beast::websocket::stream<boost::beast::tcp_stream> ws_;
+    std::string ip_;
+    std::string wsPort_;
+    std::optional<std::string> clientIp_;
+
+    // only accessed on the strand
+    bool connected_ = false;
+    bool sending_ = false;
+    std::queue<std::string> messages_;
+
+    mutable std::mutex mtx_;
+    std::unordered_map<std::int64_t, std::shared_ptr<ResponseChannel>> pending_;
+    std::int64_t nextId_ = 0;
+    std::chrono::steady_clock::time_point lastUsed_ = std::chrono::steady_clock::now();
+    bool closed_ = false;
+
+    std::atomic_bool wasReady_{false};
+
+public:
+    /**
+     * @brief Create a connection; it does not connect until started.
+     *
+     * @param ioc The io_context to run on
+     * @param ip The IP of rippled
+     * @param wsPort The WebSocket port of rippled
+     * @param clientIp The IP of the client the requests are forwarded for, if known
+     */
+    ForwardingConnection(
+        boost::asio::io_context& ioc,
+        std::string ip,
+        std::string wsPort,
+        std::optional<std::string> clientIp
+    );
+
+    /**
+     * @brief Connect to rippled and start reading responses.
+     */
+    void
+    start();
+
+    /**
+     * @brief Close the connection; requests in flight fail.
+     */
+    void
+    close();
+
+    /**
+     * @brief Send a request over the connection and wait for its response.
+     *
+     * Requests sent while the connection is being established are sent once it is.
+     *
+     * @param request The request to send
+     * @param timeout How long to wait for the response
+     * @param yield The coroutine context
+     * @return The response; nullopt if the connection failed or the request timed out
+     */
+    std::optional<boost::json::object>
+    request(
+        boost::json::object const& request,
+        std::chrono::steady_clock::duration timeout,
+        boost::asio::yield_context yield
+    );
+
+    /**
+     * @return true if the connection was closed or failed
+     */
+    bool
+    isClosed() const;
+
+    /**
+     * @return true if the handshake with rippled succeeded at some point
+     */
+    bool
+    wasReady() const;
+
+    /**
+     * @return How long the connection has had no requests in flight; zero if it has some
+     */
+    std::chrono::steady_clock::duration
+    idleFor() const;
+
+private:
+    void
+    run(boost::asio::yield_context yield);
+
+    void
+    onMessage(std::string const& message);
+
+    void
+    maybeSendNext();
+
+    void
+    onWrite(boost::beast::error_code ec, std::size_t);
+
+    void
+    fail(boost::beast::error_code ec, char const* what);
+};
+
+/**
+ * @brief A pool of persistent, multiplexed WebSocket connections to the rippled of one ETL source.
+ *
+ * rippled charges the client IP sent in the `Forwarded` header of the handshake when clio is its secure gateway, so
+ * requests forwarded for different clients can't share a connection: there is one connection per client IP. Idle
+ * connections are closed after a while. If connecting fails, the pool backs off exponentially and fails requests fast
+ * until it may try again. When the pool is full and every connection is busy, the request gets a connection of its own
+ * for just that request.
+ */
+class ForwardingConnectionPool {
+public:
+    static constexpr std::size_t MAX_CONNECTIONS = 64;
+    static constexpr auto REQUEST_TIMEOUT = std::chrono::seconds{3};
+    static constexpr auto IDLE_TIMEOUT = std::chrono::seconds{60};
+    static constexpr auto MAX_BACKOFF = std::chrono::seconds{30};
+
+private:
+    util::Logger log_{"ETL"};
+
+    boost::asio::io_context& ioc_;
+    std::string ip_;
+    std::string wsPort_;
+
+    mutable std::mutex mtx_;
+    std::unordered_map<std::string, std::shared_ptr<ForwardingConnection>> connections_;
+    std::size_t numConnectFailures_ = 0;
+    std::chrono::steady_clock::time_point retryAfter_;
+
+public:
+    /**
+     * @brief Create an empty pool; connections are made on demand.
+     *
+     * @param ioc The io_context to run on
+     * @param ip The IP of rippled
+     * @param wsPort The WebSocket port of rippled
+     */
+    ForwardingConnectionPool(boost::asio::io_context& ioc, std::string ip, std::string wsPort);
+
+    ~ForwardingConnectionPool();
+
+    ForwardingConnectionPool(ForwardingConnectionPool const&) = delete;
+    ForwardingConnectionPool&
+    operator=(ForwardingConnectionPool const&) = delete;
+
+    /**
+     * @brief Send a request to rippled and wait for its response.
+     *
+     * @param request The request to send
+     * @param clientIp The IP of the client the request is forwarded for, if known
+     * @param yield The coroutine context
+     * @return The response; nullopt on failure
+     */
+    std::optional<boost::json::object>
+    request(
+        boost::json::object const& request,
+        std::optional<std::string> const& clientIp,
+        boost::asio::yield_context yield
+    );
+
+    /**
+     * @return The number of connections in the pool
+     */
+    std::size_t
+    size() const;
+
+private:
+    void
+    sweep();
+
+    std::shared_ptr<ForwardingConnection>
+    acquire(std::optional<std::string> const& clientIp);
+
+    std::optional<boost::json::object>
+    requestWithNewConnection(
+        boost::json::object const& request,
+        std::optional<std::string> const& clientIp,
+        boost::asio::yield_context yield
+    ) const;
+};
+
+}  // namespace etl::detail
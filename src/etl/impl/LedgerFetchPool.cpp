@@ -0,0 +1,219 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of clio: https://github.com/XRPLF/clio
+    Copyright (c) 2023, the clio developers.
+
+    Permission to use, copy, modify, and distribute this software for any
+    purpose with or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL,  DIRECT,  INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include "etl/impl/LedgerFetchPool.h"
+
+#include "etl/Source.h"
+#include "etl/impl/AsyncData.h"
+#include "util/Assert.h"
+#include "util/log/Logger.h"
+
+#include <grpcpp/grpcpp.h>
+#include <ripple/beast/core/CurrentThreadName.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <utility>
+
+namespace etl::detail {
+
+LedgerFetchPool::LedgerFetchPool(RankFunction rank, std::size_t numPollers, std::size_t fetchesPerSource)
+    : rank_{std::move(rank)}, fetchesPerSource_{std::max(fetchesPerSource, std::size_t{1})}
+{
+    for (std::size_t i = 0; i < std::max(numPollers, std::size_t{1}); ++i)
+        queues_.push_back(std::make_unique<grpc::CompletionQueue>());
+
+    for (auto& queue : queues_) {
+        pollers_.emplace_back([this, &cq = *queue]() {
+            beast::setCurrentThreadName("ETL fetch poller");
+            poll(cq);
+        });
+    }
+}
+
+LedgerFetchPool::~LedgerFetchPool()
+{
+    stop();
+}
+
+std::future<LedgerFetchPool::OptionalResponseType>
+LedgerFetchPool::fetch(std::uint32_t sequence, bool getObjects, bool getObjectNeighbors)
+{
+    auto request = std::make_shared<Request>();
+    request->sequence = sequence;
+    request->getObjects = getObjects;
+    request->getObjectNeighbors = getObjectNeighbors;
+    auto future = request->promise.get_future();
+
+    std::scoped_lock const lck{mtx_};
+    if (stopping_) {
+        request->promise.set_value(std::nullopt);
+        return future;
+    }
+
+    queued_.push_back(std::move(request));
+    dispatch();
+    return future;
+}
+
+void
+LedgerFetchPool::stop()
+{
+    {
+        std::scoped_lock const lck{mtx_};
+        if (stopping_)
+            return;
+
+        stopping_ = true;
+        for (auto& request : queued_)
+            request->promise.set_value(std::nullopt);
+        queued_.clear();
+
+        // the cancelled calls still complete on their queues and resolve their requests there
+        for (auto& [fetch, request] : running_)
+            request->fetch->cancel();
+    }
+
+    for (auto& queue : queues_)
+        queue->Shutdown();
+
+    for (auto& poller : pollers_)
+        poller.join();
+}
+
+void
+LedgerFetchPool::poll(grpc::CompletionQueue& cq)
+{
+    void* tag = nullptr;
+    bool ok = false;
+
+    while (true) {
+        auto const status = cq.AsyncNext(&tag, &ok, std::chrono::system_clock::now() + POLL_INTERVAL);
+        if (status == grpc::CompletionQueue::SHUTDOWN)
+            return;
+
+        if (status == grpc::CompletionQueue::GOT_EVENT) {
+            ASSERT(tag != nullptr, "Tag can't be null.");
+            onComplete(static_cast<AsyncLedgerFetch*>(tag));
+        } else {
+            // picks up the requests whose retry delay passed
+            std::scoped_lock const lck{mtx_};
+            dispatch();
+        }
+    }
+}
+
+void
+LedgerFetchPool::onComplete(AsyncLedgerFetch* fetch)
+{
+    std::scoped_lock const lck{mtx_};
+
+    auto const it = running_.find(fetch);
+    ASSERT(it != running_.end(), "Completed call must be running");
+    auto request = std::move(it->second);
+    running_.erase(it);
+    --inFlight_[request->source];
+
+    fetch->complete();
+    if (fetch->status().ok() and fetch->response().validated()) {
+        LOG(log_.info()) << "Successfully fetched ledger = " << request->sequence
+                         << " from source = " << request->source->toString();
+        request->promise.set_value(std::move(fetch->response()));
+    } else if (stopping_) {
+        request->promise.set_value(std::nullopt);
+    } else {
+        LOG(log_.warn()) << "Could not fetch ledger " << request->sequence
+                         << ", error_code: " << fetch->status().error_code()
+                         << ", error_msg: " << fetch->status().error_message()
+                         << ", source = " << request->source->toString();
+
+        request->failedAt.push_back(request->source);
+        request->fetch.reset();
+        queued_.push_front(std::move(request));
+    }
+
+    dispatch();
+}
+
+void
+LedgerFetchPool::dispatch()
+{
+    if (stopping_ or queued_.empty())
+        return;
+
+    auto const sources = rank_();
+    auto const now = std::chrono::steady_clock::now();
+
+    for (auto it = queued_.begin(); it != queued_.end();) {
+        auto& request = **it;
+        if (request.notBefore > now) {
+            ++it;
+            continue;
+        }
+
+        Source* picked = nullptr;
+        bool isBusy = false;
+
+        for (auto* source : sources) {
+            if (std::ranges::find(request.failedAt, source) != request.failedAt.end() or
+                not source->hasLedger(request.sequence))
+                continue;
+
+            if (inFlight_[source] >= fetchesPerSource_) {
+                isBusy = true;
+                continue;
+            }
+
+            auto& cq = *queues_[nextQueue_++ % queues_.size()];
+            request.fetch =
+                source->fetchLedgerAsync(request.sequence, request.getObjects, request.getObjectNeighbors, cq);
+            if (request.fetch) {
+                picked = source;
+                break;
+            }
+
+            request.failedAt.push_back(source);
+        }
+
+        if (picked != nullptr) {
+            request.source = picked;
+            ++inFlight_[picked];
+            running_.emplace(request.fetch.get(), std::move(*it));
+            it = queued_.erase(it);
+            continue;
+        }
+
+        // a busy source frees up once one of its calls completes; otherwise no source can serve the ledger yet
+        if (not isBusy) {
+            LOG(log_.info()) << "Ledger sequence " << request.sequence
+                             << " is not yet available from any configured sources. Trying again later";
+            request.failedAt.clear();
+            request.notBefore = now + RETRY_DELAY;
+        }
+        ++it;
+    }
+}
+
+}  // namespace etl::detail
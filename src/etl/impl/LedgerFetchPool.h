@@ -0,0 +1,144 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of clio: https://github.com/XRPLF/clio
+    Copyright (c) 2023, the clio developers.
+
+    Permission to use, copy, modify, and distribute this software for any
+    purpose with or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL,  DIRECT,  INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#pragma once
+
+#include "util/log/Logger.h"
+
+#include <grpcpp/grpcpp.h>
+#include <ripple/proto/org/xrpl/rpc/v1/xrp_ledger.grpc.pb.h>
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <future>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace etl {
+class Source;
+}  // namespace etl
+
+namespace etl::detail {
+
+class AsyncLedgerFetch;
+
+/**
+ * @brief Fetches many ledgers at once over the asynchronous gRPC API.
+ *
+ * The calls complete on the completion queues of a few poller threads, so the number of ledgers in flight does not
+ * depend on the number of threads waiting for them. Every source has a limited number of calls in flight; a request
+ * that finds all sources busy waits for a free slot. A failed call is retried at the next ranked source that has the
+ * ledger. Once none is left, the request is retried after RETRY_DELAY, like LoadBalancer::execute() does.
+ */
+class LedgerFetchPool {
+public:
+    using ResponseType = org::xrpl::rpc::v1::GetLedgerResponse;
+    using OptionalResponseType = std::optional<ResponseType>;
+    using RankFunction = std::function<std::vector<Source*>()>;
+
+    static constexpr std::size_t DEFAULT_POLLERS = 1;
+    static constexpr std::size_t DEFAULT_FETCHES_PER_SOURCE = 4;
+    static constexpr auto RETRY_DELAY = std::chrono::seconds{2};
+    static constexpr auto POLL_INTERVAL = std::chrono::milliseconds{100};
+
+private:
+    struct Request {
+        std::uint32_t sequence;
+        bool getObjects;
+        bool getObjectNeighbors;
+        std::promise<OptionalResponseType> promise;
+
+        Source* source = nullptr;
+        std::unique_ptr<AsyncLedgerFetch> fetch;
+        std::vector<Source const*> failedAt;  // since the last retry delay
+        std::chrono::steady_clock::time_point notBefore;
+    };
+
+    util::Logger log_{"ETL"};
+
+    RankFunction rank_;
+    std::size_t fetchesPerSource_;
+
+    std::mutex mtx_;
+    bool stopping_ = false;
+    std::list<std::shared_ptr<Request>> queued_;
+    std::unordered_map<AsyncLedgerFetch const*, std::shared_ptr<Request>> running_;
+    std::unordered_map<Source const*, std::size_t> inFlight_;
+    std::size_t nextQueue_ = 0;
+
+    std::vector<std::unique_ptr<grpc::CompletionQueue>> queues_;
+    std::vector<std::thread> pollers_;
+
+public:
+    /**
+     * @brief Create the pool and start its poller threads.
+     *
+     * @param rank Returns the sources to try a request on, best first
+     * @param numPollers The number of poller threads, each with its own completion queue; at least 1
+     * @param fetchesPerSource The maximum number of calls in flight to a single source; at least 1
+     */
+    LedgerFetchPool(RankFunction rank, std::size_t numPollers, std::size_t fetchesPerSource);
+
+    ~LedgerFetchPool();
+
+    LedgerFetchPool(LedgerFetchPool const&) = delete;
+    LedgerFetchPool&
+    operator=(LedgerFetchPool const&) = delete;
+
+    /**
+     * @brief Start fetching a ledger.
+     *
+     * The ledger is fetched until a source returns it validated or the pool is stopped.
+     *
+     * @param sequence Sequence of the ledger to fetch
+     * @param getObjects Whether to get the account state diff between this ledger and the prior one
+     * @param getObjectNeighbors Whether to request object neighbors
+     * @return The response once it arrives; nullopt if the pool was stopped first
+     */
+    std::future<OptionalResponseType>
+    fetch(std::uint32_t sequence, bool getObjects, bool getObjectNeighbors);
+
+    /**
+     * @brief Cancel all calls, resolve all requests with nullopt and join the poller threads.
+     *
+     * Must be called before the sources go away.
+     */
+    void
+    stop();
+
+private:
+    void
+    poll(grpc::CompletionQueue& cq);
+
+    void
+    onComplete(AsyncLedgerFetch* fetch);
+
+    // start the queued requests that a source is free for; requires mtx_ to be held
+    void
+    dispatch();
+};
+
+}  // namespace etl::detail
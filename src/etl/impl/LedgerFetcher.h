@@ -26,6 +26,7 @@
 #include <grpcpp/grpcpp.h>
 #include <ripple/proto/org/xrpl/rpc/v1/xrp_ledger.grpc.pb.h>
 
+#include <future>
 #include <optional>
 #include <utility>
 
@@ -97,6 +98,24 @@ public:
 
         return response;
     }
+
+    /**
+     * @brief Start extracting diff data for a particular ledger without waiting for it; see fetchDataAndDiff().
+     *
+     * Lets a caller keep several ledgers in flight, e.g. while catching up.
+     *
+     * @param sequence sequence of the ledger to extract
+     * @return the data of fetchDataAndDiff() once it arrives
+     */
+    std::future<OptionalGetLedgerResponseType>
+    fetchDataAndDiffAsync(uint32_t sequence)
+    {
+        LOG(log_.debug()) << "Attempting to fetch ledger with sequence = " << sequence << " asynchronously";
+
+        return loadBalancer_->fetchLedgerAsync(
+            sequence, true, !backend_->cache().isFull() || backend_->cache().latestLedgerSequence() >= sequence
+        );
+    }
 };
 
 }  // namespace etl::detail
@@ -0,0 +1,302 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of clio: https://github.com/XRPLF/clio
+    Copyright (c) 2023, the clio developers.
+
+    Permission to use, copy, modify, and distribute this software for any
+    purpose with or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL,  DIRECT,  INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#pragma once
+
+#include "data/BackendInterface.h"
+#include "data/DBHelpers.h"
+#include "data/Types.h"
+#include "etl/impl/AsyncData.h"
+#include "etl/impl/LedgerRecording.h"
+#include "util/config/Config.h"
+#include "util/log/Logger.h"
+
+#include <ripple/basics/base_uint.h>
+#include <ripple/beast/core/CurrentThreadName.h>
+#include <ripple/proto/org/xrpl/rpc/v1/get_ledger_data.pb.h>
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace etl::detail {
+
+/**
+ * @brief Imports a ledger dump into an empty DB without a rippled, e.g. to bootstrap a full history node.
+ *
+ * The dump is a recording as written by LedgerRecordWriter: the state of its first ledger followed by every ledger
+ * from the first one on, each with its diff and object neighbors. The state is written as a snapshot of the first
+ * ledger and all ledgers as diffs on top of it. Ledgers are handed out in batches of `batch_size` consecutive ledgers
+ * to `threads` threads, which write their batch in order. Unlike the backfill, the import does not pause for the write
+ * load; only the outstanding write limit of the backend slows it down.
+ *
+ * The ledger range is only written once all ledgers are, so the ETL continues from the ledger after the last one.
+ */
+template <typename LedgerLoaderType>
+class LedgerImport {
+public:
+    using GetLedgerResponseType = typename LedgerLoaderType::GetLedgerResponseType;
+
+    static constexpr std::uint32_t DEFAULT_THREADS = 8;
+    static constexpr std::uint32_t DEFAULT_BATCH_SIZE = 256;
+
+private:
+    static constexpr std::uint64_t PROGRESS_INTERVAL = 10000;
+
+    using Batch = std::vector<LedgerRecordReader::Record>;
+
+    util::Logger log_{"ETL"};
+
+    std::shared_ptr<BackendInterface> backend_;
+    std::reference_wrapper<LedgerLoaderType> loader_;
+
+    std::uint32_t numThreads_ = DEFAULT_THREADS;
+    std::uint32_t batchSize_ = DEFAULT_BATCH_SIZE;
+
+    std::mutex mtx_;
+    std::condition_variable cv_;
+    std::deque<Batch> batches_;
+    bool isReadingDone_ = false;
+    std::exception_ptr error_;
+    std::atomic_uint64_t numImported_ = 0;
+
+public:
+    /**
+     * @brief Create the import.
+     *
+     * @param config The `import` section of the config
+     * @param backend The backend to write to
+     * @param loader The ledger loader that writes the ledgers
+     * @throws std::runtime_error if the config is invalid
+     */
+    LedgerImport(util::Config const& config, std::shared_ptr<BackendInterface> backend, LedgerLoaderType& loader)
+        : backend_{std::move(backend)}
+        , loader_{std::ref(loader)}
+        , numThreads_{config.valueOr<std::uint32_t>("threads", DEFAULT_THREADS)}
+        , batchSize_{config.valueOr<std::uint32_t>("batch_size", DEFAULT_BATCH_SIZE)}
+    {
+        if (numThreads_ == 0)
+            throw std::runtime_error("import.threads must be positive");
+
+        if (batchSize_ == 0)
+            throw std::runtime_error("import.batch_size must be positive");
+    }
+
+    /**
+     * @brief Import a dump and write the range of its ledgers.
+     *
+     * @param reader The dump
+     * @return The range of the DB after the import
+     * @throws std::runtime_error if the DB is not empty, the dump is not contiguous or a ledger could not be written.
+     * The range is not written then, so the DB has to be cleared before importing again
+     */
+    data::LedgerRange
+    run(LedgerRecordReader& reader)
+    {
+        if (backend_->hardFetchLedgerRangeNoThrow())
+            throw std::runtime_error("The DB must be empty to import a dump into it");
+
+        auto record = reader.next();
+        auto const first = importState(reader, record);
+        if (!record or record->kind != LedgerRecordKind::Ledger or record->sequence != first)
+            throw std::runtime_error("The dump has no ledger " + std::to_string(first) + " after its state");
+
+        std::vector<std::thread> threads;
+        threads.reserve(numThreads_);
+        for (auto i = 0u; i < numThreads_; ++i) {
+            threads.emplace_back([this]() {
+                beast::setCurrentThreadName("ETL import");
+                // imported ledgers are not committed one by one, so they don't start write groups
+                backend_->isolateThreadWrites();
+                importBatches();
+            });
+        }
+
+        // the last ledger is held back; it is written once all others are, so finishing it waits for all writes
+        auto last = std::move(*record);
+        try {
+            Batch batch;
+            while ((record = reader.next())) {
+                if (record->kind != LedgerRecordKind::Ledger or record->sequence != last.sequence + 1)
+                    throw std::runtime_error("The dump has a gap after ledger " + std::to_string(last.sequence));
+
+                batch.push_back(std::exchange(last, std::move(*record)));
+                if (batch.size() == batchSize_)
+                    push(std::exchange(batch, {}));
+            }
+
+            if (!batch.empty())
+                push(std::move(batch));
+        } catch (...) {
+            fail(std::current_exception());
+        }
+
+        {
+            std::scoped_lock const lck{mtx_};
+            isReadingDone_ = true;
+        }
+        cv_.notify_all();
+
+        for (auto& thread : threads)
+            thread.join();
+
+        if (error_)
+            std::rethrow_exception(error_);
+
+        importLedger(last);
+        return commit(first, last.sequence);
+    }
+
+private:
+    /**
+     * @brief Write the recorded state of the first ledger as a snapshot, with the edges of the successor table.
+     *
+     * @param reader The dump
+     * @param record The first record; left at the first record after the state
+     * @return The sequence of the first ledger
+     */
+    std::uint32_t
+    importState(LedgerRecordReader& reader, std::optional<LedgerRecordReader::Record>& record)
+    {
+        if (!record or record->kind != LedgerRecordKind::LedgerDataPage)
+            throw std::runtime_error("The dump does not start with the state of its first ledger");
+
+        auto const sequence = record->sequence;
+        LOG(log_.info()) << "Importing the state of ledger " << sequence;
+
+        // the recorded pages are a single range over the whole key space
+        AsyncCallData callData{sequence, ripple::uint256{}, std::nullopt};
+        for (; record and record->kind == LedgerRecordKind::LedgerDataPage; record = reader.next()) {
+            if (record->sequence != sequence)
+                throw std::runtime_error("The dump has the state of more than one ledger");
+
+            callData.processRecorded(
+                record->parse<org::xrpl::rpc::v1::GetLedgerDataResponse>(),
+                *backend_,
+                AsyncCallData::Target::DatabaseOnly
+            );
+        }
+
+        if (!callData.getFirstKey().empty()) {
+            backend_->writeSuccessor(uint256ToString(data::firstKey), sequence, callData.getFirstKey());
+            backend_->writeSuccessor(callData.getLastKey(), sequence, uint256ToString(data::lastKey));
+        }
+
+        return sequence;
+    }
+
+    void
+    push(Batch batch)
+    {
+        std::unique_lock lck{mtx_};
+
+        // bounds what is read ahead of the writes
+        cv_.wait(lck, [this]() { return batches_.size() < numThreads_ or error_; });
+        if (error_)
+            throw std::runtime_error("Stopped reading the dump as a ledger failed to import");
+
+        batches_.push_back(std::move(batch));
+        cv_.notify_all();
+    }
+
+    std::optional<Batch>
+    pop()
+    {
+        std::unique_lock lck{mtx_};
+        cv_.wait(lck, [this]() { return not batches_.empty() or isReadingDone_ or error_; });
+        if (batches_.empty() or error_)
+            return std::nullopt;
+
+        auto batch = std::move(batches_.front());
+        batches_.pop_front();
+        cv_.notify_all();
+        return batch;
+    }
+
+    void
+    importBatches()
+    {
+        while (auto batch = pop()) {
+            try {
+                for (auto const& record : *batch)
+                    importLedger(record);
+            } catch (...) {
+                fail(std::current_exception());
+                return;
+            }
+
+            auto const numImported = numImported_ += batch->size();
+            if (numImported / PROGRESS_INTERVAL != (numImported - batch->size()) / PROGRESS_INTERVAL)
+                LOG(log_.info()) << "Imported " << numImported << " ledgers";
+        }
+
+        // finishing the last ledger does not wait for isolated writes
+        backend_->syncThreadWrites();
+    }
+
+    void
+    importLedger(LedgerRecordReader::Record const& record)
+    {
+        auto ledger = record.parse<GetLedgerResponseType>();
+        loader_.get().loadLedgerDiff(ledger);
+    }
+
+    /** @brief Keep the first failure and stop reading and writing. */
+    void
+    fail(std::exception_ptr error)
+    {
+        {
+            std::scoped_lock const lck{mtx_};
+            if (!error_)
+                error_ = std::move(error);
+        }
+        cv_.notify_all();
+    }
+
+    /**
+     * @brief Write the range once all ledgers are written: the last ledger first, then the minimum is extended down to
+     * the first one, like a backfill does.
+     */
+    data::LedgerRange
+    commit(std::uint32_t first, std::uint32_t last)
+    {
+        if (!backend_->finishWrites(last))
+            throw std::runtime_error("Could not write the range of the imported ledgers");
+
+        if (first < last and !backend_->extendMinSequence(last, first))
+            throw std::runtime_error("Could not extend the range of the imported ledgers");
+
+        LOG(log_.info()) << "Imported ledgers " << first << " to " << last;
+        return {.minSequence = first, .maxSequence = last};
+    }
+};
+
+}  // namespace etl::detail
@@ -20,6 +20,8 @@
 #pragma once
 
 #include "data/BackendInterface.h"
+#include "data/DBHelpers.h"
+#include "data/Types.h"
 #include "etl/NFTHelpers.h"
 #include "etl/SystemState.h"
 #include "etl/impl/LedgerFetcher.h"
@@ -28,10 +30,20 @@
 #include "util/Profiler.h"
 #include "util/log/Logger.h"
 
+#include <boost/asio/post.hpp>
+#include <boost/asio/thread_pool.hpp>
 #include <ripple/beast/core/CurrentThreadName.h>
 
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <future>
 #include <memory>
+#include <optional>
+#include <stdexcept>
+#include <string>
 #include <utility>
+#include <vector>
 
 /**
  * @brief Account transactions, NFT transactions and NFT data bundled togeher.
@@ -40,10 +52,67 @@ struct FormattedTransactionsData {
     std::vector<AccountTransactionsData> accountTxData;
     std::vector<NFTTransactionsData> nfTokenTxData;
     std::vector<NFTsData> nfTokensData;
+    std::vector<data::TransactionAndMetadata> transactions;  // ordered by transaction index, ready to be published
 };
 
 namespace etl::detail {
 
+/**
+ * @brief Write the successors of the objects created or deleted in a ledger, using the neighbors sent by rippled.
+ *
+ * Does nothing if the data does not include object neighbors.
+ *
+ * @param backend The backend to write to
+ * @param sequence The sequence of the ledger
+ * @param rawData Data extracted from an ETL source; the neighbors and book successors are moved out of it
+ */
+template <typename RawLedgerObjectType, typename GetLedgerResponseType>
+void
+writeSuccessorsFromNeighbors(BackendInterface& backend, std::uint32_t sequence, GetLedgerResponseType& rawData)
+{
+    static util::Logger const log{"ETL"};
+
+    if (!rawData.object_neighbors_included())
+        return;
+
+    LOG(log.debug()) << "object neighbors included";
+
+    for (auto& obj : *(rawData.mutable_book_successors())) {
+        auto firstBook = std::move(*obj.mutable_first_book());
+        if (!firstBook.size())
+            firstBook = uint256ToString(data::lastKey);
+        LOG(log.debug()) << "writing book successor " << ripple::strHex(obj.book_base()) << " - "
+                         << ripple::strHex(firstBook);
+
+        backend.writeSuccessor(std::move(*obj.mutable_book_base()), sequence, std::move(firstBook));
+    }
+
+    for (auto& obj : *(rawData.mutable_ledger_objects()->mutable_objects())) {
+        if (obj.mod_type() != RawLedgerObjectType::MODIFIED) {
+            std::string* predPtr = obj.mutable_predecessor();
+            if (predPtr->empty())
+                *predPtr = uint256ToString(data::firstKey);
+            std::string* succPtr = obj.mutable_successor();
+            if (succPtr->empty())
+                *succPtr = uint256ToString(data::lastKey);
+
+            if (obj.mod_type() == RawLedgerObjectType::DELETED) {
+                LOG(log.debug()) << "Modifying successors for deleted object " << ripple::strHex(obj.key()) << " - "
+                                 << ripple::strHex(*predPtr) << " - " << ripple::strHex(*succPtr);
+
+                backend.writeSuccessor(std::move(*predPtr), sequence, std::move(*succPtr));
+            } else {
+                LOG(log.debug()) << "adding successor for new object " << ripple::strHex(obj.key()) << " - "
+                                 << ripple::strHex(*predPtr) << " - " << ripple::strHex(*succPtr);
+
+                backend.writeSuccessor(std::move(*predPtr), sequence, std::string{obj.key()});
+                backend.writeSuccessor(std::string{obj.key()}, sequence, std::move(*succPtr));
+            }
+        } else
+            LOG(log.debug()) << "object modified " << ripple::strHex(obj.key());
+    }
+}
+
 /**
  * @brief Loads ledger data into the DB
  */
@@ -62,21 +131,37 @@ private:
     std::reference_wrapper<LedgerFetcherType> fetcher_;
     std::reference_wrapper<SystemState const> state_;  // shared state for ETL
 
+    // ledgers with fewer transactions than this per decode thread are not worth splitting
+    static constexpr std::size_t MIN_TXNS_PER_SHARD = 64;
+
+    std::uint32_t decodeThreads_;
+    std::optional<boost::asio::thread_pool> decodePool_;  // only used with more than one decode thread
+
 public:
     /**
      * @brief Create an instance of the loader
+     *
+     * @param backend The backend to write to
+     * @param balancer The load balancer to fetch the initial ledger from
+     * @param fetcher The ledger fetcher
+     * @param state The shared ETL state
+     * @param decodeThreads The number of threads decoding the transactions of large ledgers; 1 decodes on the caller
      */
     LedgerLoader(
         std::shared_ptr<BackendInterface> backend,
         std::shared_ptr<LoadBalancerType> balancer,
         LedgerFetcherType& fetcher,
-        SystemState const& state
+        SystemState const& state,
+        std::uint32_t decodeThreads = 1
     )
         : backend_{std::move(backend)}
         , loadBalancer_{std::move(balancer)}
         , fetcher_{std::ref(fetcher)}
         , state_{std::cref(state)}
+        , decodeThreads_{std::max(decodeThreads, 1u)}
     {
+        if (decodeThreads_ > 1)
+            decodePool_.emplace(decodeThreads_);
     }
 
     /**
@@ -85,6 +170,9 @@ public:
      * Insert all of the extracted transactions into the ledger, returning transactions related to accounts,
      * transactions related to NFTs, and NFTs themselves for later processsing.
      *
+     * Large ledgers are decoded in shards on the decode pool; the results and the writes keep the order in which the
+     * transactions were received.
+     *
      * @param ledger ledger to insert transactions into
      * @param data data extracted from an ETL source
      * @return struct that contains the neccessary info to write to the account_transactions/account_tx and
@@ -94,32 +182,36 @@ public:
     insertTransactions(ripple::LedgerHeader const& ledger, GetLedgerResponseType& data)
     {
         FormattedTransactionsData result;
+        auto decoded = decodeTransactions(ledger, data);
 
-        for (auto& txn : *(data.mutable_transactions_list()->mutable_transactions())) {
-            std::string* raw = txn.mutable_transaction_blob();
-
-            ripple::SerialIter it{raw->data(), raw->size()};
-            ripple::STTx const sttx{it};
+        // kept alongside the writes so the ledger can be published without reading it back from the DB
+        std::vector<std::pair<std::uint32_t, data::TransactionAndMetadata>> transactions;
+        transactions.reserve(decoded.size());
+        result.accountTxData.reserve(decoded.size());
 
-            LOG(log_.trace()) << "Inserting transaction = " << sttx.getTransactionID();
+        // merged and written in the order the transactions were received, no matter how they were decoded
+        for (auto& tx : decoded) {
+            LOG(log_.trace()) << "Inserting transaction = " << tx.id;
 
-            ripple::TxMeta txMeta{sttx.getTransactionID(), ledger.seq, txn.metadata_blob()};
+            result.nfTokenTxData.insert(result.nfTokenTxData.end(), tx.nfTokenTxData.begin(), tx.nfTokenTxData.end());
+            if (tx.nfTokenData)
+                result.nfTokensData.push_back(*tx.nfTokenData);
 
-            auto const [nftTxs, maybeNFT] = getNFTDataFromTx(txMeta, sttx);
-            result.nfTokenTxData.insert(result.nfTokenTxData.end(), nftTxs.begin(), nftTxs.end());
-            if (maybeNFT)
-                result.nfTokensData.push_back(*maybeNFT);
+            auto const index = tx.accountTxData.transactionIndex;
+            backend_->writeTransactionIndex(ledger.seq, index, tx.id);
 
-            result.accountTxData.emplace_back(txMeta, sttx.getTransactionID());
             static constexpr std::size_t KEY_SIZE = 32;
-            std::string keyStr{reinterpret_cast<char const*>(sttx.getTransactionID().data()), KEY_SIZE};
+            std::string keyStr{reinterpret_cast<char const*>(tx.id.data()), KEY_SIZE};
             backend_->writeTransaction(
                 std::move(keyStr),
                 ledger.seq,
                 ledger.closeTime.time_since_epoch().count(),
-                std::move(*raw),
-                std::move(*txn.mutable_metadata_blob())
+                std::move(tx.encodedTransaction),
+                std::move(tx.encodedMetadata)
             );
+
+            transactions.emplace_back(index, std::move(tx.transaction));
+            result.accountTxData.push_back(std::move(tx.accountTxData));
         }
 
         // Remove all but the last NFTsData for each id. unique removes all but the first of a group, so we want to
@@ -136,13 +228,23 @@ public:
         );
         result.nfTokensData.erase(last, result.nfTokensData.end());
 
+        std::sort(transactions.begin(), transactions.end(), [](auto const& a, auto const& b) {
+            return a.first < b.first;
+        });
+
+        result.transactions.reserve(transactions.size());
+        for (auto& indexAndTx : transactions)
+            result.transactions.push_back(std::move(indexAndTx.second));
+
         return result;
     }
 
     /**
      * @brief Download a ledger with specified sequence in full
      *
-     * Note: This takes several minutes or longer.
+     * Note: This takes several minutes or longer. If an earlier download was interrupted, e.g. by a restart, that
+     * download is resumed instead, even if it was of another ledger. The cache is only marked as full if the download
+     * was not resumed, as the objects written before the restart are not in it.
      *
      * @param sequence the sequence of the ledger to download
      * @return The ledger downloaded, with a full transaction and account state map
@@ -157,6 +259,14 @@ public:
             return {};
         }
 
+        auto const progress = data::synchronousAndRetryOnTimeout([this](auto yield) {
+            return backend_->fetchInitialLoadProgress(yield);
+        });
+        if (progress) {
+            LOG(log_.info()) << "Found an interrupted download of ledger " << progress->sequence << ". Resuming it";
+            sequence = progress->sequence;
+        }
+
         // Fetch the ledger from the network. This function will not return until either the fetch is successful, or the
         // server is being shutdown. This only fetches the ledger header and the transactions+metadata
         OptionalGetLedgerResponseType ledgerData{fetcher_.get().fetchData(sequence)};
@@ -167,89 +277,205 @@ public:
 
         LOG(log_.debug()) << "Deserialized ledger header. " << ::util::toString(lgrInfo);
 
-        auto timeDiff = ::util::timed<std::chrono::duration<double>>([this, sequence, &lgrInfo, &ledgerData]() {
-            backend_->startWrites();
-
-            LOG(log_.debug()) << "Started writes";
-
-            backend_->writeLedger(lgrInfo, std::move(*ledgerData->mutable_ledger_header()));
-
-            LOG(log_.debug()) << "Wrote ledger";
-            FormattedTransactionsData insertTxResult = insertTransactions(lgrInfo, *ledgerData);
-            LOG(log_.debug()) << "Inserted txns";
-
-            // download the full account state map. This function downloads full
-            // ledger data and pushes the downloaded data into the writeQueue.
-            // asyncWriter consumes from the queue and inserts the data into the
-            // Ledger object. Once the below call returns, all data has been pushed
-            // into the queue
-            auto [edgeKeys, success] = loadBalancer_->loadInitialLedger(sequence);
-
-            if (success) {
-                size_t numWrites = 0;
-                backend_->cache().setFull();
-
-                auto seconds = ::util::timed<std::chrono::seconds>([this, edgeKeys = &edgeKeys, sequence, &numWrites] {
-                    for (auto& key : *edgeKeys) {
-                        LOG(log_.debug()) << "Writing edge key = " << ripple::strHex(key);
-                        auto succ = backend_->cache().getSuccessor(*ripple::uint256::fromVoidChecked(key), sequence);
-                        if (succ)
-                            backend_->writeSuccessor(std::move(key), sequence, uint256ToString(succ->key));
-                    }
-
-                    ripple::uint256 prev = data::firstKey;
-                    while (auto cur = backend_->cache().getSuccessor(prev, sequence)) {
-                        ASSERT(cur.has_value(), "Succesor for key {} must exist", ripple::strHex(prev));
-                        if (prev == data::firstKey)
-                            backend_->writeSuccessor(uint256ToString(prev), sequence, uint256ToString(cur->key));
-
-                        if (isBookDir(cur->key, cur->blob)) {
-                            auto base = getBookBase(cur->key);
-                            // make sure the base is not an actual object
-                            if (!backend_->cache().get(cur->key, sequence)) {
-                                auto succ = backend_->cache().getSuccessor(base, sequence);
-                                ASSERT(succ.has_value(), "Book base {} must have a successor", ripple::strHex(base));
-                                if (succ->key == cur->key) {
-                                    LOG(log_.debug()) << "Writing book successor = " << ripple::strHex(base) << " - "
-                                                      << ripple::strHex(cur->key);
-
-                                    backend_->writeSuccessor(
-                                        uint256ToString(base), sequence, uint256ToString(cur->key)
-                                    );
-                                }
-                            }
-
-                            ++numWrites;
-                        }
-
-                        prev = cur->key;
-                        static constexpr std::size_t LOG_INTERVAL = 100000;
-                        if (numWrites % LOG_INTERVAL == 0 && numWrites != 0)
-                            LOG(log_.info()) << "Wrote " << numWrites << " book successors";
-                    }
-
-                    backend_->writeSuccessor(uint256ToString(prev), sequence, uint256ToString(data::lastKey));
-                    ++numWrites;
-                });
-
-                LOG(log_.info()) << "Looping through cache and submitting all writes took " << seconds
-                                 << " seconds. numWrites = " << std::to_string(numWrites);
-            }
+        auto timeDiff = ::util::timed<std::chrono::duration<double>>(
+            [this, sequence, isResumed = progress.has_value(), &lgrInfo, &ledgerData]() {
+                backend_->startWrites();
 
-            LOG(log_.debug()) << "Loaded initial ledger";
+                LOG(log_.debug()) << "Started writes";
 
-            if (not state_.get().isStopping) {
-                backend_->writeAccountTransactions(std::move(insertTxResult.accountTxData));
-                backend_->writeNFTs(insertTxResult.nfTokensData);
-                backend_->writeNFTTransactions(insertTxResult.nfTokenTxData);
-            }
+                backend_->writeLedger(lgrInfo, std::move(*ledgerData->mutable_ledger_header()));
 
-            backend_->finishWrites(sequence);
-        });
+                LOG(log_.debug()) << "Wrote ledger";
+                FormattedTransactionsData insertTxResult = insertTransactions(lgrInfo, *ledgerData);
+                LOG(log_.debug()) << "Inserted txns";
+
+                // download the full account state map, including all successors. Once the below call returns, all data
+                // has been pushed into the write queue. If a source fails, the next one picks up where it stopped
+                auto const success = loadBalancer_->loadInitialLedger(sequence);
+                if (success and not isResumed)
+                    backend_->cache().setFull();
+
+                LOG(log_.debug()) << "Loaded initial ledger";
+
+                if (not state_.get().isStopping) {
+                    backend_->writeAccountTransactions(std::move(insertTxResult.accountTxData));
+                    backend_->writeNFTs(insertTxResult.nfTokensData);
+                    backend_->writeNFTTransactions(insertTxResult.nfTokenTxData);
+                }
+
+                backend_->finishWrites(sequence);
+                backend_->clearInitialLoadProgress();
+            }
+        );
 
         LOG(log_.debug()) << "Time to download and store ledger = " << timeDiff;
         return lgrInfo;
     }
+
+    /**
+     * @brief Write a ledger below the range of the DB in full: header, transactions, diff and account state map.
+     *
+     * Unlike loadInitialLedger the DB does not have to be empty and the cache is left alone. Only the objects of the
+     * diff are added to the ledger diff. The writes are not waited for; see BackendInterface::writeBackfilledChunk.
+     *
+     * @param sequence the sequence of the ledger to download
+     * @return true if the ledger was written; false if the server is shutting down
+     * @throw std::runtime_error if the data has no object neighbors or a transaction could not be decoded
+     */
+    bool
+    loadLedgerSnapshot(uint32_t sequence)
+    {
+        // the diff holds the objects deleted by this ledger, which the snapshot knows nothing about
+        OptionalGetLedgerResponseType ledgerData{fetcher_.get().fetchDataAndDiff(sequence)};
+        if (!ledgerData)
+            return false;
+
+        loadLedgerDiff(*ledgerData);
+        return loadBalancer_->loadLedgerSnapshot(sequence);
+    }
+
+    /**
+     * @brief Write a ledger below the range of the DB on top of the ledger before it, which must be written already.
+     *
+     * Successors are taken from the object neighbors in the data, as the cache only covers the latest ledgers.
+     *
+     * @param data Data of the ledger, fetched with its diff and object neighbors
+     * @throw std::runtime_error if the data has no object neighbors or a transaction could not be decoded
+     */
+    void
+    loadLedgerDiff(GetLedgerResponseType& data)
+    {
+        if (!data.object_neighbors_included())
+            throw std::runtime_error("Object neighbors are required to load a ledger diff");
+
+        ripple::LedgerHeader const lgrInfo = ::util::deserializeHeader(ripple::makeSlice(data.ledger_header()));
+        LOG(log_.debug()) << "Loading diff of ledger. " << ::util::toString(lgrInfo);
+
+        backend_->writeLedger(lgrInfo, std::move(*data.mutable_ledger_header()));
+        writeSuccessorsFromNeighbors<RawLedgerObjectType>(*backend_, lgrInfo.seq, data);
+
+        for (auto& obj : *(data.mutable_ledger_objects()->mutable_objects()))
+            backend_->writeLedgerObject(std::move(*obj.mutable_key()), lgrInfo.seq, std::move(*obj.mutable_data()));
+
+        auto insertTxResult = insertTransactions(lgrInfo, data);
+        backend_->writeAccountTransactions(std::move(insertTxResult.accountTxData));
+        backend_->writeNFTs(insertTxResult.nfTokensData);
+        backend_->writeNFTTransactions(insertTxResult.nfTokenTxData);
+    }
+
+    /**
+     * @brief Write the deletions of a ledger that was loaded as a plain snapshot, such as the initial ledger.
+     *
+     * Used for the ledger right above a backfilled chunk. A plain snapshot only holds what exists, so reads of it would
+     * otherwise find the objects and first book directories it deleted in the chunk below. Nothing is added to the
+     * ledger diff.
+     *
+     * @param data Data of the ledger, fetched with its diff and object neighbors
+     * @throw std::runtime_error if the data has no object neighbors
+     */
+    void
+    loadDeletions(GetLedgerResponseType& data)
+    {
+        if (!data.object_neighbors_included())
+            throw std::runtime_error("Object neighbors are required to load deletions");
+
+        ripple::LedgerHeader const lgrInfo = ::util::deserializeHeader(ripple::makeSlice(data.ledger_header()));
+        writeSuccessorsFromNeighbors<RawLedgerObjectType>(*backend_, lgrInfo.seq, data);
+
+        for (auto& obj : *(data.mutable_ledger_objects()->mutable_objects())) {
+            if (obj.mod_type() == RawLedgerObjectType::DELETED)
+                backend_->writeSnapshotObject(std::move(*obj.mutable_key()), lgrInfo.seq, std::string{});
+        }
+    }
+
+private:
+    /** @brief Everything derived from a single transaction; produced by the decode stage. */
+    struct DecodedTransaction {
+        ripple::uint256 id;
+        AccountTransactionsData accountTxData;
+        std::vector<NFTTransactionsData> nfTokenTxData;
+        std::optional<NFTsData> nfTokenData;
+        data::TransactionAndMetadata transaction;
+        std::string encodedTransaction;
+        std::string encodedMetadata;
+    };
+
+    /**
+     * @brief Decode all transactions of a ledger, in parallel on the decode pool if the ledger is large enough.
+     *
+     * @return The decoded transactions in the order they were received
+     * @throw std::runtime_error if any transaction could not be decoded
+     */
+    std::vector<DecodedTransaction>
+    decodeTransactions(ripple::LedgerHeader const& ledger, GetLedgerResponseType& data)
+    {
+        auto& txns = *(data.mutable_transactions_list()->mutable_transactions());
+        auto const numTxns = static_cast<std::size_t>(txns.size());
+        std::vector<DecodedTransaction> decoded(numTxns);
+
+        auto decodeRange = [&](std::size_t begin, std::size_t end) {
+            for (auto i = begin; i < end; ++i)
+                decoded[i] = decodeTransaction(ledger, txns[static_cast<int>(i)]);
+        };
+
+        auto const numShards =
+            std::min<std::size_t>(decodeThreads_, (numTxns + MIN_TXNS_PER_SHARD - 1) / MIN_TXNS_PER_SHARD);
+        if (numShards <= 1 or not decodePool_.has_value()) {
+            decodeRange(0, numTxns);
+            return decoded;
+        }
+
+        // each shard fills its own contiguous slice of decoded so the order is the same as with a single thread
+        auto const shardSize = (numTxns + numShards - 1) / numShards;
+        std::vector<std::future<void>> shards;
+        shards.reserve(numShards);
+
+        for (auto shard = 0u; shard < numShards; ++shard) {
+            auto const begin = shard * shardSize;
+            auto const end = std::min(numTxns, begin + shardSize);
+            auto task = std::packaged_task<void()>{[&decodeRange, begin, end]() { decodeRange(begin, end); }};
+
+            shards.push_back(task.get_future());
+            boost::asio::post(*decodePool_, std::move(task));
+        }
+
+        // all shards must be done with decoded before a decoding error is rethrown
+        for (auto& shard : shards)
+            shard.wait();
+
+        for (auto& shard : shards)
+            shard.get();
+
+        return decoded;
+    }
+
+    template <typename RawTransactionType>
+    DecodedTransaction
+    decodeTransaction(ripple::LedgerHeader const& ledger, RawTransactionType& txn) const
+    {
+        std::string* raw = txn.mutable_transaction_blob();
+
+        ripple::SerialIter it{raw->data(), raw->size()};
+        ripple::STTx const sttx{it};
+        ripple::TxMeta txMeta{sttx.getTransactionID(), ledger.seq, txn.metadata_blob()};
+
+        auto [nftTxs, maybeNFT] = getNFTDataFromTx(txMeta, sttx);
+
+        DecodedTransaction decoded;
+        decoded.id = sttx.getTransactionID();
+        decoded.accountTxData = AccountTransactionsData{txMeta, decoded.id, sttx.getTxnType()};
+        decoded.nfTokenTxData = std::move(nftTxs);
+        decoded.nfTokenData = std::move(maybeNFT);
+        decoded.transaction = data::TransactionAndMetadata{
+            data::Blob{raw->begin(), raw->end()},
+            data::Blob{txn.metadata_blob().begin(), txn.metadata_blob().end()},
+            ledger.seq,
+            static_cast<std::uint32_t>(ledger.closeTime.time_since_epoch().count())
+        };
+        decoded.encodedTransaction = backend_->codec().encode(std::move(*raw));
+        decoded.encodedMetadata = backend_->codec().encode(std::move(*txn.mutable_metadata_blob()));
+        return decoded;
+    }
 };
 
 }  // namespace etl::detail
@@ -25,11 +25,18 @@
 #include "util/Assert.h"
 #include "util/LedgerUtils.h"
 #include "util/log/Logger.h"
+#include "util/prometheus/Label.h"
+#include "util/prometheus/Prometheus.h"
 
 #include <ripple/protocol/LedgerHeader.h>
 
+#include <algorithm>
 #include <chrono>
+#include <cstdint>
+#include <functional>
+#include <optional>
 #include <utility>
+#include <vector>
 
 namespace etl::detail {
 
@@ -43,6 +50,9 @@ namespace etl::detail {
  * monitoring processes will not be able to detect if the writer failed. Therefore, publishing each ledger (which
  * includes reading all of the transactions from the database) is done from the application wide asio io_service, and a
  * strand is used to ensure ledgers are published in order.
+ *
+ * The writer already holds the transactions of the ledgers it wrote, so it hands them over directly and only the
+ * monitoring processes read them back from the database.
  */
 template <typename SubscriptionManagerType, typename CacheType>
 class LedgerPublisher {
@@ -64,6 +74,18 @@ class LedgerPublisher {
     std::optional<uint32_t> lastPublishedSequence_;
     mutable std::shared_mutex lastPublishedSeqMtx_;
 
+    // time from the close of a ledger to it being published, by where the transactions came from
+    std::reference_wrapper<util::prometheus::HistogramInt> publishFromMemoryHistogram_;
+    std::reference_wrapper<util::prometheus::HistogramInt> publishFromDatabaseHistogram_;
+
+    static std::vector<std::int64_t> const&
+    publishDurationBuckets()
+    {
+        // close times are rounded to the close time resolution of the network, so finer buckets would only show noise
+        static std::vector<std::int64_t> const buckets{500, 1000, 2000, 3000, 4000, 5000, 7000, 10000, 20000, 60000};
+        return buckets;
+    }
+
 public:
     /**
      * @brief Create an instance of the publisher
@@ -80,6 +102,18 @@ public:
         , cache_{cache}
         , subscriptions_{std::move(subscriptions)}
         , state_{std::cref(state)}
+        , publishFromMemoryHistogram_{PrometheusService::histogramInt(
+              "etl_publish_duration_milliseconds_histogram",
+              util::prometheus::Labels({{"source", "memory"}}),
+              publishDurationBuckets(),
+              "The time from the close of a ledger until it is published"
+          )}
+        , publishFromDatabaseHistogram_{PrometheusService::histogramInt(
+              "etl_publish_duration_milliseconds_histogram",
+              util::prometheus::Labels({{"source", "database"}}),
+              publishDurationBuckets(),
+              "The time from the close of a ledger until it is published"
+          )}
     {
     }
 
@@ -112,6 +146,9 @@ public:
                 continue;
             }
 
+            // the ETL writer may have pruned or backfilled history since we last looked
+            backend_->updateRangeMin(range->minSequence);
+
             auto lgr = data::synchronousAndRetryOnTimeout([&](auto yield) {
                 return backend_->fetchLedgerBySequence(ledgerSequence, yield);
             });
@@ -128,74 +165,28 @@ public:
      * @brief Publish the passed ledger asynchronously.
      *
      * All ledgers are published thru publishStrand_ which ensures that all publishes are performed in a serial fashion.
+     * The transactions of the ledger are read from the database.
      *
      * @param lgrInfo the ledger to publish
      */
     void
     publish(ripple::LedgerHeader const& lgrInfo)
     {
-        boost::asio::post(publishStrand_, [this, lgrInfo = lgrInfo]() {
-            LOG(log_.info()) << "Publishing ledger " << std::to_string(lgrInfo.seq);
-
-            if (!state_.get().isWriting) {
-                LOG(log_.info()) << "Updating cache";
-
-                std::vector<data::LedgerObject> const diff = data::synchronousAndRetryOnTimeout([&](auto yield) {
-                    return backend_->fetchLedgerDiff(lgrInfo.seq, yield);
-                });
-
-                cache_.get().update(diff, lgrInfo.seq);
-                backend_->updateRange(lgrInfo.seq);
-            }
-
-            setLastClose(lgrInfo.closeTime);
-            auto age = lastCloseAgeSeconds();
-
-            // if the ledger closed over MAX_LEDGER_AGE_SECONDS ago, assume we are still catching up and don't publish
-            // TODO: this probably should be a strategy
-            static constexpr std::uint32_t MAX_LEDGER_AGE_SECONDS = 600;
-            if (age < MAX_LEDGER_AGE_SECONDS) {
-                std::optional<ripple::Fees> fees = data::synchronousAndRetryOnTimeout([&](auto yield) {
-                    return backend_->fetchFees(lgrInfo.seq, yield);
-                });
-                ASSERT(fees.has_value(), "Fees must exist for ledger {}", lgrInfo.seq);
-
-                std::vector<data::TransactionAndMetadata> transactions =
-                    data::synchronousAndRetryOnTimeout([&](auto yield) {
-                        return backend_->fetchAllTransactionsInLedger(lgrInfo.seq, yield);
-                    });
-
-                auto const ledgerRange = backend_->fetchLedgerRange();
-                ASSERT(ledgerRange.has_value(), "Ledger range must exist");
-
-                std::string const range =
-                    std::to_string(ledgerRange->minSequence) + "-" + std::to_string(ledgerRange->maxSequence);
-
-                subscriptions_->pubLedger(lgrInfo, *fees, range, transactions.size());
-
-                // order with transaction index
-                std::sort(transactions.begin(), transactions.end(), [](auto const& t1, auto const& t2) {
-                    ripple::SerialIter iter1{t1.metadata.data(), t1.metadata.size()};
-                    ripple::STObject const object1(iter1, ripple::sfMetadata);
-                    ripple::SerialIter iter2{t2.metadata.data(), t2.metadata.size()};
-                    ripple::STObject const object2(iter2, ripple::sfMetadata);
-                    return object1.getFieldU32(ripple::sfTransactionIndex) <
-                        object2.getFieldU32(ripple::sfTransactionIndex);
-                });
-
-                for (auto& txAndMeta : transactions)
-                    subscriptions_->pubTransaction(txAndMeta, lgrInfo);
-
-                subscriptions_->pubBookChanges(lgrInfo, transactions);
-
-                setLastPublishTime();
-                LOG(log_.info()) << "Published ledger " << std::to_string(lgrInfo.seq);
-            } else
-                LOG(log_.info()) << "Skipping publishing ledger " << std::to_string(lgrInfo.seq);
-        });
+        schedulePublish(lgrInfo, std::nullopt);
+    }
 
-        // we track latest publish-requested seq, not necessarily already published
-        setLastPublishedSequence(lgrInfo.seq);
+    /**
+     * @brief Publish the passed ledger asynchronously using transactions that are already in memory.
+     *
+     * Used by the writer right after it committed the ledger so nothing has to be read back from the database.
+     *
+     * @param lgrInfo the ledger to publish
+     * @param transactions all transactions of the ledger, ordered by transaction index
+     */
+    void
+    publish(ripple::LedgerHeader const& lgrInfo, std::vector<data::TransactionAndMetadata> transactions)
+    {
+        schedulePublish(lgrInfo, std::move(transactions));
     }
 
     /**
@@ -245,6 +236,109 @@ public:
     }
 
 private:
+    void
+    schedulePublish(
+        ripple::LedgerHeader const& lgrInfo,
+        std::optional<std::vector<data::TransactionAndMetadata>> inMemoryTransactions
+    )
+    {
+        boost::asio::post(
+            publishStrand_,
+            [this, lgrInfo = lgrInfo, inMemoryTransactions = std::move(inMemoryTransactions)]() mutable {
+                LOG(log_.info()) << "Publishing ledger " << std::to_string(lgrInfo.seq);
+
+                if (!state_.get().isWriting) {
+                    LOG(log_.info()) << "Updating cache";
+
+                    std::vector<data::LedgerObject> const diff = data::synchronousAndRetryOnTimeout([&](auto yield) {
+                        return backend_->fetchLedgerDiff(lgrInfo.seq, yield);
+                    });
+
+                    cache_.get().update(diff, lgrInfo.seq);
+                    backend_->updateRange(lgrInfo.seq);
+                }
+
+                setLastClose(lgrInfo.closeTime);
+                auto age = lastCloseAgeSeconds();
+
+                // if the ledger closed over MAX_LEDGER_AGE_SECONDS ago, assume we are still catching up and don't
+                // publish
+                // TODO: this probably should be a strategy
+                static constexpr std::uint32_t MAX_LEDGER_AGE_SECONDS = 600;
+                if (age < MAX_LEDGER_AGE_SECONDS) {
+                    // served from the cache when it is up to date with this ledger
+                    std::optional<ripple::Fees> fees = data::synchronousAndRetryOnTimeout([&](auto yield) {
+                        return backend_->fetchFees(lgrInfo.seq, yield);
+                    });
+                    ASSERT(fees.has_value(), "Fees must exist for ledger {}", lgrInfo.seq);
+
+                    auto const fromMemory = inMemoryTransactions.has_value();
+                    auto transactions = fromMemory ? std::move(*inMemoryTransactions) : fetchTransactions(lgrInfo.seq);
+
+                    auto const ledgerRange = backend_->fetchLedgerRange();
+                    ASSERT(ledgerRange.has_value(), "Ledger range must exist");
+
+                    std::string const range =
+                        std::to_string(ledgerRange->minSequence) + "-" + std::to_string(ledgerRange->maxSequence);
+
+                    subscriptions_->pubLedger(lgrInfo, *fees, range, transactions.size());
+
+                    for (auto& txAndMeta : transactions)
+                        subscriptions_->pubTransaction(txAndMeta, lgrInfo);
+
+                    subscriptions_->pubBookChanges(lgrInfo, transactions);
+
+                    setLastPublishTime();
+                    auto const duration = std::chrono::duration_cast<std::chrono::milliseconds>(sinceClose(lgrInfo));
+                    (fromMemory ? publishFromMemoryHistogram_ : publishFromDatabaseHistogram_)
+                        .get()
+                        .observe(duration.count());
+
+                    LOG(log_.info()) << "Published ledger " << std::to_string(lgrInfo.seq) << " " << duration.count()
+                                     << " ms after its close";
+                } else
+                    LOG(log_.info()) << "Skipping publishing ledger " << std::to_string(lgrInfo.seq);
+            }
+        );
+
+        // we track latest publish-requested seq, not necessarily already published
+        setLastPublishedSequence(lgrInfo.seq);
+    }
+
+    /**
+     * @brief Read the transactions of a ledger from the database, ordered by transaction index.
+     */
+    std::vector<data::TransactionAndMetadata>
+    fetchTransactions(std::uint32_t ledgerSequence)
+    {
+        std::vector<data::TransactionAndMetadata> transactions = data::synchronousAndRetryOnTimeout([&](auto yield) {
+            return backend_->fetchAllTransactionsInLedger(ledgerSequence, yield);
+        });
+
+        // order with transaction index
+        std::sort(transactions.begin(), transactions.end(), [](auto const& t1, auto const& t2) {
+            ripple::SerialIter iter1{t1.metadata.data(), t1.metadata.size()};
+            ripple::STObject const object1(iter1, ripple::sfMetadata);
+            ripple::SerialIter iter2{t2.metadata.data(), t2.metadata.size()};
+            ripple::STObject const object2(iter2, ripple::sfMetadata);
+            return object1.getFieldU32(ripple::sfTransactionIndex) < object2.getFieldU32(ripple::sfTransactionIndex);
+        });
+
+        return transactions;
+    }
+
+    /**
+     * @return The time since the close of a ledger; 0 if its close time is ahead of the local clock
+     */
+    static std::chrono::system_clock::duration
+    sinceClose(ripple::LedgerHeader const& lgrInfo)
+    {
+        auto const closeTime = std::chrono::system_clock::time_point{
+            std::chrono::seconds{rippleEpochStart + lgrInfo.closeTime.time_since_epoch().count()}
+        };
+        return std::max(std::chrono::system_clock::now() - closeTime, std::chrono::system_clock::duration::zero());
+    }
+
     void
     setLastClose(std::chrono::time_point<ripple::NetClock> lastCloseTime)
     {
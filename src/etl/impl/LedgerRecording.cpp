@@ -0,0 +1,173 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of clio: https://github.com/XRPLF/clio
+    Copyright (c) 2023, the clio developers.
+
+    Permission to use, copy, modify, and distribute this software for any
+    purpose with or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL,  DIRECT,  INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include "etl/impl/LedgerRecording.h"
+
+#include <fmt/core.h>
+#include <ripple/proto/org/xrpl/rpc/v1/get_ledger.pb.h>
+#include <ripple/proto/org/xrpl/rpc/v1/get_ledger_data.pb.h>
+#include <zstd.h>
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <ios>
+#include <optional>
+#include <stdexcept>
+#include <string>
+
+namespace etl::detail {
+
+namespace {
+
+// a recorded response is at most a few hundred megabytes; guards against allocating based on a corrupted size
+constexpr std::uint32_t MAX_PAYLOAD_SIZE = 1024u * 1024 * 1024;
+
+constexpr std::size_t RECORD_HEADER_SIZE = 9;
+
+void
+putUint32(char* out, std::uint32_t value)
+{
+    for (std::size_t i = 0; i < 4; ++i)
+        out[i] = static_cast<char>((value >> (8 * i)) & 0xFF);
+}
+
+std::uint32_t
+getUint32(char const* in)
+{
+    std::uint32_t value = 0;
+    for (std::size_t i = 0; i < 4; ++i)
+        value |= static_cast<std::uint32_t>(static_cast<unsigned char>(in[i])) << (8 * i);
+    return value;
+}
+
+}  // namespace
+
+LedgerRecordWriter::LedgerRecordWriter(std::string const& path) : out_{path, std::ios::binary | std::ios::trunc}
+{
+    if (!out_)
+        throw std::runtime_error("Can't create ledger recording " + path);
+
+    out_.write(MAGIC.data(), static_cast<std::streamsize>(MAGIC.size()));
+    out_.put(static_cast<char>(VERSION));
+}
+
+void
+LedgerRecordWriter::writeLedgerDataPage(std::uint32_t sequence, org::xrpl::rpc::v1::GetLedgerDataResponse const& page)
+{
+    write(LedgerRecordKind::LedgerDataPage, sequence, page.SerializeAsString());
+}
+
+void
+LedgerRecordWriter::writeLedger(std::uint32_t sequence, org::xrpl::rpc::v1::GetLedgerResponse const& ledger)
+{
+    write(LedgerRecordKind::Ledger, sequence, ledger.SerializeAsString());
+}
+
+void
+LedgerRecordWriter::flush()
+{
+    out_.flush();
+    if (!out_)
+        throw std::runtime_error("Can't write ledger recording");
+}
+
+void
+LedgerRecordWriter::write(LedgerRecordKind kind, std::uint32_t sequence, std::string const& serialized)
+{
+    std::string payload(ZSTD_compressBound(serialized.size()), '\0');
+    auto const size =
+        ZSTD_compress(payload.data(), payload.size(), serialized.data(), serialized.size(), COMPRESSION_LEVEL);
+    if (ZSTD_isError(size))
+        throw std::runtime_error(fmt::format("Can't compress ledger {}: {}", sequence, ZSTD_getErrorName(size)));
+    payload.resize(size);
+
+    std::array<char, RECORD_HEADER_SIZE> header{};
+    header[0] = static_cast<char>(kind);
+    putUint32(header.data() + 1, sequence);
+    putUint32(header.data() + 5, static_cast<std::uint32_t>(payload.size()));
+
+    out_.write(header.data(), header.size());
+    out_.write(payload.data(), static_cast<std::streamsize>(payload.size()));
+    if (!out_)
+        throw std::runtime_error(fmt::format("Can't write ledger {} to the recording", sequence));
+}
+
+LedgerRecordReader::LedgerRecordReader(std::string const& path) : in_{path, std::ios::binary}
+{
+    if (!in_)
+        throw std::runtime_error("Can't open ledger recording " + path);
+
+    std::string magic(LedgerRecordWriter::MAGIC.size(), '\0');
+    in_.read(magic.data(), static_cast<std::streamsize>(magic.size()));
+    auto const version = in_.get();
+
+    if (!in_ or magic != LedgerRecordWriter::MAGIC)
+        throw std::runtime_error(path + " is not a ledger recording");
+
+    if (version != LedgerRecordWriter::VERSION)
+        throw std::runtime_error(fmt::format("Unsupported version {} of ledger recording {}", version, path));
+}
+
+std::optional<LedgerRecordReader::Record>
+LedgerRecordReader::next()
+{
+    std::array<char, RECORD_HEADER_SIZE> header{};
+    in_.read(header.data(), header.size());
+    if (in_.gcount() == 0 and in_.eof())
+        return std::nullopt;
+
+    if (!in_)
+        throw std::runtime_error("Ledger recording is truncated");
+
+    auto const kind = static_cast<LedgerRecordKind>(header[0]);
+    if (kind != LedgerRecordKind::LedgerDataPage and kind != LedgerRecordKind::Ledger)
+        throw std::runtime_error(fmt::format(
+            "Unknown record kind {} in ledger recording", static_cast<int>(static_cast<unsigned char>(header[0]))
+        ));
+
+    auto const size = getUint32(header.data() + 5);
+    if (size > MAX_PAYLOAD_SIZE)
+        throw std::runtime_error(fmt::format("Record of {} bytes in ledger recording is too large", size));
+
+    Record record{.kind = kind, .sequence = getUint32(header.data() + 1), .payload = std::string(size, '\0')};
+    in_.read(record.payload.data(), size);
+    if (!in_)
+        throw std::runtime_error("Ledger recording is truncated");
+
+    return record;
+}
+
+std::string
+LedgerRecordReader::decompress(std::string const& payload)
+{
+    auto const contentSize = ZSTD_getFrameContentSize(payload.data(), payload.size());
+    if (contentSize == ZSTD_CONTENTSIZE_ERROR or contentSize == ZSTD_CONTENTSIZE_UNKNOWN or
+        contentSize > MAX_PAYLOAD_SIZE)
+        throw std::runtime_error("Recorded payload is not a valid zstd frame");
+
+    std::string decompressed(contentSize, '\0');
+    auto const size = ZSTD_decompress(decompressed.data(), decompressed.size(), payload.data(), payload.size());
+    if (ZSTD_isError(size) or size != contentSize)
+        throw std::runtime_error(fmt::format("Can't decompress recorded payload: {}", ZSTD_getErrorName(size)));
+
+    return decompressed;
+}
+
+}  // namespace etl::detail
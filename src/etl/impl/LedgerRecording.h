@@ -0,0 +1,158 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of clio: https://github.com/XRPLF/clio
+    Copyright (c) 2023, the clio developers.
+
+    Permission to use, copy, modify, and distribute this software for any
+    purpose with or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL,  DIRECT,  INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#pragma once
+
+#include <ripple/proto/org/xrpl/rpc/v1/get_ledger.pb.h>
+#include <ripple/proto/org/xrpl/rpc/v1/get_ledger_data.pb.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+
+namespace etl::detail {
+
+/** @brief What a record of a ledger recording holds. */
+enum class LedgerRecordKind : std::uint8_t {
+    LedgerDataPage = 1, /*< A GetLedgerDataResponse page of the state of the first ledger */
+    Ledger = 2,         /*< A GetLedgerResponse, including the diff and the object neighbors */
+};
+
+/**
+ * @brief Writes ledgers fetched from a source to a file, so the ETL can later be replayed without a rippled.
+ *
+ * The file starts with MAGIC and a version byte, followed by the records. A record is the kind byte, the ledger
+ * sequence and the payload size as little endian 32 bit integers and the payload: the serialized response, compressed
+ * as a single zstd frame.
+ */
+class LedgerRecordWriter {
+public:
+    static constexpr std::string_view MAGIC = "CLIOLREC";
+    static constexpr std::uint8_t VERSION = 1;
+    static constexpr int COMPRESSION_LEVEL = 3;
+
+private:
+    std::ofstream out_;
+
+public:
+    /**
+     * @brief Create the file, replacing any existing one.
+     *
+     * @param path The path of the file
+     * @throws std::runtime_error if the file can't be created
+     */
+    explicit LedgerRecordWriter(std::string const& path);
+
+    /**
+     * @brief Append a page of the state of the first ledger. The pages must be written in order.
+     *
+     * @param sequence The sequence of the ledger
+     * @param page The page
+     */
+    void
+    writeLedgerDataPage(std::uint32_t sequence, org::xrpl::rpc::v1::GetLedgerDataResponse const& page);
+
+    /**
+     * @brief Append a ledger.
+     *
+     * @param sequence The sequence of the ledger
+     * @param ledger The response to a GetLedger call for it
+     */
+    void
+    writeLedger(std::uint32_t sequence, org::xrpl::rpc::v1::GetLedgerResponse const& ledger);
+
+    /**
+     * @brief Flush the file.
+     *
+     * @throws std::runtime_error if writing failed
+     */
+    void
+    flush();
+
+private:
+    void
+    write(LedgerRecordKind kind, std::uint32_t sequence, std::string const& serialized);
+};
+
+/**
+ * @brief Reads a file written by LedgerRecordWriter.
+ */
+class LedgerRecordReader {
+public:
+    /** @brief A record with its payload still compressed. */
+    struct Record {
+        LedgerRecordKind kind;
+        std::uint32_t sequence;
+        std::string payload;
+
+        /**
+         * @brief Decompress and parse the payload.
+         *
+         * @tparam MessageType The response the kind of the record holds
+         * @throws std::runtime_error if the payload is corrupted
+         */
+        template <typename MessageType>
+        MessageType
+        parse() const
+        {
+            MessageType message;
+            if (!message.ParseFromString(decompress(payload)))
+                throw std::runtime_error("Can't parse recorded ledger " + std::to_string(sequence));
+
+            return message;
+        }
+    };
+
+private:
+    std::ifstream in_;
+
+public:
+    /**
+     * @brief Open a recording.
+     *
+     * @param path The path of the file
+     * @throws std::runtime_error if the file can't be opened or is not a recording of a supported version
+     */
+    explicit LedgerRecordReader(std::string const& path);
+
+    /**
+     * @brief Read the next record.
+     *
+     * @return The record; nullopt at the end of the file
+     * @throws std::runtime_error if the file is truncated
+     */
+    std::optional<Record>
+    next();
+
+    /**
+     * @brief Decompress the payload of a record.
+     *
+     * @param payload The payload
+     * @return The serialized response
+     * @throws std::runtime_error if the payload is not a valid zstd frame
+     */
+    static std::string
+    decompress(std::string const& payload);
+};
+
+}  // namespace etl::detail
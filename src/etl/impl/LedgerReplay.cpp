@@ -0,0 +1,205 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of clio: https://github.com/XRPLF/clio
+    Copyright (c) 2023, the clio developers.
+
+    Permission to use, copy, modify, and distribute this software for any
+    purpose with or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL,  DIRECT,  INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include "etl/impl/LedgerReplay.h"
+
+#include "data/BackendInterface.h"
+#include "data/DBHelpers.h"
+#include "data/Types.h"
+#include "etl/impl/AsyncData.h"
+#include "etl/impl/LedgerRecording.h"
+#include "util/LedgerUtils.h"
+#include "util/Profiler.h"
+#include "util/log/Logger.h"
+
+#include <boost/json/object.hpp>
+#include <ripple/basics/Slice.h>
+#include <ripple/basics/base_uint.h>
+#include <ripple/proto/org/xrpl/rpc/v1/get_ledger.pb.h>
+#include <ripple/proto/org/xrpl/rpc/v1/get_ledger_data.pb.h>
+
+#include <chrono>
+#include <cstdint>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+namespace etl::detail {
+
+void
+ReplayStageStats::add(ReplayStageStats const& other)
+{
+    ledgers += other.ledgers;
+    transactions += other.transactions;
+    objects += other.objects;
+}
+
+boost::json::object
+ReplayStageStats::toJson() const
+{
+    auto const seconds = elapsed.count();
+    auto const perSecond = [seconds](std::uint64_t count) {
+        return seconds > 0 ? static_cast<double>(count) / seconds : 0.0;
+    };
+
+    return {
+        {"ledgers", ledgers},
+        {"transactions", transactions},
+        {"objects", objects},
+        {"seconds", seconds},
+        {"ledgers_per_second", perSecond(ledgers)},
+        {"transactions_per_second", perSecond(transactions)},
+        {"objects_per_second", perSecond(objects)},
+    };
+}
+
+LedgerReplay::LedgerReplay(std::shared_ptr<BackendInterface> backend, LedgerRecordReader& reader)
+    : backend_{std::move(backend)}
+{
+    while (auto record = reader.next()) {
+        if (record->kind == LedgerRecordKind::LedgerDataPage) {
+            if (!pages_.empty() and record->sequence != stateSequence_)
+                throw std::runtime_error("The recording has the state of more than one ledger");
+
+            stateSequence_ = record->sequence;
+            pages_.push_back(std::move(record->payload));
+            continue;
+        }
+
+        auto const ledger = record->parse<GetLedgerResponseType>();
+        auto const header = ::util::deserializeHeader(ripple::makeSlice(ledger.ledger_header()));
+
+        ledgers_[record->sequence] = RecordedLedger{
+            .payload = std::move(record->payload),
+            .closeTime = header.closeTime,
+            .stats =
+                {.ledgers = 1,
+                 .transactions = static_cast<std::uint64_t>(ledger.transactions_list().transactions_size()),
+                 .objects = static_cast<std::uint64_t>(ledger.ledger_objects().objects_size())},
+        };
+    }
+
+    if (pages_.empty())
+        throw std::runtime_error("The recording has no state of a ledger to start from");
+
+    if (ledgers_.empty() or ledgers_.begin()->first != stateSequence_ or
+        ledgers_.rbegin()->first - ledgers_.begin()->first + 1 != ledgers_.size())
+        throw std::runtime_error("The recorded ledgers must start at the ledger of the state and have no gaps");
+
+    LOG(log_.info()) << "Loaded a recording of ledgers " << firstSequence() << " to " << lastSequence() << " with "
+                     << pages_.size() << " pages of state";
+}
+
+std::uint32_t
+LedgerReplay::firstSequence() const
+{
+    return stateSequence_;
+}
+
+std::uint32_t
+LedgerReplay::lastSequence() const
+{
+    return ledgers_.rbegin()->first;
+}
+
+std::chrono::seconds
+LedgerReplay::closeOffset(std::uint32_t sequence) const
+{
+    return std::chrono::duration_cast<std::chrono::seconds>(
+        ledgers_.at(sequence).closeTime - ledgers_.begin()->second.closeTime
+    );
+}
+
+ReplayStageStats
+LedgerReplay::statsOf(std::uint32_t sequence) const
+{
+    return ledgers_.at(sequence).stats;
+}
+
+ReplayStageStats
+LedgerReplay::extracted() const
+{
+    std::scoped_lock const lck{mtx_};
+    return extracted_;
+}
+
+LedgerReplay::OptionalGetLedgerResponseType
+LedgerReplay::fetchLedger(std::uint32_t sequence, bool, bool)
+{
+    auto const it = ledgers_.find(sequence);
+    if (it == ledgers_.end()) {
+        LOG(log_.info()) << "Ledger " << sequence << " is not recorded. Replay is done";
+        return std::nullopt;
+    }
+
+    auto [response, time] = ::util::timed<std::chrono::duration<double>>([&it]() {
+        GetLedgerResponseType parsed;
+        if (!parsed.ParseFromString(LedgerRecordReader::decompress(it->second.payload)))
+            throw std::runtime_error("Can't parse recorded ledger " + std::to_string(it->first));
+        return parsed;
+    });
+
+    std::scoped_lock const lck{mtx_};
+    extracted_.add(it->second.stats);
+    extracted_.elapsed += std::chrono::duration<double>{time};
+    return std::move(response);
+}
+
+std::future<LedgerReplay::OptionalGetLedgerResponseType>
+LedgerReplay::fetchLedgerAsync(std::uint32_t sequence, bool getObjects, bool getObjectNeighbors)
+{
+    std::promise<OptionalGetLedgerResponseType> promise;
+    promise.set_value(fetchLedger(sequence, getObjects, getObjectNeighbors));
+    return promise.get_future();
+}
+
+bool
+LedgerReplay::loadInitialLedger(std::uint32_t sequence, bool cacheOnly)
+{
+    if (sequence != stateSequence_) {
+        LOG(log_.error()) << "The recording has the state of ledger " << stateSequence_ << ", not of " << sequence;
+        return false;
+    }
+
+    // the recorded pages are a single range over the whole key space
+    AsyncCallData callData{sequence, ripple::uint256{}, std::nullopt};
+    auto const target = cacheOnly ? AsyncCallData::Target::CacheOnly : AsyncCallData::Target::CacheAndDatabase;
+
+    for (auto const& page : pages_) {
+        org::xrpl::rpc::v1::GetLedgerDataResponse response;
+        if (!response.ParseFromString(LedgerRecordReader::decompress(page)))
+            throw std::runtime_error("Can't parse recorded state of ledger " + std::to_string(sequence));
+
+        callData.processRecorded(std::move(response), *backend_, target);
+    }
+
+    if (!cacheOnly and !callData.getFirstKey().empty()) {
+        backend_->writeSuccessor(uint256ToString(data::firstKey), sequence, callData.getFirstKey());
+        backend_->writeSuccessor(callData.getLastKey(), sequence, uint256ToString(data::lastKey));
+    }
+
+    LOG(log_.info()) << "Finished loadInitialLedger. cache size = " << backend_->cache().size();
+    return true;
+}
+
+}  // namespace etl::detail
@@ -0,0 +1,161 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of clio: https://github.com/XRPLF/clio
+    Copyright (c) 2023, the clio developers.
+
+    Permission to use, copy, modify, and distribute this software for any
+    purpose with or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL,  DIRECT,  INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#pragma once
+
+#include "data/BackendInterface.h"
+#include "etl/impl/LedgerRecording.h"
+#include "util/log/Logger.h"
+
+#include <boost/json/object.hpp>
+#include <ripple/basics/chrono.h>
+#include <ripple/proto/org/xrpl/rpc/v1/get_ledger.pb.h>
+#include <ripple/proto/org/xrpl/rpc/v1/ledger.pb.h>
+
+#include <chrono>
+#include <cstdint>
+#include <future>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace etl::detail {
+
+/**
+ * @brief Throughput of a stage of the ETL during a replay.
+ */
+struct ReplayStageStats {
+    std::uint64_t ledgers = 0;
+    std::uint64_t transactions = 0;
+    std::uint64_t objects = 0;
+    std::chrono::duration<double> elapsed{0.0};
+
+    /**
+     * @brief Add the counts of another ledger or stage; the time is added separately.
+     *
+     * @param other The stats to add
+     */
+    void
+    add(ReplayStageStats const& other);
+
+    /** @return The counts and their rates per second */
+    boost::json::object
+    toJson() const;
+};
+
+/**
+ * @brief Serves a ledger recording in place of the load balancer, so the ETL can run without a rippled.
+ *
+ * Used with the same LedgerFetcher and LedgerLoader the ETL uses, so everything downstream of the load balancer is
+ * what a replay measures. The recording is kept compressed in memory; a ledger is decompressed and parsed when it is
+ * fetched, which counts toward the extract stage.
+ */
+class LedgerReplay {
+public:
+    using RawLedgerObjectType = org::xrpl::rpc::v1::RawLedgerObject;
+    using GetLedgerResponseType = org::xrpl::rpc::v1::GetLedgerResponse;
+    using OptionalGetLedgerResponseType = std::optional<GetLedgerResponseType>;
+
+private:
+    struct RecordedLedger {
+        std::string payload;
+        ripple::NetClock::time_point closeTime;
+        ReplayStageStats stats;
+    };
+
+    util::Logger log_{"ETL"};
+
+    std::shared_ptr<BackendInterface> backend_;
+    std::uint32_t stateSequence_ = 0;
+    std::vector<std::string> pages_;
+    std::map<std::uint32_t, RecordedLedger> ledgers_;
+
+    mutable std::mutex mtx_;
+    ReplayStageStats extracted_;
+
+public:
+    /**
+     * @brief Read a recording into memory.
+     *
+     * @param backend The backend the initial ledger is written to
+     * @param reader The recording
+     * @throws std::runtime_error if the recording is corrupted, has no state pages or has gaps between its ledgers
+     */
+    LedgerReplay(std::shared_ptr<BackendInterface> backend, LedgerRecordReader& reader);
+
+    /** @return The sequence of the ledger whose state is recorded; the replay starts there */
+    std::uint32_t
+    firstSequence() const;
+
+    /** @return The sequence of the last recorded ledger */
+    std::uint32_t
+    lastSequence() const;
+
+    /**
+     * @param sequence A recorded ledger
+     * @return How long after the first ledger the ledger closed
+     */
+    std::chrono::seconds
+    closeOffset(std::uint32_t sequence) const;
+
+    /**
+     * @param sequence A recorded ledger
+     * @return The transactions and objects of the ledger
+     */
+    ReplayStageStats
+    statsOf(std::uint32_t sequence) const;
+
+    /** @return What was fetched so far and the time spent decompressing and parsing it */
+    ReplayStageStats
+    extracted() const;
+
+    /**
+     * @brief Fetch a recorded ledger. The recording always has the diff and the object neighbors.
+     *
+     * @param sequence Sequence of the ledger to fetch
+     * @param getObjects Ignored
+     * @param getObjectNeighbors Ignored
+     * @return The recorded response; nullopt if the ledger is not recorded, which stops the extractors
+     */
+    OptionalGetLedgerResponseType
+    fetchLedger(std::uint32_t sequence, bool getObjects, bool getObjectNeighbors);
+
+    /**
+     * @brief Fetch a recorded ledger without waiting for it; see fetchLedger().
+     *
+     * @return A future that is ready already
+     */
+    std::future<OptionalGetLedgerResponseType>
+    fetchLedgerAsync(std::uint32_t sequence, bool getObjects, bool getObjectNeighbors);
+
+    /**
+     * @brief Write the recorded state of the first ledger, including all successors.
+     *
+     * @param sequence Sequence of the ledger; must be firstSequence()
+     * @param cacheOnly Whether to only write to the cache and not to the DB; defaults to false
+     * @return true if the state was written; false if it is not recorded for the ledger
+     */
+    bool
+    loadInitialLedger(std::uint32_t sequence, bool cacheOnly = false);
+};
+
+}  // namespace etl::detail
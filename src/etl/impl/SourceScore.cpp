@@ -0,0 +1,123 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of clio: https://github.com/XRPLF/clio
+    Copyright (c) 2023, the clio developers.
+
+    Permission to use, copy, modify, and distribute this software for any
+    purpose with or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL,  DIRECT,  INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include "etl/impl/SourceScore.h"
+
+#include "util/prometheus/Label.h"
+#include "util/prometheus/Prometheus.h"
+
+#include <boost/json/object.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <optional>
+#include <string>
+
+namespace etl::detail {
+
+SourceScore::SourceScore(std::string const& source)
+    : latencyGauge_{PrometheusService::gaugeDouble(
+          "etl_source_latency_milliseconds",
+          util::prometheus::Labels({{"source", source}}),
+          "The average latency of successful requests to the ETL source"
+      )}
+    , errorRateGauge_{PrometheusService::gaugeDouble(
+          "etl_source_error_rate",
+          util::prometheus::Labels({{"source", source}}),
+          "The fraction of recent requests to the ETL source that failed"
+      )}
+    , scoreGauge_{PrometheusService::gaugeDouble(
+          "etl_source_score",
+          util::prometheus::Labels({{"source", source}}),
+          "The score the ETL source is picked by; lower is better"
+      )}
+{
+}
+
+void
+SourceScore::recordSuccess(std::chrono::steady_clock::duration latency)
+{
+    auto const sampleMs = std::chrono::duration<double, std::milli>{latency}.count();
+
+    std::scoped_lock const lck{mtx_};
+    latencyMs_ = latencyMs_ ? (1 - SMOOTHING) * *latencyMs_ + SMOOTHING * sampleMs : sampleMs;
+    errorRate_ = (1 - SMOOTHING) * errorRate_;
+
+    latencyGauge_.get().set(*latencyMs_);
+    errorRateGauge_.get().set(errorRate_);
+}
+
+void
+SourceScore::recordFailure()
+{
+    std::scoped_lock const lck{mtx_};
+    errorRate_ = (1 - SMOOTHING) * errorRate_ + SMOOTHING;
+
+    errorRateGauge_.get().set(errorRate_);
+}
+
+std::optional<double>
+SourceScore::latencyMs() const
+{
+    std::scoped_lock const lck{mtx_};
+    return latencyMs_;
+}
+
+double
+SourceScore::errorRate() const
+{
+    std::scoped_lock const lck{mtx_};
+    return errorRate_;
+}
+
+double
+SourceScore::score(std::uint32_t lag, std::chrono::system_clock::duration lastMessageAge) const
+{
+    auto score = 0.0;
+    {
+        std::scoped_lock const lck{mtx_};
+        auto const latencyMs = latencyMs_.value_or(errorRate_ > 0.0 ? UNKNOWN_LATENCY_MS : 0.0);
+        score = latencyMs / (1 - std::min(errorRate_, MAX_ERROR_RATE));
+    }
+
+    score += std::min(lag, MAX_LAG) * LAG_PENALTY_MS;
+    if (lastMessageAge > STALE_AFTER)
+        score += STALE_PENALTY_MS;
+
+    scoreGauge_.get().set(score);
+    return score;
+}
+
+boost::json::object
+SourceScore::toJson(std::uint32_t lag, std::chrono::system_clock::duration lastMessageAge) const
+{
+    boost::json::object res;
+
+    if (auto const latency = latencyMs(); latency)
+        res["latency_ms"] = *latency;
+    res["error_rate"] = errorRate();
+    res["lag"] = lag;
+    res["score"] = score(lag, lastMessageAge);
+
+    return res;
+}
+
+}  // namespace etl::detail
@@ -0,0 +1,120 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of clio: https://github.com/XRPLF/clio
+    Copyright (c) 2023, the clio developers.
+
+    Permission to use, copy, modify, and distribute this software for any
+    purpose with or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL,  DIRECT,  INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#pragma once
+
+#include "util/prometheus/Prometheus.h"
+
+#include <boost/json/object.hpp>
+
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <optional>
+#include <string>
+
+namespace etl::detail {
+
+/**
+ * @brief Rates how well an ETL source serves requests, so the load balancer can prefer the healthy ones.
+ *
+ * Latency and error rate of the requests sent to the source are exponentially weighted moving averages, so a source
+ * that misbehaved recovers once it serves requests well again. The score adds penalties for lagging behind the network
+ * and for not sending messages on the ledgers stream. Lower scores are better.
+ */
+class SourceScore {
+public:
+    static constexpr double SMOOTHING = 0.2;
+    static constexpr double MAX_ERROR_RATE = 0.99;
+    static constexpr double UNKNOWN_LATENCY_MS = 1000.0;
+    static constexpr double LAG_PENALTY_MS = 1000.0;
+    static constexpr std::uint32_t MAX_LAG = 1000;
+    static constexpr auto STALE_AFTER = std::chrono::seconds{20};
+    static constexpr double STALE_PENALTY_MS = 10000.0;
+
+private:
+    mutable std::mutex mtx_;
+    std::optional<double> latencyMs_;
+    double errorRate_ = 0.0;
+
+    std::reference_wrapper<util::prometheus::GaugeDouble> latencyGauge_;
+    std::reference_wrapper<util::prometheus::GaugeDouble> errorRateGauge_;
+    std::reference_wrapper<util::prometheus::GaugeDouble> scoreGauge_;
+
+public:
+    /**
+     * @brief Create a score with no requests recorded yet.
+     *
+     * @param source The name of the source the score is reported under
+     */
+    explicit SourceScore(std::string const& source);
+
+    /**
+     * @brief Record a request that succeeded.
+     *
+     * @param latency How long the request took
+     */
+    void
+    recordSuccess(std::chrono::steady_clock::duration latency);
+
+    /**
+     * @brief Record a request that failed.
+     */
+    void
+    recordFailure();
+
+    /**
+     * @return The average latency of successful requests in milliseconds; nullopt if none succeeded yet
+     */
+    std::optional<double>
+    latencyMs() const;
+
+    /**
+     * @return The fraction of recent requests that failed
+     */
+    double
+    errorRate() const;
+
+    /**
+     * @brief Compute the score of the source.
+     *
+     * The base is the expected time for a request to succeed, i.e. the latency divided by the success rate. An untried
+     * source scores best, so it gets tried. A source whose requests only failed so far is assumed to have a latency of
+     * UNKNOWN_LATENCY_MS, so its errors still push it down.
+     *
+     * @param lag How many ledgers the source is behind the network
+     * @param lastMessageAge The time since the source sent its last message
+     * @return The score; lower is better
+     */
+    double
+    score(std::uint32_t lag, std::chrono::system_clock::duration lastMessageAge) const;
+
+    /**
+     * @brief Describe the score for the load balancer's JSON representation.
+     *
+     * @param lag How many ledgers the source is behind the network
+     * @param lastMessageAge The time since the source sent its last message
+     * @return The latency, error rate and score of the source
+     */
+    boost::json::object
+    toJson(std::uint32_t lag, std::chrono::system_clock::duration lastMessageAge) const;
+};
+
+}  // namespace etl::detail
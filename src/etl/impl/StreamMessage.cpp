@@ -0,0 +1,230 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of clio: https://github.com/XRPLF/clio
+    Copyright (c) 2023, the clio developers.
+
+    Permission to use, copy, modify, and distribute this software for any
+    purpose with or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL,  DIRECT,  INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include "etl/impl/StreamMessage.h"
+
+#include <boost/json/basic_parser_impl.hpp>
+#include <boost/json/error.hpp>
+#include <boost/json/parse_options.hpp>
+#include <boost/json/string_view.hpp>
+#include <ripple/protocol/AccountID.h>
+#include <ripple/protocol/tokens.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <utility>
+
+namespace etl::detail {
+
+namespace {
+
+// the names of the callbacks and limits are the ones boost::json::basic_parser requires
+class StreamMessageHandler {
+    std::size_t depth_ = 0;
+    std::size_t arrayDepth_ = 0;
+    bool isObject_ = false;
+    bool inTransaction_ = false;
+    std::string topLevelKey_;
+    std::string key_;
+    std::string string_;
+
+public:
+    static constexpr std::size_t max_object_size = static_cast<std::size_t>(-1);
+    static constexpr std::size_t max_array_size = static_cast<std::size_t>(-1);
+    static constexpr std::size_t max_key_size = static_cast<std::size_t>(-1);
+    static constexpr std::size_t max_string_size = static_cast<std::size_t>(-1);
+
+    StreamMessage message;
+
+    bool
+    isObject() const
+    {
+        return isObject_;
+    }
+
+    bool
+    on_document_begin(boost::json::error_code&)
+    {
+        return true;
+    }
+
+    bool
+    on_document_end(boost::json::error_code&)
+    {
+        return true;
+    }
+
+    bool
+    on_object_begin(boost::json::error_code&)
+    {
+        if (depth_ == 0)
+            isObject_ = true;
+
+        if (depth_ == 1 and topLevelKey_ == "transaction") {
+            message.hasTransaction = true;
+            inTransaction_ = true;
+        }
+
+        ++depth_;
+        return true;
+    }
+
+    bool
+    on_object_end(std::size_t, boost::json::error_code&)
+    {
+        --depth_;
+        if (depth_ == 1)
+            inTransaction_ = false;
+
+        return true;
+    }
+
+    bool
+    on_array_begin(boost::json::error_code&)
+    {
+        ++depth_;
+        ++arrayDepth_;
+        return true;
+    }
+
+    bool
+    on_array_end(std::size_t, boost::json::error_code&)
+    {
+        --depth_;
+        --arrayDepth_;
+        return true;
+    }
+
+    bool
+    on_key_part(boost::json::string_view part, std::size_t, boost::json::error_code&)
+    {
+        key_.append(part.data(), part.size());
+        return true;
+    }
+
+    bool
+    on_key(boost::json::string_view part, std::size_t, boost::json::error_code&)
+    {
+        key_.append(part.data(), part.size());
+        if (depth_ == 1) {
+            topLevelKey_ = key_;
+            if (topLevelKey_ == "result")
+                message.hasResult = true;
+        }
+
+        key_.clear();
+        return true;
+    }
+
+    bool
+    on_string_part(boost::json::string_view part, std::size_t, boost::json::error_code&)
+    {
+        string_.append(part.data(), part.size());
+        return true;
+    }
+
+    bool
+    on_string(boost::json::string_view part, std::size_t, boost::json::error_code&)
+    {
+        string_.append(part.data(), part.size());
+
+        if (depth_ == 1 and topLevelKey_ == "type") {
+            message.type = string_;
+        } else if (inTransaction_ and arrayDepth_ == 0) {
+            if (auto const account = ripple::parseBase58<ripple::AccountID>(string_); account)
+                message.accounts.push_back(*account);
+        }
+
+        string_.clear();
+        return true;
+    }
+
+    bool
+    on_number_part(boost::json::string_view, boost::json::error_code&)
+    {
+        return true;
+    }
+
+    bool
+    on_int64(std::int64_t, boost::json::string_view, boost::json::error_code&)
+    {
+        return true;
+    }
+
+    bool
+    on_uint64(std::uint64_t, boost::json::string_view, boost::json::error_code&)
+    {
+        return true;
+    }
+
+    bool
+    on_double(double, boost::json::string_view, boost::json::error_code&)
+    {
+        return true;
+    }
+
+    bool
+    on_bool(bool, boost::json::error_code&)
+    {
+        return true;
+    }
+
+    bool
+    on_null(boost::json::error_code&)
+    {
+        return true;
+    }
+
+    bool
+    on_comment_part(boost::json::string_view, boost::json::error_code&)
+    {
+        return true;
+    }
+
+    bool
+    on_comment(boost::json::string_view, boost::json::error_code&)
+    {
+        return true;
+    }
+};
+
+}  // namespace
+
+std::optional<StreamMessage>
+inspectStreamMessage(std::string_view message)
+{
+    boost::json::basic_parser<StreamMessageHandler> parser{boost::json::parse_options{}};
+    boost::json::error_code ec;
+
+    auto const consumed = parser.write_some(false, message.data(), message.size(), ec);
+    if (ec or not parser.done() or not parser.handler().isObject())
+        return std::nullopt;
+
+    // like boost::json::parse, only whitespace may follow the object
+    auto const rest = message.substr(consumed);
+    if (rest.find_first_not_of(" \t\r\n") != std::string_view::npos)
+        return std::nullopt;
+
+    return std::move(parser.handler().message);
+}
+
+}  // namespace etl::detail
@@ -0,0 +1,56 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of clio: https://github.com/XRPLF/clio
+    Copyright (c) 2023, the clio developers.
+
+    Permission to use, copy, modify, and distribute this software for any
+    purpose with or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL,  DIRECT,  INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#pragma once
+
+#include <ripple/protocol/AccountID.h>
+
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace etl::detail {
+
+/**
+ * @brief What routing needs to know about a message from the subscription streams of rippled.
+ *
+ * Most stream messages are proposed transactions, validations and manifests that are published to subscribers as they
+ * are, so they are read with a SAX parser instead of being parsed into a JSON tree.
+ */
+struct StreamMessage {
+    std::optional<std::string> type;
+    bool hasResult = false;
+    bool hasTransaction = false;
+    std::vector<ripple::AccountID> accounts;
+};
+
+/**
+ * @brief Read the routing information of a stream message.
+ *
+ * The accounts are those of the strings in the `transaction` object and its nested objects, the same ones
+ * rpc::getAccountsFromTransaction finds in a parsed transaction.
+ *
+ * @param message The raw message
+ * @return The routing information; nullopt if the message is not a JSON object
+ */
+std::optional<StreamMessage>
+inspectStreamMessage(std::string_view message);
+
+}  // namespace etl::detail
@@ -20,6 +20,7 @@
 #pragma once
 
 #include "data/BackendInterface.h"
+#include "data/Types.h"
 #include "etl/SystemState.h"
 #include "etl/impl/AmendmentBlock.h"
 #include "etl/impl/LedgerLoader.h"
@@ -32,10 +33,17 @@
 #include <ripple/beast/core/CurrentThreadName.h>
 #include <ripple/proto/org/xrpl/rpc/v1/xrp_ledger.grpc.pb.h>
 
+#include <algorithm>
 #include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
 #include <memory>
+#include <mutex>
+#include <optional>
 #include <thread>
 #include <utility>
+#include <vector>
 
 namespace etl::detail {
 
@@ -70,6 +78,27 @@ class Transformer {
     uint32_t startSequence_;
     std::reference_wrapper<SystemState> state_;  // shared state for ETL
 
+    /** @brief A ledger whose writes were all issued and that is waiting to be committed. */
+    struct LedgerToCommit {
+        ripple::LedgerHeader lgrInfo;
+        std::int64_t numTxns = 0;
+        std::int64_t numObjects = 0;
+        std::chrono::system_clock::time_point start{};
+        std::vector<data::TransactionAndMetadata> transactions{};  // handed to the publisher once committed
+    };
+
+    // only used with pipelined writes: at most one ledger is being committed while the next one is built
+    bool pipelinedWrites_;
+    std::mutex commitMtx_;
+    std::condition_variable commitCv_;
+    std::optional<LedgerToCommit> toCommit_;
+    bool commitFailed_ = false;
+    bool stopCommitting_ = false;
+    std::thread committerThread_;
+
+    // renews the writer lease before each commit; unset when the writer is not elected by lease
+    std::function<bool()> renewLease_;
+
     std::thread thread_;
 
 public:
@@ -78,6 +107,12 @@ public:
      *
      * This spawns a new thread that reads from the data pipe and writes ledgers to the DB using LedgerLoader and
      * LedgerPublisher.
+     *
+     * With pipelined writes a second thread commits and publishes the ledgers strictly in order, so the writes of
+     * the next ledger are issued while the previous ledger is still being committed.
+     *
+     * If renewLease is set, the writer lease is renewed before each ledger is committed and the ledger is not
+     * committed if the lease was lost.
      */
     Transformer(
         DataPipeType& pipe,
@@ -86,7 +121,9 @@ public:
         LedgerPublisherType& publisher,
         AmendmentBlockHandlerType& amendmentBlockHandler,
         uint32_t startSequence,
-        SystemState& state
+        SystemState& state,
+        bool pipelinedWrites = false,
+        std::function<bool()> renewLease = {}
     )
         : pipe_{std::ref(pipe)}
         , backend_{std::move(backend)}
@@ -95,7 +132,12 @@ public:
         , amendmentBlockHandler_{std::ref(amendmentBlockHandler)}
         , startSequence_{startSequence}
         , state_{std::ref(state)}
+        , pipelinedWrites_{pipelinedWrites}
+        , renewLease_{std::move(renewLease)}
     {
+        if (pipelinedWrites_)
+            committerThread_ = std::thread([this]() { commitInOrder(); });
+
         thread_ = std::thread([this]() { process(); });
     }
 
@@ -138,38 +180,135 @@ private:
                 continue;
 
             auto const start = std::chrono::system_clock::now();
-            auto [lgrInfo, success] = buildNextLedger(*fetchResponse);
+            auto ledger = buildNextLedger(*fetchResponse);
+            auto success = ledger.has_value();
 
             if (success) {
-                auto const numTxns = fetchResponse->transactions_list().transactions_size();
-                auto const numObjects = fetchResponse->ledger_objects().objects_size();
-                auto const end = std::chrono::system_clock::now();
-                auto const duration = ((end - start).count()) / 1000000000.0;
-
-                LOG(log_.info()) << "Load phase of etl : "
-                                 << "Successfully wrote ledger! Ledger info: " << util::toString(lgrInfo)
-                                 << ". txn count = " << numTxns << ". object count = " << numObjects
-                                 << ". load time = " << duration << ". load txns per second = " << numTxns / duration
-                                 << ". load objs per second = " << numObjects / duration;
-
-                // success is false if the ledger was already written
-                publisher_.get().publish(lgrInfo);
+                ledger->start = start;
+                success = pipelinedWrites_ ? scheduleCommit(std::move(*ledger)) : commit(std::move(*ledger));
             } else {
-                LOG(log_.error()) << "Error writing ledger. " << util::toString(lgrInfo);
+                LOG(log_.error()) << "Error building ledger " << currentSequence - 1;
             }
 
-            setWriteConflict(not success);
+            // the committer thread may have already flagged a conflict; never reset it from here
+            if (not success)
+                setWriteConflict(true);
+        }
+
+        if (pipelinedWrites_)
+            stopCommitting();
+    }
+
+    /**
+     * @brief Commit a ledger whose writes were all issued and publish it on success.
+     *
+     * @param ledger The ledger to commit
+     * @return true if the ledger was committed; false otherwise
+     */
+    bool
+    commit(LedgerToCommit ledger)
+    {
+        auto const& lgrInfo = ledger.lgrInfo;
+        if (renewLease_ and not renewLease_()) {
+            LOG(log_.warn()) << "Lost the writer lease. Not committing ledger " << lgrInfo.seq;
+            return false;
+        }
+
+        auto [success, writesDuration] =
+            ::util::timed<std::chrono::duration<double>>([&]() { return backend_->finishWrites(lgrInfo.seq); });
+
+        LOG(log_.debug()) << "Finished writes. Total time: " << std::to_string(writesDuration);
+        LOG(log_.debug()) << "Finished ledger update: " << ::util::toString(lgrInfo);
+
+        // success is false if the ledger was already written
+        if (not success) {
+            LOG(log_.error()) << "Error writing ledger. " << util::toString(lgrInfo);
+            return false;
+        }
+
+        auto const end = std::chrono::system_clock::now();
+        auto const duration = ((end - ledger.start).count()) / 1000000000.0;
+
+        LOG(log_.info()) << "Load phase of etl : "
+                         << "Successfully wrote ledger! Ledger info: " << util::toString(lgrInfo)
+                         << ". txn count = " << ledger.numTxns << ". object count = " << ledger.numObjects
+                         << ". load time = " << duration << ". load txns per second = " << ledger.numTxns / duration
+                         << ". load objs per second = " << ledger.numObjects / duration;
+
+        publisher_.get().publish(lgrInfo, std::move(ledger.transactions));
+        return true;
+    }
+
+    /**
+     * @brief Hand a ledger over to the committer thread once the previous ledger is committed.
+     *
+     * @param ledger The ledger to commit
+     * @return true if the ledger was scheduled; false if committing an earlier ledger failed
+     */
+    bool
+    scheduleCommit(LedgerToCommit ledger)
+    {
+        std::unique_lock lck(commitMtx_);
+        commitCv_.wait(lck, [this]() { return not toCommit_.has_value(); });
+
+        if (commitFailed_)
+            return false;
+
+        toCommit_ = std::move(ledger);
+        commitCv_.notify_all();
+        return true;
+    }
+
+    void
+    commitInOrder()
+    {
+        beast::setCurrentThreadName("ETLService commit");
+
+        while (true) {
+            std::unique_lock lck(commitMtx_);
+            commitCv_.wait(lck, [this]() { return toCommit_.has_value() or stopCommitting_; });
+
+            // a scheduled ledger is still committed when stopping
+            if (not toCommit_.has_value())
+                return;
+
+            // the slot stays taken until the ledger is committed
+            auto ledger = std::move(*toCommit_);
+            lck.unlock();
+
+            auto const success = commit(std::move(ledger));
+            if (not success)
+                setWriteConflict(true);  // stops the extractors without waiting for the next ledger to arrive
+
+            lck.lock();
+            commitFailed_ = commitFailed_ or not success;
+            toCommit_.reset();
+            commitCv_.notify_all();
+        }
+    }
+
+    void
+    stopCommitting()
+    {
+        {
+            std::lock_guard const lck(commitMtx_);
+            stopCommitting_ = true;
         }
+
+        commitCv_.notify_all();
+        committerThread_.join();
     }
 
     /**
      * @brief Build the next ledger using the previous ledger and the extracted data.
      * @note rawData should be data that corresponds to the ledger immediately following the previous seq.
      *
+     * The writes of the ledger are issued but not waited for; the ledger is committed separately using @ref commit.
+     *
      * @param rawData Data extracted from an ETL source
-     * @return The newly built ledger and data to write to the database
+     * @return The newly built ledger if all of its writes were issued; nullopt otherwise
      */
-    std::pair<ripple::LedgerHeader, bool>
+    std::optional<LedgerToCommit>
     buildNextLedger(GetLedgerResponseType& rawData)
     {
         LOG(log_.debug()) << "Beginning ledger update";
@@ -192,7 +331,7 @@ private:
             LOG(log_.fatal()) << "Failed to build next ledger: " << e.what();
 
             amendmentBlockHandler_.get().onAmendmentBlock();
-            return {ripple::LedgerHeader{}, false};
+            return std::nullopt;
         }
 
         LOG(log_.debug()) << "Inserted all transactions. Number of transactions  = "
@@ -202,13 +341,12 @@ private:
         backend_->writeNFTs(insertTxResultOp->nfTokensData);
         backend_->writeNFTTransactions(insertTxResultOp->nfTokenTxData);
 
-        auto [success, duration] =
-            ::util::timed<std::chrono::duration<double>>([&]() { return backend_->finishWrites(lgrInfo.seq); });
-
-        LOG(log_.debug()) << "Finished writes. Total time: " << std::to_string(duration);
-        LOG(log_.debug()) << "Finished ledger update: " << ::util::toString(lgrInfo);
-
-        return {lgrInfo, success};
+        return LedgerToCommit{
+            .lgrInfo = lgrInfo,
+            .numTxns = rawData.transactions_list().transactions_size(),
+            .numObjects = rawData.ledger_objects().objects_size(),
+            .transactions = std::move(insertTxResultOp->transactions)
+        };
     }
 
     /**
@@ -289,46 +427,31 @@ private:
             if (!backend_->cache().isFull() || backend_->cache().latestLedgerSequence() != lgrInfo.seq)
                 throw std::logic_error("Cache is not full, but object neighbors were not included");
 
+            // cacheUpdates can carry the same key more than once, so sort and dedupe the created/deleted keys
+            std::vector<ripple::uint256> changedKeys;
+            changedKeys.reserve(cacheUpdates.size());
             for (auto const& obj : cacheUpdates) {
-                if (modified.contains(obj.key))
-                    continue;
-
-                auto lb = backend_->cache().getPredecessor(obj.key, lgrInfo.seq);
-                if (!lb)
-                    lb = {data::firstKey, {}};
-
-                auto ub = backend_->cache().getSuccessor(obj.key, lgrInfo.seq);
-                if (!ub)
-                    ub = {data::lastKey, {}};
+                if (!modified.contains(obj.key))
+                    changedKeys.push_back(obj.key);
+            }
 
-                if (obj.blob.empty()) {
-                    LOG(log_.debug()) << "writing successor for deleted object " << ripple::strHex(obj.key) << " - "
-                                      << ripple::strHex(lb->key) << " - " << ripple::strHex(ub->key);
+            std::sort(changedKeys.begin(), changedKeys.end());
+            changedKeys.erase(std::unique(changedKeys.begin(), changedKeys.end()), changedKeys.end());
 
-                    backend_->writeSuccessor(uint256ToString(lb->key), lgrInfo.seq, uint256ToString(ub->key));
-                } else {
-                    backend_->writeSuccessor(uint256ToString(lb->key), lgrInfo.seq, uint256ToString(obj.key));
-                    backend_->writeSuccessor(uint256ToString(obj.key), lgrInfo.seq, uint256ToString(ub->key));
-
-                    LOG(log_.debug()) << "writing successor for new object " << ripple::strHex(lb->key) << " - "
-                                      << ripple::strHex(obj.key) << " - " << ripple::strHex(ub->key);
-                }
-            }
+            auto successors = backend_->cache().getSuccessorUpdates(changedKeys, lgrInfo.seq);
+            LOG(log_.debug()) << "Computed " << successors.size() << " successors for " << changedKeys.size()
+                              << " created or deleted objects";
 
             for (auto const& base : bookSuccessorsToCalculate) {
-                auto succ = backend_->cache().getSuccessor(base, lgrInfo.seq);
-                if (succ) {
-                    backend_->writeSuccessor(uint256ToString(base), lgrInfo.seq, uint256ToString(succ->key));
-
-                    LOG(log_.debug()) << "Updating book successor " << ripple::strHex(base) << " - "
-                                      << ripple::strHex(succ->key);
-                } else {
-                    backend_->writeSuccessor(uint256ToString(base), lgrInfo.seq, uint256ToString(data::lastKey));
+                auto const succ = backend_->cache().getSuccessor(base, lgrInfo.seq);
+                auto const succKey = succ ? succ->key : data::lastKey;
+                successors.emplace_back(base, succKey);
 
-                    LOG(log_.debug()) << "Updating book successor " << ripple::strHex(base) << " - "
-                                      << ripple::strHex(data::lastKey);
-                }
+                LOG(log_.debug()) << "Updating book successor " << ripple::strHex(base) << " - "
+                                  << ripple::strHex(succKey);
             }
+
+            backend_->writeSuccessors(successors, lgrInfo.seq);
         }
     }
 
@@ -342,44 +465,7 @@ private:
     writeSuccessors(ripple::LedgerHeader const& lgrInfo, GetLedgerResponseType& rawData)
     {
         // Write successor info, if included from rippled
-        if (rawData.object_neighbors_included()) {
-            LOG(log_.debug()) << "object neighbors included";
-
-            for (auto& obj : *(rawData.mutable_book_successors())) {
-                auto firstBook = std::move(*obj.mutable_first_book());
-                if (!firstBook.size())
-                    firstBook = uint256ToString(data::lastKey);
-                LOG(log_.debug()) << "writing book successor " << ripple::strHex(obj.book_base()) << " - "
-                                  << ripple::strHex(firstBook);
-
-                backend_->writeSuccessor(std::move(*obj.mutable_book_base()), lgrInfo.seq, std::move(firstBook));
-            }
-
-            for (auto& obj : *(rawData.mutable_ledger_objects()->mutable_objects())) {
-                if (obj.mod_type() != RawLedgerObjectType::MODIFIED) {
-                    std::string* predPtr = obj.mutable_predecessor();
-                    if (predPtr->empty())
-                        *predPtr = uint256ToString(data::firstKey);
-                    std::string* succPtr = obj.mutable_successor();
-                    if (succPtr->empty())
-                        *succPtr = uint256ToString(data::lastKey);
-
-                    if (obj.mod_type() == RawLedgerObjectType::DELETED) {
-                        LOG(log_.debug()) << "Modifying successors for deleted object " << ripple::strHex(obj.key())
-                                          << " - " << ripple::strHex(*predPtr) << " - " << ripple::strHex(*succPtr);
-
-                        backend_->writeSuccessor(std::move(*predPtr), lgrInfo.seq, std::move(*succPtr));
-                    } else {
-                        LOG(log_.debug()) << "adding successor for new object " << ripple::strHex(obj.key()) << " - "
-                                          << ripple::strHex(*predPtr) << " - " << ripple::strHex(*succPtr);
-
-                        backend_->writeSuccessor(std::move(*predPtr), lgrInfo.seq, std::string{obj.key()});
-                        backend_->writeSuccessor(std::string{obj.key()}, lgrInfo.seq, std::move(*succPtr));
-                    }
-                } else
-                    LOG(log_.debug()) << "object modified " << ripple::strHex(obj.key());
-            }
-        }
+        writeSuccessorsFromNeighbors<RawLedgerObjectType>(*backend_, lgrInfo.seq, rawData);
     }
 
     /** @return true if the transformer is stopping; false otherwise */
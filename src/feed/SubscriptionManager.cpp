@@ -299,28 +299,46 @@ SubscriptionManager::pubBookChanges(
 void
 SubscriptionManager::forwardProposedTransaction(boost::json::object const& response)
 {
-    auto pubMsg = std::make_shared<std::string>(boost::json::serialize(response));
-    txProposedSubscribers_.publish(pubMsg);
+    auto const& transaction = response.at("transaction").as_object();
+    forwardProposedTransaction(
+        std::make_shared<std::string>(boost::json::serialize(response)), rpc::getAccountsFromTransaction(transaction)
+    );
+}
 
-    auto transaction = response.at("transaction").as_object();
-    auto accounts = rpc::getAccountsFromTransaction(transaction);
+void
+SubscriptionManager::forwardProposedTransaction(
+    std::shared_ptr<std::string> const& message,
+    std::vector<ripple::AccountID> const& accounts
+)
+{
+    txProposedSubscribers_.publish(message);
 
     for (ripple::AccountID const& account : accounts)
-        accountProposedSubscribers_.publish(pubMsg, account);
+        accountProposedSubscribers_.publish(message, account);
 }
 
 void
 SubscriptionManager::forwardManifest(boost::json::object const& response)
 {
-    auto pubMsg = std::make_shared<std::string>(boost::json::serialize(response));
-    manifestSubscribers_.publish(pubMsg);
+    forwardManifest(std::make_shared<std::string>(boost::json::serialize(response)));
+}
+
+void
+SubscriptionManager::forwardManifest(std::shared_ptr<std::string> const& message)
+{
+    manifestSubscribers_.publish(message);
 }
 
 void
 SubscriptionManager::forwardValidation(boost::json::object const& response)
 {
-    auto pubMsg = std::make_shared<std::string>(boost::json::serialize(response));
-    validationsSubscribers_.publish(pubMsg);
+    forwardValidation(std::make_shared<std::string>(boost::json::serialize(response)));
+}
+
+void
+SubscriptionManager::forwardValidation(std::shared_ptr<std::string> const& message)
+{
+    validationsSubscribers_.publish(message);
 }
 
 void
@@ -26,9 +26,12 @@
 #include "web/interface/ConnectionBase.h"
 
 #include <fmt/format.h>
+#include <ripple/protocol/AccountID.h>
 #include <ripple/protocol/LedgerHeader.h>
 
 #include <memory>
+#include <string>
+#include <vector>
 
 /**
  * @brief This namespace deals with subscriptions.
@@ -526,6 +529,18 @@ public:
     void
     forwardProposedTransaction(boost::json::object const& response);
 
+    /**
+     * @brief Publish a proposed transaction as it was received, without parsing or serializing it again.
+     *
+     * @param message The message to publish
+     * @param accounts The accounts affected by the transaction
+     */
+    void
+    forwardProposedTransaction(
+        std::shared_ptr<std::string> const& message,
+        std::vector<ripple::AccountID> const& accounts
+    );
+
     /**
      * @brief Publish manifest updates from a JSON response.
      *
@@ -534,6 +549,14 @@ public:
     void
     forwardManifest(boost::json::object const& response);
 
+    /**
+     * @brief Publish a manifest update as it was received.
+     *
+     * @param message The message to publish
+     */
+    void
+    forwardManifest(std::shared_ptr<std::string> const& message);
+
     /**
      * @brief Publish validation updates from a JSON response.
      *
@@ -542,6 +565,14 @@ public:
     void
     forwardValidation(boost::json::object const& response);
 
+    /**
+     * @brief Publish a validation update as it was received.
+     *
+     * @param message The message to publish
+     */
+    void
+    forwardValidation(std::shared_ptr<std::string> const& message);
+
     /**
      * @brief Subscribe to the proposed account stream.
      *
@@ -0,0 +1,322 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of clio: https://github.com/XRPLF/clio
+    Copyright (c) 2023, the clio developers.
+
+    Permission to use, copy, modify, and distribute this software for any
+    purpose with or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL,  DIRECT,  INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include "data/BackendFactory.h"
+#include "data/BackendInterface.h"
+#include "data/Types.h"
+#include "etl/ETLHelpers.h"
+#include "etl/SystemState.h"
+#include "etl/impl/AsyncData.h"
+#include "etl/impl/ExtractionDataPipe.h"
+#include "etl/impl/Extractor.h"
+#include "etl/impl/LedgerFetcher.h"
+#include "etl/impl/LedgerLoader.h"
+#include "etl/impl/LedgerRecording.h"
+#include "etl/impl/LedgerReplay.h"
+#include "etl/impl/Transformer.h"
+#include "main/Build.h"
+#include "util/Profiler.h"
+#include "util/config/Config.h"
+#include "util/log/Logger.h"
+#include "util/prometheus/Prometheus.h"
+
+#include <boost/json/object.hpp>
+#include <boost/json/serialize.hpp>
+#include <boost/program_options/options_description.hpp>
+#include <boost/program_options/parsers.hpp>
+#include <boost/program_options/positional_options.hpp>
+#include <boost/program_options/value_semantic.hpp>
+#include <boost/program_options/variables_map.hpp>
+#include <grpcpp/grpcpp.h>
+#include <ripple/protocol/LedgerHeader.h>
+#include <ripple/proto/org/xrpl/rpc/v1/get_ledger.pb.h>
+#include <ripple/proto/org/xrpl/rpc/v1/get_ledger_data.pb.h>
+#include <ripple/proto/org/xrpl/rpc/v1/xrp_ledger.grpc.pb.h>
+
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <exception>
+#include <iostream>
+#include <memory>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace util;
+
+namespace po = boost::program_options;
+
+namespace {
+
+using ReplayPipeType = etl::detail::ExtractionDataPipe<org::xrpl::rpc::v1::GetLedgerResponse>;
+using ReplayFetcherType = etl::detail::LedgerFetcher<etl::detail::LedgerReplay>;
+using ReplayExtractorType = etl::detail::Extractor<ReplayPipeType, etl::NetworkValidatedLedgers, ReplayFetcherType>;
+using ReplayLoaderType = etl::detail::LedgerLoader<etl::detail::LedgerReplay, ReplayFetcherType>;
+
+/**
+ * @brief Stands in for the publisher at the end of the pipeline and counts what was written.
+ */
+struct ReplayPublisher {
+    std::reference_wrapper<etl::detail::LedgerReplay const> replay;
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    etl::detail::ReplayStageStats loaded{};
+
+    void
+    publish(ripple::LedgerHeader const& lgrInfo, std::vector<data::TransactionAndMetadata>)
+    {
+        loaded.add(replay.get().statsOf(lgrInfo.seq));
+        loaded.elapsed = std::chrono::steady_clock::now() - start;
+    }
+};
+
+struct ReplayAmendmentBlockHandler {
+    util::Logger log{"ETL"};
+
+    void
+    onAmendmentBlock()
+    {
+        LOG(log.warn()) << "A replayed ledger has a transaction this server does not know";
+    }
+};
+
+using ReplayTransformerType =
+    etl::detail::Transformer<ReplayPipeType, ReplayLoaderType, ReplayPublisher, ReplayAmendmentBlockHandler>;
+
+/**
+ * @brief Record the state of the first ledger and all ledgers up to the last one from a rippled.
+ */
+void
+record(std::string const& source, std::uint32_t first, std::uint32_t last, std::string const& path)
+{
+    if (first >= last)
+        throw std::runtime_error("The last ledger must be after the first one");
+
+    grpc::ChannelArguments chArgs;
+    chArgs.SetMaxReceiveMessageSize(-1);
+    auto const stub = org::xrpl::rpc::v1::XRPLedgerAPIService::NewStub(
+        grpc::CreateCustomChannel(source, grpc::InsecureChannelCredentials(), chArgs)
+    );
+
+    auto const deadline = []() { return std::chrono::system_clock::now() + etl::detail::AsyncLedgerFetch::TIMEOUT; };
+    etl::detail::LedgerRecordWriter writer{path};
+
+    org::xrpl::rpc::v1::GetLedgerDataRequest dataRequest;
+    dataRequest.mutable_ledger()->set_sequence(first);
+    dataRequest.set_user("ETL");
+
+    std::size_t numObjects = 0;
+    do {
+        org::xrpl::rpc::v1::GetLedgerDataResponse page;
+        grpc::ClientContext context;
+        context.set_deadline(deadline());
+
+        if (auto const status = stub->GetLedgerData(&context, dataRequest, &page); !status.ok())
+            throw std::runtime_error("GetLedgerData failed: " + status.error_message());
+
+        numObjects += page.ledger_objects().objects_size();
+        writer.writeLedgerDataPage(first, page);
+        dataRequest.set_marker(page.marker());
+    } while (!dataRequest.marker().empty());
+
+    std::cerr << "Recorded " << numObjects << " objects of ledger " << first << '\n';
+
+    for (auto sequence = first; sequence <= last; ++sequence) {
+        org::xrpl::rpc::v1::GetLedgerRequest request;
+        request.mutable_ledger()->set_sequence(sequence);
+        request.set_transactions(true);
+        request.set_expand(true);
+        request.set_get_objects(true);
+        request.set_get_object_neighbors(true);
+        request.set_user("ETL");
+
+        org::xrpl::rpc::v1::GetLedgerResponse response;
+        grpc::ClientContext context;
+        context.set_deadline(deadline());
+
+        if (auto const status = stub->GetLedger(&context, request, &response); !status.ok() or !response.validated())
+            throw std::runtime_error("GetLedger failed for ledger " + std::to_string(sequence));
+
+        writer.writeLedger(sequence, response);
+    }
+
+    writer.flush();
+    std::cerr << "Recorded ledgers " << first << " to " << last << " to " << path << '\n';
+}
+
+/**
+ * @brief Replay a recording into the DB of the config through the extract, transform and load stages of the ETL.
+ *
+ * The DB must be empty. The ETL options of the config (extractor threads, pipelined writes, ...) apply.
+ *
+ * @return The throughput of each stage
+ */
+boost::json::object
+replay(Config const& config, std::string const& path, bool realtime)
+{
+    auto backend = data::make_Backend(config);
+    auto reader = etl::detail::LedgerRecordReader{path};
+    auto ledgerReplay = std::make_shared<etl::detail::LedgerReplay>(backend, reader);
+    auto const first = ledgerReplay->firstSequence();
+    auto const last = ledgerReplay->lastSequence();
+
+    etl::SystemState state;
+    ReplayFetcherType fetcher{backend, ledgerReplay};
+    ReplayLoaderType loader{
+        backend, ledgerReplay, fetcher, state, config.valueOr<std::uint32_t>("transaction_decode_threads", 4)
+    };
+
+    auto const initialSeconds = ::util::timed<std::chrono::duration<double>>([&]() {
+        if (!loader.loadInitialLedger(first))
+            throw std::runtime_error("Can't load the initial ledger");
+    });
+
+    etl::detail::ReplayStageStats initial = ledgerReplay->statsOf(first);
+    initial.objects = backend->cache().size();
+    initial.elapsed = std::chrono::duration<double>{initialSeconds};
+
+    // the network "validates" the recorded ledgers at once, or when they closed
+    auto const ledgers = etl::NetworkValidatedLedgers::make_ValidatedLedgers();
+    std::thread network{[&ledgers, &source = *ledgerReplay, first, last, realtime]() {
+        if (!realtime) {
+            ledgers->push(last);
+            return;
+        }
+
+        auto const begin = std::chrono::steady_clock::now() - source.closeOffset(first + 1);
+        for (auto sequence = first + 1; sequence <= last; ++sequence) {
+            std::this_thread::sleep_until(begin + source.closeOffset(sequence));
+            ledgers->push(sequence);
+        }
+    }};
+
+    auto const numExtractors = config.valueOr<std::uint32_t>("extractor_threads", 1);
+    ReplayPipeType pipe{numExtractors, first + 1, config.maybeValue<std::uint32_t>("extraction_queue_depth")};
+    ReplayPublisher publisher{.replay = std::cref(*ledgerReplay)};
+    ReplayAmendmentBlockHandler amendmentBlockHandler;
+
+    std::vector<std::unique_ptr<ReplayExtractorType>> extractors;
+    for (auto i = 0u; i < numExtractors; ++i) {
+        extractors.push_back(std::make_unique<ReplayExtractorType>(
+            pipe,
+            ledgers,
+            fetcher,
+            first + 1 + i,
+            last,
+            state,
+            config.valueOr<std::uint32_t>("extractor_fetches_in_flight", 1)
+        ));
+    }
+
+    ReplayTransformerType transformer{
+        pipe,
+        backend,
+        loader,
+        publisher,
+        amendmentBlockHandler,
+        first + 1,
+        state,
+        config.valueOr("pipelined_writes", false)
+    };
+    transformer.waitTillFinished();
+    pipe.cleanup();
+
+    for (auto& extractor : extractors)
+        extractor->waitTillFinished();
+    network.join();
+
+    return {
+        {"first_ledger", first},
+        {"last_ledger", last},
+        {"realtime", realtime},
+        {"initial_ledger", initial.toJson()},
+        {"extract", ledgerReplay->extracted().toJson()},
+        {"load", publisher.loaded.toJson()},
+    };
+}
+
+}  // namespace
+
+int
+main(int argc, char* argv[])
+try {
+    // clang-format off
+    po::options_description description("Options");
+    description.add_options()
+        ("help,h", "print help message and exit")
+        ("mode", po::value<std::string>(), "record or replay")
+        ("file", po::value<std::string>(), "the recording to write or to replay")
+        ("source,s", po::value<std::string>(), "record: gRPC endpoint of the rippled to record from, as ip:port")
+        ("first", po::value<std::uint32_t>(), "record: the ledger whose state is recorded")
+        ("last", po::value<std::uint32_t>(), "record: the last ledger recorded")
+        ("conf,c", po::value<std::string>(), "replay: configuration file with the database to write to")
+        ("realtime", "replay: make ledgers available at the pace they closed instead of all at once")
+    ;
+    // clang-format on
+    po::positional_options_description positional;
+    positional.add("mode", 1).add("file", 1);
+
+    po::variables_map parsed;
+    po::store(po::command_line_parser(argc, argv).options(description).positional(positional).run(), parsed);
+    po::notify(parsed);
+
+    if (parsed.count("help") != 0u or parsed.count("mode") == 0u or parsed.count("file") == 0u) {
+        std::cout << "Clio ETL benchmark " << Build::getClioFullVersionString() << "\n\n"
+                  << "Usage: clio_etl_bench record FILE --source IP:PORT --first SEQ --last SEQ\n"
+                  << "       clio_etl_bench replay FILE --conf CONFIG [--realtime]\n\n"
+                  << description;
+        return parsed.count("help") != 0u ? EXIT_SUCCESS : EXIT_FAILURE;
+    }
+
+    auto const mode = parsed["mode"].as<std::string>();
+    auto const file = parsed["file"].as<std::string>();
+
+    if (mode == "record") {
+        if (parsed.count("source") == 0u or parsed.count("first") == 0u or parsed.count("last") == 0u)
+            throw std::runtime_error("record needs --source, --first and --last");
+
+        auto const first = parsed["first"].as<std::uint32_t>();
+        auto const last = parsed["last"].as<std::uint32_t>();
+        record(parsed["source"].as<std::string>(), first, last, file);
+        return EXIT_SUCCESS;
+    }
+
+    if (mode == "replay") {
+        if (parsed.count("conf") == 0u)
+            throw std::runtime_error("replay needs --conf");
+
+        auto const configPath = parsed["conf"].as<std::string>();
+        auto const config = ConfigReader::open(configPath);
+        if (!config)
+            throw std::runtime_error("Couldnt parse config '" + configPath + "'.");
+
+        LogService::init(config);
+        PrometheusService::init(config);
+
+        std::cout << boost::json::serialize(replay(config, file, parsed.count("realtime") != 0u)) << std::endl;
+        return EXIT_SUCCESS;
+    }
+
+    throw std::runtime_error("Unknown mode '" + mode + "'. Use record or replay");
+} catch (std::exception const& e) {
+    std::cerr << "Exit on exception: " << e.what() << std::endl;
+    return EXIT_FAILURE;
+}
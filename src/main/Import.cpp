@@ -0,0 +1,108 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of clio: https://github.com/XRPLF/clio
+    Copyright (c) 2023, the clio developers.
+
+    Permission to use, copy, modify, and distribute this software for any
+    purpose with or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL,  DIRECT,  INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include "data/BackendFactory.h"
+#include "etl/SystemState.h"
+#include "etl/impl/LedgerFetcher.h"
+#include "etl/impl/LedgerImport.h"
+#include "etl/impl/LedgerLoader.h"
+#include "etl/impl/LedgerRecording.h"
+#include "etl/impl/LedgerReplay.h"
+#include "main/Build.h"
+#include "util/config/Config.h"
+#include "util/log/Logger.h"
+#include "util/prometheus/Prometheus.h"
+
+#include <boost/program_options/options_description.hpp>
+#include <boost/program_options/parsers.hpp>
+#include <boost/program_options/positional_options.hpp>
+#include <boost/program_options/value_semantic.hpp>
+#include <boost/program_options/variables_map.hpp>
+
+#include <cstdint>
+#include <cstdlib>
+#include <exception>
+#include <iostream>
+#include <memory>
+#include <stdexcept>
+#include <string>
+
+using namespace util;
+
+namespace po = boost::program_options;
+
+namespace {
+
+// ledgers are only written as diffs, which needs neither a source nor a fetcher; the replay source provides the types
+using ImportFetcherType = etl::detail::LedgerFetcher<etl::detail::LedgerReplay>;
+using ImportLoaderType = etl::detail::LedgerLoader<etl::detail::LedgerReplay, ImportFetcherType>;
+
+}  // namespace
+
+int
+main(int argc, char* argv[])
+try {
+    // clang-format off
+    po::options_description description("Options");
+    description.add_options()
+        ("help,h", "print help message and exit")
+        ("conf,c", po::value<std::string>(), "configuration file with the database to import into")
+        ("dump", po::value<std::string>(), "the ledger dump to import, e.g. written by clio_etl_bench record")
+    ;
+    // clang-format on
+    po::positional_options_description positional;
+    positional.add("dump", 1);
+
+    po::variables_map parsed;
+    po::store(po::command_line_parser(argc, argv).options(description).positional(positional).run(), parsed);
+    po::notify(parsed);
+
+    if (parsed.count("help") != 0u or parsed.count("conf") == 0u or parsed.count("dump") == 0u) {
+        std::cout << "Clio ledger import " << Build::getClioFullVersionString() << "\n\n"
+                  << "Usage: clio_import DUMP --conf CONFIG\n\n"
+                  << description;
+        return parsed.count("help") != 0u ? EXIT_SUCCESS : EXIT_FAILURE;
+    }
+
+    auto const configPath = parsed["conf"].as<std::string>();
+    auto const config = ConfigReader::open(configPath);
+    if (!config)
+        throw std::runtime_error("Couldnt parse config '" + configPath + "'.");
+
+    LogService::init(config);
+    PrometheusService::init(config);
+
+    auto backend = data::make_Backend(config);
+    etl::SystemState const state;
+    ImportFetcherType fetcher{backend, nullptr};
+    ImportLoaderType loader{
+        backend, nullptr, fetcher, state, config.valueOr<std::uint32_t>("transaction_decode_threads", 4)
+    };
+
+    auto reader = etl::detail::LedgerRecordReader{parsed["dump"].as<std::string>()};
+    etl::detail::LedgerImport<ImportLoaderType> ledgerImport{config.sectionOr("import", {}), backend, loader};
+    auto const range = ledgerImport.run(reader);
+
+    std::cout << "Imported ledgers " << range.minSequence << " to " << range.maxSequence
+              << ". Clio continues from ledger " << range.maxSequence + 1 << std::endl;
+    return EXIT_SUCCESS;
+} catch (std::exception const& e) {
+    std::cerr << "Exit on exception: " << e.what() << std::endl;
+    return EXIT_FAILURE;
+}
@@ -0,0 +1,233 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of clio: https://github.com/XRPLF/clio
+    Copyright (c) 2023, the clio developers.
+
+    Permission to use, copy, modify, and distribute this software for any
+    purpose with or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL,  DIRECT,  INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include "rpc/common/impl/ForwardingCache.h"
+
+#include <boost/asio/spawn.hpp>
+#include <boost/json/array.hpp>
+#include <boost/json/object.hpp>
+#include <boost/json/serialize.hpp>
+#include <boost/json/string.hpp>
+#include <boost/json/value.hpp>
+#include <boost/system/error_code.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace rpc::detail {
+
+namespace {
+
+// serializes with the fields of objects sorted, so requests that differ only in field order get the same key
+void
+normalize(boost::json::value const& value, std::string& out)
+{
+    if (value.is_object()) {
+        std::vector<std::pair<std::string_view, boost::json::value const*>> fields;
+        for (auto const& [key, field] : value.as_object())
+            fields.emplace_back(key, &field);
+        std::sort(fields.begin(), fields.end(), [](auto const& a, auto const& b) { return a.first < b.first; });
+
+        out.push_back('{');
+        for (auto const& [key, field] : fields) {
+            out += boost::json::serialize(boost::json::string{key});
+            out.push_back(':');
+            normalize(*field, out);
+            out.push_back(',');
+        }
+        out.push_back('}');
+    } else if (value.is_array()) {
+        out.push_back('[');
+        for (auto const& element : value.as_array()) {
+            normalize(element, out);
+            out.push_back(',');
+        }
+        out.push_back(']');
+    } else {
+        out += boost::json::serialize(value);
+    }
+}
+
+std::string
+makeKey(std::string const& method, boost::json::object const& request)
+{
+    auto params = request;
+    params.erase("id");
+    params.erase("command");
+    params.erase("method");
+
+    auto key = method;
+    key.push_back(' ');
+    normalize(params, key);
+    return key;
+}
+
+bool
+isError(boost::json::object const& response)
+{
+    if (response.contains("error"))
+        return true;
+
+    auto const* result = response.if_contains("result");
+    return result != nullptr and result->is_object() and result->as_object().contains("error");
+}
+
+}  // namespace
+
+std::optional<ForwardingCache::Policy>
+ForwardingCache::policyFor(std::string const& method)
+{
+    using namespace std::chrono_literals;
+
+    // submitting a transaction twice must reach rippled twice
+    if (method.starts_with("submit"))
+        return std::nullopt;
+
+    static std::unordered_map<std::string, Policy> const policies{
+        {"fee", {.ttl = 1s, .expiresOnLedgerClose = true}},
+        {"ledger_closed", {.ttl = 1s, .expiresOnLedgerClose = true}},
+        {"ledger_current", {.ttl = 1s, .expiresOnLedgerClose = true}},
+        {"manifest", {.ttl = 10s, .expiresOnLedgerClose = false}},
+        {"server_definitions", {.ttl = 60s, .expiresOnLedgerClose = false}},
+    };
+
+    if (auto const it = policies.find(method); it != policies.end())
+        return it->second;
+
+    return std::nullopt;
+}
+
+std::optional<boost::json::object>
+ForwardingCache::getOrFetch(
+    std::string const& method,
+    boost::json::object const& request,
+    std::uint32_t ledgerSequence,
+    FetchType const& fetch,
+    boost::asio::yield_context yield
+)
+{
+    auto const policy = policyFor(method);
+    if (not policy)
+        return fetch();
+
+    auto const key = makeKey(method, request);
+    std::shared_ptr<WaiterChannel> waiter;
+    {
+        std::scoped_lock const lck{mtx_};
+
+        if (auto const it = entries_.find(key); it != entries_.end()) {
+            auto const& entry = it->second;
+            auto const isFresh = std::chrono::steady_clock::now() < entry.expiresAt and
+                (not entry.ledgerSequence or *entry.ledgerSequence == ledgerSequence);
+            if (isFresh)
+                return entry.response;
+
+            entries_.erase(it);
+        }
+
+        if (auto const it = inFlight_.find(key); it != inFlight_.end()) {
+            waiter = std::make_shared<WaiterChannel>(yield.get_executor(), 1);
+            it->second.push_back(waiter);
+        } else {
+            inFlight_.emplace(key, std::vector<std::shared_ptr<WaiterChannel>>{});
+        }
+    }
+
+    if (waiter) {
+        boost::system::error_code ec;
+        auto response = waiter->async_receive(yield[ec]);
+        if (ec)
+            return std::nullopt;
+
+        return response;
+    }
+
+    std::optional<boost::json::object> response;
+    try {
+        response = fetch();
+    } catch (...) {
+        complete(key, *policy, ledgerSequence, std::nullopt);
+        throw;
+    }
+
+    complete(key, *policy, ledgerSequence, response);
+    return response;
+}
+
+std::size_t
+ForwardingCache::size()
+{
+    std::scoped_lock const lck{mtx_};
+    return entries_.size();
+}
+
+void
+ForwardingCache::complete(
+    std::string const& key,
+    Policy const& policy,
+    std::uint32_t ledgerSequence,
+    std::optional<boost::json::object> const& response
+)
+{
+    // the id rippled echoes back belongs to the request that was forwarded, not to the ones sharing its response
+    auto shared = response;
+    if (shared)
+        shared->erase("id");
+
+    std::vector<std::shared_ptr<WaiterChannel>> waiters;
+    {
+        std::scoped_lock const lck{mtx_};
+        if (auto it = inFlight_.find(key); it != inFlight_.end()) {
+            waiters = std::move(it->second);
+            inFlight_.erase(it);
+        }
+
+        auto const now = std::chrono::steady_clock::now();
+        if (entries_.size() >= MAX_ENTRIES)
+            std::erase_if(entries_, [now](auto const& item) { return item.second.expiresAt <= now; });
+
+        if (shared and not isError(*shared) and entries_.size() < MAX_ENTRIES) {
+            entries_.insert_or_assign(
+                key,
+                Entry{
+                    .response = *shared,
+                    .expiresAt = now + policy.ttl,
+                    .ledgerSequence =
+                        policy.expiresOnLedgerClose ? std::make_optional(ledgerSequence) : std::nullopt,
+                }
+            );
+        }
+    }
+
+    for (auto const& waiter : waiters)
+        waiter->try_send(boost::system::error_code{}, shared);
+}
+
+}  // namespace rpc::detail
@@ -0,0 +1,120 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of clio: https://github.com/XRPLF/clio
+    Copyright (c) 2023, the clio developers.
+
+    Permission to use, copy, modify, and distribute this software for any
+    purpose with or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL,  DIRECT,  INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#pragma once
+
+#include <boost/asio/experimental/concurrent_channel.hpp>
+#include <boost/asio/spawn.hpp>
+#include <boost/json/object.hpp>
+#include <boost/system/error_code.hpp>
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace rpc::detail {
+
+/**
+ * @brief Short-lived cache of the responses to forwarded requests that many clients send with the same parameters.
+ *
+ * Requests are keyed on their command and normalized parameters, so the order of fields and the request id don't
+ * matter. Identical requests that arrive while one is being forwarded wait for its response instead of being forwarded
+ * themselves. Only idempotent commands with a @ref Policy are cached; `submit` and its variants never are.
+ */
+class ForwardingCache {
+public:
+    /**
+     * @brief How long the response to a command may be served from the cache.
+     */
+    struct Policy {
+        std::chrono::steady_clock::duration ttl;
+        bool expiresOnLedgerClose;
+    };
+
+    static constexpr std::size_t MAX_ENTRIES = 10000;
+
+    using FetchType = std::function<std::optional<boost::json::object>()>;
+
+private:
+    using WaiterChannel = boost::asio::experimental::
+        concurrent_channel<void(boost::system::error_code, std::optional<boost::json::object>)>;
+
+    struct Entry {
+        boost::json::object response;
+        std::chrono::steady_clock::time_point expiresAt;
+        std::optional<std::uint32_t> ledgerSequence;
+    };
+
+    std::mutex mtx_;
+    std::unordered_map<std::string, Entry> entries_;
+    std::unordered_map<std::string, std::vector<std::shared_ptr<WaiterChannel>>> inFlight_;
+
+public:
+    /**
+     * @brief Get the caching policy of a command.
+     *
+     * @param method The command
+     * @return The policy; nullopt if responses to the command must not be cached
+     */
+    static std::optional<Policy>
+    policyFor(std::string const& method);
+
+    /**
+     * @brief Get the response to a request from the cache, or from the forwarded request if there is none.
+     *
+     * @param method The command of the request
+     * @param request The request as it is forwarded
+     * @param ledgerSequence The most recent validated ledger at the time of the request
+     * @param fetch Forwards the request; not called if the response is cached or another forward of it is in flight
+     * @param yield The coroutine context
+     * @return The response; nullopt if forwarding failed
+     */
+    std::optional<boost::json::object>
+    getOrFetch(
+        std::string const& method,
+        boost::json::object const& request,
+        std::uint32_t ledgerSequence,
+        FetchType const& fetch,
+        boost::asio::yield_context yield
+    );
+
+    /**
+     * @return The number of cached responses
+     */
+    std::size_t
+    size();
+
+private:
+    void
+    complete(
+        std::string const& key,
+        Policy const& policy,
+        std::uint32_t ledgerSequence,
+        std::optional<boost::json::object> const& response
+    );
+};
+
+}  // namespace rpc::detail
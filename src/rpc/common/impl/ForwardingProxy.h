@@ -24,10 +24,12 @@
 #include "rpc/Counters.h"
 #include "rpc/RPCHelpers.h"
 #include "rpc/common/Types.h"
+#include "rpc/common/impl/ForwardingCache.h"
 #include "util/log/Logger.h"
 #include "web/Context.h"
 
 #include <memory>
+#include <optional>
 #include <string>
 
 namespace rpc::detail {
@@ -40,6 +42,8 @@ class ForwardingProxy {
     std::reference_wrapper<CountersType> counters_;
     std::shared_ptr<HandlerProviderType const> handlerProvider_;
 
+    ForwardingCache cache_;
+
 public:
     ForwardingProxy(
         std::shared_ptr<LoadBalancerType> const& balancer,
@@ -89,7 +93,13 @@ public:
         auto toForward = ctx.params;
         toForward["command"] = ctx.method;
 
-        auto const res = balancer_->forwardToRippled(toForward, ctx.clientIp, ctx.yield);
+        auto const res = cache_.getOrFetch(
+            ctx.method,
+            toForward,
+            ctx.range.maxSequence,
+            [&]() { return balancer_->forwardToRippled(toForward, ctx.clientIp, ctx.yield); },
+            ctx.yield
+        );
         if (not res) {
             notifyFailedToForward(ctx.method);
             return Status{RippledError::rpcFAILED_TO_FORWARD};
@@ -47,6 +47,7 @@
 #include "rpc/handlers/NFTsByIssuer.h"
 #include "rpc/handlers/NoRippleCheck.h"
 #include "rpc/handlers/Ping.h"
+#include "rpc/handlers/PruneHistory.h"
 #include "rpc/handlers/Random.h"
 #include "rpc/handlers/ServerInfo.h"
 #include "rpc/handlers/Subscribe.h"
@@ -94,6 +95,7 @@ ProductionHandlerProvider::ProductionHandlerProvider(
           {"nft_sell_offers", {NFTSellOffersHandler{backend}}},
           {"noripple_check", {NoRippleCheckHandler{backend}}},
           {"ping", {PingHandler{}}},
+          {"prune_history", {PruneHistoryHandler{backend, etl}, true}},  // clio only
           {"random", {RandomHandler{}}},
           {"server_info", {ServerInfoHandler{backend, subscriptionManager, balancer, etl, counters}}},
           {"transaction_entry", {TransactionEntryHandler{backend}}},
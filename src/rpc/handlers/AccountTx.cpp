@@ -171,7 +171,45 @@ AccountTxHandler::process(AccountTxHandler::Input input, Context const& ctx) con
 
     auto const limit = input.limit.value_or(LIMIT_DEFAULT);
     auto const accountID = accountFromStringStrict(input.account);
+
+    // The type index has no rows for ledgers written before it was introduced. Pages that start below the oldest
+    // covered ledger read the full history and filter it below instead.
+    auto const typeIndexStart = [&]() -> std::optional<std::uint32_t> {
+        if (not input.transactionType)
+            return std::nullopt;
+
+        auto const coverage = sharedPtrBackend_->fetchIndexCoverage(data::INDEX_ACCOUNT_TX_BY_TYPE, ctx.yield);
+        if (not coverage)
+            return std::nullopt;
+
+        auto const startsCovered = input.forward
+            ? cursor->ledgerSequence >= *coverage or
+                (cursor->ledgerSequence + 1 == *coverage and
+                 cursor->transactionIndex == static_cast<std::uint32_t>(std::numeric_limits<int32_t>::max()))
+            : cursor->ledgerSequence >= *coverage;
+
+        if (not startsCovered)
+            return std::nullopt;
+
+        return coverage;
+    }();
+
+    // going backwards, a page served by the type index continues without it below the oldest covered ledger
+    auto const uncoveredContinuation = [&]() -> std::optional<Marker> {
+        if (*typeIndexStart <= minIndex)
+            return std::nullopt;
+
+        return Marker{*typeIndexStart - 1, static_cast<std::uint32_t>(std::numeric_limits<int32_t>::max())};
+    };
+
     auto const [txnsAndCursor, timeDiff] = util::timed([&]() {
+        // the type index lets the database do the filtering so that limit counts matching transactions only
+        if (typeIndexStart) {
+            return sharedPtrBackend_->fetchAccountTransactionsByType(
+                *accountID, *input.transactionType, limit, input.forward, cursor, ctx.yield
+            );
+        }
+
         return sharedPtrBackend_->fetchAccountTransactions(*accountID, limit, input.forward, cursor, ctx.yield);
     });
 
@@ -184,6 +222,11 @@ AccountTxHandler::process(AccountTxHandler::Input input, Context const& ctx) con
         response.marker = {retCursor->ledgerSequence, retCursor->transactionIndex};
 
     for (auto const& txnPlusMeta : blobs) {
+        if (typeIndexStart and txnPlusMeta.ledgerSequence < *typeIndexStart) {
+            response.marker = uncoveredContinuation();
+            break;
+        }
+
         // over the range
         if ((txnPlusMeta.ledgerSequence < minIndex && !input.forward) ||
             (txnPlusMeta.ledgerSequence > maxIndex && input.forward)) {
@@ -245,6 +288,9 @@ AccountTxHandler::process(AccountTxHandler::Input input, Context const& ctx) con
         response.transactions.push_back(std::move(obj));
     }
 
+    if (typeIndexStart and not input.forward and not retCursor and not response.marker)
+        response.marker = uncoveredContinuation();
+
     response.limit = input.limit;
     response.account = ripple::to_string(*accountID);
     response.ledgerIndexMin = minIndex;
@@ -0,0 +1,127 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of clio: https://github.com/XRPLF/clio
+    Copyright (c) 2023, the clio developers.
+
+    Permission to use, copy, modify, and distribute this software for any
+    purpose with or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL,  DIRECT,  INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#pragma once
+
+#include "data/BackendInterface.h"
+#include "etl/ETLService.h"
+#include "rpc/Errors.h"
+#include "rpc/JS.h"
+#include "rpc/common/Types.h"
+#include "rpc/common/Validators.h"
+
+#include <boost/json/conversion.hpp>
+#include <boost/json/object.hpp>
+#include <boost/json/value.hpp>
+#include <ripple/protocol/ErrorCodes.h>
+#include <ripple/protocol/jss.h>
+
+#include <cstdint>
+#include <memory>
+#include <optional>
+
+namespace rpc {
+
+/**
+ * @brief The prune_history command deletes ledger history below the given ledger. Admin only.
+ *
+ * Pruning happens in the background on the ETL writer; without `min_ledger` the command only reports its progress.
+ * Not documented in the official rippled API docs.
+ */
+template <typename ETLServiceType>
+class BasePruneHistoryHandler {
+    std::shared_ptr<BackendInterface> sharedPtrBackend_;
+    std::shared_ptr<ETLServiceType const> etl_;
+
+public:
+    struct Output {
+        boost::json::object info;
+    };
+
+    struct Input {
+        std::optional<uint32_t> minLedger;
+    };
+
+    using Result = HandlerReturnType<Output>;
+
+    BasePruneHistoryHandler(
+        std::shared_ptr<BackendInterface> const& sharedPtrBackend,
+        std::shared_ptr<ETLServiceType const> const& etl
+    )
+        : sharedPtrBackend_(sharedPtrBackend), etl_(etl)
+    {
+    }
+
+    static RpcSpecConstRef
+    spec([[maybe_unused]] uint32_t apiVersion)
+    {
+        static auto const rpcSpec = RpcSpec{
+            {JS(min_ledger), validation::Type<uint32_t>{}},
+        };
+
+        return rpcSpec;
+    }
+
+    Result
+    process(Input input, Context const& ctx) const
+    {
+        if (not ctx.isAdmin)
+            return Error{Status{RippledError::rpcNO_PERMISSION}};
+
+        if (input.minLedger) {
+            // note: we can't get here if range is not available so it's safe
+            auto const range = sharedPtrBackend_->fetchLedgerRange().value();
+            if (*input.minLedger > range.maxSequence)
+                return Error{Status{RippledError::rpcINVALID_PARAMS, "minLedgerAboveLatest"}};
+
+            if (not etl_->requestHistoryPruning(*input.minLedger))
+                return Error{Status{RippledError::rpcNOT_ENABLED, "notAvailableInReadOnlyMode"}};
+        }
+
+        return Output{etl_->getHistoryPruningInfo()};
+    }
+
+private:
+    friend void
+    tag_invoke(boost::json::value_from_tag, boost::json::value& jv, Output const& output)
+    {
+        jv = output.info;
+    }
+
+    friend Input
+    tag_invoke(boost::json::value_to_tag<Input>, boost::json::value const& jv)
+    {
+        auto input = BasePruneHistoryHandler::Input{};
+        auto const& jsonObject = jv.as_object();
+
+        if (jsonObject.contains(JS(min_ledger)))
+            input.minLedger = jv.at(JS(min_ledger)).as_int64();
+
+        return input;
+    }
+};
+
+/**
+ * @brief The prune_history command deletes ledger history below the given ledger.
+ *
+ * This is a type alias for @ref BasePruneHistoryHandler using the default ETLService.
+ */
+using PruneHistoryHandler = BasePruneHistoryHandler<etl::ETLService>;
+
+}  // namespace rpc
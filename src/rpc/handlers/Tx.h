@@ -20,6 +20,7 @@
 #pragma once
 
 #include "data/BackendInterface.h"
+#include "data/Types.h"
 #include "etl/ETLService.h"
 #include "rpc/RPCHelpers.h"
 #include "rpc/common/JsonBool.h"
@@ -185,6 +186,15 @@ private:
     std::optional<data::TransactionAndMetadata>
     fetchTxViaCtid(uint32_t ledgerSeq, uint32_t txId, boost::asio::yield_context yield) const
     {
+        if (auto tx = sharedPtrBackend_->fetchTransactionByIndex(ledgerSeq, txId, yield); tx)
+            return tx;
+
+        // ledgers written before transaction positions were recorded can only be searched in full. A miss in a covered
+        // ledger is final, so made up CTIDs can't make every request read a whole ledger
+        auto const coverage = sharedPtrBackend_->fetchIndexCoverage(data::INDEX_LEDGER_TRANSACTION_INDEXES, yield);
+        if (coverage and ledgerSeq >= *coverage)
+            return std::nullopt;
+
         auto const txs = sharedPtrBackend_->fetchAllTransactionsInLedger(ledgerSeq, yield);
 
         for (auto const& tx : txs) {
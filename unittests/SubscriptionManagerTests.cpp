@@ -268,6 +268,27 @@ TEST_F(SubscriptionManagerSimpleBackendTest, SubscriptionManagerProposedTransact
     CheckSubscriberMessage(dummyTransaction, session);
 }
 
+/*
+ * test ProposedTransaction published from the raw message
+ * the message is forwarded as it was received, to the accounts it was routed to
+ */
+TEST_F(SubscriptionManagerSimpleBackendTest, SubscriptionManagerRawProposedTransaction)
+{
+    auto account = GetAccountIDWithString(ACCOUNT1);
+    subManagerPtr->subProposedAccount(account, session);
+
+    std::shared_ptr<web::ConnectionBase> const sessionIdle = std::make_shared<MockSession>(tagDecoratorFactory);
+    subManagerPtr->subProposedAccount(GetAccountIDWithString(ACCOUNT2), sessionIdle);
+
+    auto const message =
+        std::make_shared<std::string>(R"({"transaction":{"Account":"rf1BiGeXwwQoi8Z2ueFYTEXSwuJYfV2Jpn"}})");
+    subManagerPtr->forwardProposedTransaction(message, std::vector<ripple::AccountID>{account});
+    CheckSubscriberMessage(*message, session);
+    auto rawIdle = dynamic_cast<MockSession*>(sessionIdle.get());
+    ASSERT_NE(rawIdle, nullptr);
+    EXPECT_EQ("", rawIdle->message);
+}
+
 /*
  * test ProposedTransaction for one account
  * we need to construct a valid account in the transaction
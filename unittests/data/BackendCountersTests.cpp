@@ -48,7 +48,9 @@ struct BackendCountersTest : WithPrometheus {
             "read_async_pending": 0,
             "read_async_completed": 0,
             "read_async_retry": 0,
-            "read_async_error": 0
+            "read_async_error": 0,
+            "read_statements": {},
+            "write_statements": {}
         })")
             .as_object();
     }
@@ -194,6 +196,32 @@ TEST_F(BackendCountersTest, RegisterReadError)
     EXPECT_EQ(counters->report(), expectedReport);
 }
 
+TEST_F(BackendCountersTest, RegisterReadStatement)
+{
+    counters->registerReadStatement("selectObject", std::chrono::microseconds{300});
+    counters->registerReadStatement("selectObject", std::chrono::microseconds{100}, 2);
+    counters->registerReadStatement("selectSuccessor", std::chrono::microseconds{50});
+
+    auto expectedReport = emptyReport();
+    expectedReport["read_statements"] = boost::json::parse(R"({
+        "selectObject": {"completed": 3, "duration_us": 500, "avg_duration_us": 166},
+        "selectSuccessor": {"completed": 1, "duration_us": 50, "avg_duration_us": 50}
+    })");
+    EXPECT_EQ(counters->report(), expectedReport);
+}
+
+TEST_F(BackendCountersTest, RegisterWriteStatement)
+{
+    counters->registerWriteStatement("insertObject", std::chrono::microseconds{1000});
+    counters->registerWriteStatement("insertObject", std::chrono::microseconds{3000});
+
+    auto expectedReport = emptyReport();
+    expectedReport["write_statements"] = boost::json::parse(R"({
+        "insertObject": {"completed": 2, "duration_us": 4000, "avg_duration_us": 2000}
+    })");
+    EXPECT_EQ(counters->report(), expectedReport);
+}
+
 struct BackendCountersMockPrometheusTest : WithMockPrometheus {
     BackendCounters::PtrType const counters = BackendCounters::make();
 };
@@ -295,3 +323,37 @@ TEST_F(BackendCountersMockPrometheusTest, registerReadError)
     EXPECT_CALL(errorCounter, add(1));
     counters->registerReadError();
 }
+
+TEST_F(BackendCountersMockPrometheusTest, registerReadStatement)
+{
+    auto& completedCounter = makeMock<CounterInt>(
+        "backend_statements_total_number", "{operation=\"read\",statement=\"selectObject\"}"
+    );
+    auto& durationCounter = makeMock<CounterInt>(
+        "backend_statements_duration_microseconds_total", "{operation=\"read\",statement=\"selectObject\"}"
+    );
+    auto& histogram = makeMock<HistogramInt>(
+        "backend_statements_duration_milliseconds_histogram", "{operation=\"read\",statement=\"selectObject\"}"
+    );
+    EXPECT_CALL(completedCounter, add(2));
+    EXPECT_CALL(durationCounter, add(4000));
+    EXPECT_CALL(histogram, observe(2)).Times(2);
+    counters->registerReadStatement("selectObject", std::chrono::microseconds{2000}, 2);
+}
+
+TEST_F(BackendCountersMockPrometheusTest, registerWriteStatement)
+{
+    auto& completedCounter = makeMock<CounterInt>(
+        "backend_statements_total_number", "{operation=\"write\",statement=\"insertObject\"}"
+    );
+    auto& durationCounter = makeMock<CounterInt>(
+        "backend_statements_duration_microseconds_total", "{operation=\"write\",statement=\"insertObject\"}"
+    );
+    auto& histogram = makeMock<HistogramInt>(
+        "backend_statements_duration_milliseconds_histogram", "{operation=\"write\",statement=\"insertObject\"}"
+    );
+    EXPECT_CALL(completedCounter, add(1));
+    EXPECT_CALL(durationCounter, add(1000));
+    EXPECT_CALL(histogram, observe(1));
+    counters->registerWriteStatement("insertObject", std::chrono::microseconds{1000});
+}
@@ -0,0 +1,161 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of clio: https://github.com/XRPLF/clio
+    Copyright (c) 2023, the clio developers.
+
+    Permission to use, copy, modify, and distribute this software for any
+    purpose with or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL,  DIRECT,  INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include "data/BlobCodec.h"
+#include "data/Types.h"
+#include "util/MockPrometheus.h"
+#include "util/TmpFile.h"
+#include "util/config/Config.h"
+
+#include <boost/json/parse.hpp>
+#include <fmt/core.h>
+#include <gtest/gtest.h>
+
+#include <stdexcept>
+#include <string>
+
+using namespace data;
+using namespace util::prometheus;
+
+namespace {
+
+// Same shape as a serialized transaction: starts with the TransactionType field header and repeats a lot
+std::string const repetitiveBlob = [] {
+    std::string blob{"\x12\x00\x00", 3};
+    for (auto i = 0; i < 100; ++i)
+        blob += "rHb9CJAWyB4rj91VRWn96DkukG4bwdtyTh";
+    return blob;
+}();
+
+Blob
+toBlob(std::string const& str)
+{
+    return {str.begin(), str.end()};
+}
+
+util::Config
+makeConfig(std::string const& json)
+{
+    return util::Config{boost::json::parse(json)};
+}
+
+}  // namespace
+
+struct BlobCodecTest : WithPrometheus {
+    BlobCodec const disabled;
+    BlobCodec const enabled{makeConfig(R"({"enabled": true})")};
+};
+
+TEST_F(BlobCodecTest, DisabledByDefault)
+{
+    EXPECT_FALSE(disabled.isEnabled());
+    EXPECT_EQ(disabled.encode(std::string{repetitiveBlob}), repetitiveBlob);
+}
+
+TEST_F(BlobCodecTest, EncodeDecodeRoundTrip)
+{
+    auto encoded = enabled.encode(std::string{repetitiveBlob});
+    EXPECT_LT(encoded.size(), repetitiveBlob.size());
+    EXPECT_TRUE(BlobCodec::isEncoded(toBlob(encoded)));
+
+    auto const decoded = enabled.decode(toBlob(encoded));
+    ASSERT_TRUE(decoded);
+    EXPECT_EQ(*decoded, toBlob(repetitiveBlob));
+
+    // any codec can decode, even with compression disabled
+    auto const decodedByDisabled = disabled.decode(toBlob(encoded));
+    ASSERT_TRUE(decodedByDisabled);
+    EXPECT_EQ(*decodedByDisabled, toBlob(repetitiveBlob));
+}
+
+TEST_F(BlobCodecTest, RawBlobsPassThrough)
+{
+    auto const decoded = enabled.decode(toBlob(repetitiveBlob));
+    ASSERT_TRUE(decoded);
+    EXPECT_EQ(*decoded, toBlob(repetitiveBlob));
+    EXPECT_FALSE(BlobCodec::isEncoded(toBlob(repetitiveBlob)));
+
+    auto const empty = enabled.decode(Blob{});
+    ASSERT_TRUE(empty);
+    EXPECT_TRUE(empty->empty());
+}
+
+TEST_F(BlobCodecTest, IncompressibleBlobIsStoredRaw)
+{
+    std::string const small{"\x12\x00\x07", 3};
+    EXPECT_EQ(enabled.encode(std::string{small}), small);
+}
+
+TEST_F(BlobCodecTest, UnknownVersionIsAnError)
+{
+    auto blob = toBlob(enabled.encode(std::string{repetitiveBlob}));
+    blob[2] = 42;
+
+    auto const decoded = enabled.decode(std::move(blob));
+    ASSERT_FALSE(decoded);
+    EXPECT_EQ(decoded.error(), "Unknown blob format version 42");
+}
+
+TEST_F(BlobCodecTest, CorruptedBlobIsAnError)
+{
+    auto blob = toBlob(enabled.encode(std::string{repetitiveBlob}));
+    blob.resize(blob.size() / 2);
+
+    EXPECT_FALSE(enabled.decode(std::move(blob)));
+}
+
+TEST_F(BlobCodecTest, Dictionary)
+{
+    TmpFile const dictionary{repetitiveBlob};
+    auto const config = makeConfig(fmt::format(R"({{"enabled": true, "dictionary": "{}"}})", dictionary.path));
+    BlobCodec const withDictionary{config};
+
+    auto encoded = withDictionary.encode(std::string{repetitiveBlob});
+    EXPECT_LT(encoded.size(), enabled.encode(std::string{repetitiveBlob}).size());
+
+    auto const decoded = withDictionary.decode(toBlob(encoded));
+    ASSERT_TRUE(decoded);
+    EXPECT_EQ(*decoded, toBlob(repetitiveBlob));
+}
+
+TEST_F(BlobCodecTest, MissingDictionaryThrows)
+{
+    EXPECT_THROW(BlobCodec{makeConfig(R"({"dictionary": "/nonexistent/xrpl.dict"})")}, std::runtime_error);
+}
+
+TEST_F(BlobCodecTest, InvalidLevelThrows)
+{
+    EXPECT_THROW(BlobCodec{makeConfig(R"({"level": 1000})")}, std::runtime_error);
+}
+
+TEST_F(BlobCodecTest, Report)
+{
+    auto encoded = enabled.encode(std::string{repetitiveBlob});
+    ASSERT_TRUE(enabled.decode(toBlob(encoded)));
+
+    auto const report = enabled.report();
+    EXPECT_TRUE(report.at("enabled").as_bool());
+    for (auto const operation : {"encode", "decode"}) {
+        auto const& counters = report.at(operation).as_object();
+        EXPECT_EQ(counters.at("blobs").as_uint64(), 1u);
+        EXPECT_EQ(counters.at("raw_bytes").as_uint64(), repetitiveBlob.size());
+        EXPECT_EQ(counters.at("stored_bytes").as_uint64(), encoded.size());
+        EXPECT_EQ(counters.at("saved_bytes").as_uint64(), repetitiveBlob.size() - encoded.size());
+    }
+}
@@ -0,0 +1,87 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of clio: https://github.com/XRPLF/clio
+    Copyright (c) 2024, the clio developers.
+
+    Permission to use, copy, modify, and distribute this software for any
+    purpose with or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL,  DIRECT,  INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include "data/LedgerCache.h"
+#include "data/Types.h"
+#include "util/MockPrometheus.h"
+
+#include <gtest/gtest.h>
+#include <ripple/basics/base_uint.h>
+
+#include <utility>
+#include <vector>
+
+using namespace data;
+using namespace util::prometheus;
+
+namespace {
+
+constexpr auto SEQ = 30;
+
+ripple::uint256 const KEY1{"1000000000000000000000000000000000000000000000000000000000000000"};
+ripple::uint256 const KEY2{"2000000000000000000000000000000000000000000000000000000000000000"};
+ripple::uint256 const KEY3{"3000000000000000000000000000000000000000000000000000000000000000"};
+ripple::uint256 const KEY4{"4000000000000000000000000000000000000000000000000000000000000000"};
+
+Blob const BLOB{'b', 'l', 'o', 'b'};
+
+}  // namespace
+
+struct LedgerCacheTest : WithPrometheus {
+    LedgerCacheTest()
+    {
+        cache.update({{KEY1, BLOB}, {KEY3, BLOB}}, SEQ - 1);
+        cache.setFull();
+    }
+
+    LedgerCache cache;
+};
+
+TEST_F(LedgerCacheTest, SuccessorUpdatesForCreatedAndDeletedKeys)
+{
+    cache.update({{KEY2, BLOB}, {KEY3, {}}, {KEY4, BLOB}}, SEQ);
+
+    using Edges = std::vector<std::pair<ripple::uint256, ripple::uint256>>;
+    auto const edges = cache.getSuccessorUpdates({KEY2, KEY3, KEY4}, SEQ);
+    EXPECT_EQ(edges, (Edges{{KEY1, KEY2}, {KEY2, KEY4}, {KEY4, lastKey}}));
+}
+
+TEST_F(LedgerCacheTest, SuccessorUpdatesLinkFirstKey)
+{
+    cache.update({{KEY1, {}}}, SEQ);
+
+    using Edges = std::vector<std::pair<ripple::uint256, ripple::uint256>>;
+    auto const edges = cache.getSuccessorUpdates({KEY1}, SEQ);
+    EXPECT_EQ(edges, (Edges{{firstKey, KEY3}}));
+}
+
+TEST_F(LedgerCacheTest, SuccessorUpdatesForOutdatedSequence)
+{
+    cache.update({{KEY2, BLOB}}, SEQ);
+
+    EXPECT_TRUE(cache.getSuccessorUpdates({KEY2}, SEQ - 1).empty());
+}
+
+TEST_F(LedgerCacheTest, SuccessorUpdatesWhenNotFull)
+{
+    LedgerCache notFullCache;
+    notFullCache.update({{KEY1, BLOB}}, SEQ);
+
+    EXPECT_TRUE(notFullCache.getSuccessorUpdates({KEY1}, SEQ).empty());
+}
@@ -29,6 +29,7 @@
 #include "util/LedgerUtils.h"
 #include "util/Random.h"
 #include "util/StringUtils.h"
+#include "util/TestObject.h"
 #include "util/config/Config.h"
 
 #include <boost/asio/impl/spawn.hpp>
@@ -44,7 +45,9 @@
 #include <ripple/protocol/LedgerHeader.h>
 #include <ripple/protocol/STTx.h>
 #include <ripple/protocol/Serializer.h>
+#include <ripple/protocol/TxFormats.h>
 #include <ripple/protocol/TxMeta.h>
+#include <ripple/protocol/nft.h>
 
 #include <algorithm>
 #include <atomic>
@@ -135,6 +138,11 @@ TEST_F(BackendCassandraTest, Basic)
             EXPECT_EQ(rng->minSequence, rng->maxSequence);
             EXPECT_EQ(rng->maxSequence, lgrInfo.seq);
         }
+        {
+            // the database was created by this version, so the index tables cover all of its history
+            EXPECT_EQ(backend->fetchIndexCoverage(data::INDEX_ACCOUNT_TX_BY_TYPE, yield), 0u);
+            EXPECT_EQ(backend->fetchIndexCoverage(data::INDEX_NFT_STATE, yield), 0u);
+        }
         {
             auto seq = backend->fetchLatestLedgerSequence(yield);
             ASSERT_TRUE(seq.has_value());
@@ -374,6 +382,9 @@ TEST_F(BackendCassandraTest, Basic)
         std::string nftTxnBlob = hexStringToBinaryString(nftTxnHex);
         std::string const nftTxnMetaBlob = hexStringToBinaryString(nftTxnMeta);
 
+        ripple::SerialIter txnIt{txnBlob.data(), txnBlob.size()};
+        auto const txnType = ripple::STTx{txnIt}.getTxnType();
+
         {
             lgrInfoNext.seq = lgrInfoNext.seq + 1;
             lgrInfoNext.txHash = ~lgrInfo.txHash;
@@ -389,7 +400,7 @@ TEST_F(BackendCassandraTest, Basic)
                 affectedAccounts.push_back(a);
             }
             std::vector<AccountTransactionsData> accountTxData;
-            accountTxData.emplace_back(txMeta, hash256);
+            accountTxData.emplace_back(txMeta, hash256, txnType);
 
             ripple::uint256 nftHash256;
             EXPECT_TRUE(nftHash256.parseHex(nftTxnHashHex));
@@ -414,6 +425,7 @@ TEST_F(BackendCassandraTest, Basic)
                 std::string{txnBlob},
                 std::string{metaBlob}
             );
+            backend->writeTransactionIndex(lgrInfoNext.seq, txMeta.getIndex(), hash256);
             backend->writeAccountTransactions(std::move(accountTxData));
             backend->writeNFTs(nftData);
             backend->writeNFTTransactions(parsedNFTTxs);
@@ -446,14 +458,39 @@ TEST_F(BackendCassandraTest, Basic)
             auto hashes = backend->fetchAllTransactionHashesInLedger(lgrInfoNext.seq, yield);
             EXPECT_EQ(hashes.size(), 1);
             EXPECT_EQ(ripple::strHex(hashes[0]), hashHex);
+
+            ripple::TxMeta const txMeta{hashes[0], lgrInfoNext.seq, metaBlob};
+            auto const txByIndex = backend->fetchTransactionByIndex(lgrInfoNext.seq, txMeta.getIndex(), yield);
+            ASSERT_TRUE(txByIndex.has_value());
+            EXPECT_EQ(txByIndex->transaction, allTransactions[0].transaction);
+            EXPECT_FALSE(backend->fetchTransactionByIndex(lgrInfoNext.seq, txMeta.getIndex() + 1, yield).has_value());
             for (auto& a : affectedAccounts) {
                 auto [accountTransactions, cursor] = backend->fetchAccountTransactions(a, 100, true, {}, yield);
                 EXPECT_EQ(accountTransactions.size(), 1);
                 EXPECT_EQ(accountTransactions[0], accountTransactions[0]);
                 EXPECT_FALSE(cursor);
+
+                auto [typedTransactions, typedCursor] =
+                    backend->fetchAccountTransactionsByType(a, txnType, 100, true, {}, yield);
+                EXPECT_EQ(typedTransactions.size(), 1);
+                EXPECT_FALSE(typedCursor);
             }
             auto nft = backend->fetchNFT(nftID, lgrInfoNext.seq, yield);
             EXPECT_TRUE(nft.has_value());
+
+            auto const [issuerNFTs, issuerCursor] = backend->fetchNFTsByIssuer(
+                ripple::nft::getIssuer(nftID), std::nullopt, lgrInfoNext.seq, 100, std::nullopt, yield
+            );
+            ASSERT_EQ(issuerNFTs.size(), 1);
+            EXPECT_EQ(issuerNFTs[0].tokenID, nftID);
+            EXPECT_EQ(issuerNFTs[0].owner, nft->owner);
+            EXPECT_FALSE(issuerCursor);
+
+            // the NFT did not exist yet, so the state table must not leak it into the past
+            auto const [pastNFTs, pastCursor] = backend->fetchNFTsByIssuer(
+                ripple::nft::getIssuer(nftID), std::nullopt, lgrInfoNext.seq - 1, 100, std::nullopt, yield
+            );
+            EXPECT_TRUE(pastNFTs.empty());
             auto [nftTxns, cursor] = backend->fetchNFTTransactions(nftID, 100, true, {}, yield);
             EXPECT_EQ(nftTxns.size(), 1);
             EXPECT_EQ(nftTxns[0], nftTxns[0]);
@@ -1265,3 +1302,63 @@ TEST_F(BackendCassandraTest, CacheIntegration)
     ctx.run();
     ASSERT_EQ(done, true);
 }
+
+TEST_F(BackendCassandraTest, WriterLeaseUpdateIsIdempotent)
+{
+    auto const first = data::WriterLease{.writer = "first", .term = 1, .heartbeat = 0};
+    auto const renewed = data::WriterLease{.writer = "first", .term = 1, .heartbeat = 1};
+    auto const other = data::WriterLease{.writer = "second", .term = 2, .heartbeat = 0};
+
+    EXPECT_TRUE(backend->updateWriterLease(std::nullopt, first));
+    EXPECT_TRUE(backend->updateWriterLease(first, renewed));
+
+    // a retry of an update that was applied already, e.g. after a timeout, still reports success
+    EXPECT_TRUE(backend->updateWriterLease(first, renewed));
+    EXPECT_FALSE(backend->updateWriterLease(first, other));
+
+    auto const current = data::synchronousAndRetryOnTimeout([this](auto yield) {
+        return backend->fetchWriterLease(yield);
+    });
+    EXPECT_EQ(current, renewed);
+}
+
+TEST_F(BackendCassandraTest, NFTStateKeepsLatestLedgerWhateverTheWriteOrder)
+{
+    static constexpr std::uint32_t FIRST_SEQ = 30;
+    static constexpr auto LEDGER_HASH = "4BC50C9B0D8515D3EAAE1E74B29A95804346C491EE1A95BF25E4AAB854A6A652";
+    auto const nftID = ripple::uint256{"000827103B94ECBB7BF0A0A6ED62B3607801A27B65F4679F4AD1D4850000C0F7"};
+    auto const minter = GetAccountIDWithString("rf1BiGeXwwQoi8Z2ueFYTEXSwuJYfV2Jpn");
+    auto const buyer = GetAccountIDWithString("rLEsXccBGNR3UPuPu2hUXPjziKC3qKSBun");
+    auto const uri = ripple::Blob{'u', 'r', 'i'};
+
+    // the database is created by this version, so nfts_by_issuer is served from the state table
+    auto const lgrInfo = CreateLedgerInfo(LEDGER_HASH, FIRST_SEQ);
+    backend->writeLedger(lgrInfo, ledgerInfoToBinaryString(lgrInfo));
+    backend->writeSuccessor(uint256ToString(data::firstKey), FIRST_SEQ, uint256ToString(data::lastKey));
+    ASSERT_TRUE(backend->finishWrites(FIRST_SEQ));
+
+    // the transfer arrives before the mint of the ledger before it
+    auto transfer = NFTsData{nftID, FIRST_SEQ + 2, buyer, ripple::Blob{}};
+    transfer.uri.reset();
+    backend->writeNFTs({transfer});
+    backend->writeNFTs({NFTsData{nftID, FIRST_SEQ + 1, minter, uri}});
+    backend->syncThreadWrites();
+
+    auto const fetch = [this, issuer = ripple::nft::getIssuer(nftID)](std::uint32_t seq) {
+        return data::synchronousAndRetryOnTimeout([&](auto yield) {
+            return backend->fetchNFTsByIssuer(issuer, std::nullopt, seq, 100, std::nullopt, yield);
+        });
+    };
+
+    auto const latest = fetch(FIRST_SEQ + 2);
+    ASSERT_EQ(latest.nfts.size(), 1);
+    EXPECT_EQ(latest.nfts[0].ledgerSequence, FIRST_SEQ + 2);
+    EXPECT_EQ(latest.nfts[0].owner, buyer);
+    EXPECT_EQ(latest.nfts[0].uri, uri);
+
+    auto const minted = fetch(FIRST_SEQ + 1);
+    ASSERT_EQ(minted.nfts.size(), 1);
+    EXPECT_EQ(minted.nfts[0].ledgerSequence, FIRST_SEQ + 1);
+    EXPECT_EQ(minted.nfts[0].owner, minter);
+    EXPECT_EQ(minted.nfts[0].uri, uri);
+}
@@ -31,6 +31,7 @@
 #include <gmock/gmock.h>
 #include <gtest/gtest.h>
 
+#include <algorithm>
 #include <atomic>
 #include <chrono>
 #include <cstdint>
@@ -38,6 +39,7 @@
 #include <memory>
 #include <optional>
 #include <stdexcept>
+#include <string_view>
 #include <thread>
 #include <vector>
 
@@ -90,6 +92,14 @@ protected:
             registerReadErrorImpl(count);
         }
         MOCK_METHOD(void, registerReadErrorImpl, (std::uint64_t), ());
+
+        void
+        registerReadStatement(std::string_view statement, std::chrono::microseconds duration, std::uint64_t count = 1)
+        {
+            registerReadStatementImpl(statement, duration, count);
+        }
+        MOCK_METHOD(void, registerReadStatementImpl, (std::string_view, std::chrono::microseconds, std::uint64_t), ());
+        MOCK_METHOD(void, registerWriteStatement, (std::string_view, std::chrono::microseconds), ());
         MOCK_METHOD(boost::json::object, report, (), ());
     };
 
@@ -128,6 +138,7 @@ TEST_F(BackendCassandraExecutionStrategyTest, ReadOneInCoroutineSuccessful)
         .Times(1);
     EXPECT_CALL(*counters, registerReadStartedImpl(1));
     EXPECT_CALL(*counters, registerReadFinishedImpl(testing::_, 1));
+    EXPECT_CALL(*counters, registerReadStatementImpl(FakeStatement::label(), testing::_, 1));
 
     runSpawn([&strat](boost::asio::yield_context yield) {
         auto statement = FakeStatement{};
@@ -193,6 +204,7 @@ TEST_F(BackendCassandraExecutionStrategyTest, ReadBatchInCoroutineSuccessful)
         .Times(1);
     EXPECT_CALL(*counters, registerReadStartedImpl(NUM_STATEMENTS));
     EXPECT_CALL(*counters, registerReadFinishedImpl(testing::_, NUM_STATEMENTS));
+    EXPECT_CALL(*counters, registerReadStatementImpl(FakeStatement::label(), testing::_, NUM_STATEMENTS));
 
     runSpawn([&strat](boost::asio::yield_context yield) {
         auto statements = std::vector<FakeStatement>(NUM_STATEMENTS);
@@ -267,6 +279,7 @@ TEST_F(BackendCassandraExecutionStrategyTest, ReadBatchInCoroutineMarksBusyIfReq
         .Times(1);
     EXPECT_CALL(*counters, registerReadStartedImpl(NUM_STATEMENTS));
     EXPECT_CALL(*counters, registerReadFinishedImpl(testing::_, NUM_STATEMENTS));
+    EXPECT_CALL(*counters, registerReadStatementImpl(FakeStatement::label(), testing::_, NUM_STATEMENTS));
 
     runSpawn([&strat](boost::asio::yield_context yield) {
         EXPECT_FALSE(strat.isTooBusy());  // 2 was the limit, 0 atm
@@ -295,6 +308,7 @@ TEST_F(BackendCassandraExecutionStrategyTest, ReadEachInCoroutineSuccessful)
         .Times(NUM_STATEMENTS);  // once per statement
     EXPECT_CALL(*counters, registerReadStartedImpl(NUM_STATEMENTS));
     EXPECT_CALL(*counters, registerReadFinishedImpl(testing::_, NUM_STATEMENTS));
+    EXPECT_CALL(*counters, registerReadStatementImpl(FakeStatement::label(), testing::_, NUM_STATEMENTS));
 
     runSpawn([&strat](boost::asio::yield_context yield) {
         auto statements = std::vector<FakeStatement>(NUM_STATEMENTS);
@@ -329,6 +343,7 @@ TEST_F(BackendCassandraExecutionStrategyTest, ReadEachInCoroutineThrowsOnFailure
     EXPECT_CALL(*counters, registerReadStartedImpl(NUM_STATEMENTS));
     EXPECT_CALL(*counters, registerReadErrorImpl(1));
     EXPECT_CALL(*counters, registerReadFinishedImpl(testing::_, 2));
+    EXPECT_CALL(*counters, registerReadStatementImpl(FakeStatement::label(), testing::_, 2));
 
     runSpawn([&strat](boost::asio::yield_context yield) {
         auto statements = std::vector<FakeStatement>(NUM_STATEMENTS);
@@ -336,6 +351,84 @@ TEST_F(BackendCassandraExecutionStrategyTest, ReadEachInCoroutineThrowsOnFailure
     });
 }
 
+TEST_F(BackendCassandraExecutionStrategyTest, ReadPagedInCoroutineVisitsAllPages)
+{
+    auto strat = makeStrategy();
+    auto callCount = std::atomic_uint{0};
+
+    ON_CALL(handle, asyncExecute(A<FakeStatement const&>(), A<std::function<void(FakeResultOrError)>&&>()))
+        .WillByDefault([&callCount](auto const&, auto&& cb) {
+            // every page but the last one reports there is more to fetch
+            cb(FakeResultOrError{.result = FakeResult{.morePages = ++callCount < NUM_STATEMENTS}});
+            return FakeFutureWithCallback{};
+        });
+    EXPECT_CALL(handle, asyncExecute(A<FakeStatement const&>(), A<std::function<void(FakeResultOrError)>&&>()))
+        .Times(NUM_STATEMENTS);  // once per page
+    EXPECT_CALL(*counters, registerReadStartedImpl(1)).Times(NUM_STATEMENTS);
+    EXPECT_CALL(*counters, registerReadFinishedImpl(testing::_, 1)).Times(NUM_STATEMENTS);
+    EXPECT_CALL(*counters, registerReadStatementImpl(FakeStatement::label(), testing::_, 1)).Times(NUM_STATEMENTS);
+
+    runSpawn([&strat, &callCount](boost::asio::yield_context yield) {
+        auto numPages = 0u;
+        strat.readPaged(yield, FakeStatement{}, [&](FakeResult const&) {
+            ++numPages;
+            // the next page is already requested while the current one is processed
+            EXPECT_EQ(callCount.load(), std::min(numPages + 1, NUM_STATEMENTS));
+        });
+        EXPECT_EQ(numPages, NUM_STATEMENTS);
+        EXPECT_FALSE(strat.isTooBusy());
+    });
+}
+
+TEST_F(BackendCassandraExecutionStrategyTest, ReadPagedInCoroutineRethrowsAfterNextPageArrived)
+{
+    auto strat = makeStrategy();
+
+    ON_CALL(handle, asyncExecute(A<FakeStatement const&>(), A<std::function<void(FakeResultOrError)>&&>()))
+        .WillByDefault([](auto const&, auto&& cb) {
+            cb(FakeResultOrError{.result = FakeResult{.morePages = true}});
+            return FakeFutureWithCallback{};
+        });
+    EXPECT_CALL(handle, asyncExecute(A<FakeStatement const&>(), A<std::function<void(FakeResultOrError)>&&>()))
+        .Times(2);
+    EXPECT_CALL(*counters, registerReadStartedImpl(1)).Times(2);
+    EXPECT_CALL(*counters, registerReadFinishedImpl(testing::_, 1)).Times(2);
+    EXPECT_CALL(*counters, registerReadStatementImpl(FakeStatement::label(), testing::_, 1)).Times(2);
+
+    runSpawn([&strat](boost::asio::yield_context yield) {
+        EXPECT_THROW(
+            strat.readPaged(yield, FakeStatement{}, [](FakeResult const&) { throw std::runtime_error("stop"); }),
+            std::runtime_error
+        );
+    });
+}
+
+TEST_F(BackendCassandraExecutionStrategyTest, ReadPagedInCoroutineThrowsOnTimeoutOfNextPage)
+{
+    auto strat = makeStrategy();
+    auto callCount = std::atomic_int{0};
+
+    ON_CALL(handle, asyncExecute(A<FakeStatement const&>(), A<std::function<void(FakeResultOrError)>&&>()))
+        .WillByDefault([&callCount](auto const&, auto&& cb) {
+            if (callCount++ == 0) {
+                cb(FakeResultOrError{.result = FakeResult{.morePages = true}});
+            } else {
+                cb(FakeResultOrError{CassandraError{"timeout", CASS_ERROR_LIB_REQUEST_TIMED_OUT}});
+            }
+            return FakeFutureWithCallback{};
+        });
+    EXPECT_CALL(handle, asyncExecute(A<FakeStatement const&>(), A<std::function<void(FakeResultOrError)>&&>()))
+        .Times(2);
+    EXPECT_CALL(*counters, registerReadStartedImpl(1)).Times(2);
+    EXPECT_CALL(*counters, registerReadFinishedImpl(testing::_, 1));
+    EXPECT_CALL(*counters, registerReadStatementImpl(FakeStatement::label(), testing::_, 1));
+    EXPECT_CALL(*counters, registerReadErrorImpl(1));
+
+    runSpawn([&strat](boost::asio::yield_context yield) {
+        EXPECT_THROW(strat.readPaged(yield, FakeStatement{}, [](FakeResult const&) {}), DatabaseTimeout);
+    });
+}
+
 TEST_F(BackendCassandraExecutionStrategyTest, WriteSyncFirstTrySuccessful)
 {
     auto strat = makeStrategy();
@@ -344,7 +437,36 @@ TEST_F(BackendCassandraExecutionStrategyTest, WriteSyncFirstTrySuccessful)
     EXPECT_CALL(handle,
                 execute(A<FakeStatement const&>())).Times(1);  // first one will succeed
     EXPECT_CALL(*counters, registerWriteSync(testing::_));
+    EXPECT_CALL(*counters, registerWriteStatement(FakeStatement::label(), testing::_));
+
+    EXPECT_TRUE(strat.writeSync({}));
+}
+
+TEST_F(BackendCassandraExecutionStrategyTest, ReadsAndWritesUseSeparateHandles)
+{
+    MockHandle readHandle{};
+    auto strat = DefaultExecutionStrategy<MockHandle, MockBackendCounters>(Settings{}, handle, readHandle, counters);
+
+    ON_CALL(readHandle, asyncExecute(A<FakeStatement const&>(), A<std::function<void(FakeResultOrError)>&&>()))
+        .WillByDefault([](auto const&, auto&& cb) {
+            cb({});  // pretend we got data
+            return FakeFutureWithCallback{};
+        });
+    EXPECT_CALL(readHandle, asyncExecute(A<FakeStatement const&>(), A<std::function<void(FakeResultOrError)>&&>()))
+        .Times(1);
+    EXPECT_CALL(handle, asyncExecute(A<FakeStatement const&>(), A<std::function<void(FakeResultOrError)>&&>()))
+        .Times(0);
+    EXPECT_CALL(*counters, registerReadStartedImpl(1));
+    EXPECT_CALL(*counters, registerReadFinishedImpl(testing::_, 1));
+    EXPECT_CALL(*counters, registerReadStatementImpl(FakeStatement::label(), testing::_, 1));
+
+    ON_CALL(handle, execute(A<FakeStatement const&>())).WillByDefault([](auto const&) { return FakeResultOrError{}; });
+    EXPECT_CALL(handle, execute(A<FakeStatement const&>())).Times(1);
+    EXPECT_CALL(readHandle, execute(A<FakeStatement const&>())).Times(0);
+    EXPECT_CALL(*counters, registerWriteSync(testing::_));
+    EXPECT_CALL(*counters, registerWriteStatement(FakeStatement::label(), testing::_));
 
+    runSpawn([&strat](boost::asio::yield_context yield) { strat.read(yield, FakeStatement{}); });
     EXPECT_TRUE(strat.writeSync({}));
 }
 
@@ -362,6 +484,7 @@ TEST_F(BackendCassandraExecutionStrategyTest, WriteSyncRetrySuccessful)
                 execute(A<FakeStatement const&>())).Times(2);  // first one will fail, second will succeed
     EXPECT_CALL(*counters, registerWriteSyncRetry());
     EXPECT_CALL(*counters, registerWriteSync(testing::_));
+    EXPECT_CALL(*counters, registerWriteStatement(FakeStatement::label(), testing::_));
 
     EXPECT_TRUE(strat.writeSync({}));
 }
@@ -394,6 +517,7 @@ TEST_F(BackendCassandraExecutionStrategyTest, WriteMultipleAndCallSyncSucceeds)
         .Times(totalRequests);  // one per write call
     EXPECT_CALL(*counters, registerWriteStarted()).Times(totalRequests);
     EXPECT_CALL(*counters, registerWriteFinished(testing::_)).Times(totalRequests);
+    EXPECT_CALL(*counters, registerWriteStatement(FakeStatement::label(), testing::_)).Times(totalRequests);
 
     auto makeStatements = [] { return std::vector<FakeStatement>(16); };
     for (auto i = 0u; i < totalRequests; ++i)
@@ -406,6 +530,98 @@ TEST_F(BackendCassandraExecutionStrategyTest, WriteMultipleAndCallSyncSucceeds)
     thread.join();
 }
 
+TEST_F(BackendCassandraExecutionStrategyTest, SyncOfWriteGroupDoesNotWaitForLaterGroups)
+{
+    auto strat = makeStrategy();
+    auto callCount = std::atomic_uint{0u};
+    auto heldCallback = std::function<void(FakeResultOrError)>{};
+
+    auto work = std::optional<boost::asio::io_context::work>{ctx};
+    auto thread = std::thread{[this]() { ctx.run(); }};
+
+    ON_CALL(handle, asyncExecute(A<std::vector<FakeStatement> const&>(), A<std::function<void(FakeResultOrError)>&&>()))
+        .WillByDefault([this, &callCount, &heldCallback](auto const&, auto&& cb) {
+            // the write of the first group completes right away, the one of the second group is held back
+            if (callCount++ == 0) {
+                boost::asio::post(ctx, [cb = std::forward<decltype(cb)>(cb)] { cb({}); });
+            } else {
+                heldCallback = std::forward<decltype(cb)>(cb);
+            }
+            return FakeFutureWithCallback{};
+        });
+    EXPECT_CALL(
+        handle,
+        asyncExecute(
+            A<std::vector<FakeStatement> const&>(),
+            A<std::function<void(FakeResultOrError)>&&>()
+        )
+    )
+        .Times(2);
+    EXPECT_CALL(*counters, registerWriteStarted()).Times(2);
+    EXPECT_CALL(*counters, registerWriteFinished(testing::_)).Times(2);
+    EXPECT_CALL(*counters, registerWriteStatement(FakeStatement::label(), testing::_)).Times(2);
+
+    auto const firstGroup = strat.newWriteGroup();
+    strat.write(std::vector<FakeStatement>(16));
+
+    auto const secondGroup = strat.newWriteGroup();
+    EXPECT_GT(secondGroup, firstGroup);
+    strat.write(std::vector<FakeStatement>(16));
+
+    strat.sync(firstGroup);  // must not wait for the held write of the second group
+    EXPECT_EQ(callCount, 2u);
+
+    ASSERT_TRUE(heldCallback);
+    boost::asio::post(ctx, [&heldCallback] { heldCallback({}); });
+    strat.sync(secondGroup);
+    strat.sync();
+
+    work.reset();
+    thread.join();
+}
+
+TEST_F(BackendCassandraExecutionStrategyTest, IsolatedThreadWritesAreOnlyWaitedForByTheirThread)
+{
+    auto strat = makeStrategy();
+    auto heldCallback = std::function<void(FakeResultOrError)>{};
+
+    auto work = std::optional<boost::asio::io_context::work>{ctx};
+    auto thread = std::thread{[this]() { ctx.run(); }};
+
+    ON_CALL(handle, asyncExecute(A<std::vector<FakeStatement> const&>(), A<std::function<void(FakeResultOrError)>&&>()))
+        .WillByDefault([&heldCallback](auto const&, auto&& cb) {
+            heldCallback = std::forward<decltype(cb)>(cb);
+            return FakeFutureWithCallback{};
+        });
+    EXPECT_CALL(
+        handle,
+        asyncExecute(
+            A<std::vector<FakeStatement> const&>(),
+            A<std::function<void(FakeResultOrError)>&&>()
+        )
+    );
+    EXPECT_CALL(*counters, registerWriteStarted());
+    EXPECT_CALL(*counters, registerWriteFinished(testing::_));
+    EXPECT_CALL(*counters, registerWriteStatement(FakeStatement::label(), testing::_));
+
+    auto const group = strat.newWriteGroup();
+    std::thread{[&strat]() {
+        strat.isolateThread();
+        EXPECT_TRUE(strat.isThreadIsolated());
+        strat.write(std::vector<FakeStatement>(16));
+    }}.join();
+    EXPECT_FALSE(strat.isThreadIsolated());
+
+    strat.sync(group);  // must not wait for the held write of the isolated thread
+
+    ASSERT_TRUE(heldCallback);
+    boost::asio::post(ctx, [&heldCallback] { heldCallback({}); });
+    strat.syncThread();  // not isolated, so waits for all writes
+
+    work.reset();
+    thread.join();
+}
+
 TEST_F(BackendCassandraExecutionStrategyTest, StatsCallsCountersReport)
 {
     auto strat = makeStrategy();
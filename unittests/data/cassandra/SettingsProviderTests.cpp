@@ -24,11 +24,13 @@
 #include "util/config/Config.h"
 
 #include <boost/json/parse.hpp>
+#include <cassandra.h>
 #include <fmt/core.h>
 #include <gtest/gtest.h>
 
 #include <chrono>
 #include <optional>
+#include <stdexcept>
 #include <thread>
 #include <variant>
 
@@ -58,6 +60,11 @@ TEST_F(SettingsProviderTest, Defaults)
     EXPECT_EQ(settings.username, std::nullopt);
     EXPECT_EQ(settings.password, std::nullopt);
     EXPECT_EQ(settings.queueSizeIO, std::nullopt);
+    EXPECT_EQ(settings.slowStatementThreshold, std::chrono::milliseconds{500});
+    EXPECT_EQ(settings.pageSize, 256);
+    EXPECT_EQ(settings.consistency, CASS_CONSISTENCY_QUORUM);
+    EXPECT_EQ(settings.localDataCenter, std::nullopt);
+    EXPECT_FALSE(provider.getReadSettings().has_value());
 
     auto const* cp = std::get_if<Settings::ContactPoints>(&settings.connectionInfo);
     ASSERT_TRUE(cp != nullptr);
@@ -77,12 +84,16 @@ TEST_F(SettingsProviderTest, SimpleConfig)
         "keyspace": "test",
         "replication_factor": 42,
         "table_prefix": "prefix",
-        "threads": 24
+        "threads": 24,
+        "slow_statement_threshold": 100,
+        "page_size": 50
     })")};
     SettingsProvider const provider{cfg};
 
     auto const settings = provider.getSettings();
     EXPECT_EQ(settings.threads, 24);
+    EXPECT_EQ(settings.slowStatementThreshold, std::chrono::milliseconds{100});
+    EXPECT_EQ(settings.pageSize, 50);
 
     auto const* cp = std::get_if<Settings::ContactPoints>(&settings.connectionInfo);
     ASSERT_TRUE(cp != nullptr);
@@ -132,3 +143,69 @@ TEST_F(SettingsProviderTest, CertificateConfig)
     auto const settings = provider.getSettings();
     EXPECT_EQ(settings.certificate, "certificateData");
 }
+
+TEST_F(SettingsProviderTest, SeparateReadAndWriteSessions)
+{
+    Config const cfg{json::parse(R"({
+        "contact_points": "127.0.0.1",
+        "threads": 8,
+        "max_read_requests_outstanding": 42,
+        "read": {
+            "contact_points": "123.123.123.123",
+            "port": 1234,
+            "local_data_center": "dc2",
+            "threads": 4,
+            "core_connections_per_host": 3,
+            "consistency": "local_one"
+        },
+        "write": {
+            "local_data_center": "dc1",
+            "consistency": "local_quorum"
+        }
+    })")};
+    SettingsProvider const provider{cfg};
+
+    auto const writeSettings = provider.getSettings();
+    EXPECT_EQ(writeSettings.threads, 8);
+    EXPECT_EQ(writeSettings.coreConnectionsPerHost, 1);
+    EXPECT_EQ(writeSettings.localDataCenter, "dc1");
+    EXPECT_EQ(writeSettings.consistency, CASS_CONSISTENCY_LOCAL_QUORUM);
+    auto const* writePoints = std::get_if<Settings::ContactPoints>(&writeSettings.connectionInfo);
+    ASSERT_TRUE(writePoints != nullptr);
+    EXPECT_EQ(writePoints->contactPoints, "127.0.0.1");
+
+    auto const readSettings = provider.getReadSettings();
+    ASSERT_TRUE(readSettings.has_value());
+    EXPECT_EQ(readSettings->threads, 4);
+    EXPECT_EQ(readSettings->coreConnectionsPerHost, 3);
+    EXPECT_EQ(readSettings->localDataCenter, "dc2");
+    EXPECT_EQ(readSettings->consistency, CASS_CONSISTENCY_LOCAL_ONE);
+    EXPECT_EQ(readSettings->maxReadRequestsOutstanding, 42);
+    auto const* readPoints = std::get_if<Settings::ContactPoints>(&readSettings->connectionInfo);
+    ASSERT_TRUE(readPoints != nullptr);
+    EXPECT_EQ(readPoints->contactPoints, "123.123.123.123");
+    EXPECT_EQ(readPoints->port, 1234);
+}
+
+TEST_F(SettingsProviderTest, WriteSectionAloneSeparatesReads)
+{
+    Config const cfg{json::parse(R"({
+        "contact_points": "127.0.0.1",
+        "write": {"threads": 2}
+    })")};
+    SettingsProvider const provider{cfg};
+
+    EXPECT_EQ(provider.getSettings().threads, 2);
+    auto const readSettings = provider.getReadSettings();
+    ASSERT_TRUE(readSettings.has_value());
+    EXPECT_EQ(readSettings->threads, std::thread::hardware_concurrency());
+}
+
+TEST_F(SettingsProviderTest, InvalidConsistency)
+{
+    Config const cfg{json::parse(R"({
+        "contact_points": "127.0.0.1",
+        "consistency": "most"
+    })")};
+    EXPECT_THROW(SettingsProvider{cfg}, std::runtime_error);
+}
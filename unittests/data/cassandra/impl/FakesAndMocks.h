@@ -22,15 +22,27 @@
 
 #include <gmock/gmock.h>
 
+#include <cstdint>
+#include <string>
+#include <string_view>
 #include <vector>
 
 using namespace data::cassandra;
 using namespace data::cassandra::detail;
 
-struct FakeResult {};
+struct FakeResult {
+    bool morePages = false;
+
+    bool
+    hasMorePages() const
+    {
+        return morePages;
+    }
+};
 
 struct FakeResultOrError {
     CassandraError err{"<default>", CASS_OK};
+    FakeResult result{};
 
     operator bool() const
     {
@@ -43,16 +55,38 @@ struct FakeResultOrError {
         return err;
     }
 
-    static FakeResult
-    value()
+    FakeResult
+    value() const
     {
-        return FakeResult{};
+        return result;
     }
 };
 
 struct FakeMaybeError {};
 
-struct FakeStatement {};
+struct FakeStatement {
+    static std::string_view
+    label()
+    {
+        return "fake";
+    }
+
+    static std::string
+    boundKey()
+    {
+        return {};
+    }
+
+    static void
+    setPageSize(std::uint32_t /* pageSize */)
+    {
+    }
+
+    static void
+    setPagingState(FakeResult const& /* result */)
+    {
+    }
+};
 
 struct FakePreparedStatement {};
 
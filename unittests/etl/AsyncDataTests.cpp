@@ -0,0 +1,294 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of clio: https://github.com/XRPLF/clio
+    Copyright (c) 2023, the clio developers.
+
+    Permission to use, copy, modify, and distribute this software for any
+    purpose with or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL,  DIRECT,  INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include "data/DBHelpers.h"
+#include "data/Types.h"
+#include "etl/impl/AsyncData.h"
+#include "util/Fixtures.h"
+#include "util/MockBackend.h"
+#include "util/TestObject.h"
+
+#include <gmock/gmock.h>
+#include <grpcpp/grpcpp.h>
+#include <gtest/gtest.h>
+#include <ripple/basics/base_uint.h>
+#include <ripple/proto/org/xrpl/rpc/v1/xrp_ledger.grpc.pb.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+
+using namespace testing;
+using namespace etl::detail;
+
+static auto constexpr ACCOUNT = "rf1BiGeXwwQoi8Z2ueFYTEXSwuJYfV2Jpn";
+static auto constexpr LEDGERHASH = "4BC50C9B0D8515D3EAAE1E74B29A95804346C491EE1A95BF25E4AAB854A6A652";
+static auto constexpr SEQ = 30;
+
+namespace {
+
+// a key whose first byte decides the marker range it falls into
+std::string
+keyWithPrefix(unsigned char prefix)
+{
+    ripple::uint256 key{1};
+    key.data()[0] = prefix;
+    return uint256ToString(key);
+}
+
+std::string
+accountRootBlob()
+{
+    auto const blob = CreateAccountRootObject(ACCOUNT, 0, 1, 10, 2, LEDGERHASH, 3).getSerializer().peekData();
+    return {blob.begin(), blob.end()};
+}
+
+/**
+ * @brief The gRPC service of a rippled that pages through a fixed state map, one object per page.
+ *
+ * Like rippled, a page starts at the key of the marker it was asked for. The calls can be made to fail after a while.
+ */
+class FakeLedgerDataService : public org::xrpl::rpc::v1::XRPLedgerAPIService::Service {
+    std::mutex mtx_;
+    std::vector<std::string> keys_;
+    std::optional<std::size_t> callsBeforeFailure_;
+    std::vector<std::string> requestedMarkers_;
+
+public:
+    explicit FakeLedgerDataService(std::vector<std::string> keys) : keys_{std::move(keys)}
+    {
+        std::ranges::sort(keys_);
+    }
+
+    grpc::Status
+    GetLedgerData(
+        grpc::ServerContext*,
+        org::xrpl::rpc::v1::GetLedgerDataRequest const* request,
+        org::xrpl::rpc::v1::GetLedgerDataResponse* response
+    ) override
+    {
+        std::scoped_lock const lck{mtx_};
+        requestedMarkers_.push_back(request->marker());
+
+        if (callsBeforeFailure_) {
+            if (*callsBeforeFailure_ == 0)
+                return {grpc::StatusCode::UNAVAILABLE, "unavailable"};
+            --*callsBeforeFailure_;
+        }
+
+        auto it = std::ranges::lower_bound(keys_, request->marker());
+        if (it != keys_.end()) {
+            auto* obj = response->mutable_ledger_objects()->add_objects();
+            obj->set_key(*it);
+            obj->set_data(accountRootBlob());
+            ++it;
+        }
+        if (it != keys_.end())
+            response->set_marker(*it);
+
+        response->set_is_unlimited(true);
+        return grpc::Status::OK;
+    }
+
+    void
+    failAfter(std::size_t calls)
+    {
+        std::scoped_lock const lck{mtx_};
+        callsBeforeFailure_ = calls;
+    }
+
+    std::vector<std::string>
+    requestedMarkers()
+    {
+        std::scoped_lock const lck{mtx_};
+        return requestedMarkers_;
+    }
+};
+
+struct FakeRippled {
+    FakeLedgerDataService service;
+    std::unique_ptr<grpc::Server> server;
+    std::unique_ptr<org::xrpl::rpc::v1::XRPLedgerAPIService::Stub> stub;
+
+    explicit FakeRippled(std::vector<std::string> keys) : service{std::move(keys)}
+    {
+        int port = 0;
+        grpc::ServerBuilder builder;
+        builder.AddListeningPort("127.0.0.1:0", grpc::InsecureServerCredentials(), &port);
+        builder.RegisterService(&service);
+        server = builder.BuildAndStart();
+
+        stub = org::xrpl::rpc::v1::XRPLedgerAPIService::NewStub(
+            grpc::CreateChannel("127.0.0.1:" + std::to_string(port), grpc::InsecureChannelCredentials())
+        );
+    }
+
+    ~FakeRippled()
+    {
+        server->Shutdown();
+    }
+
+    FakeRippled(FakeRippled const&) = delete;
+    FakeRippled&
+    operator=(FakeRippled const&) = delete;
+};
+
+}  // namespace
+
+struct AsyncDataTest : MockBackendTest {
+    MockBackend* rawBackendPtr = nullptr;
+
+    std::string const key10 = keyWithPrefix(0x10);
+    std::string const key20 = keyWithPrefix(0x20);
+    std::string const key30 = keyWithPrefix(0x30);
+    std::string const key90 = keyWithPrefix(0x90);
+    std::string const keyA0 = keyWithPrefix(0xA0);
+
+    void
+    SetUp() override
+    {
+        MockBackendTest::SetUp();
+        rawBackendPtr = dynamic_cast<MockBackend*>(mockBackendPtr.get());
+        ASSERT_NE(rawBackendPtr, nullptr);
+    }
+
+    // the cursor of a marker range that got as far as key20 before the download stopped
+    data::InitialLoadCursor
+    interruptedCursor() const
+    {
+        return {
+            .marker = ripple::uint256{0},
+            .firstKey = ripple::uint256::fromVoid(key10.data()),
+            .lastKey = ripple::uint256::fromVoid(key20.data())
+        };
+    }
+
+    static org::xrpl::rpc::v1::GetLedgerDataResponse
+    makePage(std::vector<std::string> const& keys)
+    {
+        org::xrpl::rpc::v1::GetLedgerDataResponse page;
+        for (auto const& key : keys) {
+            auto* obj = page.mutable_ledger_objects()->add_objects();
+            obj->set_key(key);
+            obj->set_data(accountRootBlob());
+        }
+        return page;
+    }
+};
+
+TEST_F(AsyncDataTest, ResumedCallSkipsWrittenKeysAndLinksFromLastKey)
+{
+    AsyncCallData call{SEQ, interruptedCursor(), std::nullopt};
+
+    EXPECT_CALL(*rawBackendPtr, writeLedgerObject(std::string{key30}, SEQ, _));
+    EXPECT_CALL(*rawBackendPtr, writeSuccessor(std::string{key20}, SEQ, std::string{key30}));
+
+    EXPECT_EQ(call.processRecorded(makePage({key10, key20, key30}), *rawBackendPtr), AsyncCallData::CallStatus::DONE);
+    EXPECT_EQ(call.getFirstKey(), key10);
+    EXPECT_EQ(call.getLastKey(), key30);
+}
+
+TEST_F(AsyncDataTest, DownloadResumesFromCursor)
+{
+    FakeRippled rippled{{key10, key20, key30}};
+    std::vector<data::InitialLoadCursor> cursors{interruptedCursor()};
+
+    EXPECT_CALL(*rawBackendPtr, writeLedgerObject(std::string{key30}, SEQ, _));
+    EXPECT_CALL(*rawBackendPtr, writeSuccessor(std::string{key20}, SEQ, std::string{key30}));
+
+    EXPECT_TRUE(downloadLedgerData(
+        rippled.stub, *rawBackendPtr, SEQ, cursors, AsyncCallData::Target::CacheAndDatabase, false, "source"
+    ));
+    EXPECT_THAT(rippled.service.requestedMarkers(), ElementsAre(key20, key30));
+
+    ASSERT_EQ(cursors.size(), 1);
+    EXPECT_EQ(cursors[0].firstKey, ripple::uint256::fromVoid(key10.data()));
+    EXPECT_EQ(cursors[0].lastKey, ripple::uint256::fromVoid(key30.data()));
+    EXPECT_TRUE(cursors[0].isDone);
+}
+
+TEST_F(AsyncDataTest, DownloadSkipsFinishedMarkers)
+{
+    FakeRippled rippled{{key10, key20, key90, keyA0}};
+    auto finished = interruptedCursor();
+    finished.isDone = true;
+    ripple::uint256 secondMarker{0};
+    secondMarker.data()[0] = 0x80;
+    std::vector<data::InitialLoadCursor> cursors{finished, {.marker = secondMarker}};
+
+    EXPECT_CALL(*rawBackendPtr, writeLedgerObject(std::string{key90}, SEQ, _));
+    EXPECT_CALL(*rawBackendPtr, writeLedgerObject(std::string{keyA0}, SEQ, _));
+    EXPECT_CALL(*rawBackendPtr, writeSuccessor(std::string{key90}, SEQ, std::string{keyA0}));
+
+    EXPECT_TRUE(downloadLedgerData(
+        rippled.stub, *rawBackendPtr, SEQ, cursors, AsyncCallData::Target::CacheAndDatabase, false, "source"
+    ));
+    EXPECT_THAT(rippled.service.requestedMarkers(), ElementsAre(uint256ToString(secondMarker), keyA0));
+
+    EXPECT_EQ(cursors[0].lastKey, ripple::uint256::fromVoid(key20.data()));
+    EXPECT_EQ(cursors[1].firstKey, ripple::uint256::fromVoid(key90.data()));
+    EXPECT_EQ(cursors[1].lastKey, ripple::uint256::fromVoid(keyA0.data()));
+    EXPECT_TRUE(cursors[1].isDone);
+}
+
+TEST_F(AsyncDataTest, DownloadCheckpointsWhenSourceFails)
+{
+    FakeRippled rippled{{key10, key20, key30}};
+    rippled.service.failAfter(1);
+    std::vector<data::InitialLoadCursor> cursors{{.marker = ripple::uint256{0}}};
+
+    std::vector<data::InitialLoadProgress> checkpoints;
+    EXPECT_CALL(*rawBackendPtr, writeInitialLoadProgress).WillRepeatedly([&checkpoints](auto const& progress) {
+        checkpoints.push_back(progress);
+    });
+
+    EXPECT_FALSE(downloadLedgerData(
+        rippled.stub, *rawBackendPtr, SEQ, cursors, AsyncCallData::Target::CacheAndDatabase, true, "source"
+    ));
+
+    // one checkpoint before anything is written, one once the source failed
+    ASSERT_EQ(checkpoints.size(), 2);
+    EXPECT_EQ(checkpoints.front().sequence, SEQ);
+    ASSERT_EQ(checkpoints.front().cursors.size(), 1);
+    EXPECT_FALSE(checkpoints.front().cursors[0].lastKey.has_value());
+
+    auto const& failed = checkpoints.back();
+    EXPECT_EQ(failed.sequence, SEQ);
+    ASSERT_EQ(failed.cursors.size(), 1);
+    EXPECT_EQ(failed.cursors[0].firstKey, ripple::uint256::fromVoid(key10.data()));
+    EXPECT_EQ(failed.cursors[0].lastKey, ripple::uint256::fromVoid(key10.data()));
+    EXPECT_FALSE(failed.cursors[0].isDone);
+}
+
+TEST_F(AsyncDataTest, DownloadWithoutStubFails)
+{
+    std::unique_ptr<org::xrpl::rpc::v1::XRPLedgerAPIService::Stub> stub;
+    std::vector<data::InitialLoadCursor> cursors{{.marker = ripple::uint256{0}}};
+
+    EXPECT_CALL(*rawBackendPtr, writeInitialLoadProgress).Times(0);
+    EXPECT_FALSE(
+        downloadLedgerData(stub, *rawBackendPtr, SEQ, cursors, AsyncCallData::Target::CacheAndDatabase, true, "source")
+    );
+}
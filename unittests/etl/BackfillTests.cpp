@@ -0,0 +1,216 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of clio: https://github.com/XRPLF/clio
+    Copyright (c) 2023, the clio developers.
+
+    Permission to use, copy, modify, and distribute this software for any
+    purpose with or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL,  DIRECT,  INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include "data/Types.h"
+#include "etl/SystemState.h"
+#include "etl/impl/Backfill.h"
+#include "util/FakeFetchResponse.h"
+#include "util/Fixtures.h"
+#include "util/MockBackend.h"
+#include "util/MockLedgerFetcher.h"
+#include "util/MockLedgerLoader.h"
+#include "util/MockPrometheus.h"
+#include "util/config/Config.h"
+
+#include <boost/json/parse.hpp>
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <cstdint>
+#include <optional>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+using namespace testing;
+using namespace etl;
+using namespace data;
+
+static auto constexpr MIN_SEQ = 100;
+static auto constexpr MAX_SEQ = 200;
+
+struct BackfillTest : util::prometheus::WithPrometheus, MockBackendTest {
+    using BackfillType = etl::detail::Backfill<MockLedgerFetcher, MockLedgerLoader>;
+
+    SystemState state;
+    MockLedgerFetcher fetcher;
+    MockLedgerLoader loader;
+    MockBackend* rawBackendPtr = nullptr;
+
+    void
+    SetUp() override
+    {
+        MockBackendTest::SetUp();
+        rawBackendPtr = dynamic_cast<MockBackend*>(mockBackendPtr.get());
+        ASSERT_NE(rawBackendPtr, nullptr);
+
+        state.isWriting = true;
+        ON_CALL(*rawBackendPtr, hardFetchLedgerRange(_))
+            .WillByDefault(Return(LedgerRange{.minSequence = MIN_SEQ, .maxSequence = MAX_SEQ}));
+        ON_CALL(fetcher, fetchDataAndDiff).WillByDefault(Return(std::make_optional<FakeFetchResponse>()));
+        ON_CALL(loader, loadLedgerSnapshot).WillByDefault(Return(true));
+    }
+
+    BackfillType
+    makeBackfill(char const* config)
+    {
+        return BackfillType{util::Config{boost::json::parse(config)}, mockBackendPtr, fetcher, loader, state};
+    }
+};
+
+TEST_F(BackfillTest, InvalidConfig)
+{
+    EXPECT_THROW(makeBackfill(R"({"chunk_size": 0})"), std::runtime_error);
+    EXPECT_THROW(makeBackfill(R"({"pipelines": 0})"), std::runtime_error);
+    EXPECT_THROW(makeBackfill(R"({"max_write_load": 0})"), std::runtime_error);
+    EXPECT_THROW(makeBackfill(R"({"max_write_load": 1.5})"), std::runtime_error);
+}
+
+TEST_F(BackfillTest, DisabledWithoutStartSequenceOrWhenReadOnly)
+{
+    EXPECT_CALL(*rawBackendPtr, hardFetchLedgerRange).Times(0);
+    EXPECT_CALL(loader, loadLedgerSnapshot).Times(0);
+
+    makeBackfill("{}").waitTillFinished();
+
+    state.isReadOnly = true;
+    makeBackfill(R"({"start_sequence": 75})").waitTillFinished();
+}
+
+TEST_F(BackfillTest, OnlyTheWriterBackfills)
+{
+    state.isWriting = false;
+    EXPECT_CALL(*rawBackendPtr, hardFetchLedgerRange).Times(0);
+    EXPECT_CALL(loader, loadLedgerSnapshot).Times(0);
+
+    auto const backfill = makeBackfill(R"({"start_sequence": 80, "chunk_size": 10, "pipelines": 1})");
+    std::this_thread::sleep_for(std::chrono::milliseconds{20});
+}
+
+TEST_F(BackfillTest, StopsTakingChunksWhenNoLongerWriter)
+{
+    EXPECT_CALL(loader, loadLedgerSnapshot(90)).WillOnce([this](auto) {
+        state.isWriting = false;
+        return true;
+    });
+    EXPECT_CALL(loader, loadLedgerDiff).Times(0);
+    EXPECT_CALL(*rawBackendPtr, writeBackfilledChunk).Times(0);
+    EXPECT_CALL(*rawBackendPtr, doUpdateMinSequence).Times(0);
+    EXPECT_CALL(loader, loadLedgerSnapshot(80)).Times(0);
+
+    auto const backfill = makeBackfill(R"({"start_sequence": 80, "chunk_size": 10, "pipelines": 1})");
+    std::this_thread::sleep_for(std::chrono::milliseconds{20});
+}
+
+TEST_F(BackfillTest, NothingToBackfillAboveMinimum)
+{
+    EXPECT_CALL(*rawBackendPtr, fetchBackfilledChunks).Times(0);
+    EXPECT_CALL(loader, loadLedgerSnapshot).Times(0);
+
+    makeBackfill(R"({"start_sequence": 100})").waitTillFinished();
+}
+
+TEST_F(BackfillTest, BackfillsChunksFromTheTopAndExtendsRange)
+{
+    Sequence loaderSeq;
+    Sequence backendSeq;
+
+    // chunks are aligned to the chunk size: 90-99, 80-89 and the rest down to the start sequence, 75-79
+    EXPECT_CALL(loader, loadLedgerSnapshot(90)).InSequence(loaderSeq);
+    EXPECT_CALL(loader, loadLedgerDiff).Times(9).InSequence(loaderSeq);
+    EXPECT_CALL(loader, loadDeletions).InSequence(loaderSeq);
+    EXPECT_CALL(loader, loadLedgerSnapshot(80)).InSequence(loaderSeq);
+    EXPECT_CALL(loader, loadLedgerDiff).Times(9).InSequence(loaderSeq);
+    EXPECT_CALL(loader, loadLedgerSnapshot(75)).InSequence(loaderSeq);
+    EXPECT_CALL(loader, loadLedgerDiff).Times(4).InSequence(loaderSeq);
+
+    // only the ledger above the top chunk is fetched for its deletions
+    EXPECT_CALL(fetcher, fetchDataAndDiff(Lt(MIN_SEQ))).Times(22);
+    EXPECT_CALL(fetcher, fetchDataAndDiff(MIN_SEQ));
+
+    auto const chunk = [](std::uint32_t first, std::uint32_t last) {
+        return AllOf(Field(&LedgerRange::minSequence, first), Field(&LedgerRange::maxSequence, last));
+    };
+    EXPECT_CALL(*rawBackendPtr, writeBackfilledChunk(chunk(90, 99))).InSequence(backendSeq);
+    EXPECT_CALL(*rawBackendPtr, doUpdateMinSequence(MIN_SEQ, 90)).InSequence(backendSeq).WillOnce(Return(true));
+    EXPECT_CALL(*rawBackendPtr, writeBackfilledChunk(chunk(80, 89))).InSequence(backendSeq);
+    EXPECT_CALL(*rawBackendPtr, doUpdateMinSequence(90, 80)).InSequence(backendSeq).WillOnce(Return(true));
+    EXPECT_CALL(*rawBackendPtr, writeBackfilledChunk(chunk(75, 79))).InSequence(backendSeq);
+    EXPECT_CALL(*rawBackendPtr, doUpdateMinSequence(80, 75)).InSequence(backendSeq).WillOnce(Return(true));
+
+    makeBackfill(R"({"start_sequence": 75, "chunk_size": 10, "pipelines": 1})").waitTillFinished();
+}
+
+TEST_F(BackfillTest, SkipsRecordedChunks)
+{
+    EXPECT_CALL(*rawBackendPtr, fetchBackfilledChunks)
+        .WillOnce(Return(std::vector<LedgerRange>{{.minSequence = 90, .maxSequence = 99}}));
+
+    // the recorded chunk is contiguous with the range already
+    EXPECT_CALL(*rawBackendPtr, doUpdateMinSequence(MIN_SEQ, 90)).WillOnce(Return(true));
+    EXPECT_CALL(loader, loadLedgerSnapshot(90)).Times(0);
+    EXPECT_CALL(loader, loadDeletions).Times(0);
+
+    EXPECT_CALL(loader, loadLedgerSnapshot(80));
+    EXPECT_CALL(*rawBackendPtr, writeBackfilledChunk);
+    EXPECT_CALL(*rawBackendPtr, doUpdateMinSequence(90, 80)).WillOnce(Return(true));
+
+    makeBackfill(R"({"start_sequence": 80, "chunk_size": 10, "pipelines": 1})").waitTillFinished();
+}
+
+TEST_F(BackfillTest, ParallelPipelinesExtendRangeOnlyOverContiguousChunks)
+{
+    EXPECT_CALL(loader, loadLedgerSnapshot).Times(4);
+    EXPECT_CALL(*rawBackendPtr, writeBackfilledChunk).Times(4);
+
+    // each pipeline waits only for the writes of its own chunks
+    EXPECT_CALL(*rawBackendPtr, isolateThreadWrites).Times(3);
+
+    // the range is extended in any number of steps but always ends at the start sequence
+    EXPECT_CALL(*rawBackendPtr, doUpdateMinSequence(_, _)).WillRepeatedly([](auto oldMin, auto newMin) {
+        EXPECT_GT(oldMin, newMin);
+        EXPECT_EQ(newMin % 10, 0);
+        return true;
+    });
+    EXPECT_CALL(*rawBackendPtr, doUpdateMinSequence(_, 60)).WillOnce(Return(true));
+
+    makeBackfill(R"({"start_sequence": 60, "chunk_size": 10, "pipelines": 3})").waitTillFinished();
+}
+
+TEST_F(BackfillTest, StopsWhenMinimumChangedConcurrently)
+{
+    EXPECT_CALL(loader, loadLedgerSnapshot(90));
+    EXPECT_CALL(*rawBackendPtr, writeBackfilledChunk);
+    EXPECT_CALL(*rawBackendPtr, doUpdateMinSequence(MIN_SEQ, 90)).WillOnce(Return(false));
+    EXPECT_CALL(loader, loadLedgerSnapshot(80)).Times(0);
+
+    makeBackfill(R"({"start_sequence": 80, "chunk_size": 10, "pipelines": 1})").waitTillFinished();
+}
+
+TEST_F(BackfillTest, StopsWhenLedgerCannotBeLoaded)
+{
+    EXPECT_CALL(loader, loadLedgerSnapshot(90));
+    EXPECT_CALL(loader, loadLedgerDiff).WillOnce(Throw(std::runtime_error{"no object neighbors"}));
+    EXPECT_CALL(*rawBackendPtr, writeBackfilledChunk).Times(0);
+    EXPECT_CALL(*rawBackendPtr, doUpdateMinSequence).Times(0);
+    EXPECT_CALL(loader, loadLedgerSnapshot(80)).Times(0);
+
+    makeBackfill(R"({"start_sequence": 80, "chunk_size": 10, "pipelines": 1})").waitTillFinished();
+}
@@ -19,7 +19,9 @@
 
 #include "etl/impl/ExtractionDataPipe.h"
 #include "util/Fixtures.h"
+#include "util/MockPrometheus.h"
 
+#include <gmock/gmock.h>
 #include <gtest/gtest.h>
 
 #include <atomic>
@@ -28,10 +30,12 @@
 #include <cstdint>
 #include <thread>
 
+using namespace util::prometheus;
+
 constexpr static auto STRIDE = 4;
 constexpr static auto START_SEQ = 1234;
 
-class ETLExtractionDataPipeTest : public NoLoggerFixture {
+class ETLExtractionDataPipeTest : public WithPrometheus, public NoLoggerFixture {
 protected:
     etl::detail::ExtractionDataPipe<uint32_t> pipe_{STRIDE, START_SEQ};
 };
@@ -67,7 +71,7 @@ TEST_F(ETLExtractionDataPipeTest, CallingCleanupUnblocksOtherThread)
 {
     std::atomic_bool unblocked = false;
     auto bgThread = std::thread([this, &unblocked] {
-        for (std::size_t i = 0; i < 252; ++i)
+        for (std::size_t i = 0; i < 251; ++i)
             pipe_.push(START_SEQ, 1234);  // 251st element will block this thread here
         unblocked = true;
     });
@@ -81,3 +85,59 @@ TEST_F(ETLExtractionDataPipeTest, CallingCleanupUnblocksOtherThread)
     bgThread.join();
     EXPECT_TRUE(unblocked);
 }
+
+TEST_F(ETLExtractionDataPipeTest, QueueDepthIsConfigurable)
+{
+    etl::detail::ExtractionDataPipe<uint32_t> pipe{STRIDE, START_SEQ, 2};
+
+    std::atomic_bool unblocked = false;
+    auto bgThread = std::thread([&pipe, &unblocked] {
+        for (std::size_t i = 0; i < 3; ++i)
+            pipe.push(START_SEQ, 1234);  // 3rd element will block this thread here
+        unblocked = true;
+    });
+
+    std::this_thread::sleep_for(std::chrono::milliseconds{100});
+
+    EXPECT_FALSE(unblocked);
+    EXPECT_EQ(pipe.popNext(START_SEQ).value(), 1234);
+
+    bgThread.join();
+    EXPECT_TRUE(unblocked);
+}
+
+TEST_F(ETLExtractionDataPipeTest, ConcurrentProducerAndConsumerKeepOrder)
+{
+    static constexpr auto COUNT = 10000u;
+    etl::detail::ExtractionDataPipe<uint32_t> pipe{1, START_SEQ, 8};
+
+    auto producer = std::thread([&pipe] {
+        for (auto i = 0u; i < COUNT; ++i)
+            pipe.push(START_SEQ + i, START_SEQ + i);
+        pipe.finish(START_SEQ + COUNT);
+    });
+
+    for (auto i = 0u; i < COUNT; ++i)
+        EXPECT_EQ(pipe.popNext(START_SEQ + i).value(), START_SEQ + i);
+    EXPECT_FALSE(pipe.popNext(START_SEQ + COUNT).has_value());
+
+    producer.join();
+}
+
+struct ETLExtractionDataPipeMockPrometheusTest : WithMockPrometheus, NoLoggerFixture {};
+
+TEST_F(ETLExtractionDataPipeMockPrometheusTest, QueueSizeIsReported)
+{
+    auto& firstQueueSizeMock = makeMock<GaugeInt>("etl_extraction_queue_size", "{queue=\"0\"}");
+    auto& secondQueueSizeMock = makeMock<GaugeInt>("etl_extraction_queue_size", "{queue=\"1\"}");
+
+    EXPECT_CALL(firstQueueSizeMock, set(0));
+    EXPECT_CALL(secondQueueSizeMock, set(0));
+    etl::detail::ExtractionDataPipe<uint32_t> pipe{2, START_SEQ};
+
+    EXPECT_CALL(secondQueueSizeMock, add(1));
+    pipe.push(START_SEQ + 1, START_SEQ + 1);
+
+    EXPECT_CALL(secondQueueSizeMock, add(-1));
+    EXPECT_EQ(pipe.popNext(START_SEQ + 1).value(), START_SEQ + 1);
+}
@@ -28,12 +28,30 @@
 #include <gmock/gmock.h>
 #include <gtest/gtest.h>
 
+#include <condition_variable>
+#include <cstdint>
+#include <future>
+#include <map>
 #include <memory>
+#include <mutex>
 #include <optional>
+#include <vector>
 
 using namespace testing;
 using namespace etl;
 
+namespace {
+
+std::future<std::optional<FakeFetchResponse>>
+makeReadyFuture(std::optional<FakeFetchResponse> response)
+{
+    std::promise<std::optional<FakeFetchResponse>> promise;
+    promise.set_value(std::move(response));
+    return promise.get_future();
+}
+
+}  // namespace
+
 class ETLExtractorTest : public NoLoggerFixture {
 protected:
     using ExtractionDataPipeType = MockExtractionDataPipe;
@@ -166,3 +184,85 @@ TEST_F(ETLExtractorTest, CallsPipeFinishWithInitialSequenceAtExit)
 
     extractor_ = std::make_unique<ExtractorType>(dataPipe_, networkValidatedLedgers_, ledgerFetcher_, 123, 234, state_);
 }
+
+TEST_F(ETLExtractorTest, PipelinedKeepsLedgersInFlightAndPushesThemInOrder)
+{
+    static constexpr auto FETCHES_IN_FLIGHT = 3;
+    auto const rawNetworkValidatedLedgersPtr = networkValidatedLedgers_.get();
+
+    ON_CALL(*rawNetworkValidatedLedgersPtr, waitUntilValidatedByNetwork).WillByDefault(Return(true));
+    ON_CALL(*rawNetworkValidatedLedgersPtr, tryGetMostRecent).WillByDefault(Return(10));
+    ON_CALL(dataPipe_, getStride).WillByDefault(Return(1));
+
+    std::mutex mtx;
+    std::condition_variable cv;
+    std::map<uint32_t, std::promise<std::optional<FakeFetchResponse>>> pending;
+
+    EXPECT_CALL(ledgerFetcher_, fetchDataAndDiffAsync).Times(FETCHES_IN_FLIGHT).WillRepeatedly([&](uint32_t seq) {
+        std::scoped_lock const lck{mtx};
+        auto future = pending[seq].get_future();
+        cv.notify_all();
+        return future;
+    });
+
+    std::vector<uint32_t> pushed;
+    EXPECT_CALL(dataPipe_, push)
+        .Times(FETCHES_IN_FLIGHT)
+        .WillRepeatedly([&pushed](uint32_t seq, std::optional<FakeFetchResponse>&& response) {
+            ASSERT_TRUE(response.has_value());
+            EXPECT_EQ(response->id, seq);
+            pushed.push_back(seq);
+        });
+    EXPECT_CALL(dataPipe_, finish(0));
+
+    extractor_ = std::make_unique<ExtractorType>(
+        dataPipe_, networkValidatedLedgers_, ledgerFetcher_, 0, FETCHES_IN_FLIGHT - 1, state_, FETCHES_IN_FLIGHT
+    );
+
+    {
+        // all ledgers are requested before the first one arrives; they arrive in reverse
+        std::unique_lock lck{mtx};
+        cv.wait(lck, [&pending]() { return pending.size() == FETCHES_IN_FLIGHT; });
+        for (auto it = pending.rbegin(); it != pending.rend(); ++it)
+            it->second.set_value(FakeFetchResponse{it->first});
+    }
+
+    extractor_->waitTillFinished();
+    EXPECT_THAT(pushed, ElementsAre(0, 1, 2));
+}
+
+TEST_F(ETLExtractorTest, PipelinedOnlyFetchesAheadLedgersValidatedByNetwork)
+{
+    auto const rawNetworkValidatedLedgersPtr = networkValidatedLedgers_.get();
+
+    EXPECT_CALL(*rawNetworkValidatedLedgersPtr, waitUntilValidatedByNetwork(0)).WillOnce(Return(true));
+    EXPECT_CALL(*rawNetworkValidatedLedgersPtr, waitUntilValidatedByNetwork(2)).WillOnce(Return(false));
+    ON_CALL(*rawNetworkValidatedLedgersPtr, tryGetMostRecent).WillByDefault(Return(1));
+    ON_CALL(dataPipe_, getStride).WillByDefault(Return(1));
+
+    EXPECT_CALL(ledgerFetcher_, fetchDataAndDiffAsync(0))
+        .WillOnce(Return(ByMove(makeReadyFuture(FakeFetchResponse{0}))));
+    EXPECT_CALL(ledgerFetcher_, fetchDataAndDiffAsync(1))
+        .WillOnce(Return(ByMove(makeReadyFuture(FakeFetchResponse{1}))));
+    EXPECT_CALL(dataPipe_, push).Times(2);
+    EXPECT_CALL(dataPipe_, finish(0));
+
+    extractor_ = std::make_unique<ExtractorType>(dataPipe_, networkValidatedLedgers_, ledgerFetcher_, 0, 64, state_, 4);
+    extractor_->waitTillFinished();
+}
+
+TEST_F(ETLExtractorTest, PipelinedStopsIfFetchIsUnsuccessful)
+{
+    auto const rawNetworkValidatedLedgersPtr = networkValidatedLedgers_.get();
+
+    ON_CALL(*rawNetworkValidatedLedgersPtr, waitUntilValidatedByNetwork).WillByDefault(Return(true));
+    ON_CALL(*rawNetworkValidatedLedgersPtr, tryGetMostRecent).WillByDefault(Return(0));
+    ON_CALL(dataPipe_, getStride).WillByDefault(Return(1));
+
+    EXPECT_CALL(ledgerFetcher_, fetchDataAndDiffAsync(0)).WillOnce(Return(ByMove(makeReadyFuture(std::nullopt))));
+    EXPECT_CALL(dataPipe_, push).Times(0);
+    EXPECT_CALL(dataPipe_, finish(0));
+
+    extractor_ = std::make_unique<ExtractorType>(dataPipe_, networkValidatedLedgers_, ledgerFetcher_, 0, 64, state_, 4);
+    extractor_->waitTillFinished();
+}
@@ -0,0 +1,159 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of clio: https://github.com/XRPLF/clio
+    Copyright (c) 2023, the clio developers.
+
+    Permission to use, copy, modify, and distribute this software for any
+    purpose with or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL,  DIRECT,  INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include "etl/impl/ForwardCache.h"
+#include "util/Fixtures.h"
+#include "util/MockPrometheus.h"
+#include "util/MockSource.h"
+#include "util/config/Config.h"
+
+#include <boost/json/object.hpp>
+#include <boost/json/parse.hpp>
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <optional>
+#include <stdexcept>
+
+using namespace testing;
+using namespace etl::detail;
+using namespace util::prometheus;
+
+namespace {
+
+constexpr auto CONFIG = R"({
+    "ip": "127.0.0.1",
+    "ws_port": "6005",
+    "cache": ["fee"],
+    "cache_timers": [{"command": "server_info", "max_age": 2}]
+})";
+
+boost::json::object const FEE_REQUEST = {{"command", "fee"}};
+boost::json::object const SERVER_INFO_REQUEST = {{"command", "server_info"}};
+boost::json::object const RESPONSE = {{"result", {{"status", "success"}}}};
+
+}  // namespace
+
+struct ForwardCacheTest : WithPrometheus, SyncAsioContextTest {
+    StrictMock<MockSource> source;
+    ForwardCache cache{util::Config{boost::json::parse(CONFIG)}, ctx, source};
+
+    ~ForwardCacheTest() override
+    {
+        cache.stop();
+        ctx.run();
+    }
+};
+
+TEST_F(ForwardCacheTest, InvalidConfig)
+{
+    auto const makeCache = [this](char const* config) {
+        ForwardCache{util::Config{boost::json::parse(config)}, ctx, source};
+    };
+
+    EXPECT_THROW(makeCache(R"({"cache": "fee"})"), std::runtime_error);
+    EXPECT_THROW(makeCache(R"({"cache_timers": [{"command": "fee"}]})"), std::runtime_error);
+    EXPECT_THROW(makeCache(R"({"cache_timers": [{"command": "fee", "max_age": 0}]})"), std::runtime_error);
+}
+
+TEST_F(ForwardCacheTest, EmptyUntilRefreshed)
+{
+    EXPECT_FALSE(cache.get(FEE_REQUEST));
+    EXPECT_FALSE(cache.get(SERVER_INFO_REQUEST));
+    EXPECT_FALSE(cache.get({{"command", "account_info"}}));
+}
+
+TEST_F(ForwardCacheTest, RefreshesOnLedgerClose)
+{
+    EXPECT_CALL(source, requestFromRippled(FEE_REQUEST, Eq(std::nullopt), _)).WillOnce(Return(RESPONSE));
+
+    cache.onLedgerClosed();
+    ctx.run();
+
+    EXPECT_EQ(cache.get(FEE_REQUEST), RESPONSE);
+    EXPECT_EQ(cache.get({{"method", "fee"}}), RESPONSE);
+
+    // requests for a specific ledger are not served from the cache
+    EXPECT_FALSE(cache.get({{"command", "fee"}, {"ledger_index", "current"}}));
+}
+
+TEST_F(ForwardCacheTest, CoalescesConcurrentRefreshes)
+{
+    EXPECT_CALL(source, requestFromRippled(FEE_REQUEST, _, _)).WillOnce(Return(RESPONSE));
+
+    cache.onLedgerClosed();
+    cache.onLedgerClosed();
+    cache.onLedgerClosed();
+    ctx.run();
+
+    EXPECT_EQ(cache.get(FEE_REQUEST), RESPONSE);
+}
+
+TEST_F(ForwardCacheTest, ErrorsAreNotCached)
+{
+    EXPECT_CALL(source, requestFromRippled(FEE_REQUEST, _, _))
+        .WillOnce(Return(RESPONSE))
+        .WillOnce(Return(boost::json::object{{"error", "tooBusy"}}));
+
+    cache.onLedgerClosed();
+    ctx.run();
+    ctx.restart();
+    EXPECT_EQ(cache.get(FEE_REQUEST), RESPONSE);
+
+    cache.onLedgerClosed();
+    ctx.run();
+    EXPECT_FALSE(cache.get(FEE_REQUEST));
+}
+
+TEST_F(ForwardCacheTest, RefreshesOnTimerFromStart)
+{
+    EXPECT_CALL(source, requestFromRippled(SERVER_INFO_REQUEST, _, _)).WillOnce(Return(RESPONSE));
+
+    cache.start();
+    ctx.poll();
+
+    EXPECT_EQ(cache.get(SERVER_INFO_REQUEST), RESPONSE);
+}
+
+struct ForwardCacheMetricsTest : WithMockPrometheus, SyncAsioContextTest {
+    StrictMock<MockSource> source;
+};
+
+TEST_F(ForwardCacheMetricsTest, CountsHitsMissesAndRefreshes)
+{
+    auto const labels = [](char const* status) {
+        return std::string{"{source=\"127.0.0.1:6005\",command=\"fee\",status=\""} + status + "\"}";
+    };
+    auto& hitsMock = makeMock<CounterInt>("etl_forward_cache_total_number", labels("hit"));
+    auto& missesMock = makeMock<CounterInt>("etl_forward_cache_total_number", labels("miss"));
+    auto& refreshesMock = makeMock<CounterInt>("etl_forward_cache_total_number", labels("refresh"));
+
+    ForwardCache cache{util::Config{boost::json::parse(CONFIG)}, ctx, source};
+    EXPECT_CALL(source, requestFromRippled(FEE_REQUEST, _, _)).WillOnce(Return(RESPONSE));
+
+    EXPECT_CALL(missesMock, add(1));
+    EXPECT_FALSE(cache.get(FEE_REQUEST));
+
+    EXPECT_CALL(refreshesMock, add(1));
+    cache.onLedgerClosed();
+    ctx.run();
+
+    EXPECT_CALL(hitsMock, add(1));
+    EXPECT_TRUE(cache.get(FEE_REQUEST));
+}
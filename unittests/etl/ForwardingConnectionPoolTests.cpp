@@ -0,0 +1,181 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of clio: https://github.com/XRPLF/clio
+    Copyright (c) 2023, the clio developers.
+
+    Permission to use, copy, modify, and distribute this software for any
+    purpose with or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL,  DIRECT,  INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include "etl/impl/ForwardingConnectionPool.h"
+#include "util/Fixtures.h"
+
+#include <boost/asio/buffer.hpp>
+#include <boost/asio/io_context.hpp>
+#include <boost/asio/ip/address.hpp>
+#include <boost/asio/ip/tcp.hpp>
+#include <boost/asio/spawn.hpp>
+#include <boost/beast/core/buffers_to_string.hpp>
+#include <boost/beast/core/error.hpp>
+#include <boost/beast/core/flat_buffer.hpp>
+#include <boost/beast/http/field.hpp>
+#include <boost/beast/http/message.hpp>
+#include <boost/beast/http/read.hpp>
+#include <boost/beast/http/string_body.hpp>
+#include <boost/beast/websocket/stream.hpp>
+#include <boost/json/object.hpp>
+#include <boost/json/parse.hpp>
+#include <boost/json/serialize.hpp>
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <cstddef>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+
+using namespace testing;
+using namespace etl::detail;
+
+namespace {
+
+/**
+ * @brief A rippled that answers each request with its command, in reverse order of a batch of requests.
+ */
+struct FakeRippled {
+    boost::asio::ip::tcp::acceptor acceptor;
+    std::vector<std::string> forwardedFor;
+
+    explicit FakeRippled(boost::asio::io_context& ctx)
+        : acceptor{ctx, boost::asio::ip::tcp::endpoint{boost::asio::ip::make_address("127.0.0.1"), 0}}
+    {
+    }
+
+    std::string
+    port() const
+    {
+        return std::to_string(acceptor.local_endpoint().port());
+    }
+
+    void
+    serve(boost::asio::yield_context yield, std::size_t batchSize)
+    {
+        namespace http = boost::beast::http;
+
+        boost::beast::error_code ec;
+        auto socket = acceptor.async_accept(yield[ec]);
+        if (ec)
+            return;
+
+        boost::beast::flat_buffer buffer;
+        http::request<http::string_body> handshake;
+        http::async_read(socket, buffer, handshake, yield[ec]);
+        if (ec)
+            return;
+
+        forwardedFor.emplace_back(handshake[http::field::forwarded]);
+
+        boost::beast::websocket::stream<boost::asio::ip::tcp::socket> ws{std::move(socket)};
+        ws.async_accept(handshake, yield[ec]);
+
+        std::vector<boost::json::object> batch;
+        while (!ec) {
+            boost::beast::flat_buffer message;
+            ws.async_read(message, yield[ec]);
+            if (ec)
+                return;
+
+            batch.push_back(boost::json::parse(boost::beast::buffers_to_string(message.data())).as_object());
+            if (batch.size() < batchSize)
+                continue;
+
+            for (auto it = batch.rbegin(); it != batch.rend() && !ec; ++it) {
+                boost::json::object const response{{"id", it->at("id")}, {"result", {{"command", it->at("command")}}}};
+                ws.async_write(boost::asio::buffer(boost::json::serialize(response)), yield[ec]);
+            }
+            batch.clear();
+        }
+    }
+};
+
+}  // namespace
+
+struct ForwardingConnectionPoolTest : SyncAsioContextTest {
+    FakeRippled rippled{ctx};
+    std::optional<ForwardingConnectionPool> pool;
+
+    ForwardingConnectionPoolTest()
+    {
+        pool.emplace(ctx, "127.0.0.1", rippled.port());
+    }
+};
+
+TEST_F(ForwardingConnectionPoolTest, MultiplexesRequestsOverOneConnection)
+{
+    boost::asio::spawn(ctx, [this](boost::asio::yield_context yield) { rippled.serve(yield, 2); });
+
+    std::optional<boost::json::object> fee;
+    std::optional<boost::json::object> ledgerCurrent;
+    auto outstanding = 2;
+
+    auto const send = [&](char const* request, std::optional<boost::json::object>& response) {
+        boost::asio::spawn(ctx, [&, request](boost::asio::yield_context yield) {
+            response = pool->request(boost::json::parse(request).as_object(), std::nullopt, yield);
+            if (--outstanding == 0)
+                pool.reset();
+        });
+    };
+    send(R"({"command": "fee", "id": "client id"})", fee);
+    send(R"({"command": "ledger_current"})", ledgerCurrent);
+    ctx.run();
+
+    // rippled answers in reverse order, and the ids rippled sees are replaced by the ones of the clients
+    EXPECT_EQ(fee, boost::json::parse(R"({"id": "client id", "result": {"command": "fee"}})").as_object());
+    EXPECT_EQ(ledgerCurrent, boost::json::parse(R"({"result": {"command": "ledger_current"}})").as_object());
+    EXPECT_THAT(rippled.forwardedFor, ElementsAre(""));
+}
+
+TEST_F(ForwardingConnectionPoolTest, OneConnectionPerClientIp)
+{
+    for (auto i = 0; i < 2; ++i)
+        boost::asio::spawn(ctx, [this](boost::asio::yield_context yield) { rippled.serve(yield, 1); });
+
+    boost::asio::spawn(ctx, [this](boost::asio::yield_context yield) {
+        boost::json::object const request{{"command", "fee"}};
+        EXPECT_TRUE(pool->request(request, "1.2.3.4", yield));
+        EXPECT_TRUE(pool->request(request, std::nullopt, yield));
+        EXPECT_TRUE(pool->request(request, "1.2.3.4", yield));
+        EXPECT_EQ(pool->size(), 2u);
+        pool.reset();
+    });
+    ctx.run();
+
+    EXPECT_THAT(rippled.forwardedFor, UnorderedElementsAre("for=1.2.3.4", ""));
+}
+
+TEST_F(ForwardingConnectionPoolTest, FailsWhenRippledIsDown)
+{
+    rippled.acceptor.close();
+
+    boost::asio::spawn(ctx, [this](boost::asio::yield_context yield) {
+        boost::json::object const request{{"command", "fee"}};
+        EXPECT_FALSE(pool->request(request, std::nullopt, yield));
+
+        // the failed connection is dropped and the pool backs off instead of connecting again
+        EXPECT_FALSE(pool->request(request, std::nullopt, yield));
+        EXPECT_EQ(pool->size(), 0u);
+        pool.reset();
+    });
+    ctx.run();
+}
@@ -0,0 +1,209 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of clio: https://github.com/XRPLF/clio
+    Copyright (c) 2023, the clio developers.
+
+    Permission to use, copy, modify, and distribute this software for any
+    purpose with or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL,  DIRECT,  INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include "data/DBHelpers.h"
+#include "data/Types.h"
+#include "etl/HistoryPruner.h"
+#include "etl/SystemState.h"
+#include "util/Fixtures.h"
+#include "util/MockBackend.h"
+#include "util/MockPrometheus.h"
+#include "util/TestObject.h"
+#include "util/config/Config.h"
+
+#include <boost/json/parse.hpp>
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include <ripple/basics/base_uint.h>
+#include <ripple/protocol/TxFormats.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+using namespace testing;
+using namespace etl;
+using namespace data;
+
+static auto constexpr ACCOUNT = "rf1BiGeXwwQoi8Z2ueFYTEXSwuJYfV2Jpn";
+static auto constexpr LEDGERHASH = "4BC50C9B0D8515D3EAAE1E74B29A95804346C491EE1A95BF25E4AAB854A6A652";
+static auto constexpr TXNHASH = "05FB0EB4B899F056FA095537C5817163801F544BAFCEA39C995D76DB4D16F9DD";
+static auto constexpr ACCOUNT2 = "rLEsXccBGNR3UPuPu2hUXPjziKC3qKSBun";
+static auto constexpr KEY1 = "1B8590C01B0006EDFA9ED60296DD052DC5E90F99659B25014D08E1BC983515BC";
+static auto constexpr KEY2 = "1B8590C01B0006EDFA9ED60296DD052DC5E90F99659B25014D08E1BC983515BD";
+static auto constexpr MIN_SEQ = 30;
+
+struct HistoryPrunerTest : util::prometheus::WithPrometheus, MockBackendTest {
+    SystemState state;
+    MockBackend* rawBackendPtr = nullptr;
+
+    void
+    SetUp() override
+    {
+        MockBackendTest::SetUp();
+        rawBackendPtr = dynamic_cast<MockBackend*>(mockBackendPtr.get());
+        ASSERT_NE(rawBackendPtr, nullptr);
+    }
+
+    HistoryPruner
+    makePruner(char const* config = "{}")
+    {
+        return HistoryPruner{util::Config{boost::json::parse(config)}, mockBackendPtr, state};
+    }
+};
+
+TEST_F(HistoryPrunerTest, InvalidConfig)
+{
+    EXPECT_THROW(makePruner(R"({"ledgers_per_batch": 0})"), std::runtime_error);
+    EXPECT_THROW(makePruner(R"({"max_write_load": 0})"), std::runtime_error);
+    EXPECT_THROW(makePruner(R"({"max_write_load": 1.5})"), std::runtime_error);
+    EXPECT_THROW(makePruner(R"({"retain_ledgers": 0})"), std::runtime_error);
+}
+
+TEST_F(HistoryPrunerTest, RequestRejectedWhenReadOnly)
+{
+    state.isReadOnly = true;
+    auto pruner = makePruner();
+    EXPECT_FALSE(pruner.request(MIN_SEQ + 10));
+    EXPECT_FALSE(pruner.getInfo().contains("requested_min_ledger"));
+}
+
+TEST_F(HistoryPrunerTest, RequestAccepted)
+{
+    auto pruner = makePruner(R"({"retain_ledgers": 1000})");
+    EXPECT_TRUE(pruner.request(MIN_SEQ + 10));
+
+    auto const info = pruner.getInfo();
+    EXPECT_EQ(info.at("requested_min_ledger").as_uint64(), MIN_SEQ + 10);
+    EXPECT_EQ(info.at("retain_ledgers").as_uint64(), 1000);
+    EXPECT_EQ(info.at("pruned_ledgers").as_uint64(), 0);
+}
+
+TEST_F(HistoryPrunerTest, PruneBatch)
+{
+    TransactionAndMetadata tx;
+    tx.transaction = CreatePaymentTransactionObject(ACCOUNT, ACCOUNT2, 2, 3, 300).getSerializer().peekData();
+    tx.metadata = CreatePaymentTransactionMetaObject(ACCOUNT, ACCOUNT2, 110, 30).getSerializer().peekData();
+    tx.ledgerSequence = MIN_SEQ;
+    auto const txHash = ripple::uint256{TXNHASH};
+
+    EXPECT_CALL(*rawBackendPtr, fetchLedgerBySequence(MIN_SEQ, _))
+        .WillOnce(Return(CreateLedgerInfo(LEDGERHASH, MIN_SEQ)));
+    EXPECT_CALL(*rawBackendPtr, fetchAllTransactionHashesInLedger(MIN_SEQ, _))
+        .WillOnce(Return(std::vector<ripple::uint256>{txHash}));
+    EXPECT_CALL(*rawBackendPtr, fetchTransactions(std::vector<ripple::uint256>{txHash}, _))
+        .WillOnce(Return(std::vector<TransactionAndMetadata>{tx}));
+    EXPECT_CALL(*rawBackendPtr, fetchLedgerDiff(MIN_SEQ, _))
+        .WillOnce(Return(std::vector<LedgerObject>{
+            {.key = ripple::uint256{KEY1}, .blob = Blob{'s'}}, {.key = ripple::uint256{KEY2}, .blob = {}}
+        }));
+    EXPECT_CALL(*rawBackendPtr, hardFetchLedgerRange(_))
+        .WillOnce(Return(LedgerRange{.minSequence = MIN_SEQ, .maxSequence = MIN_SEQ + 10}));
+
+    // rows are deleted before the range is advanced, so an interrupted batch leaves nothing behind for good
+    Sequence seq;
+    EXPECT_CALL(*rawBackendPtr, deleteHistory)
+        .InSequence(seq)
+        .WillOnce([&](PrunedHistory const& history, std::size_t chunkSize, auto const&) {
+            EXPECT_EQ(chunkSize, HistoryPruner::DELETES_PER_CHUNK);
+            EXPECT_EQ(history.minSequence, MIN_SEQ + 1);
+            EXPECT_EQ(history.ledgerSequences, std::vector<std::uint32_t>{MIN_SEQ});
+            EXPECT_EQ(history.ledgerHashes, std::vector<ripple::uint256>{ripple::uint256{LEDGERHASH}});
+            ASSERT_EQ(history.transactions.size(), 1);
+            EXPECT_EQ(history.transactions[0].first, MIN_SEQ);
+            EXPECT_EQ(history.transactions[0].second, std::vector<ripple::uint256>{txHash});
+
+            // modified object keeps its latest version, deleted object goes entirely
+            using Bounds = std::vector<std::pair<ripple::uint256, std::uint32_t>>;
+            EXPECT_EQ(
+                history.objects, (Bounds{{ripple::uint256{KEY1}, MIN_SEQ}, {ripple::uint256{KEY2}, MIN_SEQ + 1}})
+            );
+            EXPECT_EQ(history.successors, (Bounds{{ripple::uint256{KEY2}, MIN_SEQ + 1}}));
+            EXPECT_TRUE(history.nfts.empty());
+            EXPECT_TRUE(history.nftTokenIDs.empty());
+            for (auto const* account : {ACCOUNT, ACCOUNT2}) {
+                EXPECT_NE(
+                    std::find(history.accounts.begin(), history.accounts.end(), GetAccountIDWithString(account)),
+                    history.accounts.end()
+                );
+                auto const accountTxType = std::make_pair(GetAccountIDWithString(account), ripple::ttPAYMENT);
+                EXPECT_NE(
+                    std::find(history.accountTxTypes.begin(), history.accountTxTypes.end(), accountTxType),
+                    history.accountTxTypes.end()
+                );
+            }
+        });
+    EXPECT_CALL(*rawBackendPtr, doUpdateMinSequence(MIN_SEQ, MIN_SEQ + 1)).InSequence(seq).WillOnce(Return(true));
+
+    auto pruner = makePruner();
+    EXPECT_TRUE(pruner.pruneBatch(MIN_SEQ, MIN_SEQ + 1));
+    EXPECT_EQ(pruner.getInfo().at("pruned_ledgers").as_uint64(), 1);
+}
+
+TEST_F(HistoryPrunerTest, PruneBatchNothingDeletedOnConflict)
+{
+    EXPECT_CALL(*rawBackendPtr, hardFetchLedgerRange(_))
+        .WillOnce(Return(LedgerRange{.minSequence = MIN_SEQ + 1, .maxSequence = MIN_SEQ + 10}));
+    EXPECT_CALL(*rawBackendPtr, fetchLedgerDiff).Times(0);
+    EXPECT_CALL(*rawBackendPtr, deleteHistory).Times(0);
+    EXPECT_CALL(*rawBackendPtr, doUpdateMinSequence).Times(0);
+
+    auto pruner = makePruner();
+    EXPECT_FALSE(pruner.pruneBatch(MIN_SEQ, MIN_SEQ + 2));
+    EXPECT_EQ(pruner.getInfo().at("pruned_ledgers").as_uint64(), 0);
+}
+
+TEST_F(HistoryPrunerTest, PruneBatchWaitsForWriteCapacityBetweenChunks)
+{
+    EXPECT_CALL(*rawBackendPtr, hardFetchLedgerRange(_))
+        .WillOnce(Return(LedgerRange{.minSequence = MIN_SEQ, .maxSequence = MIN_SEQ + 10}));
+    EXPECT_CALL(*rawBackendPtr, fetchLedgerBySequence).WillOnce(Return(std::nullopt));
+    EXPECT_CALL(*rawBackendPtr, fetchAllTransactionHashesInLedger);
+    EXPECT_CALL(*rawBackendPtr, fetchTransactions);
+    EXPECT_CALL(*rawBackendPtr, fetchLedgerDiff);
+
+    // the next chunk is only issued once the write load dropped below max_write_load
+    EXPECT_CALL(*rawBackendPtr, writeLoad).WillOnce(Return(0.9)).WillOnce(Return(0.1));
+    EXPECT_CALL(*rawBackendPtr, deleteHistory).WillOnce([](auto const&, auto, std::function<void()> const& wait) {
+        wait();
+    });
+    EXPECT_CALL(*rawBackendPtr, doUpdateMinSequence(MIN_SEQ, MIN_SEQ + 1)).WillOnce(Return(true));
+
+    auto pruner = makePruner(R"({"max_write_load": 0.5})");
+    EXPECT_TRUE(pruner.pruneBatch(MIN_SEQ, MIN_SEQ + 1));
+}
+
+TEST_F(HistoryPrunerTest, PruneBatchFailsWhenMinimumMovedWhileDeleting)
+{
+    EXPECT_CALL(*rawBackendPtr, hardFetchLedgerRange(_))
+        .WillOnce(Return(LedgerRange{.minSequence = MIN_SEQ, .maxSequence = MIN_SEQ + 10}));
+    EXPECT_CALL(*rawBackendPtr, fetchLedgerBySequence).WillOnce(Return(std::nullopt));
+    EXPECT_CALL(*rawBackendPtr, fetchAllTransactionHashesInLedger);
+    EXPECT_CALL(*rawBackendPtr, fetchTransactions);
+    EXPECT_CALL(*rawBackendPtr, fetchLedgerDiff);
+    EXPECT_CALL(*rawBackendPtr, deleteHistory);
+    EXPECT_CALL(*rawBackendPtr, doUpdateMinSequence(MIN_SEQ, MIN_SEQ + 1)).WillOnce(Return(false));
+
+    auto pruner = makePruner();
+    EXPECT_FALSE(pruner.pruneBatch(MIN_SEQ, MIN_SEQ + 1));
+    EXPECT_EQ(pruner.getInfo().at("pruned_ledgers").as_uint64(), 0);
+}
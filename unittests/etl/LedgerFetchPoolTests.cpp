@@ -0,0 +1,257 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of clio: https://github.com/XRPLF/clio
+    Copyright (c) 2023, the clio developers.
+
+    Permission to use, copy, modify, and distribute this software for any
+    purpose with or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL,  DIRECT,  INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include "etl/impl/AsyncData.h"
+#include "etl/impl/LedgerFetchPool.h"
+#include "etl/impl/SourceScore.h"
+#include "util/MockPrometheus.h"
+#include "util/MockSource.h"
+
+#include <gmock/gmock.h>
+#include <grpcpp/grpcpp.h>
+#include <gtest/gtest.h>
+#include <ripple/proto/org/xrpl/rpc/v1/xrp_ledger.grpc.pb.h>
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <vector>
+
+using namespace testing;
+using namespace etl::detail;
+
+namespace {
+
+/**
+ * @brief The gRPC service of a rippled that returns the requested ledger, optionally failing the first calls.
+ *
+ * The calls can be held to keep them in flight.
+ */
+class FakeLedgerService : public org::xrpl::rpc::v1::XRPLedgerAPIService::Service {
+    std::mutex mtx_;
+    std::condition_variable cv_;
+    bool isHeld_ = false;
+    std::size_t failures_ = 0;
+    std::size_t running_ = 0;
+    std::size_t maxRunning_ = 0;
+    std::vector<std::uint32_t> requested_;
+
+public:
+    grpc::Status
+    GetLedger(
+        grpc::ServerContext*,
+        org::xrpl::rpc::v1::GetLedgerRequest const* request,
+        org::xrpl::rpc::v1::GetLedgerResponse* response
+    ) override
+    {
+        std::unique_lock lck{mtx_};
+        requested_.push_back(request->ledger().sequence());
+        maxRunning_ = std::max(maxRunning_, ++running_);
+        cv_.notify_all();
+        cv_.wait(lck, [this]() { return not isHeld_; });
+        --running_;
+
+        if (failures_ > 0) {
+            --failures_;
+            return {grpc::StatusCode::UNAVAILABLE, "unavailable"};
+        }
+
+        response->set_validated(true);
+        response->set_ledger_header(std::to_string(request->ledger().sequence()));
+        return grpc::Status::OK;
+    }
+
+    void
+    hold()
+    {
+        std::scoped_lock const lck{mtx_};
+        isHeld_ = true;
+    }
+
+    void
+    release()
+    {
+        std::scoped_lock const lck{mtx_};
+        isHeld_ = false;
+        cv_.notify_all();
+    }
+
+    void
+    failNext(std::size_t count)
+    {
+        std::scoped_lock const lck{mtx_};
+        failures_ = count;
+    }
+
+    void
+    waitForRunning(std::size_t count)
+    {
+        std::unique_lock lck{mtx_};
+        cv_.wait(lck, [this, count]() { return running_ == count; });
+    }
+
+    std::size_t
+    maxRunning()
+    {
+        std::scoped_lock const lck{mtx_};
+        return maxRunning_;
+    }
+
+    std::vector<std::uint32_t>
+    requested()
+    {
+        std::scoped_lock const lck{mtx_};
+        return requested_;
+    }
+};
+
+struct FakeRippled {
+    FakeLedgerService service;
+    std::unique_ptr<grpc::Server> server;
+    std::unique_ptr<org::xrpl::rpc::v1::XRPLedgerAPIService::Stub> stub;
+
+    FakeRippled()
+    {
+        int port = 0;
+        grpc::ServerBuilder builder;
+        builder.AddListeningPort("127.0.0.1:0", grpc::InsecureServerCredentials(), &port);
+        builder.RegisterService(&service);
+        server = builder.BuildAndStart();
+
+        stub = org::xrpl::rpc::v1::XRPLedgerAPIService::NewStub(
+            grpc::CreateChannel("127.0.0.1:" + std::to_string(port), grpc::InsecureChannelCredentials())
+        );
+    }
+
+    ~FakeRippled()
+    {
+        service.release();
+        server->Shutdown();
+    }
+
+    FakeRippled(FakeRippled const&) = delete;
+    FakeRippled&
+    operator=(FakeRippled const&) = delete;
+};
+
+}  // namespace
+
+struct LedgerFetchPoolTest : util::prometheus::WithPrometheus {
+    FakeRippled firstRippled;
+    FakeRippled secondRippled;
+    SourceScore firstScore{"first"};
+    SourceScore secondScore{"second"};
+    NiceMock<MockSource> firstSource;
+    NiceMock<MockSource> secondSource;
+
+    LedgerFetchPoolTest()
+    {
+        serve(firstSource, firstRippled, firstScore);
+        serve(secondSource, secondRippled, secondScore);
+    }
+
+    static void
+    serve(NiceMock<MockSource>& source, FakeRippled& rippled, SourceScore& score)
+    {
+        ON_CALL(source, hasLedger).WillByDefault(Return(true));
+        ON_CALL(source, toString).WillByDefault(Return("source"));
+        ON_CALL(source, fetchLedgerAsync)
+            .WillByDefault([&rippled, &score](uint32_t seq, bool objects, bool neighbors, grpc::CompletionQueue& cq) {
+                org::xrpl::rpc::v1::GetLedgerRequest request;
+                request.mutable_ledger()->set_sequence(seq);
+                request.set_get_objects(objects);
+                request.set_get_object_neighbors(neighbors);
+                return std::make_unique<AsyncLedgerFetch>(*rippled.stub, request, cq, score);
+            });
+    }
+
+    LedgerFetchPool::RankFunction
+    rankBothSources()
+    {
+        return [this]() { return std::vector<etl::Source*>{&firstSource, &secondSource}; };
+    }
+};
+
+TEST_F(LedgerFetchPoolTest, FetchesLedgersConcurrentlyUpToLimitPerSource)
+{
+    static constexpr std::size_t FETCHES_PER_SOURCE = 2;
+    LedgerFetchPool pool{[this]() { return std::vector<etl::Source*>{&firstSource}; }, 1, FETCHES_PER_SOURCE};
+
+    firstRippled.service.hold();
+    std::vector<std::future<LedgerFetchPool::OptionalResponseType>> futures;
+    for (std::uint32_t seq = 1; seq <= 5; ++seq)
+        futures.push_back(pool.fetch(seq, true, false));
+
+    firstRippled.service.waitForRunning(FETCHES_PER_SOURCE);
+    firstRippled.service.release();
+
+    for (std::uint32_t seq = 1; seq <= 5; ++seq) {
+        auto const response = futures[seq - 1].get();
+        ASSERT_TRUE(response.has_value());
+        EXPECT_TRUE(response->validated());
+        EXPECT_EQ(response->ledger_header(), std::to_string(seq));
+    }
+
+    EXPECT_EQ(firstRippled.service.maxRunning(), FETCHES_PER_SOURCE);
+}
+
+TEST_F(LedgerFetchPoolTest, RetriesFailedFetchAtNextSource)
+{
+    LedgerFetchPool pool{rankBothSources(), 1, 1};
+    firstRippled.service.failNext(1);
+
+    auto const response = pool.fetch(42, true, false).get();
+    ASSERT_TRUE(response.has_value());
+    EXPECT_EQ(response->ledger_header(), "42");
+
+    EXPECT_THAT(firstRippled.service.requested(), ElementsAre(42));
+    EXPECT_THAT(secondRippled.service.requested(), ElementsAre(42));
+}
+
+TEST_F(LedgerFetchPoolTest, SkipsSourcesWithoutTheLedger)
+{
+    LedgerFetchPool pool{rankBothSources(), 2, 1};
+    ON_CALL(firstSource, hasLedger).WillByDefault(Return(false));
+
+    EXPECT_TRUE(pool.fetch(42, true, false).get().has_value());
+    EXPECT_THAT(firstRippled.service.requested(), IsEmpty());
+    EXPECT_THAT(secondRippled.service.requested(), ElementsAre(42));
+}
+
+TEST_F(LedgerFetchPoolTest, StopResolvesQueuedAndRunningFetchesWithNothing)
+{
+    LedgerFetchPool pool{rankBothSources(), 1, 1};
+    ON_CALL(secondSource, hasLedger).WillByDefault(Return(false));
+
+    firstRippled.service.hold();
+    auto running = pool.fetch(1, true, false);
+    auto queued = pool.fetch(2, true, false);
+    firstRippled.service.waitForRunning(1);
+
+    pool.stop();
+    EXPECT_FALSE(running.get().has_value());
+    EXPECT_FALSE(queued.get().has_value());
+    EXPECT_FALSE(pool.fetch(3, true, false).get().has_value());
+}
@@ -0,0 +1,245 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of clio: https://github.com/XRPLF/clio
+    Copyright (c) 2023, the clio developers.
+
+    Permission to use, copy, modify, and distribute this software for any
+    purpose with or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL,  DIRECT,  INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include "data/DBHelpers.h"
+#include "data/Types.h"
+#include "etl/impl/LedgerImport.h"
+#include "etl/impl/LedgerRecording.h"
+#include "util/Fixtures.h"
+#include "util/MockBackend.h"
+#include "util/TestObject.h"
+#include "util/TmpFile.h"
+#include "util/config/Config.h"
+
+#include <boost/json/parse.hpp>
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include <ripple/protocol/Indexes.h>
+#include <ripple/proto/org/xrpl/rpc/v1/get_ledger.pb.h>
+#include <ripple/proto/org/xrpl/rpc/v1/get_ledger_data.pb.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+using namespace testing;
+using namespace etl::detail;
+using namespace data;
+
+static auto constexpr ACCOUNT = "rf1BiGeXwwQoi8Z2ueFYTEXSwuJYfV2Jpn";
+static auto constexpr ACCOUNT2 = "rLEsXccBGNR3UPuPu2hUXPjziKC3qKSBun";
+static auto constexpr TXNID = "E3FE6EA3D48F0C2B639448020EA4F03D4F4F8FFDB243A852A0F59177921B4879";
+static auto constexpr FIRST_SEQ = 30;
+static auto constexpr LAST_SEQ = 40;
+
+namespace {
+
+struct MockImportLoader {
+    using GetLedgerResponseType = org::xrpl::rpc::v1::GetLedgerResponse;
+
+    MOCK_METHOD(void, loadLedgerDiff, (GetLedgerResponseType & data), ());
+};
+
+std::string
+accountRootKey(char const* account)
+{
+    auto const key = ripple::keylet::account(GetAccountIDWithString(account)).key;
+    return {reinterpret_cast<char const*>(key.data()), ripple::uint256::size()};
+}
+
+std::string
+accountRootBlob(char const* account)
+{
+    auto const blob = CreateAccountRootObject(account, 0, 1, 10, 2, TXNID, 3).getSerializer().peekData();
+    return {blob.begin(), blob.end()};
+}
+
+}  // namespace
+
+struct LedgerImportTest : MockBackendTest {
+    using LedgerImportType = LedgerImport<MockImportLoader>;
+
+    MockImportLoader loader;
+    MockBackend* rawBackendPtr = nullptr;
+    TmpFile dump{""};
+    std::string key1 = accountRootKey(ACCOUNT);
+    std::string key2 = accountRootKey(ACCOUNT2);
+
+    std::mutex mtx;
+    std::vector<std::uint32_t> loaded;  // in the order the ledgers were loaded
+
+    void
+    SetUp() override
+    {
+        MockBackendTest::SetUp();
+        rawBackendPtr = dynamic_cast<MockBackend*>(mockBackendPtr.get());
+        ASSERT_NE(rawBackendPtr, nullptr);
+
+        if (key2 < key1)
+            std::swap(key1, key2);
+
+        // the header of a recorded ledger is just its sequence here
+        ON_CALL(loader, loadLedgerDiff).WillByDefault([this](MockImportLoader::GetLedgerResponseType& data) {
+            std::scoped_lock const lck{mtx};
+            loaded.push_back(static_cast<std::uint32_t>(std::stoul(data.ledger_header())));
+        });
+    }
+
+    void
+    record(std::vector<std::uint32_t> const& sequences)
+    {
+        LedgerRecordWriter writer{dump.path};
+
+        org::xrpl::rpc::v1::GetLedgerDataResponse page;
+        for (auto const* account : {ACCOUNT, ACCOUNT2}) {
+            auto* obj = page.mutable_ledger_objects()->add_objects();
+            obj->set_key(accountRootKey(account));
+            obj->set_data(accountRootBlob(account));
+        }
+        std::sort(
+            page.mutable_ledger_objects()->mutable_objects()->begin(),
+            page.mutable_ledger_objects()->mutable_objects()->end(),
+            [](auto const& a, auto const& b) { return a.key() < b.key(); }
+        );
+        writer.writeLedgerDataPage(FIRST_SEQ, page);
+
+        for (auto const seq : sequences) {
+            org::xrpl::rpc::v1::GetLedgerResponse ledger;
+            ledger.set_ledger_header(std::to_string(seq));
+            writer.writeLedger(seq, ledger);
+        }
+
+        writer.flush();
+    }
+
+    static std::vector<std::uint32_t>
+    ledgers(std::uint32_t first, std::uint32_t last)
+    {
+        std::vector<std::uint32_t> sequences;
+        for (auto seq = first; seq <= last; ++seq)
+            sequences.push_back(seq);
+
+        return sequences;
+    }
+
+    LedgerImportType
+    makeImport(char const* config)
+    {
+        return LedgerImportType{util::Config{boost::json::parse(config)}, mockBackendPtr, loader};
+    }
+
+    LedgerRange
+    runImport(char const* config)
+    {
+        auto ledgerImport = makeImport(config);
+        LedgerRecordReader reader{dump.path};
+        return ledgerImport.run(reader);
+    }
+};
+
+TEST_F(LedgerImportTest, InvalidConfig)
+{
+    EXPECT_THROW(makeImport(R"({"threads": 0})"), std::runtime_error);
+    EXPECT_THROW(makeImport(R"({"batch_size": 0})"), std::runtime_error);
+}
+
+TEST_F(LedgerImportTest, RefusesDatabaseThatIsNotEmpty)
+{
+    record(ledgers(FIRST_SEQ, LAST_SEQ));
+    EXPECT_CALL(*rawBackendPtr, hardFetchLedgerRange)
+        .WillRepeatedly(Return(LedgerRange{.minSequence = FIRST_SEQ, .maxSequence = LAST_SEQ}));
+    EXPECT_CALL(*rawBackendPtr, writeSnapshotObject).Times(0);
+    EXPECT_CALL(loader, loadLedgerDiff).Times(0);
+
+    EXPECT_THROW(runImport("{}"), std::runtime_error);
+}
+
+TEST_F(LedgerImportTest, ImportsStateAndAllLedgersThenWritesRange)
+{
+    record(ledgers(FIRST_SEQ, LAST_SEQ));
+
+    EXPECT_CALL(*rawBackendPtr, writeSnapshotObject(std::string{key1}, FIRST_SEQ, _));
+    EXPECT_CALL(*rawBackendPtr, writeSnapshotObject(std::string{key2}, FIRST_SEQ, _));
+    EXPECT_CALL(*rawBackendPtr, writeSuccessor(std::string{key1}, FIRST_SEQ, std::string{key2}));
+    EXPECT_CALL(*rawBackendPtr, writeSuccessor(uint256ToString(firstKey), FIRST_SEQ, std::string{key1}));
+    EXPECT_CALL(*rawBackendPtr, writeSuccessor(std::string{key2}, FIRST_SEQ, uint256ToString(lastKey)));
+    EXPECT_CALL(loader, loadLedgerDiff).Times(LAST_SEQ - FIRST_SEQ + 1);
+
+    // the range is written once, after all ledgers: the last ledger, then down to the first one. Each thread writes
+    // its ledgers without write groups and waits for them before the last ledger is finished
+    Sequence s;
+    EXPECT_CALL(*rawBackendPtr, isolateThreadWrites).Times(3);
+    EXPECT_CALL(*rawBackendPtr, syncThreadWrites).Times(3).InSequence(s);
+    EXPECT_CALL(*rawBackendPtr, doFinishWrites(LAST_SEQ)).InSequence(s).WillOnce(Return(true));
+    EXPECT_CALL(*rawBackendPtr, doUpdateMinSequence(LAST_SEQ, FIRST_SEQ)).InSequence(s).WillOnce(Return(true));
+
+    auto const range = runImport(R"({"threads": 3, "batch_size": 2})");
+    EXPECT_EQ(range.minSequence, FIRST_SEQ);
+    EXPECT_EQ(range.maxSequence, LAST_SEQ);
+
+    ASSERT_EQ(loaded.size(), LAST_SEQ - FIRST_SEQ + 1);
+    EXPECT_EQ(loaded.back(), LAST_SEQ);
+    std::sort(loaded.begin(), loaded.end());
+    EXPECT_EQ(loaded, ledgers(FIRST_SEQ, LAST_SEQ));
+}
+
+TEST_F(LedgerImportTest, SingleLedgerOnlyWritesMaximum)
+{
+    record({FIRST_SEQ});
+
+    EXPECT_CALL(loader, loadLedgerDiff);
+    EXPECT_CALL(*rawBackendPtr, doFinishWrites(FIRST_SEQ)).WillOnce(Return(true));
+    EXPECT_CALL(*rawBackendPtr, doUpdateMinSequence).Times(0);
+
+    auto const range = runImport("{}");
+    EXPECT_EQ(range.minSequence, FIRST_SEQ);
+    EXPECT_EQ(range.maxSequence, FIRST_SEQ);
+}
+
+TEST_F(LedgerImportTest, DumpWithGapIsNotCommitted)
+{
+    record({FIRST_SEQ, FIRST_SEQ + 1, FIRST_SEQ + 3});
+    EXPECT_CALL(*rawBackendPtr, doFinishWrites).Times(0);
+
+    EXPECT_THROW(runImport("{}"), std::runtime_error);
+}
+
+TEST_F(LedgerImportTest, DumpWithoutFirstLedgerIsRejected)
+{
+    record(ledgers(FIRST_SEQ + 1, LAST_SEQ));
+    EXPECT_CALL(loader, loadLedgerDiff).Times(0);
+    EXPECT_CALL(*rawBackendPtr, doFinishWrites).Times(0);
+
+    EXPECT_THROW(runImport("{}"), std::runtime_error);
+}
+
+TEST_F(LedgerImportTest, FailedLedgerStopsImport)
+{
+    record(ledgers(FIRST_SEQ, LAST_SEQ));
+    EXPECT_CALL(loader, loadLedgerDiff).Times(AnyNumber());
+    EXPECT_CALL(loader, loadLedgerDiff(Property(&MockImportLoader::GetLedgerResponseType::ledger_header, "35")))
+        .WillOnce(Throw(std::runtime_error{"no object neighbors"}));
+    EXPECT_CALL(*rawBackendPtr, doFinishWrites).Times(0);
+
+    EXPECT_THROW(runImport(R"({"threads": 2, "batch_size": 2})"), std::runtime_error);
+}
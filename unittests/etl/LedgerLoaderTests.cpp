@@ -0,0 +1,220 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of clio: https://github.com/XRPLF/clio
+    Copyright (c) 2023, the clio developers.
+
+    Permission to use, copy, modify, and distribute this software for any
+    purpose with or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL,  DIRECT,  INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include "data/Types.h"
+#include "etl/SystemState.h"
+#include "etl/impl/LedgerLoader.h"
+#include "util/Fixtures.h"
+#include "util/MockBackend.h"
+#include "util/StringUtils.h"
+#include "util/TestObject.h"
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include <ripple/basics/base_uint.h>
+#include <ripple/protocol/STTx.h>
+#include <ripple/protocol/Serializer.h>
+#include <ripple/proto/org/xrpl/rpc/v1/get_ledger.pb.h>
+
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+using namespace testing;
+using namespace etl::detail;
+
+static auto constexpr ACCOUNT = "rf1BiGeXwwQoi8Z2ueFYTEXSwuJYfV2Jpn";
+static auto constexpr ACCOUNT2 = "rLEsXccBGNR3UPuPu2hUXPjziKC3qKSBun";
+static auto constexpr LEDGERHASH = "4BC50C9B0D8515D3EAAE1E74B29A95804346C491EE1A95BF25E4AAB854A6A652";
+static auto constexpr SEQ = 30;
+static auto constexpr RESUMED_SEQ = 25;
+static auto constexpr DECODE_THREADS = 4;
+static auto constexpr NUM_TXNS = 300;  // enough for a shard on each decode thread
+
+namespace {
+
+struct MockInitialLoadBalancer {
+    using RawLedgerObjectType = org::xrpl::rpc::v1::RawLedgerObject;
+    using GetLedgerResponseType = org::xrpl::rpc::v1::GetLedgerResponse;
+    using OptionalGetLedgerResponseType = std::optional<GetLedgerResponseType>;
+
+    MOCK_METHOD(bool, loadInitialLedger, (std::uint32_t), ());
+};
+
+struct MockGetLedgerFetcher {
+    MOCK_METHOD(std::optional<org::xrpl::rpc::v1::GetLedgerResponse>, fetchData, (std::uint32_t), ());
+};
+
+org::xrpl::rpc::v1::GetLedgerResponse
+makeLedger(std::uint32_t sequence)
+{
+    org::xrpl::rpc::v1::GetLedgerResponse ledger;
+    ledger.set_ledger_header(ledgerInfoToBinaryString(CreateLedgerInfo(LEDGERHASH, sequence)));
+    ledger.set_validated(true);
+    return ledger;
+}
+
+// payments whose transaction indexes run opposite to the order they are received in
+org::xrpl::rpc::v1::GetLedgerResponse
+makeLedgerWithPayments(std::uint32_t sequence)
+{
+    auto ledger = makeLedger(sequence);
+    for (auto i = 0; i < NUM_TXNS; ++i) {
+        auto const tx = CreatePaymentTransactionObject(ACCOUNT, ACCOUNT2, 1, 1, i).getSerializer().peekData();
+        auto const meta = CreatePaymentTransactionMetaObject(ACCOUNT, ACCOUNT2, 100, 200, NUM_TXNS - 1 - i)
+                              .getSerializer()
+                              .peekData();
+
+        auto* txn = ledger.mutable_transactions_list()->add_transactions();
+        txn->set_transaction_blob(std::string{tx.begin(), tx.end()});
+        txn->set_metadata_blob(std::string{meta.begin(), meta.end()});
+    }
+    return ledger;
+}
+
+ripple::uint256
+transactionId(org::xrpl::rpc::v1::GetLedgerResponse const& ledger, int index)
+{
+    auto const& blob = ledger.transactions_list().transactions(index).transaction_blob();
+    ripple::SerialIter it{blob.data(), blob.size()};
+    return ripple::STTx{it}.getTransactionID();
+}
+
+}  // namespace
+
+struct LedgerLoaderTest : MockBackendTest {
+    using LoaderType = LedgerLoader<MockInitialLoadBalancer, MockGetLedgerFetcher>;
+
+    MockBackend* rawBackendPtr = nullptr;
+    std::shared_ptr<MockInitialLoadBalancer> balancer = std::make_shared<MockInitialLoadBalancer>();
+    MockGetLedgerFetcher fetcher;
+    etl::SystemState state;
+
+    void
+    SetUp() override
+    {
+        MockBackendTest::SetUp();
+        rawBackendPtr = dynamic_cast<MockBackend*>(mockBackendPtr.get());
+        ASSERT_NE(rawBackendPtr, nullptr);
+
+        ON_CALL(*rawBackendPtr, hardFetchLedgerRange(_)).WillByDefault(Return(std::nullopt));
+    }
+
+    // the writes of the initial ledger other than its state, which comes from the load balancer
+    void
+    expectInitialLedgerWrites(std::uint32_t sequence)
+    {
+        EXPECT_CALL(fetcher, fetchData(sequence)).WillOnce(Return(makeLedger(sequence)));
+        EXPECT_CALL(*rawBackendPtr, startWrites);
+        EXPECT_CALL(*rawBackendPtr, writeLedger(Field(&ripple::LedgerHeader::seq, sequence), _));
+        EXPECT_CALL(*rawBackendPtr, doFinishWrites(sequence)).WillOnce(Return(true));
+        EXPECT_CALL(*rawBackendPtr, clearInitialLoadProgress);
+    }
+};
+
+TEST_F(LedgerLoaderTest, LoadInitialLedgerMarksCacheFull)
+{
+    LoaderType loader{mockBackendPtr, balancer, fetcher, state};
+
+    EXPECT_CALL(*rawBackendPtr, fetchInitialLoadProgress).WillOnce(Return(std::nullopt));
+    expectInitialLedgerWrites(SEQ);
+    EXPECT_CALL(*balancer, loadInitialLedger(SEQ)).WillOnce(Return(true));
+
+    auto const header = loader.loadInitialLedger(SEQ);
+    ASSERT_TRUE(header.has_value());
+    EXPECT_EQ(header->seq, SEQ);
+    EXPECT_TRUE(mockBackendPtr->cache().isFull());
+}
+
+TEST_F(LedgerLoaderTest, LoadInitialLedgerResumesInterruptedDownload)
+{
+    LoaderType loader{mockBackendPtr, balancer, fetcher, state};
+
+    // the objects downloaded before the restart are in the DB but not in the cache
+    data::InitialLoadProgress const progress{
+        .sequence = RESUMED_SEQ,
+        .cursors = {{.marker = ripple::uint256{0}, .lastKey = ripple::uint256{1}}}
+    };
+    EXPECT_CALL(*rawBackendPtr, fetchInitialLoadProgress).WillOnce(Return(progress));
+    expectInitialLedgerWrites(RESUMED_SEQ);
+    EXPECT_CALL(fetcher, fetchData(SEQ)).Times(0);
+    EXPECT_CALL(*balancer, loadInitialLedger(RESUMED_SEQ)).WillOnce(Return(true));
+
+    auto const header = loader.loadInitialLedger(SEQ);
+    ASSERT_TRUE(header.has_value());
+    EXPECT_EQ(header->seq, RESUMED_SEQ);
+    EXPECT_FALSE(mockBackendPtr->cache().isFull());
+}
+
+TEST_F(LedgerLoaderTest, ShardedDecodeKeepsReceivedOrder)
+{
+    LoaderType shardedLoader{mockBackendPtr, balancer, fetcher, state, DECODE_THREADS};
+    LoaderType singleLoader{mockBackendPtr, balancer, fetcher, state};
+    auto const header = CreateLedgerInfo(LEDGERHASH, SEQ);
+
+    std::vector<ripple::uint256> received;
+    auto sharded = makeLedgerWithPayments(SEQ);
+    for (auto i = 0; i < NUM_TXNS; ++i)
+        received.push_back(transactionId(sharded, i));
+
+    std::vector<ripple::uint256> indexWrites;
+    std::vector<ripple::uint256> transactionWrites;
+    EXPECT_CALL(*rawBackendPtr, writeTransactionIndex(SEQ, _, _))
+        .Times(NUM_TXNS)
+        .WillRepeatedly([&indexWrites](auto, auto, ripple::uint256 const& hash) { indexWrites.push_back(hash); });
+    EXPECT_CALL(*rawBackendPtr, writeTransaction(_, SEQ, _, _, _))
+        .Times(NUM_TXNS)
+        .WillRepeatedly([&transactionWrites](std::string&& key, auto, auto, auto&&, auto&&) {
+            transactionWrites.push_back(ripple::uint256::fromVoid(key.data()));
+        });
+
+    auto const shardedResult = shardedLoader.insertTransactions(header, sharded);
+    EXPECT_EQ(indexWrites, received);
+    EXPECT_EQ(transactionWrites, received);
+
+    ASSERT_EQ(shardedResult.accountTxData.size(), NUM_TXNS);
+    for (auto i = 0u; i < received.size(); ++i)
+        EXPECT_EQ(shardedResult.accountTxData[i].txHash, received[i]);
+
+    Mock::VerifyAndClearExpectations(rawBackendPtr);
+    auto single = makeLedgerWithPayments(SEQ);
+    auto const singleResult = singleLoader.insertTransactions(header, single);
+
+    ASSERT_EQ(singleResult.accountTxData.size(), shardedResult.accountTxData.size());
+    for (auto i = 0u; i < singleResult.accountTxData.size(); ++i) {
+        auto const& expected = singleResult.accountTxData[i];
+        auto const& actual = shardedResult.accountTxData[i];
+        EXPECT_EQ(actual.txHash, expected.txHash);
+        EXPECT_EQ(actual.transactionIndex, expected.transactionIndex);
+        EXPECT_EQ(actual.ledgerSequence, expected.ledgerSequence);
+        EXPECT_EQ(actual.transactionType, expected.transactionType);
+        EXPECT_EQ(actual.accounts, expected.accounts);
+    }
+
+    // the transactions to publish are ordered by transaction index, the reverse of how they were received
+    EXPECT_EQ(shardedResult.transactions, singleResult.transactions);
+    ASSERT_EQ(shardedResult.transactions.size(), NUM_TXNS);
+    auto const& first = shardedResult.transactions.front().transaction;
+    ripple::SerialIter it{first.data(), first.size()};
+    EXPECT_EQ(ripple::STTx{it}.getTransactionID(), received.back());
+    EXPECT_EQ(shardedResult.nfTokenTxData.size(), singleResult.nfTokenTxData.size());
+    EXPECT_EQ(shardedResult.nfTokensData.size(), singleResult.nfTokensData.size());
+}
@@ -24,6 +24,7 @@
 #include "util/Fixtures.h"
 #include "util/MockBackend.h"
 #include "util/MockCache.h"
+#include "util/MockPrometheus.h"
 #include "util/MockSubscriptionManager.h"
 #include "util/TestObject.h"
 #include "util/config/Config.h"
@@ -50,7 +51,10 @@ static auto constexpr LEDGERHASH = "4BC50C9B0D8515D3EAAE1E74B29A95804346C491EE1A
 static auto constexpr SEQ = 30;
 static auto constexpr AGE = 800;
 
-class ETLLedgerPublisherTest : public MockBackendTest, public SyncAsioContextTest, public MockSubscriptionManagerTest {
+class ETLLedgerPublisherTest : public util::prometheus::WithPrometheus,
+                               public MockBackendTest,
+                               public SyncAsioContextTest,
+                               public MockSubscriptionManagerTest {
     void
     SetUp() override
     {
@@ -313,3 +317,52 @@ TEST_F(ETLLedgerPublisherTest, PublishMultipleTxInOrder)
     // last publish time should be set
     EXPECT_TRUE(publisher.lastPublishAgeSeconds() <= 1);
 }
+
+TEST_F(ETLLedgerPublisherTest, PublishInMemoryTransactionsWithoutReadingThemBack)
+{
+    SystemState dummyState;
+    dummyState.isWriting = true;
+
+    auto const dummyLedgerInfo = CreateLedgerInfo(LEDGERHASH, SEQ, 0);  // age is 0
+    detail::LedgerPublisher publisher(ctx, mockBackendPtr, mockCache, mockSubscriptionManagerPtr, dummyState);
+    mockBackendPtr->updateRange(SEQ - 1);
+    mockBackendPtr->updateRange(SEQ);
+
+    // already ordered by transaction index by the writer
+    TransactionAndMetadata t1;
+    t1.transaction = CreatePaymentTransactionObject(ACCOUNT, ACCOUNT2, 100, 3, SEQ).getSerializer().peekData();
+    t1.metadata = CreatePaymentTransactionMetaObject(ACCOUNT, ACCOUNT2, 110, 30, 0).getSerializer().peekData();
+    t1.ledgerSequence = SEQ;
+    t1.date = 1;
+    TransactionAndMetadata t2;
+    t2.transaction = CreatePaymentTransactionObject(ACCOUNT, ACCOUNT2, 100, 3, SEQ).getSerializer().peekData();
+    t2.metadata = CreatePaymentTransactionMetaObject(ACCOUNT, ACCOUNT2, 110, 30, 1).getSerializer().peekData();
+    t2.ledgerSequence = SEQ;
+    t2.date = 2;
+
+    publisher.publish(dummyLedgerInfo, std::vector<TransactionAndMetadata>{t1, t2});
+
+    MockBackend* rawBackendPtr = dynamic_cast<MockBackend*>(mockBackendPtr.get());
+    EXPECT_CALL(*rawBackendPtr, fetchLedgerDiff(_, _)).Times(0);
+    EXPECT_CALL(*rawBackendPtr, fetchAllTransactionsInLedger).Times(0);
+
+    // mock fetch fee
+    EXPECT_CALL(*rawBackendPtr, doFetchLedgerObject).Times(1);
+    ON_CALL(*rawBackendPtr, doFetchLedgerObject(ripple::keylet::fees().key, SEQ, _))
+        .WillByDefault(Return(CreateFeeSettingBlob(1, 2, 3, 4, 0)));
+
+    EXPECT_TRUE(publisher.getLastPublishedSequence());
+    EXPECT_EQ(publisher.getLastPublishedSequence().value(), SEQ);
+
+    MockSubscriptionManager* rawSubscriptionManagerPtr =
+        dynamic_cast<MockSubscriptionManager*>(mockSubscriptionManagerPtr.get());
+
+    EXPECT_CALL(*rawSubscriptionManagerPtr, pubLedger(_, _, fmt::format("{}-{}", SEQ - 1, SEQ), 2)).Times(1);
+    EXPECT_CALL(*rawSubscriptionManagerPtr, pubBookChanges).Times(1);
+    Sequence const s;
+    EXPECT_CALL(*rawSubscriptionManagerPtr, pubTransaction(t1, _)).InSequence(s);
+    EXPECT_CALL(*rawSubscriptionManagerPtr, pubTransaction(t2, _)).InSequence(s);
+
+    ctx.run();
+    EXPECT_TRUE(publisher.lastPublishAgeSeconds() <= 1);
+}
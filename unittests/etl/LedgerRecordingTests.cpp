@@ -0,0 +1,256 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of clio: https://github.com/XRPLF/clio
+    Copyright (c) 2023, the clio developers.
+
+    Permission to use, copy, modify, and distribute this software for any
+    purpose with or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL,  DIRECT,  INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include "data/DBHelpers.h"
+#include "data/Types.h"
+#include "etl/impl/LedgerRecording.h"
+#include "etl/impl/LedgerReplay.h"
+#include "util/Fixtures.h"
+#include "util/MockBackend.h"
+#include "util/StringUtils.h"
+#include "util/TestObject.h"
+#include "util/TmpFile.h"
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include <ripple/basics/chrono.h>
+#include <ripple/protocol/Indexes.h>
+#include <ripple/protocol/LedgerHeader.h>
+#include <ripple/proto/org/xrpl/rpc/v1/get_ledger.pb.h>
+#include <ripple/proto/org/xrpl/rpc/v1/get_ledger_data.pb.h>
+
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+using namespace testing;
+using namespace etl::detail;
+
+static auto constexpr ACCOUNT = "rf1BiGeXwwQoi8Z2ueFYTEXSwuJYfV2Jpn";
+static auto constexpr ACCOUNT2 = "rLEsXccBGNR3UPuPu2hUXPjziKC3qKSBun";
+static auto constexpr LEDGERHASH = "4BC50C9B0D8515D3EAAE1E74B29A95804346C491EE1A95BF25E4AAB854A6A652";
+static auto constexpr FIRST_SEQ = 30;
+static auto constexpr LAST_SEQ = 32;
+static auto constexpr CLOSE_INTERVAL = 4;
+
+namespace {
+
+std::string
+accountRootKey(char const* account)
+{
+    auto const key = ripple::keylet::account(GetAccountIDWithString(account)).key;
+    return {reinterpret_cast<char const*>(key.data()), ripple::uint256::size()};
+}
+
+std::string
+accountRootBlob(char const* account)
+{
+    auto const blob = CreateAccountRootObject(account, 0, 1, 10, 2, LEDGERHASH, 3).getSerializer().peekData();
+    return {blob.begin(), blob.end()};
+}
+
+org::xrpl::rpc::v1::GetLedgerResponse
+makeLedger(std::uint32_t sequence, int numObjects)
+{
+    auto header = CreateLedgerInfo(LEDGERHASH, sequence);
+    header.closeTime = ripple::NetClock::time_point{ripple::NetClock::duration{sequence * CLOSE_INTERVAL}};
+
+    org::xrpl::rpc::v1::GetLedgerResponse ledger;
+    ledger.set_ledger_header(ledgerInfoToBinaryString(header));
+    ledger.set_validated(true);
+    for (auto i = 0; i < numObjects; ++i)
+        ledger.mutable_ledger_objects()->add_objects()->set_key(accountRootKey(ACCOUNT));
+
+    return ledger;
+}
+
+}  // namespace
+
+struct LedgerRecordingTest : virtual NoLoggerFixture {
+    TmpFile file{""};
+    std::string key1 = accountRootKey(ACCOUNT);
+    std::string key2 = accountRootKey(ACCOUNT2);
+
+    void
+    SetUp() override
+    {
+        NoLoggerFixture::SetUp();
+        if (key2 < key1)
+            std::swap(key1, key2);
+    }
+
+    // the state of the first ledger in two pages, one object each, and the ledgers up to the last one
+    void
+    record()
+    {
+        LedgerRecordWriter writer{file.path};
+
+        org::xrpl::rpc::v1::GetLedgerDataResponse page;
+        auto* obj = page.mutable_ledger_objects()->add_objects();
+        obj->set_key(key1);
+        obj->set_data(accountRootBlob(ACCOUNT));
+        page.set_marker(key2);
+        writer.writeLedgerDataPage(FIRST_SEQ, page);
+
+        page.Clear();
+        obj = page.mutable_ledger_objects()->add_objects();
+        obj->set_key(key2);
+        obj->set_data(accountRootBlob(ACCOUNT2));
+        writer.writeLedgerDataPage(FIRST_SEQ, page);
+
+        for (auto seq = FIRST_SEQ; seq <= LAST_SEQ; ++seq)
+            writer.writeLedger(seq, makeLedger(seq, seq - FIRST_SEQ));
+
+        writer.flush();
+    }
+};
+
+TEST_F(LedgerRecordingTest, RoundTrip)
+{
+    record();
+
+    LedgerRecordReader reader{file.path};
+    for (auto i = 0; i < 2; ++i) {
+        auto const record = reader.next();
+        ASSERT_TRUE(record.has_value());
+        EXPECT_EQ(record->kind, LedgerRecordKind::LedgerDataPage);
+        EXPECT_EQ(record->sequence, FIRST_SEQ);
+        EXPECT_EQ(record->parse<org::xrpl::rpc::v1::GetLedgerDataResponse>().ledger_objects().objects_size(), 1);
+    }
+
+    for (auto seq = FIRST_SEQ; seq <= LAST_SEQ; ++seq) {
+        auto const record = reader.next();
+        ASSERT_TRUE(record.has_value());
+        EXPECT_EQ(record->kind, LedgerRecordKind::Ledger);
+        EXPECT_EQ(record->sequence, seq);
+
+        auto const ledger = record->parse<org::xrpl::rpc::v1::GetLedgerResponse>();
+        EXPECT_EQ(ledger.SerializeAsString(), makeLedger(seq, seq - FIRST_SEQ).SerializeAsString());
+    }
+
+    EXPECT_FALSE(reader.next().has_value());
+}
+
+TEST_F(LedgerRecordingTest, RejectsOtherFiles)
+{
+    TmpFile const other{"not a recording of ledgers"};
+    EXPECT_THROW(LedgerRecordReader{other.path}, std::runtime_error);
+    EXPECT_THROW(LedgerRecordReader{"/does/not/exist"}, std::runtime_error);
+}
+
+TEST_F(LedgerRecordingTest, TruncatedRecordThrows)
+{
+    record();
+    auto const size = std::filesystem::file_size(file.path);
+    std::filesystem::resize_file(file.path, size - 1);
+
+    LedgerRecordReader reader{file.path};
+    EXPECT_THROW(
+        {
+            while (reader.next()) {
+            }
+        },
+        std::runtime_error
+    );
+}
+
+struct LedgerReplayTest : LedgerRecordingTest, MockBackendTest {
+    MockBackend* rawBackendPtr = nullptr;
+
+    void
+    SetUp() override
+    {
+        LedgerRecordingTest::SetUp();
+        MockBackendTest::SetUp();
+        rawBackendPtr = dynamic_cast<MockBackend*>(mockBackendPtr.get());
+        ASSERT_NE(rawBackendPtr, nullptr);
+    }
+
+    LedgerReplay
+    makeReplay()
+    {
+        record();
+        LedgerRecordReader reader{file.path};
+        return LedgerReplay{mockBackendPtr, reader};
+    }
+};
+
+TEST_F(LedgerReplayTest, ServesRecordedLedgers)
+{
+    auto replay = makeReplay();
+    EXPECT_EQ(replay.firstSequence(), FIRST_SEQ);
+    EXPECT_EQ(replay.lastSequence(), LAST_SEQ);
+    EXPECT_EQ(replay.closeOffset(LAST_SEQ), std::chrono::seconds{(LAST_SEQ - FIRST_SEQ) * CLOSE_INTERVAL});
+    EXPECT_EQ(replay.statsOf(LAST_SEQ).objects, LAST_SEQ - FIRST_SEQ);
+
+    auto const response = replay.fetchLedger(FIRST_SEQ + 1, true, true);
+    ASSERT_TRUE(response.has_value());
+    EXPECT_EQ(response->SerializeAsString(), makeLedger(FIRST_SEQ + 1, 1).SerializeAsString());
+    EXPECT_TRUE(replay.fetchLedgerAsync(LAST_SEQ, true, true).get().has_value());
+
+    // replay is done past the last recorded ledger
+    EXPECT_FALSE(replay.fetchLedger(LAST_SEQ + 1, true, true).has_value());
+
+    auto const extracted = replay.extracted();
+    EXPECT_EQ(extracted.ledgers, 2);
+    EXPECT_EQ(extracted.objects, 1 + LAST_SEQ - FIRST_SEQ);
+}
+
+TEST_F(LedgerReplayTest, RejectsRecordingWithGaps)
+{
+    {
+        LedgerRecordWriter writer{file.path};
+        writer.writeLedgerDataPage(FIRST_SEQ, {});
+        writer.writeLedger(FIRST_SEQ, makeLedger(FIRST_SEQ, 0));
+        writer.writeLedger(LAST_SEQ, makeLedger(LAST_SEQ, 0));
+        writer.flush();
+    }
+
+    LedgerRecordReader reader{file.path};
+    EXPECT_THROW(LedgerReplay(mockBackendPtr, reader), std::runtime_error);
+}
+
+TEST_F(LedgerReplayTest, LoadsInitialLedgerFromRecordedPages)
+{
+    auto replay = makeReplay();
+
+    EXPECT_CALL(*rawBackendPtr, writeLedgerObject(std::string{key1}, FIRST_SEQ, _));
+    EXPECT_CALL(*rawBackendPtr, writeLedgerObject(std::string{key2}, FIRST_SEQ, _));
+    EXPECT_CALL(*rawBackendPtr, writeSuccessor(std::string{key1}, FIRST_SEQ, std::string{key2}));
+    EXPECT_CALL(*rawBackendPtr, writeSuccessor(uint256ToString(data::firstKey), FIRST_SEQ, std::string{key1}));
+    EXPECT_CALL(*rawBackendPtr, writeSuccessor(std::string{key2}, FIRST_SEQ, uint256ToString(data::lastKey)));
+
+    EXPECT_FALSE(replay.loadInitialLedger(FIRST_SEQ + 1));
+    EXPECT_TRUE(replay.loadInitialLedger(FIRST_SEQ));
+    EXPECT_EQ(mockBackendPtr->cache().size(), 2);
+}
+
+TEST_F(LedgerReplayTest, LoadsInitialLedgerIntoCacheOnly)
+{
+    auto replay = makeReplay();
+
+    EXPECT_CALL(*rawBackendPtr, writeLedgerObject).Times(0);
+    EXPECT_CALL(*rawBackendPtr, writeSuccessor).Times(0);
+
+    EXPECT_TRUE(replay.loadInitialLedger(FIRST_SEQ, true));
+    EXPECT_EQ(mockBackendPtr->cache().size(), 2);
+}
@@ -0,0 +1,271 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of clio: https://github.com/XRPLF/clio
+    Copyright (c) 2023, the clio developers.
+
+    Permission to use, copy, modify, and distribute this software for any
+    purpose with or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL,  DIRECT,  INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include "etl/ETLHelpers.h"
+#include "etl/LoadBalancer.h"
+#include "etl/Source.h"
+#include "etl/impl/AsyncData.h"
+#include "etl/impl/SourceScore.h"
+#include "util/MockPrometheus.h"
+#include "util/MockSource.h"
+#include "util/StringUtils.h"
+#include "util/TestObject.h"
+#include "util/config/Config.h"
+
+#include <boost/json/parse.hpp>
+#include <gmock/gmock.h>
+#include <grpcpp/grpcpp.h>
+#include <gtest/gtest.h>
+#include <ripple/basics/base_uint.h>
+#include <ripple/proto/org/xrpl/rpc/v1/xrp_ledger.grpc.pb.h>
+
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+using namespace testing;
+using namespace etl;
+
+static auto constexpr SEQ = 30;
+static auto constexpr HASH = "4BC50C9B0D8515D3EAAE1E74B29A95804346C491EE1A95BF25E4AAB854A6A652";
+static auto constexpr OTHER_HASH = "1B8590C01B0006EDFA9ED60296DD052DC5E90F99659B25014D08E1BC983515BC";
+static auto constexpr PARENT_HASH = "E3FE6EA3D48F0C2B639448020EA4F03D4F4F8FFDB243A852A0F59177921B4879";
+
+namespace {
+
+org::xrpl::rpc::v1::GetLedgerResponse
+makeResponse(std::uint32_t seq, char const* hash, char const* parentHash = PARENT_HASH, bool validated = true)
+{
+    auto header = CreateLedgerInfo(hash, seq);
+    header.parentHash = ripple::uint256{parentHash};
+
+    org::xrpl::rpc::v1::GetLedgerResponse response;
+    response.set_ledger_header(ledgerInfoToBinaryString(header));
+    response.set_validated(validated);
+    return response;
+}
+
+/**
+ * @brief The gRPC service of a rippled that returns the same response to every GetLedger call.
+ *
+ * The calls can be held to keep them in flight.
+ */
+class FakeLedgerService : public org::xrpl::rpc::v1::XRPLedgerAPIService::Service {
+    std::mutex mtx_;
+    std::condition_variable cv_;
+    bool isHeld_ = false;
+    org::xrpl::rpc::v1::GetLedgerResponse response_;
+
+public:
+    grpc::Status
+    GetLedger(
+        grpc::ServerContext*,
+        org::xrpl::rpc::v1::GetLedgerRequest const*,
+        org::xrpl::rpc::v1::GetLedgerResponse* response
+    ) override
+    {
+        std::unique_lock lck{mtx_};
+        cv_.wait(lck, [this]() { return not isHeld_; });
+
+        *response = response_;
+        return grpc::Status::OK;
+    }
+
+    void
+    respondWith(org::xrpl::rpc::v1::GetLedgerResponse response)
+    {
+        std::scoped_lock const lck{mtx_};
+        response_ = std::move(response);
+    }
+
+    void
+    hold()
+    {
+        std::scoped_lock const lck{mtx_};
+        isHeld_ = true;
+    }
+
+    void
+    release()
+    {
+        std::scoped_lock const lck{mtx_};
+        isHeld_ = false;
+        cv_.notify_all();
+    }
+};
+
+struct FakeRippled {
+    FakeLedgerService service;
+    std::unique_ptr<grpc::Server> server;
+    std::unique_ptr<org::xrpl::rpc::v1::XRPLedgerAPIService::Stub> stub;
+
+    FakeRippled()
+    {
+        int port = 0;
+        grpc::ServerBuilder builder;
+        builder.AddListeningPort("127.0.0.1:0", grpc::InsecureServerCredentials(), &port);
+        builder.RegisterService(&service);
+        server = builder.BuildAndStart();
+
+        stub = org::xrpl::rpc::v1::XRPLedgerAPIService::NewStub(
+            grpc::CreateChannel("127.0.0.1:" + std::to_string(port), grpc::InsecureChannelCredentials())
+        );
+    }
+
+    ~FakeRippled()
+    {
+        service.release();
+        server->Shutdown();
+    }
+
+    FakeRippled(FakeRippled const&) = delete;
+    FakeRippled&
+    operator=(FakeRippled const&) = delete;
+};
+
+}  // namespace
+
+struct LoadBalancerHedgedFetchTest : util::prometheus::WithPrometheus {
+    FakeRippled firstRippled;
+    FakeRippled secondRippled;
+    detail::SourceScore firstScore{"first"};
+    detail::SourceScore secondScore{"second"};
+
+    // owned by the balancer
+    NiceMock<MockSource>* firstSource = nullptr;
+    NiceMock<MockSource>* secondSource = nullptr;
+    std::unique_ptr<LoadBalancer> balancer;
+
+    // what the sources return when asked one by one, after no hedged response was usable
+    org::xrpl::rpc::v1::GetLedgerResponse const fallback = makeResponse(SEQ, OTHER_HASH);
+
+    LoadBalancerHedgedFetchTest()
+    {
+        auto first = std::make_unique<NiceMock<MockSource>>();
+        auto second = std::make_unique<NiceMock<MockSource>>();
+        firstSource = first.get();
+        secondSource = second.get();
+        serve(*firstSource, firstRippled, firstScore);
+        serve(*secondSource, secondRippled, secondScore);
+
+        std::vector<std::unique_ptr<Source>> sources;
+        sources.push_back(std::move(first));
+        sources.push_back(std::move(second));
+        balancer = std::make_unique<LoadBalancer>(
+            util::Config{boost::json::parse(R"({"hedged_fetch_sources": 2})")},
+            std::move(sources),
+            NetworkValidatedLedgers::make_ValidatedLedgers()
+        );
+    }
+
+    void
+    serve(NiceMock<MockSource>& source, FakeRippled& rippled, detail::SourceScore& score) const
+    {
+        ON_CALL(source, hasLedger).WillByDefault(Return(true));
+        ON_CALL(source, toString).WillByDefault(Return("source"));
+        ON_CALL(source, fetchLedgerAsync)
+            .WillByDefault([&rippled, &score](uint32_t seq, bool objects, bool neighbors, grpc::CompletionQueue& cq) {
+                org::xrpl::rpc::v1::GetLedgerRequest request;
+                request.mutable_ledger()->set_sequence(seq);
+                request.set_get_objects(objects);
+                request.set_get_object_neighbors(neighbors);
+                return std::make_unique<detail::AsyncLedgerFetch>(*rippled.stub, request, cq, score);
+            });
+        ON_CALL(source, fetchLedger).WillByDefault(Return(std::make_pair(grpc::Status::OK, fallback)));
+    }
+
+    void
+    respondWith(org::xrpl::rpc::v1::GetLedgerResponse const& response)
+    {
+        firstRippled.service.respondWith(response);
+        secondRippled.service.respondWith(response);
+    }
+
+    std::string
+    fetchHeader(std::uint32_t seq)
+    {
+        auto const response = balancer->fetchLedger(seq, true, false);
+        return response ? response->ledger_header() : std::string{};
+    }
+};
+
+TEST_F(LoadBalancerHedgedFetchTest, FirstValidResponseWins)
+{
+    firstRippled.service.respondWith(makeResponse(SEQ, HASH));
+    secondRippled.service.respondWith(makeResponse(SEQ, OTHER_HASH));
+    secondRippled.service.hold();
+
+    EXPECT_CALL(*firstSource, fetchLedger).Times(0);
+    EXPECT_CALL(*secondSource, fetchLedger).Times(0);
+
+    EXPECT_EQ(fetchHeader(SEQ), makeResponse(SEQ, HASH).ledger_header());
+
+    // the call to the second source was cancelled, which says nothing about the source
+    EXPECT_TRUE(firstScore.latencyMs().has_value());
+    EXPECT_FALSE(secondScore.latencyMs().has_value());
+    EXPECT_DOUBLE_EQ(secondScore.errorRate(), 0.0);
+}
+
+TEST_F(LoadBalancerHedgedFetchTest, RejectedResponseDoesNotWin)
+{
+    firstRippled.service.respondWith(makeResponse(SEQ, OTHER_HASH, PARENT_HASH, false));
+    secondRippled.service.respondWith(makeResponse(SEQ, HASH));
+
+    EXPECT_CALL(*firstSource, fetchLedger).Times(0);
+    EXPECT_CALL(*secondSource, fetchLedger).Times(0);
+
+    EXPECT_EQ(fetchHeader(SEQ), makeResponse(SEQ, HASH).ledger_header());
+}
+
+TEST_F(LoadBalancerHedgedFetchTest, FallsBackToSourcesOneByOneIfNotValidated)
+{
+    respondWith(makeResponse(SEQ, HASH, PARENT_HASH, false));
+    EXPECT_EQ(fetchHeader(SEQ), fallback.ledger_header());
+}
+
+TEST_F(LoadBalancerHedgedFetchTest, FallsBackToSourcesOneByOneIfOtherLedger)
+{
+    respondWith(makeResponse(SEQ + 1, HASH));
+    EXPECT_EQ(fetchHeader(SEQ), fallback.ledger_header());
+}
+
+TEST_F(LoadBalancerHedgedFetchTest, FallsBackToSourcesOneByOneIfParentHashDiffers)
+{
+    respondWith(makeResponse(SEQ, HASH));
+    EXPECT_EQ(fetchHeader(SEQ), makeResponse(SEQ, HASH).ledger_header());
+
+    // the next ledger must build on the one accepted last
+    respondWith(makeResponse(SEQ + 1, OTHER_HASH, OTHER_HASH));
+    EXPECT_EQ(fetchHeader(SEQ + 1), fallback.ledger_header());
+
+    respondWith(makeResponse(SEQ + 1, OTHER_HASH, HASH));
+    EXPECT_EQ(fetchHeader(SEQ + 1), makeResponse(SEQ + 1, OTHER_HASH, HASH).ledger_header());
+}
+
+TEST_F(LoadBalancerHedgedFetchTest, FallsBackToSourcesOneByOneIfAllCallsFail)
+{
+    EXPECT_CALL(*firstSource, fetchLedgerAsync).WillOnce(Return(nullptr));
+    EXPECT_CALL(*secondSource, fetchLedgerAsync).WillOnce(Return(nullptr));
+
+    EXPECT_EQ(fetchHeader(SEQ), fallback.ledger_header());
+}
@@ -0,0 +1,131 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of clio: https://github.com/XRPLF/clio
+    Copyright (c) 2023, the clio developers.
+
+    Permission to use, copy, modify, and distribute this software for any
+    purpose with or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL,  DIRECT,  INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include "etl/impl/SourceScore.h"
+#include "util/MockPrometheus.h"
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <chrono>
+
+using namespace testing;
+using namespace etl::detail;
+using namespace util::prometheus;
+
+static auto constexpr FRESH = std::chrono::seconds{1};
+
+struct SourceScoreTest : WithPrometheus {
+    SourceScore score{"127.0.0.1:6005"};
+};
+
+TEST_F(SourceScoreTest, UntriedSourceScoresBest)
+{
+    EXPECT_FALSE(score.latencyMs().has_value());
+    EXPECT_DOUBLE_EQ(score.errorRate(), 0.0);
+    EXPECT_DOUBLE_EQ(score.score(0, FRESH), 0.0);
+}
+
+TEST_F(SourceScoreTest, FailingSourceWithoutSuccessScoresWorseThanHealthyOne)
+{
+    SourceScore healthy{"127.0.0.1:6006"};
+    healthy.recordSuccess(std::chrono::milliseconds{100});
+
+    score.recordFailure();
+    auto const failedOnce = score.score(0, FRESH);
+    EXPECT_GT(failedOnce, healthy.score(0, FRESH));
+
+    score.recordFailure();
+    EXPECT_GT(score.score(0, FRESH), failedOnce);
+}
+
+TEST_F(SourceScoreTest, LatencyIsSmoothed)
+{
+    score.recordSuccess(std::chrono::milliseconds{100});
+    EXPECT_DOUBLE_EQ(*score.latencyMs(), 100.0);
+
+    score.recordSuccess(std::chrono::milliseconds{200});
+    EXPECT_DOUBLE_EQ(*score.latencyMs(), 100.0 + SourceScore::SMOOTHING * 100.0);
+    EXPECT_DOUBLE_EQ(score.score(0, FRESH), *score.latencyMs());
+}
+
+TEST_F(SourceScoreTest, ErrorsRaiseScoreAndDecayOnSuccess)
+{
+    score.recordSuccess(std::chrono::milliseconds{100});
+    auto const healthy = score.score(0, FRESH);
+
+    score.recordFailure();
+    score.recordFailure();
+    auto const failing = score.score(0, FRESH);
+    EXPECT_GT(failing, healthy);
+
+    score.recordSuccess(std::chrono::milliseconds{100});
+    EXPECT_LT(score.score(0, FRESH), failing);
+}
+
+TEST_F(SourceScoreTest, ErrorRateIsCapped)
+{
+    score.recordSuccess(std::chrono::milliseconds{1});
+    for (auto i = 0; i < 100; ++i)
+        score.recordFailure();
+
+    EXPECT_LE(score.errorRate(), 1.0);
+    EXPECT_DOUBLE_EQ(score.score(0, FRESH), 1.0 / (1 - SourceScore::MAX_ERROR_RATE));
+}
+
+TEST_F(SourceScoreTest, LagAndStalenessArePenalized)
+{
+    EXPECT_DOUBLE_EQ(score.score(3, FRESH), 3 * SourceScore::LAG_PENALTY_MS);
+    EXPECT_DOUBLE_EQ(
+        score.score(SourceScore::MAX_LAG * 2, FRESH), SourceScore::MAX_LAG * SourceScore::LAG_PENALTY_MS
+    );
+    EXPECT_DOUBLE_EQ(score.score(0, SourceScore::STALE_AFTER * 2), SourceScore::STALE_PENALTY_MS);
+}
+
+TEST_F(SourceScoreTest, ToJson)
+{
+    score.recordSuccess(std::chrono::milliseconds{10});
+
+    auto const json = score.toJson(2, FRESH);
+    EXPECT_DOUBLE_EQ(json.at("latency_ms").as_double(), 10.0);
+    EXPECT_DOUBLE_EQ(json.at("error_rate").as_double(), 0.0);
+    EXPECT_EQ(json.at("lag").as_uint64(), 2u);
+    EXPECT_DOUBLE_EQ(json.at("score").as_double(), 10.0 + 2 * SourceScore::LAG_PENALTY_MS);
+}
+
+struct SourceScoreMetricsTest : WithMockPrometheus {};
+
+TEST_F(SourceScoreMetricsTest, PublishesGauges)
+{
+    auto& latencyMock = makeMock<GaugeDouble>("etl_source_latency_milliseconds", "{source=\"127.0.0.1:6005\"}");
+    auto& errorRateMock = makeMock<GaugeDouble>("etl_source_error_rate", "{source=\"127.0.0.1:6005\"}");
+    auto& scoreMock = makeMock<GaugeDouble>("etl_source_score", "{source=\"127.0.0.1:6005\"}");
+
+    SourceScore score{"127.0.0.1:6005"};
+
+    EXPECT_CALL(latencyMock, set(50.0));
+    EXPECT_CALL(errorRateMock, set(0.0));
+    score.recordSuccess(std::chrono::milliseconds{50});
+
+    EXPECT_CALL(errorRateMock, set(SourceScore::SMOOTHING));
+    score.recordFailure();
+
+    EXPECT_CALL(scoreMock, set(50.0 / (1 - SourceScore::SMOOTHING)));
+    score.score(0, FRESH);
+}
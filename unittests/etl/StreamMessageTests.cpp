@@ -0,0 +1,98 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of clio: https://github.com/XRPLF/clio
+    Copyright (c) 2023, the clio developers.
+
+    Permission to use, copy, modify, and distribute this software for any
+    purpose with or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL,  DIRECT,  INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include "etl/impl/StreamMessage.h"
+#include "rpc/RPCHelpers.h"
+#include "util/TestObject.h"
+
+#include <boost/json/parse.hpp>
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <optional>
+
+using namespace testing;
+using namespace etl::detail;
+
+constexpr static auto ACCOUNT1 = "rf1BiGeXwwQoi8Z2ueFYTEXSwuJYfV2Jpn";
+constexpr static auto ACCOUNT2 = "rLEsXccBGNR3UPuPu2hUXPjziKC3qKSBun";
+
+TEST(StreamMessageTest, ProposedTransaction)
+{
+    auto constexpr message = R"({
+        "type": "transaction",
+        "engine_result": "tesSUCCESS",
+        "validated": false,
+        "Account": "rLEsXccBGNR3UPuPu2hUXPjziKC3qKSBun",
+        "transaction": {
+            "Account": "rf1BiGeXwwQoi8Z2ueFYTEXSwuJYfV2Jpn",
+            "Amount": {"currency": "USD", "issuer": "rLEsXccBGNR3UPuPu2hUXPjziKC3qKSBun", "value": "1"},
+            "Fee": "12",
+            "Memos": [{"Memo": {"MemoData": "rf1BiGeXwwQoi8Z2ueFYTEXSwuJYfV2Jpn"}}],
+            "Sequence": 5,
+            "SigningPubKey": "036F3CFFE1EA77C1EEC5DCCA38C83E62E3AC068F8A16369620AF1D609BA5A620B2"
+        }
+    })";
+
+    auto const parsed = inspectStreamMessage(message);
+    ASSERT_TRUE(parsed);
+    EXPECT_EQ(parsed->type, "transaction");
+    EXPECT_FALSE(parsed->hasResult);
+    EXPECT_TRUE(parsed->hasTransaction);
+
+    // accounts outside of the transaction and in arrays don't count, just like in the parsed transaction
+    EXPECT_THAT(parsed->accounts, ElementsAre(GetAccountIDWithString(ACCOUNT1), GetAccountIDWithString(ACCOUNT2)));
+    auto const tree = boost::json::parse(message).as_object();
+    EXPECT_EQ(parsed->accounts, rpc::getAccountsFromTransaction(tree.at("transaction").as_object()));
+}
+
+TEST(StreamMessageTest, Validation)
+{
+    auto const parsed = inspectStreamMessage(R"({"type": "validationReceived", "ledger_index": "10", "full": true})");
+    ASSERT_TRUE(parsed);
+    EXPECT_EQ(parsed->type, "validationReceived");
+    EXPECT_FALSE(parsed->hasResult);
+    EXPECT_FALSE(parsed->hasTransaction);
+    EXPECT_TRUE(parsed->accounts.empty());
+}
+
+TEST(StreamMessageTest, SubscribeResponse)
+{
+    auto const parsed = inspectStreamMessage(R"({"id": 1, "result": {"ledger_index": 10, "type": "ledgerClosed"}})");
+    ASSERT_TRUE(parsed);
+    EXPECT_EQ(parsed->type, std::nullopt);
+    EXPECT_TRUE(parsed->hasResult);
+}
+
+TEST(StreamMessageTest, EscapedStrings)
+{
+    auto const parsed = inspectStreamMessage(R"({"ty\u0070e": "manifest\u0052eceived"})");
+    ASSERT_TRUE(parsed);
+    EXPECT_EQ(parsed->type, "manifestReceived");
+}
+
+TEST(StreamMessageTest, NotAnObject)
+{
+    EXPECT_FALSE(inspectStreamMessage(""));
+    EXPECT_FALSE(inspectStreamMessage("[]"));
+    EXPECT_FALSE(inspectStreamMessage("\"transaction\""));
+    EXPECT_FALSE(inspectStreamMessage(R"({"type": "ledgerClosed")"));
+    EXPECT_FALSE(inspectStreamMessage(R"({"type": "ledgerClosed"} trailing)"));
+    EXPECT_TRUE(inspectStreamMessage("{}\n"));
+}
@@ -31,6 +31,7 @@
 #include <gmock/gmock.h>
 #include <gtest/gtest.h>
 
+#include <atomic>
 #include <chrono>
 #include <memory>
 #include <optional>
@@ -89,7 +90,7 @@ TEST_F(ETLTransformerTest, StopsOnWriteConflict)
     state_.writeConflict = true;
 
     EXPECT_CALL(dataPipe_, popNext).Times(0);
-    EXPECT_CALL(ledgerPublisher_, publish(_)).Times(0);
+    EXPECT_CALL(ledgerPublisher_, publish(A<ripple::LedgerHeader const&>(), _)).Times(0);
 
     transformer_ = std::make_unique<TransformerType>(
         dataPipe_, mockBackendPtr, ledgerLoader_, ledgerPublisher_, amendmentBlockHandler_, 0, state_
@@ -123,7 +124,7 @@ TEST_F(ETLTransformerTest, StopsOnEmptyFetchResponse)
     EXPECT_CALL(*rawBackendPtr, writeNFTs).Times(AtLeast(1));
     EXPECT_CALL(*rawBackendPtr, writeNFTTransactions).Times(AtLeast(1));
     EXPECT_CALL(*rawBackendPtr, doFinishWrites).Times(AtLeast(1));
-    EXPECT_CALL(ledgerPublisher_, publish(_)).Times(AtLeast(1));
+    EXPECT_CALL(ledgerPublisher_, publish(A<ripple::LedgerHeader const&>(), _)).Times(AtLeast(1));
 
     transformer_ = std::make_unique<TransformerType>(
         dataPipe_, mockBackendPtr, ledgerLoader_, ledgerPublisher_, amendmentBlockHandler_, 0, state_
@@ -158,11 +159,127 @@ TEST_F(ETLTransformerTest, DoesNotPublishIfCanNotBuildNextLedger)
     EXPECT_CALL(*rawBackendPtr, doFinishWrites).Times(AtLeast(1));
 
     // should not call publish
-    EXPECT_CALL(ledgerPublisher_, publish(_)).Times(0);
+    EXPECT_CALL(ledgerPublisher_, publish(A<ripple::LedgerHeader const&>(), _)).Times(0);
 
     transformer_ = std::make_unique<TransformerType>(
         dataPipe_, mockBackendPtr, ledgerLoader_, ledgerPublisher_, amendmentBlockHandler_, 0, state_
     );
 }
 
+TEST_F(ETLTransformerTest, PublishesTransactionsWithoutReadingThemBack)
+{
+    MockBackend* rawBackendPtr = dynamic_cast<MockBackend*>(mockBackendPtr.get());
+    ASSERT_NE(rawBackendPtr, nullptr);
+    mockBackendPtr->cache().setFull();  // to avoid throwing exception in updateCache
+
+    auto const blob = hexStringToBinaryString(RAW_HEADER);
+    auto const response = std::make_optional<FakeFetchResponse>(blob);
+    auto numFetched = 0;
+
+    auto const transaction = data::TransactionAndMetadata{{1, 2, 3}, {4, 5, 6}, 0, 0};
+    auto txData = FormattedTransactionsData{};
+    txData.transactions.push_back(transaction);
+
+    ON_CALL(dataPipe_, popNext).WillByDefault([&](auto) -> std::optional<FakeFetchResponse> {
+        if (numFetched++ == 1)
+            return std::nullopt;
+        return response;  // NOLINT (performance-no-automatic-move)
+    });
+    ON_CALL(ledgerLoader_, insertTransactions).WillByDefault(Return(txData));
+    ON_CALL(*rawBackendPtr, doFinishWrites).WillByDefault(Return(true));
+
+    EXPECT_CALL(dataPipe_, popNext).Times(2);
+    EXPECT_CALL(*rawBackendPtr, startWrites);
+    EXPECT_CALL(*rawBackendPtr, writeLedger(_, _));
+    EXPECT_CALL(ledgerLoader_, insertTransactions);
+    EXPECT_CALL(*rawBackendPtr, writeAccountTransactions);
+    EXPECT_CALL(*rawBackendPtr, writeNFTs);
+    EXPECT_CALL(*rawBackendPtr, writeNFTTransactions);
+    EXPECT_CALL(*rawBackendPtr, doFinishWrites);
+    EXPECT_CALL(*rawBackendPtr, fetchAllTransactionsInLedger).Times(0);
+    EXPECT_CALL(ledgerPublisher_, publish(A<ripple::LedgerHeader const&>(), ElementsAre(transaction)));
+
+    transformer_ = std::make_unique<TransformerType>(
+        dataPipe_, mockBackendPtr, ledgerLoader_, ledgerPublisher_, amendmentBlockHandler_, 0, state_
+    );
+
+    transformer_->waitTillFinished();
+}
+
+TEST_F(ETLTransformerTest, PipelinedWritesPublishEachLedgerAfterItIsCommitted)
+{
+    MockBackend* rawBackendPtr = dynamic_cast<MockBackend*>(mockBackendPtr.get());
+    ASSERT_NE(rawBackendPtr, nullptr);
+    mockBackendPtr->cache().setFull();  // to avoid throwing exception in updateCache
+
+    static constexpr auto NUM_LEDGERS = 3;
+    auto const blob = hexStringToBinaryString(RAW_HEADER);
+    auto const response = std::make_optional<FakeFetchResponse>(blob);
+    auto numFetched = 0;
+    auto numCommitted = std::atomic_int{0};
+    auto numPublished = 0;
+
+    ON_CALL(dataPipe_, popNext).WillByDefault([&](auto) -> std::optional<FakeFetchResponse> {
+        if (numFetched++ == NUM_LEDGERS)
+            return std::nullopt;
+        return response;  // NOLINT (performance-no-automatic-move)
+    });
+    ON_CALL(*rawBackendPtr, doFinishWrites).WillByDefault([&](auto) {
+        ++numCommitted;
+        return true;
+    });
+    ON_CALL(ledgerPublisher_, publish(A<ripple::LedgerHeader const&>(), _))
+        .WillByDefault([&](auto const&, auto const&) { EXPECT_EQ(numCommitted, ++numPublished); });
+
+    EXPECT_CALL(dataPipe_, popNext).Times(NUM_LEDGERS + 1);
+    EXPECT_CALL(*rawBackendPtr, startWrites).Times(NUM_LEDGERS);
+    EXPECT_CALL(*rawBackendPtr, writeLedger(_, _)).Times(NUM_LEDGERS);
+    EXPECT_CALL(ledgerLoader_, insertTransactions).Times(NUM_LEDGERS);
+    EXPECT_CALL(*rawBackendPtr, writeAccountTransactions).Times(NUM_LEDGERS);
+    EXPECT_CALL(*rawBackendPtr, writeNFTs).Times(NUM_LEDGERS);
+    EXPECT_CALL(*rawBackendPtr, writeNFTTransactions).Times(NUM_LEDGERS);
+    EXPECT_CALL(*rawBackendPtr, doFinishWrites).Times(NUM_LEDGERS);
+    EXPECT_CALL(ledgerPublisher_, publish(A<ripple::LedgerHeader const&>(), _)).Times(NUM_LEDGERS);
+
+    transformer_ = std::make_unique<TransformerType>(
+        dataPipe_, mockBackendPtr, ledgerLoader_, ledgerPublisher_, amendmentBlockHandler_, 0, state_, true
+    );
+
+    transformer_->waitTillFinished();  // the last scheduled ledger is committed before the transformer exits
+    EXPECT_EQ(numPublished, NUM_LEDGERS);
+    EXPECT_FALSE(state_.writeConflict);
+}
+
+TEST_F(ETLTransformerTest, PipelinedWritesStopOnFailedCommit)
+{
+    MockBackend* rawBackendPtr = dynamic_cast<MockBackend*>(mockBackendPtr.get());
+    ASSERT_NE(rawBackendPtr, nullptr);
+    mockBackendPtr->cache().setFull();  // to avoid throwing exception in updateCache
+
+    auto const blob = hexStringToBinaryString(RAW_HEADER);
+    auto const response = std::make_optional<FakeFetchResponse>(blob);
+
+    ON_CALL(dataPipe_, popNext).WillByDefault(Return(response));
+    ON_CALL(*rawBackendPtr, doFinishWrites).WillByDefault(Return(false));  // emulate write conflict
+
+    EXPECT_CALL(dataPipe_, popNext).Times(AtLeast(1));
+    EXPECT_CALL(*rawBackendPtr, startWrites).Times(AtLeast(1));
+    EXPECT_CALL(*rawBackendPtr, writeLedger(_, _)).Times(AtLeast(1));
+    EXPECT_CALL(ledgerLoader_, insertTransactions).Times(AtLeast(1));
+    EXPECT_CALL(*rawBackendPtr, writeAccountTransactions).Times(AtLeast(1));
+    EXPECT_CALL(*rawBackendPtr, writeNFTs).Times(AtLeast(1));
+    EXPECT_CALL(*rawBackendPtr, writeNFTTransactions).Times(AtLeast(1));
+
+    // nothing after the failed ledger is committed
+    EXPECT_CALL(*rawBackendPtr, doFinishWrites).Times(1);
+    EXPECT_CALL(ledgerPublisher_, publish(A<ripple::LedgerHeader const&>(), _)).Times(0);
+
+    transformer_ = std::make_unique<TransformerType>(
+        dataPipe_, mockBackendPtr, ledgerLoader_, ledgerPublisher_, amendmentBlockHandler_, 0, state_, true
+    );
+
+    transformer_->waitTillFinished();
+    EXPECT_TRUE(state_.writeConflict);
+}
+
 // TODO: implement tests for amendment block. requires more refactoring
@@ -0,0 +1,180 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of clio: https://github.com/XRPLF/clio
+    Copyright (c) 2023, the clio developers.
+
+    Permission to use, copy, modify, and distribute this software for any
+    purpose with or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL,  DIRECT,  INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include "data/Types.h"
+#include "etl/SystemState.h"
+#include "etl/WriterElection.h"
+#include "util/Fixtures.h"
+#include "util/MockBackend.h"
+#include "util/MockPrometheus.h"
+#include "util/config/Config.h"
+
+#include <boost/json/parse.hpp>
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <cstdint>
+#include <optional>
+#include <stdexcept>
+#include <thread>
+
+using namespace testing;
+using namespace etl;
+using namespace data;
+
+// long enough for the heartbeat thread to stay idle while a test runs
+static auto constexpr IDLE_CONFIG = R"({"id": "self", "duration_ms": 60000, "heartbeat_ms": 30000})";
+static auto constexpr FAST_CONFIG =
+    R"({"id": "self", "duration_ms": 100, "heartbeat_ms": 10, "progress_timeout_ms": 50})";
+
+struct WriterElectionTest : util::prometheus::WithPrometheus, MockBackendTest {
+    SystemState state;
+    MockBackend* rawBackendPtr = nullptr;
+
+    void
+    SetUp() override
+    {
+        MockBackendTest::SetUp();
+        rawBackendPtr = dynamic_cast<MockBackend*>(mockBackendPtr.get());
+        ASSERT_NE(rawBackendPtr, nullptr);
+    }
+
+    WriterElection
+    makeElection(char const* config = IDLE_CONFIG)
+    {
+        return WriterElection{util::Config{boost::json::parse(config)}, mockBackendPtr, state};
+    }
+
+    static std::optional<WriterLease>
+    lease(char const* writer, std::uint64_t term, std::uint64_t heartbeat)
+    {
+        return WriterLease{.writer = writer, .term = term, .heartbeat = heartbeat};
+    }
+};
+
+TEST_F(WriterElectionTest, InvalidConfig)
+{
+    EXPECT_THROW(makeElection(R"({"duration_ms": 0})"), std::runtime_error);
+    EXPECT_THROW(makeElection(R"({"heartbeat_ms": 0})"), std::runtime_error);
+    EXPECT_THROW(makeElection(R"({"duration_ms": 1000, "heartbeat_ms": 1000})"), std::runtime_error);
+    EXPECT_THROW(makeElection(R"({"id": ""})"), std::runtime_error);
+}
+
+TEST_F(WriterElectionTest, DisabledWhenReadOnlyOrConfigured)
+{
+    EXPECT_CALL(*rawBackendPtr, fetchWriterLease).Times(0);
+    EXPECT_CALL(*rawBackendPtr, updateWriterLease).Times(0);
+
+    auto disabled = makeElection(R"({"enabled": false})");
+    EXPECT_FALSE(disabled.isEnabled());
+    EXPECT_FALSE(disabled.tryAcquire());
+
+    state.isReadOnly = true;
+    auto readOnly = makeElection();
+    EXPECT_FALSE(readOnly.isEnabled());
+    EXPECT_FALSE(readOnly.tryAcquire());
+}
+
+TEST_F(WriterElectionTest, AcquiresFreeLeaseAndReleasesIt)
+{
+    EXPECT_CALL(*rawBackendPtr, fetchWriterLease).WillOnce(Return(std::nullopt));
+    EXPECT_CALL(*rawBackendPtr, updateWriterLease(Eq(std::nullopt), *lease("self", 1, 0))).WillOnce(Return(true));
+    EXPECT_CALL(*rawBackendPtr, updateWriterLease(lease("self", 1, 0), *lease("", 1, 1))).WillOnce(Return(true));
+
+    auto election = makeElection();
+    EXPECT_TRUE(election.tryAcquire());
+    EXPECT_TRUE(election.tryAcquire());  // held already; the database is not asked again
+    EXPECT_TRUE(election.getInfo().at("is_writer").as_bool());
+}
+
+TEST_F(WriterElectionTest, TakesOverReleasedLeaseAtOnce)
+{
+    EXPECT_CALL(*rawBackendPtr, fetchWriterLease).WillOnce(Return(lease("", 3, 7)));
+    EXPECT_CALL(*rawBackendPtr, updateWriterLease(lease("", 3, 7), *lease("self", 4, 0))).WillOnce(Return(true));
+    EXPECT_CALL(*rawBackendPtr, updateWriterLease(lease("self", 4, 0), _)).WillOnce(Return(true));
+
+    auto election = makeElection();
+    EXPECT_TRUE(election.tryAcquire());
+}
+
+TEST_F(WriterElectionTest, TakesOverOnlyAfterLeaseExpired)
+{
+    ON_CALL(*rawBackendPtr, fetchWriterLease).WillByDefault(Return(lease("other", 3, 7)));
+    EXPECT_CALL(*rawBackendPtr, fetchWriterLease).Times(AtLeast(2));
+    EXPECT_CALL(*rawBackendPtr, updateWriterLease).Times(AnyNumber()).WillRepeatedly(Return(true));
+    EXPECT_CALL(*rawBackendPtr, updateWriterLease(lease("other", 3, 7), _)).Times(0);
+
+    auto election = makeElection(R"({"id": "self", "duration_ms": 100, "heartbeat_ms": 20})");
+    EXPECT_FALSE(election.tryAcquire());
+
+    std::this_thread::sleep_for(std::chrono::milliseconds{150});
+
+    EXPECT_CALL(*rawBackendPtr, updateWriterLease(lease("other", 3, 7), *lease("self", 4, 0))).WillOnce(Return(true));
+    EXPECT_TRUE(election.tryAcquire());
+}
+
+TEST_F(WriterElectionTest, LosingLeaseRaisesWriteConflict)
+{
+    EXPECT_CALL(*rawBackendPtr, fetchWriterLease).WillOnce(Return(std::nullopt));
+    EXPECT_CALL(*rawBackendPtr, updateWriterLease(Eq(std::nullopt), _)).WillOnce(Return(true));
+    EXPECT_CALL(*rawBackendPtr, updateWriterLease(lease("self", 1, 0), *lease("self", 1, 1))).WillOnce(Return(false));
+
+    auto election = makeElection();
+    ASSERT_TRUE(election.tryAcquire());
+
+    EXPECT_FALSE(election.renew());
+    EXPECT_TRUE(state.writeConflict);
+    EXPECT_FALSE(election.getInfo().at("is_writer").as_bool());
+    EXPECT_FALSE(election.renew());  // not released either, as it is not ours anymore
+}
+
+TEST_F(WriterElectionTest, GivesUpLeaseWithoutProgress)
+{
+    EXPECT_CALL(*rawBackendPtr, fetchWriterLease).WillOnce(Return(std::nullopt));
+    EXPECT_CALL(*rawBackendPtr, updateWriterLease(Eq(std::nullopt), *lease("self", 1, 0))).WillOnce(Return(true));
+    EXPECT_CALL(*rawBackendPtr, updateWriterLease(Ne(std::nullopt), Field(&WriterLease::writer, "self")))
+        .Times(AnyNumber())
+        .WillRepeatedly(Return(true));
+    EXPECT_CALL(*rawBackendPtr, updateWriterLease(_, Field(&WriterLease::writer, ""))).WillOnce(Return(true));
+
+    auto election = makeElection(FAST_CONFIG);
+    ASSERT_TRUE(election.tryAcquire());
+
+    // the heartbeat alone keeps the lease only until the progress timeout
+    std::this_thread::sleep_for(std::chrono::milliseconds{150});
+    EXPECT_FALSE(election.getInfo().at("is_writer").as_bool());
+    EXPECT_TRUE(state.writeConflict);
+    EXPECT_FALSE(election.renew());
+}
+
+TEST_F(WriterElectionTest, CommittingLedgersKeepsLease)
+{
+    EXPECT_CALL(*rawBackendPtr, fetchWriterLease).WillOnce(Return(std::nullopt));
+    EXPECT_CALL(*rawBackendPtr, updateWriterLease).Times(AnyNumber()).WillRepeatedly(Return(true));
+
+    auto election = makeElection(FAST_CONFIG);
+    ASSERT_TRUE(election.tryAcquire());
+
+    for (auto i = 0; i < 10; ++i) {
+        std::this_thread::sleep_for(std::chrono::milliseconds{15});
+        ASSERT_TRUE(election.renew());
+    }
+    EXPECT_FALSE(state.writeConflict);
+}
@@ -0,0 +1,137 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of clio: https://github.com/XRPLF/clio
+    Copyright (c) 2023, the clio developers.
+
+    Permission to use, copy, modify, and distribute this software for any
+    purpose with or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL,  DIRECT,  INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include "rpc/common/impl/ForwardingCache.h"
+#include "util/Fixtures.h"
+
+#include <boost/asio/spawn.hpp>
+#include <boost/asio/steady_timer.hpp>
+#include <boost/json/object.hpp>
+#include <boost/json/parse.hpp>
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+using namespace rpc::detail;
+using namespace testing;
+namespace json = boost::json;
+
+constexpr static std::uint32_t LEDGER_SEQ = 30;
+
+class RPCForwardingCacheTest : public SyncAsioContextTest {
+protected:
+    ForwardingCache cache;
+    json::object const response = json::parse(R"({"result": {"status": "success"}, "forwarded": true})").as_object();
+    int numFetches = 0;
+
+    ForwardingCache::FetchType const fetch = [this]() -> std::optional<json::object> {
+        ++numFetches;
+        return response;
+    };
+};
+
+TEST_F(RPCForwardingCacheTest, SubmitIsNeverCached)
+{
+    EXPECT_FALSE(ForwardingCache::policyFor("submit"));
+    EXPECT_FALSE(ForwardingCache::policyFor("submit_multisigned"));
+    EXPECT_FALSE(ForwardingCache::policyFor("ripple_path_find"));
+
+    runSpawn([&](auto yield) {
+        json::object const request = {{"tx_blob", "ABCD"}};
+        EXPECT_EQ(cache.getOrFetch("submit", request, LEDGER_SEQ, fetch, yield), response);
+        EXPECT_EQ(cache.getOrFetch("submit", request, LEDGER_SEQ, fetch, yield), response);
+    });
+
+    EXPECT_EQ(numFetches, 2);
+    EXPECT_EQ(cache.size(), 0u);
+}
+
+TEST_F(RPCForwardingCacheTest, IdenticalRequestsAreServedUntilLedgerCloses)
+{
+    runSpawn([&](auto yield) {
+        auto const request = json::parse(R"({"id": 1, "api_version": 2, "command": "fee"})").as_object();
+        auto const sameRequest = json::parse(R"({"command": "fee", "api_version": 2, "id": 2})").as_object();
+        auto const otherRequest = json::parse(R"({"command": "fee", "api_version": 1})").as_object();
+
+        EXPECT_EQ(cache.getOrFetch("fee", request, LEDGER_SEQ, fetch, yield), response);
+        EXPECT_EQ(cache.getOrFetch("fee", sameRequest, LEDGER_SEQ, fetch, yield), response);
+        EXPECT_EQ(numFetches, 1);
+
+        EXPECT_EQ(cache.getOrFetch("fee", otherRequest, LEDGER_SEQ, fetch, yield), response);
+        EXPECT_EQ(numFetches, 2);
+
+        EXPECT_EQ(cache.getOrFetch("fee", request, LEDGER_SEQ + 1, fetch, yield), response);
+        EXPECT_EQ(numFetches, 3);
+    });
+}
+
+TEST_F(RPCForwardingCacheTest, ErrorsAreNotCached)
+{
+    auto const error = json::parse(R"({"result": {"error": "tooBusy"}})").as_object();
+    ForwardingCache::FetchType const fetchError = [&]() -> std::optional<json::object> {
+        ++numFetches;
+        return error;
+    };
+    ForwardingCache::FetchType const fail = [&]() -> std::optional<json::object> {
+        ++numFetches;
+        return std::nullopt;
+    };
+
+    runSpawn([&](auto yield) {
+        json::object const request = {{"command", "fee"}};
+        EXPECT_EQ(cache.getOrFetch("fee", request, LEDGER_SEQ, fetchError, yield), error);
+        EXPECT_FALSE(cache.getOrFetch("fee", request, LEDGER_SEQ, fail, yield));
+        EXPECT_EQ(cache.getOrFetch("fee", request, LEDGER_SEQ, fetch, yield), response);
+    });
+
+    EXPECT_EQ(numFetches, 3);
+}
+
+TEST_F(RPCForwardingCacheTest, ConcurrentIdenticalRequestsShareOneFetch)
+{
+    auto const leaderResponse = json::parse(R"({"id": 1, "result": {"status": "success"}})").as_object();
+    std::vector<std::optional<json::object>> responses;
+
+    boost::asio::spawn(ctx, [&](boost::asio::yield_context yield) {
+        ForwardingCache::FetchType const slowFetch = [&]() -> std::optional<json::object> {
+            ++numFetches;
+            boost::asio::steady_timer timer{ctx, std::chrono::milliseconds{10}};
+            timer.async_wait(yield);
+            return leaderResponse;
+        };
+        responses.push_back(cache.getOrFetch("server_definitions", {{"id", 1}}, LEDGER_SEQ, slowFetch, yield));
+    });
+
+    for (auto id = 2; id <= 3; ++id) {
+        boost::asio::spawn(ctx, [&, id](boost::asio::yield_context yield) {
+            responses.push_back(cache.getOrFetch("server_definitions", {{"id", id}}, LEDGER_SEQ, fetch, yield));
+        });
+    }
+
+    ctx.run();
+
+    // the followers don't get the id of the request that was forwarded
+    auto const sharedResponse = json::parse(R"({"result": {"status": "success"}})").as_object();
+    EXPECT_EQ(numFetches, 1);
+    EXPECT_THAT(responses, UnorderedElementsAre(leaderResponse, sharedResponse, sharedResponse));
+}
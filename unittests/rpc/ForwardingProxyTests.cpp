@@ -434,3 +434,37 @@ TEST_F(RPCForwardingProxyTest, ForwardingFailYieldsErrorStatus)
         EXPECT_EQ(*status, ripple::rpcFAILED_TO_FORWARD);
     });
 }
+
+TEST_F(RPCForwardingProxyTest, ForwardServesRepeatedRequestsFromCache)
+{
+    auto const rawHandlerProviderPtr = handlerProvider.get();
+    auto const rawBalancerPtr = loadBalancer.get();
+    auto const apiVersion = 2u;
+    auto const method = "fee";
+    auto const params = json::parse(R"({})");
+    auto const forwarded = json::parse(R"({"command": "fee"})");
+    auto const response = json::parse(R"({"result": {"drops": {}}, "forwarded": true})");
+
+    EXPECT_CALL(*rawBalancerPtr, forwardToRippled(forwarded.as_object(), std::make_optional<std::string>(CLIENT_IP), _))
+        .WillOnce(Return(response.as_object()));
+
+    ON_CALL(*rawHandlerProviderPtr, contains).WillByDefault(Return(true));
+    EXPECT_CALL(*rawHandlerProviderPtr, contains(method)).Times(2);
+
+    ON_CALL(counters, rpcForwarded).WillByDefault(Return());
+    EXPECT_CALL(counters, rpcForwarded(method)).Times(2);
+
+    runSpawn([&](auto yield) {
+        auto const range = mockBackendPtr->fetchLedgerRange();
+        auto const ctx =
+            web::Context(yield, method, apiVersion, params.as_object(), nullptr, tagFactory, *range, CLIENT_IP, true);
+
+        for (auto i = 0; i < 2; ++i) {
+            auto const res = proxy.forward(ctx);
+
+            auto const data = std::get_if<json::object>(&res);
+            ASSERT_TRUE(data != nullptr);
+            EXPECT_EQ(*data, response.as_object());
+        }
+    });
+}
@@ -32,6 +32,7 @@
 #include <gtest/gtest.h>
 #include <ripple/basics/base_uint.h>
 #include <ripple/protocol/STObject.h>
+#include <ripple/protocol/TxFormats.h>
 
 #include <cstdint>
 #include <optional>
@@ -2037,9 +2038,11 @@ TEST_P(AccountTxTransactionTypeTest, SpecificTransactionType)
 
     auto const transactions = genTransactions(MAXSEQ, MAXSEQ - 1);
     auto const transCursor = TransactionsAndCursor{transactions, TransactionsCursor{12, 34}};
-    ON_CALL(*rawBackendPtr, fetchAccountTransactions).WillByDefault(Return(transCursor));
+    ON_CALL(*rawBackendPtr, fetchIndexCoverage(INDEX_ACCOUNT_TX_BY_TYPE, _)).WillByDefault(Return(0));
+    ON_CALL(*rawBackendPtr, fetchAccountTransactionsByType).WillByDefault(Return(transCursor));
     EXPECT_CALL(
-        *rawBackendPtr, fetchAccountTransactions(_, _, false, Optional(Eq(TransactionsCursor{MAXSEQ, INT32_MAX})), _)
+        *rawBackendPtr,
+        fetchAccountTransactionsByType(_, _, _, false, Optional(Eq(TransactionsCursor{MAXSEQ, INT32_MAX})), _)
     )
         .Times(1);
 
@@ -2059,3 +2062,186 @@ TEST_P(AccountTxTransactionTypeTest, SpecificTransactionType)
         EXPECT_EQ(jsonObject, transactions);
     });
 }
+
+TEST_F(RPCAccountTxHandlerTest, TransactionTypeUsesTypeIndex)
+{
+    mockBackendPtr->updateRange(MINSEQ);  // min
+    mockBackendPtr->updateRange(MAXSEQ);  // max
+    MockBackend* rawBackendPtr = dynamic_cast<MockBackend*>(mockBackendPtr.get());
+    ASSERT_NE(rawBackendPtr, nullptr);
+
+    auto const transactions = genTransactions(MAXSEQ, MAXSEQ - 1);
+    auto const transCursor = TransactionsAndCursor{transactions, TransactionsCursor{12, 34}};
+    EXPECT_CALL(*rawBackendPtr, fetchIndexCoverage(INDEX_ACCOUNT_TX_BY_TYPE, _)).WillOnce(Return(MINSEQ));
+    EXPECT_CALL(*rawBackendPtr, fetchAccountTransactions).Times(0);
+    EXPECT_CALL(
+        *rawBackendPtr,
+        fetchAccountTransactionsByType(
+            _, ripple::ttPAYMENT, 2, true, Optional(Eq(TransactionsCursor{MINSEQ - 1, INT32_MAX})), _
+        )
+    )
+        .WillOnce(Return(transCursor));
+
+    runSpawn([&, this](auto yield) {
+        auto const handler = AnyHandler{AccountTxHandler{mockBackendPtr}};
+        auto const static input = json::parse(fmt::format(
+            R"({{
+                "account": "{}",
+                "ledger_index_min": {},
+                "ledger_index_max": {},
+                "limit": 2,
+                "forward": true,
+                "binary": true,
+                "tx_type": "Payment"
+            }})",
+            ACCOUNT,
+            -1,
+            -1
+        ));
+        auto const output = handler.process(input, Context{yield});
+        ASSERT_TRUE(output);
+        EXPECT_EQ(output->at("account").as_string(), ACCOUNT);
+        EXPECT_EQ(output->at("marker").as_object(), json::parse(R"({"ledger": 12, "seq": 34})"));
+        EXPECT_EQ(output->at("transactions").as_array().size(), 2);
+    });
+}
+
+TEST_F(RPCAccountTxHandlerTest, TransactionTypeFiltersFullHistoryWithoutTypeIndex)
+{
+    mockBackendPtr->updateRange(MINSEQ);  // min
+    mockBackendPtr->updateRange(MAXSEQ);  // max
+    MockBackend* rawBackendPtr = dynamic_cast<MockBackend*>(mockBackendPtr.get());
+    ASSERT_NE(rawBackendPtr, nullptr);
+
+    // nothing was ever written to the type index, e.g. right after an upgrade
+    EXPECT_CALL(*rawBackendPtr, fetchIndexCoverage(INDEX_ACCOUNT_TX_BY_TYPE, _)).WillOnce(Return(std::nullopt));
+    EXPECT_CALL(*rawBackendPtr, fetchAccountTransactionsByType).Times(0);
+    EXPECT_CALL(*rawBackendPtr, fetchAccountTransactions(_, 4, false, _, _))
+        .WillOnce(Return(TransactionsAndCursor{genNFTTransactions(MAXSEQ), TransactionsCursor{12, 34}}));
+
+    runSpawn([&, this](auto yield) {
+        auto const handler = AnyHandler{AccountTxHandler{mockBackendPtr}};
+        auto const static input = json::parse(fmt::format(
+            R"({{
+                "account": "{}",
+                "limit": 4,
+                "binary": true,
+                "tx_type": "NFTokenMint"
+            }})",
+            ACCOUNT
+        ));
+        auto const output = handler.process(input, Context{yield});
+        ASSERT_TRUE(output);
+        EXPECT_EQ(output->at("marker").as_object(), json::parse(R"({"ledger": 12, "seq": 34})"));
+        EXPECT_EQ(output->at("transactions").as_array().size(), 1);
+    });
+}
+
+TEST_F(RPCAccountTxHandlerTest, TransactionTypeForwardFromBelowTypeIndexReadsFullHistory)
+{
+    mockBackendPtr->updateRange(MINSEQ);  // min
+    mockBackendPtr->updateRange(MAXSEQ);  // max
+    MockBackend* rawBackendPtr = dynamic_cast<MockBackend*>(mockBackendPtr.get());
+    ASSERT_NE(rawBackendPtr, nullptr);
+
+    EXPECT_CALL(*rawBackendPtr, fetchIndexCoverage(INDEX_ACCOUNT_TX_BY_TYPE, _)).WillOnce(Return(MINSEQ + 1));
+    EXPECT_CALL(*rawBackendPtr, fetchAccountTransactionsByType).Times(0);
+    EXPECT_CALL(
+        *rawBackendPtr, fetchAccountTransactions(_, 2, true, Optional(Eq(TransactionsCursor{MINSEQ - 1, INT32_MAX})), _)
+    )
+        .WillOnce(Return(TransactionsAndCursor{genTransactions(MINSEQ, MINSEQ + 1), TransactionsCursor{12, 34}}));
+
+    runSpawn([&, this](auto yield) {
+        auto const handler = AnyHandler{AccountTxHandler{mockBackendPtr}};
+        auto const static input = json::parse(fmt::format(
+            R"({{
+                "account": "{}",
+                "limit": 2,
+                "forward": true,
+                "binary": true,
+                "tx_type": "Payment"
+            }})",
+            ACCOUNT
+        ));
+        auto const output = handler.process(input, Context{yield});
+        ASSERT_TRUE(output);
+        EXPECT_EQ(output->at("marker").as_object(), json::parse(R"({"ledger": 12, "seq": 34})"));
+        EXPECT_EQ(output->at("transactions").as_array().size(), 2);
+    });
+}
+
+TEST_F(RPCAccountTxHandlerTest, TransactionTypeBackwardContinuesBelowTypeIndex)
+{
+    mockBackendPtr->updateRange(MINSEQ);  // min
+    mockBackendPtr->updateRange(MAXSEQ);  // max
+    MockBackend* rawBackendPtr = dynamic_cast<MockBackend*>(mockBackendPtr.get());
+    ASSERT_NE(rawBackendPtr, nullptr);
+
+    // the index covers ledger MAXSEQ - 1 and up; the row of MAXSEQ - 2 was written by a backfill and is skipped, as
+    // the next page reads that ledger from the full history
+    EXPECT_CALL(*rawBackendPtr, fetchIndexCoverage(INDEX_ACCOUNT_TX_BY_TYPE, _)).WillOnce(Return(MAXSEQ - 1));
+    EXPECT_CALL(*rawBackendPtr, fetchAccountTransactions).Times(0);
+    EXPECT_CALL(
+        *rawBackendPtr,
+        fetchAccountTransactionsByType(
+            _, ripple::ttPAYMENT, 10, false, Optional(Eq(TransactionsCursor{MAXSEQ, INT32_MAX})), _
+        )
+    )
+        .WillOnce(Return(TransactionsAndCursor{genTransactions(MAXSEQ, MAXSEQ - 2), std::nullopt}));
+
+    runSpawn([&, this](auto yield) {
+        auto const handler = AnyHandler{AccountTxHandler{mockBackendPtr}};
+        auto const static input = json::parse(fmt::format(
+            R"({{
+                "account": "{}",
+                "limit": 10,
+                "binary": true,
+                "tx_type": "Payment"
+            }})",
+            ACCOUNT
+        ));
+        auto const output = handler.process(input, Context{yield});
+        ASSERT_TRUE(output);
+        EXPECT_EQ(
+            output->at("marker").as_object(),
+            json::parse(fmt::format(R"({{"ledger": {}, "seq": {}}})", MAXSEQ - 2, INT32_MAX))
+        );
+        EXPECT_EQ(output->at("transactions").as_array().size(), 1);
+    });
+}
+
+TEST_F(RPCAccountTxHandlerTest, TransactionTypeBackwardMarkerBelowTypeIndexReadsFullHistory)
+{
+    mockBackendPtr->updateRange(MINSEQ);  // min
+    mockBackendPtr->updateRange(MAXSEQ);  // max
+    MockBackend* rawBackendPtr = dynamic_cast<MockBackend*>(mockBackendPtr.get());
+    ASSERT_NE(rawBackendPtr, nullptr);
+
+    EXPECT_CALL(*rawBackendPtr, fetchIndexCoverage(INDEX_ACCOUNT_TX_BY_TYPE, _)).WillOnce(Return(MAXSEQ - 1));
+    EXPECT_CALL(*rawBackendPtr, fetchAccountTransactionsByType).Times(0);
+    EXPECT_CALL(
+        *rawBackendPtr,
+        fetchAccountTransactions(_, 10, false, Optional(Eq(TransactionsCursor{MAXSEQ - 2, INT32_MAX})), _)
+    )
+        .WillOnce(Return(TransactionsAndCursor{genTransactions(MAXSEQ - 2, MINSEQ), std::nullopt}));
+
+    runSpawn([&, this](auto yield) {
+        auto const handler = AnyHandler{AccountTxHandler{mockBackendPtr}};
+        auto const static input = json::parse(fmt::format(
+            R"({{
+                "account": "{}",
+                "limit": 10,
+                "binary": true,
+                "tx_type": "Payment",
+                "marker": {{"ledger": {}, "seq": {}}}
+            }})",
+            ACCOUNT,
+            MAXSEQ - 2,
+            INT32_MAX
+        ));
+        auto const output = handler.process(input, Context{yield});
+        ASSERT_TRUE(output);
+        EXPECT_FALSE(output->as_object().contains("marker"));
+        EXPECT_EQ(output->at("transactions").as_array().size(), 2);
+    });
+}
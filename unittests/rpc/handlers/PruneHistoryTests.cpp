@@ -0,0 +1,135 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of clio: https://github.com/XRPLF/clio
+    Copyright (c) 2023, the clio developers.
+
+    Permission to use, copy, modify, and distribute this software for any
+    purpose with or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL,  DIRECT,  INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include "rpc/Errors.h"
+#include "rpc/common/AnyHandler.h"
+#include "rpc/common/Types.h"
+#include "rpc/handlers/PruneHistory.h"
+#include "util/Fixtures.h"
+#include "util/MockETLService.h"
+
+#include <boost/json/object.hpp>
+#include <boost/json/parse.hpp>
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+using namespace rpc;
+namespace json = boost::json;
+using namespace testing;
+
+using TestPruneHistoryHandler = BasePruneHistoryHandler<MockETLService>;
+
+constexpr static auto RANGEMIN = 10;
+constexpr static auto RANGEMAX = 30;
+
+class RPCPruneHistoryTest : public HandlerBaseTest {};
+
+TEST_F(RPCPruneHistoryTest, NotAdmin)
+{
+    runSpawn([this](auto yield) {
+        auto const handler = AnyHandler{TestPruneHistoryHandler{mockBackendPtr, mockETLServicePtr}};
+        auto const req = json::parse(R"({"min_ledger": 20})");
+        auto const output = handler.process(req, Context{yield});
+        ASSERT_FALSE(output);
+
+        auto const err = rpc::makeError(output.error());
+        EXPECT_EQ(err.at("error").as_string(), "noPermission");
+    });
+}
+
+TEST_F(RPCPruneHistoryTest, MinLedgerNotInt)
+{
+    runSpawn([this](auto yield) {
+        auto const handler = AnyHandler{TestPruneHistoryHandler{mockBackendPtr, mockETLServicePtr}};
+        auto const req = json::parse(R"({"min_ledger": "20"})");
+        auto const output = handler.process(req, Context{yield, {}, true});
+        ASSERT_FALSE(output);
+
+        auto const err = rpc::makeError(output.error());
+        EXPECT_EQ(err.at("error").as_string(), "invalidParams");
+    });
+}
+
+TEST_F(RPCPruneHistoryTest, MinLedgerAboveLatest)
+{
+    mockBackendPtr->updateRange(RANGEMIN);
+    mockBackendPtr->updateRange(RANGEMAX);
+
+    runSpawn([this](auto yield) {
+        auto const handler = AnyHandler{TestPruneHistoryHandler{mockBackendPtr, mockETLServicePtr}};
+        auto const req = json::parse(R"({"min_ledger": 31})");
+        auto const output = handler.process(req, Context{yield, {}, true});
+        ASSERT_FALSE(output);
+
+        auto const err = rpc::makeError(output.error());
+        EXPECT_EQ(err.at("error").as_string(), "invalidParams");
+        EXPECT_EQ(err.at("error_message").as_string(), "minLedgerAboveLatest");
+    });
+}
+
+TEST_F(RPCPruneHistoryTest, ReadOnly)
+{
+    mockBackendPtr->updateRange(RANGEMIN);
+    mockBackendPtr->updateRange(RANGEMAX);
+    EXPECT_CALL(*mockETLServicePtr, requestHistoryPruning(20)).WillOnce(Return(false));
+
+    runSpawn([this](auto yield) {
+        auto const handler = AnyHandler{TestPruneHistoryHandler{mockBackendPtr, mockETLServicePtr}};
+        auto const req = json::parse(R"({"min_ledger": 20})");
+        auto const output = handler.process(req, Context{yield, {}, true});
+        ASSERT_FALSE(output);
+
+        auto const err = rpc::makeError(output.error());
+        EXPECT_EQ(err.at("error").as_string(), "notEnabled");
+        EXPECT_EQ(err.at("error_message").as_string(), "notAvailableInReadOnlyMode");
+    });
+}
+
+TEST_F(RPCPruneHistoryTest, RequestAccepted)
+{
+    mockBackendPtr->updateRange(RANGEMIN);
+    mockBackendPtr->updateRange(RANGEMAX);
+
+    auto const info = json::parse(R"({"is_pruning": false, "pruned_ledgers": 0, "requested_min_ledger": 20})");
+    EXPECT_CALL(*mockETLServicePtr, requestHistoryPruning(20)).WillOnce(Return(true));
+    EXPECT_CALL(*mockETLServicePtr, getHistoryPruningInfo).WillOnce(Return(info.as_object()));
+
+    runSpawn([&, this](auto yield) {
+        auto const handler = AnyHandler{TestPruneHistoryHandler{mockBackendPtr, mockETLServicePtr}};
+        auto const req = json::parse(R"({"min_ledger": 20})");
+        auto const output = handler.process(req, Context{yield, {}, true});
+        ASSERT_TRUE(output);
+        EXPECT_EQ(*output, info);
+    });
+}
+
+TEST_F(RPCPruneHistoryTest, StatusOnly)
+{
+    auto const info = json::parse(R"({"is_pruning": true, "pruned_ledgers": 5})");
+    EXPECT_CALL(*mockETLServicePtr, requestHistoryPruning).Times(0);
+    EXPECT_CALL(*mockETLServicePtr, getHistoryPruningInfo).WillOnce(Return(info.as_object()));
+
+    runSpawn([&, this](auto yield) {
+        auto const handler = AnyHandler{TestPruneHistoryHandler{mockBackendPtr, mockETLServicePtr}};
+        auto const req = json::parse("{}");
+        auto const output = handler.process(req, Context{yield, {}, true});
+        ASSERT_TRUE(output);
+        EXPECT_EQ(*output, info);
+    });
+}
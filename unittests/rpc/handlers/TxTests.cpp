@@ -1094,6 +1094,71 @@ TEST_F(RPCTxTest, ViaCTID)
     });
 }
 
+TEST_F(RPCTxTest, ViaCTIDUsesTransactionIndex)
+{
+    auto const rawBackendPtr = dynamic_cast<MockBackend*>(mockBackendPtr.get());
+    TransactionAndMetadata tx;
+    tx.metadata = CreateMetaDataForCreateOffer(CURRENCY, ACCOUNT, 1, 200, 300).getSerializer().peekData();
+    tx.transaction =
+        CreateCreateOfferTransactionObject(ACCOUNT, 2, 100, CURRENCY, ACCOUNT2, 200, 300).getSerializer().peekData();
+    tx.date = 123456;
+    tx.ledgerSequence = SEQ_FROM_CTID;
+
+    EXPECT_CALL(*rawBackendPtr, fetchTransactionByIndex(SEQ_FROM_CTID, 1, _)).WillOnce(Return(tx));
+    EXPECT_CALL(*rawBackendPtr, fetchAllTransactionsInLedger).Times(0);
+
+    auto const rawETLPtr = dynamic_cast<MockETLService*>(mockETLServicePtr.get());
+    ASSERT_NE(rawETLPtr, nullptr);
+    EXPECT_CALL(*rawETLPtr, getETLState).WillOnce(Return(etl::ETLState{.networkID = 2}));
+
+    runSpawn([this](auto yield) {
+        auto const handler = AnyHandler{TestTxHandler{mockBackendPtr, mockETLServicePtr}};
+        auto const req = json::parse(fmt::format(
+            R"({{ 
+                "command": "tx",
+                "ctid": "{}"
+            }})",
+            CTID
+        ));
+        auto const output = handler.process(req, Context{yield});
+        ASSERT_TRUE(output);
+        EXPECT_EQ(output->at("ctid").as_string(), CTID);
+        EXPECT_EQ(output->at("ledger_index").as_uint64(), SEQ_FROM_CTID);
+    });
+}
+
+TEST_F(RPCTxTest, CtidMissInCoveredLedgerDoesNotReadWholeLedger)
+{
+    auto const rawBackendPtr = dynamic_cast<MockBackend*>(mockBackendPtr.get());
+    ASSERT_NE(rawBackendPtr, nullptr);
+    mockBackendPtr->updateRange(1);     // min
+    mockBackendPtr->updateRange(1000);  // max
+    EXPECT_CALL(*rawBackendPtr, fetchTransactionByIndex(SEQ_FROM_CTID, 1, _)).WillOnce(Return(std::nullopt));
+    EXPECT_CALL(*rawBackendPtr, fetchIndexCoverage(std::string{data::INDEX_LEDGER_TRANSACTION_INDEXES}, _))
+        .WillOnce(Return(SEQ_FROM_CTID));
+    EXPECT_CALL(*rawBackendPtr, fetchAllTransactionsInLedger).Times(0);
+
+    auto const rawETLPtr = dynamic_cast<MockETLService*>(mockETLServicePtr.get());
+    ASSERT_NE(rawETLPtr, nullptr);
+    EXPECT_CALL(*rawETLPtr, getETLState).WillOnce(Return(etl::ETLState{.networkID = 2}));
+
+    runSpawn([this](auto yield) {
+        auto const handler = AnyHandler{TestTxHandler{mockBackendPtr, mockETLServicePtr}};
+        auto const req = json::parse(fmt::format(
+            R"({{
+                "command": "tx",
+                "ctid": "{}"
+            }})",
+            CTID
+        ));
+        auto const output = handler.process(req, Context{yield});
+        ASSERT_FALSE(output);
+
+        auto const err = rpc::makeError(output.error());
+        EXPECT_EQ(err.at("error").as_string(), "txnNotFound");
+    });
+}
+
 TEST_F(RPCTxTest, ViaLowercaseCTID)
 {
     auto const rawBackendPtr = dynamic_cast<MockBackend*>(mockBackendPtr.get());
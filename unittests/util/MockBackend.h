@@ -76,6 +76,25 @@ struct MockBackend : public BackendInterface {
         (const, override)
     );
 
+    MOCK_METHOD(
+        TransactionsAndCursor,
+        fetchAccountTransactionsByType,
+        (ripple::AccountID const&,
+         ripple::TxType,
+         std::uint32_t const,
+         bool,
+         std::optional<TransactionsCursor> const&,
+         boost::asio::yield_context),
+        (const, override)
+    );
+
+    MOCK_METHOD(
+        std::optional<std::uint32_t>,
+        fetchIndexCoverage,
+        (std::string const&, boost::asio::yield_context),
+        (const, override)
+    );
+
     MOCK_METHOD(
         std::vector<TransactionAndMetadata>,
         fetchAllTransactionsInLedger,
@@ -90,6 +109,13 @@ struct MockBackend : public BackendInterface {
         (const, override)
     );
 
+    MOCK_METHOD(
+        std::optional<TransactionAndMetadata>,
+        fetchTransactionByIndex,
+        (std::uint32_t const, std::uint32_t const, boost::asio::yield_context),
+        (const, override)
+    );
+
     MOCK_METHOD(
         std::optional<NFT>,
         fetchNFT,
@@ -154,6 +180,8 @@ struct MockBackend : public BackendInterface {
 
     MOCK_METHOD(void, writeLedgerObject, (std::string&&, std::uint32_t const, std::string&&), (override));
 
+    MOCK_METHOD(void, writeSnapshotObject, (std::string&&, std::uint32_t const, std::string&&), (override));
+
     MOCK_METHOD(
         void,
         writeTransaction,
@@ -161,6 +189,13 @@ struct MockBackend : public BackendInterface {
         (override)
     );
 
+    MOCK_METHOD(
+        void,
+        writeTransactionIndex,
+        (std::uint32_t const, std::uint32_t const, ripple::uint256 const&),
+        (override)
+    );
+
     MOCK_METHOD(void, writeNFTs, (std::vector<NFTsData> const&), (override));
 
     MOCK_METHOD(void, writeAccountTransactions, (std::vector<AccountTransactionsData>), (override));
@@ -169,13 +204,54 @@ struct MockBackend : public BackendInterface {
 
     MOCK_METHOD(void, writeSuccessor, (std::string && key, std::uint32_t const, std::string&&), (override));
 
+    MOCK_METHOD(
+        void,
+        writeSuccessors,
+        ((std::vector<std::pair<ripple::uint256, ripple::uint256>> const&), std::uint32_t const),
+        (override)
+    );
+
     MOCK_METHOD(void, startWrites, (), (const, override));
 
+    MOCK_METHOD(
+        void,
+        deleteHistory,
+        (PrunedHistory const&, std::size_t, std::function<void()> const&),
+        (override)
+    );
+
+    MOCK_METHOD(void, isolateThreadWrites, (), (override));
+
+    MOCK_METHOD(void, syncThreadWrites, (), (override));
+
+    MOCK_METHOD(void, writeBackfilledChunk, (LedgerRange const&), (override));
+
+    MOCK_METHOD(std::vector<LedgerRange>, fetchBackfilledChunks, (boost::asio::yield_context), (const, override));
+
+    MOCK_METHOD(void, writeInitialLoadProgress, (InitialLoadProgress const&), (override));
+
+    MOCK_METHOD(
+        std::optional<InitialLoadProgress>,
+        fetchInitialLoadProgress,
+        (boost::asio::yield_context),
+        (const, override)
+    );
+
+    MOCK_METHOD(void, clearInitialLoadProgress, (), (override));
+
+    MOCK_METHOD(std::optional<WriterLease>, fetchWriterLease, (boost::asio::yield_context), (const, override));
+
+    MOCK_METHOD(bool, updateWriterLease, (std::optional<WriterLease> const&, WriterLease const&), (override));
+
     MOCK_METHOD(bool, isTooBusy, (), (const, override));
 
+    MOCK_METHOD(double, writeLoad, (), (const, override));
+
     MOCK_METHOD(boost::json::object, stats, (), (const, override));
 
     MOCK_METHOD(void, doWriteLedgerObject, (std::string&&, std::uint32_t const, std::string&&), (override));
 
-    MOCK_METHOD(bool, doFinishWrites, (), (override));
+    MOCK_METHOD(bool, doFinishWrites, (std::uint32_t), (override));
+
+    MOCK_METHOD(bool, doUpdateMinSequence, (std::uint32_t, std::uint32_t), (override));
 };
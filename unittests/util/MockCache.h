@@ -40,6 +40,13 @@ struct MockCache {
 
     MOCK_METHOD(std::optional<data::LedgerObject>, getPredecessor, (ripple::uint256 const& a, uint32_t b), (const));
 
+    MOCK_METHOD(
+        (std::vector<std::pair<ripple::uint256, ripple::uint256>>),
+        getSuccessorUpdates,
+        (std::vector<ripple::uint256> const& a, uint32_t b),
+        (const)
+    );
+
     MOCK_METHOD(void, setDisabled, (), ());
 
     MOCK_METHOD(void, setFull, (), ());
@@ -33,4 +33,6 @@ struct MockETLService {
     MOCK_METHOD(std::uint32_t, lastCloseAgeSeconds, (), (const));
     MOCK_METHOD(bool, isAmendmentBlocked, (), (const));
     MOCK_METHOD(std::optional<etl::ETLState>, getETLState, (), (const));
+    MOCK_METHOD(bool, requestHistoryPruning, (std::uint32_t), (const));
+    MOCK_METHOD(boost::json::object, getHistoryPruningInfo, (), (const));
 };
@@ -23,9 +23,11 @@
 
 #include <gmock/gmock.h>
 
+#include <future>
 #include <optional>
 
 struct MockLedgerFetcher {
     MOCK_METHOD(std::optional<FakeFetchResponse>, fetchData, (uint32_t), ());
     MOCK_METHOD(std::optional<FakeFetchResponse>, fetchDataAndDiff, (uint32_t), ());
+    MOCK_METHOD(std::future<std::optional<FakeFetchResponse>>, fetchDataAndDiffAsync, (uint32_t), ());
 };
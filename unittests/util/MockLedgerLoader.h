@@ -36,4 +36,7 @@ struct MockLedgerLoader {
         ()
     );
     MOCK_METHOD(std::optional<ripple::LedgerInfo>, loadInitialLedger, (uint32_t sequence), ());
+    MOCK_METHOD(bool, loadLedgerSnapshot, (uint32_t sequence), ());
+    MOCK_METHOD(void, loadLedgerDiff, (GetLedgerResponseType & data), ());
+    MOCK_METHOD(void, loadDeletions, (GetLedgerResponseType & data), ());
 };
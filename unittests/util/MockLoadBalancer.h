@@ -31,7 +31,7 @@
 struct MockLoadBalancer {
     using RawLedgerObjectType = FakeLedgerObject;
 
-    MOCK_METHOD(void, loadInitialLedger, (std::uint32_t, bool), ());
+    MOCK_METHOD(bool, loadInitialLedger, (std::uint32_t, bool), ());
     MOCK_METHOD(std::optional<FakeFetchResponse>, fetchLedger, (uint32_t, bool, bool), ());
     MOCK_METHOD(bool, shouldPropagateTxnStream, (etl::Source*), (const));
     MOCK_METHOD(boost::json::value, toJson, (), (const));
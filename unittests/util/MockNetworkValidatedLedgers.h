@@ -26,5 +26,6 @@
 struct MockNetworkValidatedLedgers {
     MOCK_METHOD(void, push, (uint32_t), ());
     MOCK_METHOD(std::optional<uint32_t>, getMostRecent, (), ());
+    MOCK_METHOD(std::optional<uint32_t>, tryGetMostRecent, (), (const));
     MOCK_METHOD(bool, waitUntilValidatedByNetwork, (uint32_t), ());
 };
@@ -31,13 +31,21 @@ public:
     MOCK_METHOD(void, resume, (), (override));
     MOCK_METHOD(std::string, toString, (), (const, override));
     MOCK_METHOD(bool, hasLedger, (uint32_t), (const, override));
+    MOCK_METHOD(double, score, (), (const, override));
     MOCK_METHOD(
         (std::pair<grpc::Status, org::xrpl::rpc::v1::GetLedgerResponse>),
         fetchLedger,
         (uint32_t, bool, bool),
         (override)
     );
-    MOCK_METHOD((std::pair<std::vector<std::string>, bool>), loadInitialLedger, (uint32_t, uint32_t, bool), (override));
+    MOCK_METHOD(
+        std::unique_ptr<etl::detail::AsyncLedgerFetch>,
+        fetchLedgerAsync,
+        (uint32_t, bool, bool, grpc::CompletionQueue&),
+        (override)
+    );
+    MOCK_METHOD(bool, loadInitialLedger, (uint32_t, uint32_t, bool), (override));
+    MOCK_METHOD(bool, loadLedgerSnapshot, (uint32_t, uint32_t), (override));
     MOCK_METHOD(
         std::optional<boost::json::object>,
         forwardToRippled,
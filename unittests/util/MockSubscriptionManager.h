@@ -24,6 +24,11 @@
 #include <boost/asio/spawn.hpp>
 #include <boost/json.hpp>
 #include <gmock/gmock.h>
+#include <ripple/protocol/AccountID.h>
+
+#include <memory>
+#include <string>
+#include <vector>
 
 struct MockSubscriptionManager {
 public:
@@ -76,10 +81,21 @@ public:
 
     MOCK_METHOD(void, forwardProposedTransaction, (boost::json::object const&), ());
 
+    MOCK_METHOD(
+        void,
+        forwardProposedTransaction,
+        (std::shared_ptr<std::string> const&, std::vector<ripple::AccountID> const&),
+        ()
+    );
+
     MOCK_METHOD(void, forwardManifest, (boost::json::object const&), ());
 
+    MOCK_METHOD(void, forwardManifest, (std::shared_ptr<std::string> const&), ());
+
     MOCK_METHOD(void, forwardValidation, (boost::json::object const&), ());
 
+    MOCK_METHOD(void, forwardValidation, (std::shared_ptr<std::string> const&), ());
+
     MOCK_METHOD(void, subProposedAccount, (ripple::AccountID const&, session_ptr), ());
 
     MOCK_METHOD(void, unsubProposedAccount, (ripple::AccountID const&, session_ptr), ());